@@ -0,0 +1,12 @@
+from .exceptions import AnalysisError
+
+from .mapReduce import map_reduce, frame_ranges, merge_partials
+from .ensemble import RunDirectory, EnsembleAnalysis, EnsembleResult
+from .mpiMapReduce import mpi_map_reduce
+from .orderParameters import OrderParameterAccumulator, spherical_harmonics, tetrahedral_order, steinhardt_order, order_parameters
+from .reorientation import ReorientationAccumulator, molecular_vectors, legendre_correlation, reorientation
+from .clusters import ClusterAccumulator, cluster_labels, clusters
+from .minimumDistance import MinimumDistanceAccumulator, make_whole, minimum_distances
+from .voronoi import VoronoiAccumulator, voronoi
+from .cavities import CavityAccumulator, cavities
+from .contactMaps import ContactMapAccumulator, group_contacts, contact_maps
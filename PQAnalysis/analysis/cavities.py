@@ -0,0 +1,332 @@
+"""
+A module containing the grid based cavity and pore size analysis of porous materials.
+
+...
+
+Classes
+-------
+CavityAccumulator
+    A class accumulating the void fractions and pore size distribution of all frames.
+
+Functions
+---------
+cavities
+    Computes the cavities of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import Dict, List, Tuple
+from numbers import Real
+
+from . import AnalysisError, map_reduce
+from ..core import resolve_elements
+from ..core.atom import element_covalent_radii
+from ..io import TrajectoryReader
+from ..kernels import covering_diameters, fractional_grid, surface_distances
+from ..statistics import Histogram
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DIntArray, Np1DNumberArray
+
+
+class CavityAccumulator:
+    """
+    A class accumulating the void fractions and pore size distribution of all frames.
+
+    For each frame the cell is covered by a regular grid in fractional coordinates
+    (kernels.fractional_grid), so that triclinic cells are handled exactly and each
+    grid point represents the same volume. The distance of each grid point to the
+    nearest atom surface is computed with kernels.surface_distances. A grid point
+    with a positive distance lies in the void and is accessible for the center of a
+    spherical probe if the distance is not smaller than the probe radius. The pore
+    diameter of a void point is the diameter of the largest empty sphere containing
+    the point (kernels.covering_diameters), not the diameter of the empty sphere
+    centered at the point, which would underestimate the pore size near the walls.
+
+    Per frame the void fraction, the accessible fraction and volume and the largest
+    cavity diameter are stored. The pore diameters of all void points are binned into
+    a Histogram weighted by the volume of the grid points, which gives the geometric
+    pore size distribution.
+
+    ...
+
+    Attributes
+    ----------
+    atoms : List[str] | Np1DIntArray | None
+        The selection of the atoms forming the framework.
+    radii : Dict[str, Real] | None
+        The radius of each atom name, None for the covalent radii of the elements.
+    spacing : Real
+        The largest distance of neighbouring grid points.
+    probe_radius : Real
+        The radius of the probe of the accessible volume.
+    histogram : Histogram
+        The volume of the void points of all frames binned by their pore diameter.
+    series : Dict[str, List[float]]
+        The 'void_fraction', 'accessible_fraction', 'accessible_volume' and
+        'largest_cavity_diameter' of each frame.
+    indices : Np1DIntArray | None
+        The indices of the selected atoms, determined with the first frame.
+    """
+
+    _series_names = ("void_fraction", "accessible_fraction", "accessible_volume",
+                     "largest_cavity_diameter")
+
+    def __init__(self,
+                 atoms: List[str] | Np1DIntArray | None = None,
+                 radii: Dict[str, Real] | None = None,
+                 spacing: Real = 0.5,
+                 probe_radius: Real = 0.0,
+                 max_diameter: Real = 30.0,
+                 n_bins: int = 150
+                 ) -> None:
+        """
+        Initializes the CavityAccumulator without frames.
+
+        Parameters
+        ----------
+        atoms : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the framework atoms, by default None (all atoms)
+        radii : Dict[str, Real] | None, optional
+            The radius of each atom name, by default None (the covalent radii of the
+            elements). Van der Waals radii give pore sizes comparable to other tools.
+        spacing : Real, optional
+            The largest distance of neighbouring grid points in Angstrom, by default 0.5
+        probe_radius : Real, optional
+            The radius of the probe of the accessible volume in Angstrom, by default 0.0
+        max_diameter : Real, optional
+            The largest pore diameter of the histogram in Angstrom, by default 30.0
+        n_bins : int, optional
+            The number of bins of the histogram, by default 150
+
+        Raises
+        ------
+        AnalysisError
+            If the spacing is not positive or the probe radius is negative.
+        """
+        if spacing <= 0.0:
+            raise AnalysisError("The grid spacing of the cavity analysis has to be positive.")
+
+        if probe_radius < 0.0:
+            raise AnalysisError("The probe radius of the cavity analysis must not be negative.")
+
+        self.atoms = atoms
+        self.radii = radii
+        self.spacing = spacing
+        self.probe_radius = probe_radius
+
+        self.histogram = Histogram((0.0, max_diameter), n_bins)
+        self.series = {name: [] for name in self._series_names}
+
+        self.indices = None
+        self._radii = None
+
+    def _setup(self, frame: Frame) -> None:
+        """
+        Resolves the selection and the radii of the framework atoms with the first frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The first frame.
+
+        Raises
+        ------
+        AnalysisError
+            If an atom has no radius.
+        """
+        self.indices = np.asarray(frame.system.indices_from_atoms(self.atoms))
+        atoms = [frame.system.atoms[index] for index in self.indices]
+
+        names = np.array([atom.name for atom in atoms])
+
+        if self.radii is not None:
+            radii = np.array([self.radii.get(name, np.nan) for name in names], dtype=np.float64)
+        else:
+            symbols = [atom.symbol if atom.symbol is not None else atom.name for atom in atoms]
+            codes = resolve_elements(symbols, strict=False)
+            radii = np.where(codes >= 0, element_covalent_radii[np.maximum(codes, 0)], np.nan)
+
+        missing = sorted(set(names[np.isnan(radii)]))
+
+        if len(missing) > 0:
+            raise AnalysisError(
+                f"The cavity analysis needs a radius for the atom names {missing}.")
+
+        self._radii = radii
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the cavities of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+
+        Raises
+        ------
+        AnalysisError
+            If the frame has no periodic boundary conditions.
+        """
+        if not frame.PBC:
+            raise AnalysisError(
+                "The cavity analysis needs periodic boundary conditions.")
+
+        if self.indices is None:
+            self._setup(frame)
+
+        box_matrix = frame.cell.box_matrix
+        volume = abs(np.linalg.det(box_matrix))
+
+        points, shape = fractional_grid(box_matrix, self.spacing)
+        distances, _ = surface_distances(points, frame.pos[self.indices], self._radii, box_matrix)
+
+        void = distances > 0.0
+        accessible = void & (distances >= self.probe_radius)
+
+        diameters = covering_diameters(distances, shape, box_matrix, self.histogram.edges[0])
+
+        self.histogram.add(diameters[void], volume / len(points))
+
+        self.series["void_fraction"].append(float(np.mean(void)))
+        self.series["accessible_fraction"].append(float(np.mean(accessible)))
+        self.series["accessible_volume"].append(float(np.mean(accessible)) * volume)
+        self.series["largest_cavity_diameter"].append(max(2.0 * float(np.max(distances)), 0.0))
+
+    def merge(self, other: CavityAccumulator) -> CavityAccumulator:
+        """
+        Merges the results of a later frame range into this accumulator.
+
+        Parameters
+        ----------
+        other : CavityAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        CavityAccumulator
+            This accumulator.
+        """
+        self.histogram.merge(other.histogram)
+
+        for name, values in self.series.items():
+            values.extend(other.series[name])
+
+        if self.indices is None:
+            self.indices = other.indices
+            self._radii = other._radii
+
+        return self
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return len(self.series["void_fraction"])
+
+    def time_series(self, name: str) -> Np1DNumberArray:
+        """
+        Returns a property of the cavities in each frame.
+
+        Parameters
+        ----------
+        name : str
+            The property, 'void_fraction', 'accessible_fraction', 'accessible_volume'
+            or 'largest_cavity_diameter'.
+
+        Returns
+        -------
+        Np1DNumberArray
+            The value of each frame.
+
+        Raises
+        ------
+        AnalysisError
+            If the property is not known.
+        """
+        if name not in self.series:
+            raise AnalysisError(
+                f"The cavity property {name} is not known, available are {list(self._series_names)}.")
+
+        return np.array(self.series[name])
+
+    def pore_size_distribution(self) -> Tuple[Np1DNumberArray, Np1DNumberArray]:
+        """
+        Returns the probability density of the pore diameter in the void volume.
+
+        The void volume of larger pores than the histogram range is included in the
+        normalization.
+
+        Returns
+        -------
+        diameters : Np1DNumberArray
+            The centers of the bins.
+        density : Np1DNumberArray
+            The fraction of the void volume per Angstrom of each bin.
+
+        Raises
+        ------
+        AnalysisError
+            If no void volume was found.
+        """
+        if self.histogram.total <= 0.0:
+            raise AnalysisError("No void volume was found in the added frames.")
+
+        density = self.histogram.counts / (self.histogram.total * self.histogram.widths[0])
+
+        return self.histogram.centers[0], density
+
+
+def cavities(reader: TrajectoryReader,
+             atoms: List[str] | Np1DIntArray | None = None,
+             radii: Dict[str, Real] | None = None,
+             spacing: Real = 0.5,
+             probe_radius: Real = 0.0,
+             max_diameter: Real = 30.0,
+             n_bins: int = 150,
+             md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+             n_workers: int | None = None
+             ) -> CavityAccumulator:
+    """
+    Computes the cavities of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    CavityAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    atoms : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the framework atoms, by default None (all atoms)
+    radii : Dict[str, Real] | None, optional
+        The radius of each atom name, by default None (the covalent radii of the elements)
+    spacing : Real, optional
+        The largest distance of neighbouring grid points in Angstrom, by default 0.5
+    probe_radius : Real, optional
+        The radius of the probe of the accessible volume in Angstrom, by default 0.0
+    max_diameter : Real, optional
+        The largest pore diameter of the histogram in Angstrom, by default 30.0
+    n_bins : int, optional
+        The number of bins of the histogram, by default 150
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    CavityAccumulator
+        The cavities of all frames.
+    """
+    factory = functools.partial(CavityAccumulator, atoms, radii, spacing, probe_radius,
+                                max_diameter, n_bins)
+
+    return map_reduce(reader, factory, CavityAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
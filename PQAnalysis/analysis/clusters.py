@@ -0,0 +1,431 @@
+"""
+A module containing the cluster (connected component) analysis of atoms within a distance cutoff.
+
+...
+
+Classes
+-------
+ClusterAccumulator
+    A class accumulating cluster size distributions and tracking clusters over frames.
+
+Functions
+---------
+cluster_labels
+    Returns the cluster of each position, where positions closer than a cutoff are connected.
+clusters
+    Computes the clusters of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import List, Tuple
+from numbers import Real
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import connected_components, cutoff_pairs
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def cluster_labels(pos: Np2DNumberArray,
+                   cutoff: Real,
+                   box_matrix: Np3x3NumberArray | None = None
+                   ) -> Np1DIntArray:
+    """
+    Returns the cluster of each position, where positions closer than a cutoff are connected.
+
+    The pairs within the cutoff are enumerated with cutoff_pairs (with a cell list
+    for periodic systems) and the clusters are the connected components of these
+    pairs (see kernels.connected_components).
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3).
+    cutoff : Real
+        The (exclusive) cutoff distance.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    Np1DIntArray
+        The cluster of each position. The clusters are numbered 0 ... n_clusters - 1
+        in the order of their first position.
+    """
+    pairs, _ = cutoff_pairs(pos, None, cutoff, box_matrix)
+
+    roots = connected_components(len(pos), pairs)
+
+    return np.unique(roots, return_inverse=True)[1].reshape(-1)
+
+
+def _match_clusters(previous_labels: np.ndarray,
+                    previous_ids: np.ndarray,
+                    labels: np.ndarray,
+                    tracked: np.ndarray
+                    ) -> np.ndarray:
+    """
+    Returns the track id of each cluster continuing a cluster of the previous frame.
+
+    A tracked cluster continues the track of the previous cluster, from which the
+    majority of its atoms come. If a previous cluster is continued by several clusters
+    (i.e. it split), the cluster with most of its atoms continues the track.
+
+    Parameters
+    ----------
+    previous_labels : np.ndarray
+        The cluster of each atom in the previous frame.
+    previous_ids : np.ndarray
+        The track id of each previous cluster, -1 if it is not tracked.
+    labels : np.ndarray
+        The cluster of each atom in the current frame.
+    tracked : np.ndarray
+        Whether each current cluster is tracked.
+
+    Returns
+    -------
+    np.ndarray
+        The track id of each current cluster, -1 if it does not continue a track.
+    """
+    ids = np.full(len(tracked), -1, dtype=np.int64)
+
+    atom_ids = previous_ids[previous_labels]
+    candidates = (atom_ids >= 0) & tracked[labels]
+
+    if not np.any(candidates):
+        return ids
+
+    sizes = np.bincount(labels, minlength=len(tracked))
+
+    # the number of shared atoms of each (current cluster, previous track)
+    overlaps, counts = np.unique(np.column_stack((labels[candidates], atom_ids[candidates])),
+                                 axis=0, return_counts=True)
+
+    majority = 2 * counts > sizes[overlaps[:, 0]]
+    overlaps, counts = overlaps[majority], counts[majority]
+
+    # each previous track is continued by the cluster with the largest overlap
+    order = np.lexsort((overlaps[:, 0], -counts, overlaps[:, 1]))
+    _, first = np.unique(overlaps[order, 1], return_index=True)
+    winners = overlaps[order[first]]
+
+    ids[winners[:, 0]] = winners[:, 1]
+
+    return ids
+
+
+class ClusterAccumulator:
+    """
+    A class accumulating cluster size distributions and tracking clusters over frames.
+
+    For each frame the selected atoms are clustered with cluster_labels. The number of
+    clusters of each size is accumulated over all frames, and the size of the largest
+    cluster and the number of clusters of each frame are stored as time series.
+
+    With track=True the clusters of at least min_size atoms are followed over the
+    frames: a cluster continues the track of the cluster of the previous frame from
+    which the majority of its atoms come, otherwise it starts a new track. The track
+    ids are assigned in the order of appearance.
+
+    When a later frame range is merged, its tracks are stitched to the tracks of the
+    last frame, so that the tracks do not depend on how the frames were split.
+
+    ...
+
+    Attributes
+    ----------
+    cutoff : Real
+        The cutoff distance of connected atoms.
+    atoms : List[str] | Np1DIntArray | None
+        The selection of the atoms.
+    track : bool
+        Whether the clusters are tracked over the frames.
+    min_size : int
+        The minimum size of tracked clusters.
+    size_counts : Np1DIntArray
+        The number of clusters of each size (index) summed over all frames.
+    largest : List[int]
+        The size of the largest cluster of each frame.
+    n_clusters : List[int]
+        The number of clusters of each frame.
+    track_ids : List[Np1DIntArray]
+        The track id of each tracked cluster of each frame.
+    track_sizes : List[Np1DIntArray]
+        The size of each tracked cluster of each frame.
+    n_tracks : int
+        The number of tracks.
+    indices : Np1DIntArray | None
+        The indices of the selected atoms, determined with the first frame.
+    """
+
+    def __init__(self,
+                 cutoff: Real,
+                 atoms: List[str] | Np1DIntArray | None = None,
+                 track: bool = False,
+                 min_size: int = 2
+                 ) -> None:
+        """
+        Initializes the ClusterAccumulator without frames.
+
+        Parameters
+        ----------
+        cutoff : Real
+            The cutoff distance of connected atoms.
+        atoms : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the selected atoms, by default None (all atoms)
+        track : bool, optional
+            Whether the clusters are tracked over the frames, by default False
+        min_size : int, optional
+            The minimum size of tracked clusters, by default 2
+
+        Raises
+        ------
+        AnalysisError
+            If the cutoff is not positive.
+        """
+        if cutoff <= 0.0:
+            raise AnalysisError("The cutoff of the cluster analysis has to be positive.")
+
+        self.cutoff = cutoff
+        self.atoms = atoms
+        self.track = track
+        self.min_size = min_size
+
+        self.size_counts = np.zeros(1, dtype=np.int64)
+        self.largest = []
+        self.n_clusters = []
+
+        self.track_ids = []
+        self.track_sizes = []
+        self.n_tracks = 0
+
+        self.indices = None
+
+        # the clusters of the first and last frame to stitch the tracks of frame ranges
+        self._first = None
+        self._last = None
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the clusters of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+        """
+        if self.indices is None:
+            self.indices = np.asarray(frame.system.indices_from_atoms(self.atoms))
+
+        box_matrix = frame.cell.box_matrix if frame.PBC else None
+
+        labels = cluster_labels(frame.pos[self.indices], self.cutoff, box_matrix)
+        sizes = np.bincount(labels)
+
+        self._add_size_counts(np.bincount(sizes))
+        self.largest.append(int(sizes.max(initial=0)))
+        self.n_clusters.append(len(sizes))
+
+        if not self.track:
+            return
+
+        tracked = sizes >= self.min_size
+
+        if self._last is None:
+            ids = np.full(len(sizes), -1, dtype=np.int64)
+        else:
+            ids = _match_clusters(*self._last, labels, tracked)
+
+        new = tracked & (ids < 0)
+        ids[new] = self.n_tracks + np.arange(np.count_nonzero(new))
+        self.n_tracks += int(np.count_nonzero(new))
+
+        self.track_ids.append(ids[tracked])
+        self.track_sizes.append(sizes[tracked])
+
+        self._last = (labels, ids)
+        if self._first is None:
+            self._first = (labels, ids)
+
+    def _add_size_counts(self, counts: np.ndarray) -> None:
+        if len(counts) > len(self.size_counts):
+            self.size_counts = np.pad(self.size_counts, (0, len(counts) - len(self.size_counts)))
+
+        self.size_counts[:len(counts)] += counts
+
+    def merge(self, other: ClusterAccumulator) -> ClusterAccumulator:
+        """
+        Merges the clusters of a later frame range into this accumulator.
+
+        Parameters
+        ----------
+        other : ClusterAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        ClusterAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        AnalysisError
+            If only one of the accumulators tracks the clusters.
+        """
+        if self.track != other.track:
+            raise AnalysisError(
+                "Accumulators with and without tracking of the clusters cannot be merged.")
+
+        self._add_size_counts(other.size_counts)
+        self.largest.extend(other.largest)
+        self.n_clusters.extend(other.n_clusters)
+
+        if self.indices is None:
+            self.indices = other.indices
+
+        if self.track and other._first is not None:
+            # the tracks of the later frames are renumbered, continued tracks get the id of this accumulator
+            mapping = np.full(other.n_tracks, -1, dtype=np.int64)
+
+            if self._last is not None:
+                first_labels, first_ids = other._first
+                continued = _match_clusters(*self._last, first_labels, first_ids >= 0)
+
+                mapping[first_ids[continued >= 0]] = continued[continued >= 0]
+
+            new = mapping < 0
+            mapping[new] = self.n_tracks + np.arange(np.count_nonzero(new))
+            self.n_tracks += int(np.count_nonzero(new))
+
+            self.track_ids.extend(mapping[ids] for ids in other.track_ids)
+            self.track_sizes.extend(other.track_sizes)
+
+            labels, ids = other._last
+            self._last = (labels, np.where(ids >= 0, mapping[np.maximum(ids, 0)], -1))
+
+            if self._first is None:
+                labels, ids = other._first
+                self._first = (labels, np.where(ids >= 0, mapping[np.maximum(ids, 0)], -1))
+
+        return self
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return len(self.largest)
+
+    def size_distribution(self, atom_weighted: bool = False) -> Tuple[Np1DIntArray, Np1DNumberArray]:
+        """
+        Returns the probability distribution of the cluster sizes.
+
+        Parameters
+        ----------
+        atom_weighted : bool, optional
+            Whether the probability that an atom belongs to a cluster of a size is returned
+            instead of the probability of a cluster to have the size, by default False
+
+        Returns
+        -------
+        sizes : Np1DIntArray
+            The cluster sizes 1 ... largest size.
+        probabilities : Np1DNumberArray
+            The probability of each size.
+
+        Raises
+        ------
+        AnalysisError
+            If no frame was added.
+        """
+        if self.n_frames == 0:
+            raise AnalysisError("No frames were added to the accumulator.")
+
+        sizes = np.arange(1, len(self.size_counts))
+        counts = self.size_counts[1:].astype(np.float64)
+
+        if atom_weighted:
+            counts *= sizes
+
+        return sizes, counts / np.sum(counts)
+
+    def largest_cluster(self) -> Np1DIntArray:
+        """
+        Returns the size of the largest cluster of each frame.
+
+        Returns
+        -------
+        Np1DIntArray
+            The time series of the largest cluster size.
+        """
+        return np.array(self.largest, dtype=np.int64)
+
+    def track_lifetimes(self) -> Np1DIntArray:
+        """
+        Returns the number of frames of each track.
+
+        Returns
+        -------
+        Np1DIntArray
+            The lifetime in frames of each track id.
+
+        Raises
+        ------
+        AnalysisError
+            If the clusters were not tracked.
+        """
+        if not self.track:
+            raise AnalysisError("The clusters were not tracked, use track=True.")
+
+        if len(self.track_ids) == 0:
+            return np.zeros(0, dtype=np.int64)
+
+        return np.bincount(np.concatenate(self.track_ids), minlength=self.n_tracks)
+
+
+def clusters(reader: TrajectoryReader,
+             cutoff: Real,
+             atoms: List[str] | Np1DIntArray | None = None,
+             track: bool = False,
+             min_size: int = 2,
+             md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+             n_workers: int | None = None
+             ) -> ClusterAccumulator:
+    """
+    Computes the clusters of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    ClusterAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    cutoff : Real
+        The cutoff distance of connected atoms.
+    atoms : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the selected atoms, by default None (all atoms)
+    track : bool, optional
+        Whether the clusters are tracked over the frames, by default False
+    min_size : int, optional
+        The minimum size of tracked clusters, by default 2
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    ClusterAccumulator
+        The clusters of all frames.
+    """
+    factory = functools.partial(ClusterAccumulator, cutoff, atoms, track, min_size)
+
+    return map_reduce(reader, factory, ClusterAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
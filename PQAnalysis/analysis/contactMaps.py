@@ -0,0 +1,355 @@
+"""
+A module containing the time averaged contact maps between molecules or groups of atoms.
+
+...
+
+Classes
+-------
+ContactMapAccumulator
+    A class counting the frames in which two groups of atoms are in contact.
+
+Functions
+---------
+group_contacts
+    Returns the pairs of groups with at least one pair of atoms closer than a cutoff.
+contact_maps
+    Computes the contact map of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import Tuple
+from numbers import Real
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import cutoff_pairs
+from ..topology import MoleculeTopology
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DNumberArray, Np2DIntArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def group_contacts(pos: Np2DNumberArray,
+                   cutoff: Real,
+                   topology1: MoleculeTopology,
+                   topology2: MoleculeTopology | None = None,
+                   box_matrix: Np3x3NumberArray | None = None
+                   ) -> Np2DIntArray:
+    """
+    Returns the pairs of groups with at least one pair of atoms closer than a cutoff.
+
+    The atom pairs are enumerated with cutoff_pairs, i.e. with a CellList in periodic
+    cells, and mapped to the groups (e.g. molecules or residues) of the topologies
+    in compressed sparse row form. The topologies may share atoms, but an atom is
+    never in contact with itself.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of all atoms of shape (n_atoms, 3).
+    cutoff : Real
+        The contact distance of two atoms.
+    topology1 : MoleculeTopology
+        The first groups.
+    topology2 : MoleculeTopology | None, optional
+        The second groups, by default None (the contacts between different groups of topology1)
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    Np2DIntArray
+        The unique group pairs (g1, g2) in contact of shape (n_contacts, 2), sorted by
+        g1 and g2. Without topology2 only the pairs g1 < g2 are returned.
+    """
+    groups1 = topology1.atom_molecules()
+
+    if topology2 is None:
+        pairs, _ = cutoff_pairs(pos[topology1.indices], None, cutoff, box_matrix)
+        contacts = np.sort(groups1[pairs], axis=1)
+
+        # the contacts within a group are not counted
+        contacts = contacts[contacts[:, 0] != contacts[:, 1]]
+        n_groups2 = topology1.n_molecules
+    else:
+        pairs, _ = cutoff_pairs(pos[topology1.indices], pos[topology2.indices], cutoff, box_matrix)
+
+        # an atom of both topologies is not in contact with itself
+        pairs = pairs[topology1.indices[pairs[:, 0]] != topology2.indices[pairs[:, 1]]]
+        contacts = np.column_stack((groups1[pairs[:, 0]], topology2.atom_molecules()[pairs[:, 1]]))
+        n_groups2 = topology2.n_molecules
+
+    keys = np.unique(contacts[:, 0] * n_groups2 + contacts[:, 1])
+
+    return np.column_stack((keys // n_groups2, keys % n_groups2))
+
+
+class ContactMapAccumulator:
+    """
+    A class counting the frames in which two groups of atoms are in contact.
+
+    Two groups (e.g. molecules, residues or the fixed-size groups of
+    Frame.compute_com_frame) are in contact in a frame if any of their atoms are
+    closer than the cutoff. The contacts of each frame are found with group_contacts
+    and counted in sparse coordinate form, i.e. as sorted unique keys g1 * n2 + g2 with
+    the number of frames of each key. Thus, the memory scales with the number of group
+    pairs that are in contact at least once, also for 10k x 10k groups. The keys of
+    the frames are buffered and reduced with np.unique once the buffer exceeds
+    buffer_size entries.
+
+    ...
+
+    Attributes
+    ----------
+    cutoff : Real
+        The contact distance of two atoms.
+    topology1 : MoleculeTopology | int
+        The first groups or the size of consecutive groups of all atoms.
+    topology2 : MoleculeTopology | int | None
+        The second groups or the size of consecutive groups of all atoms, None for
+        the contacts within the first groups.
+    keys : np.ndarray
+        The sorted keys g1 * n2 + g2 of the group pairs that were in contact.
+    counts : np.ndarray
+        The number of frames in which the group pair of each key was in contact.
+    n_contacts : List[int]
+        The number of group pairs in contact in each frame.
+    shape : Tuple[int, int] | None
+        The number of first and second groups, determined with the first frame.
+    """
+
+    buffer_size = 1 << 22
+
+    def __init__(self,
+                 cutoff: Real,
+                 topology1: MoleculeTopology | int,
+                 topology2: MoleculeTopology | int | None = None
+                 ) -> None:
+        """
+        Initializes the ContactMapAccumulator without frames.
+
+        Parameters
+        ----------
+        cutoff : Real
+            The contact distance of two atoms.
+        topology1 : MoleculeTopology | int
+            The first groups or the size of consecutive groups of all atoms as in
+            Frame.compute_com_frame.
+        topology2 : MoleculeTopology | int | None, optional
+            The second groups or the size of consecutive groups of all atoms, by
+            default None (the contacts between different groups of topology1)
+
+        Raises
+        ------
+        AnalysisError
+            If the cutoff is not positive.
+        """
+        if cutoff <= 0.0:
+            raise AnalysisError("The cutoff of the contact map has to be positive.")
+
+        self.cutoff = cutoff
+        self.topology1 = topology1
+        self.topology2 = topology2
+
+        self.keys = np.zeros(0, dtype=np.int64)
+        self.counts = np.zeros(0, dtype=np.int64)
+        self.n_contacts = []
+        self.shape = None
+
+        self._buffer = []
+        self._buffered = 0
+
+    def _resolve(self, frame: Frame) -> None:
+        """
+        Builds the topologies of fixed-size groups with the first frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The first frame.
+        """
+        if isinstance(self.topology1, int):
+            self.topology1 = MoleculeTopology.from_groups(frame.n_atoms, self.topology1)
+
+        if isinstance(self.topology2, int):
+            self.topology2 = MoleculeTopology.from_groups(frame.n_atoms, self.topology2)
+
+        second = self.topology1 if self.topology2 is None else self.topology2
+        self.shape = (self.topology1.n_molecules, second.n_molecules)
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the contacts of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+        """
+        if self.shape is None:
+            self._resolve(frame)
+
+        box_matrix = frame.cell.box_matrix if frame.PBC else None
+
+        contacts = group_contacts(frame.pos, self.cutoff, self.topology1, self.topology2, box_matrix)
+
+        self._buffer.append((contacts[:, 0] * self.shape[1] + contacts[:, 1],
+                             np.ones(len(contacts), dtype=np.int64)))
+        self._buffered += len(contacts)
+        self.n_contacts.append(len(contacts))
+
+        if self._buffered > self.buffer_size:
+            self._compact()
+
+    def _compact(self) -> None:
+        """
+        Reduces the buffered keys and counts into the sorted keys and counts.
+        """
+        if len(self._buffer) == 0:
+            return
+
+        keys = np.concatenate([self.keys] + [keys for keys, _ in self._buffer])
+        counts = np.concatenate([self.counts] + [counts for _, counts in self._buffer])
+
+        self.keys, inverse = np.unique(keys, return_inverse=True)
+        self.counts = np.bincount(inverse, weights=counts, minlength=len(self.keys)).astype(np.int64)
+
+        self._buffer = []
+        self._buffered = 0
+
+    def merge(self, other: ContactMapAccumulator) -> ContactMapAccumulator:
+        """
+        Adds the contacts of another frame range to this accumulator.
+
+        Parameters
+        ----------
+        other : ContactMapAccumulator
+            The accumulator of the other frames.
+
+        Returns
+        -------
+        ContactMapAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        AnalysisError
+            If the accumulators have a different number of groups.
+        """
+        if other.shape is None:
+            return self
+
+        if self.shape is None:
+            self.topology1 = other.topology1
+            self.topology2 = other.topology2
+            self.shape = other.shape
+        elif self.shape != other.shape:
+            raise AnalysisError(
+                f"A contact map of shape {other.shape} cannot be merged into a contact map of shape {self.shape}.")
+
+        other._compact()
+
+        self._buffer.append((other.keys, other.counts))
+        self._compact()
+
+        self.n_contacts.extend(other.n_contacts)
+
+        return self
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return len(self.n_contacts)
+
+    def contacts(self) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+        """
+        Returns the group pairs that were in contact and their contact frequency.
+
+        Returns
+        -------
+        pairs : Np2DIntArray
+            The group pairs (g1, g2) of shape (n_pairs, 2), sorted by g1 and g2.
+        frequencies : Np1DNumberArray
+            The fraction of the frames in which each pair was in contact.
+
+        Raises
+        ------
+        AnalysisError
+            If no frame was added.
+        """
+        if self.n_frames == 0:
+            raise AnalysisError("No frames were added to the accumulator.")
+
+        self._compact()
+
+        pairs = np.column_stack((self.keys // self.shape[1], self.keys % self.shape[1]))
+
+        return pairs, self.counts / self.n_frames
+
+    def dense(self) -> Np2DNumberArray:
+        """
+        Returns the contact frequencies as dense matrix.
+
+        The matrix needs 8 bytes per group pair, i.e. 800 MB for 10k x 10k groups, so
+        that contacts should be preferred for large systems. Without second groups the
+        matrix is symmetric.
+
+        Returns
+        -------
+        Np2DNumberArray
+            The contact frequency of each group pair of shape (n_groups1, n_groups2).
+        """
+        pairs, frequencies = self.contacts()
+
+        matrix = np.zeros(self.shape)
+        matrix[pairs[:, 0], pairs[:, 1]] = frequencies
+
+        if self.topology2 is None:
+            matrix[pairs[:, 1], pairs[:, 0]] = frequencies
+
+        return matrix
+
+
+def contact_maps(reader: TrajectoryReader,
+                 cutoff: Real,
+                 topology1: MoleculeTopology | int,
+                 topology2: MoleculeTopology | int | None = None,
+                 md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                 n_workers: int | None = None
+                 ) -> ContactMapAccumulator:
+    """
+    Computes the contact map of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    ContactMapAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    cutoff : Real
+        The contact distance of two atoms.
+    topology1 : MoleculeTopology | int
+        The first groups or the size of consecutive groups of all atoms.
+    topology2 : MoleculeTopology | int | None, optional
+        The second groups or the size of consecutive groups of all atoms, by default None
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    ContactMapAccumulator
+        The contacts of all frames.
+    """
+    factory = functools.partial(ContactMapAccumulator, cutoff, topology1, topology2)
+
+    return map_reduce(reader, factory, ContactMapAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
@@ -0,0 +1,605 @@
+"""
+A module containing classes for analyses over an ensemble of independent runs.
+
+...
+
+Classes
+-------
+RunDirectory
+    A class collecting the output files of one simulation run.
+EnsembleAnalysis
+    A class running an analysis on many independent runs in parallel.
+EnsembleResult
+    A class storing the per-run results of an EnsembleAnalysis.
+"""
+
+from __future__ import annotations
+
+import copy
+import glob
+import os
+import numbers
+import time
+import traceback
+
+import numpy as np
+
+from beartype.typing import Any, Callable, Dict, List, Sequence
+from numbers import Real
+
+from . import AnalysisError, merge_partials
+from ..io import TrajectoryReader, EnergyFileReader, RestartFileReader
+from ..physicalData import Energy
+from ..traj import Frame, MDEngineFormat
+from ..utils import process_pool
+
+
+class RunDirectory:
+    """
+    A class collecting the output files of one simulation run.
+
+    If the files are not given explicitly, they are found in the directory by their
+    extensions: '*.xyz' for the trajectory, '*.en' for the energy, '*.info' for the
+    info files and '*.rst' for the restart file. Files of the same kind are sorted
+    by name, so that e.g. md-01.xyz, md-02.xyz, ... form one continuous trajectory.
+
+    ...
+
+    Attributes
+    ----------
+    path : str
+        The directory of the run.
+    trajectory : List[str]
+        The trajectory files of the run.
+    energy : List[str]
+        The energy files of the run.
+    info : List[str]
+        The info files of the run.
+    restart : str | None
+        The last restart file of the run.
+    """
+
+    def __init__(self,
+                 path: str,
+                 trajectory: str | List[str] | None = None,
+                 energy: str | List[str] | None = None,
+                 info: str | List[str] | None = None,
+                 restart: str | None = None
+                 ) -> None:
+        """
+        Initializes the RunDirectory and finds the files which are not given.
+
+        Parameters
+        ----------
+        path : str
+            The directory of the run.
+        trajectory : str | List[str] | None, optional
+            The trajectory file(s), by default None (all '*.xyz' files of the directory)
+        energy : str | List[str] | None, optional
+            The energy file(s), by default None (all '*.en' files of the directory)
+        info : str | List[str] | None, optional
+            The info file(s), by default None (all '*.info' files of the directory)
+        restart : str | None, optional
+            The restart file, by default None (the last '*.rst' file of the directory)
+
+        Raises
+        ------
+        AnalysisError
+            If the directory does not exist.
+        """
+        if not os.path.isdir(path):
+            raise AnalysisError(f"The run directory {path} does not exist.")
+
+        self.path = path
+        self.trajectory = self._find(trajectory, "xyz")
+        self.energy = self._find(energy, "en")
+        self.info = self._find(info, "info")
+
+        if restart is None:
+            restarts = self._find(None, "rst")
+            restart = restarts[-1] if len(restarts) > 0 else None
+
+        self.restart = restart
+
+    def _find(self, files: str | List[str] | None, extension: str) -> List[str]:
+        """
+        Returns the given files or all files of the directory with the given extension.
+
+        Parameters
+        ----------
+        files : str | List[str] | None
+            The explicitly given file(s).
+        extension : str
+            The extension of the files to find.
+
+        Returns
+        -------
+        List[str]
+            The files.
+        """
+        if files is None:
+            return sorted(glob.glob(os.path.join(self.path, f"*.{extension}")))
+
+        return [files] if isinstance(files, str) else list(files)
+
+    @property
+    def name(self) -> str:
+        """
+        str: The name of the run directory.
+        """
+        return os.path.basename(os.path.normpath(self.path))
+
+    @property
+    def size(self) -> int:
+        """
+        int: The total size of the files of the run in bytes, used as the cost of the run.
+        """
+        files = self.trajectory + self.energy + self.info
+        if self.restart is not None:
+            files.append(self.restart)
+
+        return sum(os.path.getsize(file) for file in files if os.path.isfile(file))
+
+    def trajectory_reader(self, **kwargs) -> TrajectoryReader:
+        """
+        Returns a TrajectoryReader for the trajectory files of the run.
+
+        Parameters
+        ----------
+        **kwargs
+            Passed to TrajectoryReader.
+
+        Returns
+        -------
+        TrajectoryReader
+            The reader of the trajectory.
+
+        Raises
+        ------
+        AnalysisError
+            If the run has no trajectory file.
+        """
+        if len(self.trajectory) == 0:
+            raise AnalysisError(f"The run {self.path} has no trajectory file.")
+
+        filename = self.trajectory[0] if len(self.trajectory) == 1 else self.trajectory
+
+        return TrajectoryReader(filename, **kwargs)
+
+    def read_energy(self, format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF) -> Energy:
+        """
+        Reads the energy files of the run and concatenates their rows.
+
+        The info file of the first energy file is used for all energy files.
+
+        Parameters
+        ----------
+        format : MDEngineFormat | str, optional
+            The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+
+        Returns
+        -------
+        Energy
+            The energy data of the run.
+
+        Raises
+        ------
+        AnalysisError
+            If the run has no energy file.
+        """
+        if len(self.energy) == 0:
+            raise AnalysisError(f"The run {self.path} has no energy file.")
+
+        info_filename = self.info[0] if len(self.info) == 1 else None
+
+        energies = [EnergyFileReader(filename, info_filename=info_filename, format=format).read()
+                    for filename in self.energy]
+
+        if len(energies) == 1:
+            return energies[0]
+
+        data = np.concatenate([energy.data for energy in energies], axis=1)
+
+        return Energy(data, energies[0].info if energies[0].info_given else None,
+                      energies[0].units if energies[0].units_given else None)
+
+    def read_restart(self, format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF) -> Frame:
+        """
+        Reads the restart file of the run.
+
+        Parameters
+        ----------
+        format : MDEngineFormat | str, optional
+            The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+
+        Returns
+        -------
+        Frame
+            The frame of the restart file.
+
+        Raises
+        ------
+        AnalysisError
+            If the run has no restart file.
+        """
+        if self.restart is None:
+            raise AnalysisError(f"The run {self.path} has no restart file.")
+
+        return RestartFileReader(self.restart, format=format).read()
+
+    def __repr__(self) -> str:
+        return f"RunDirectory({self.path!r})"
+
+
+class EnsembleAnalysis:
+    """
+    A class running an analysis on many independent runs in parallel.
+
+    Each run is analysed by one job of a process pool. The jobs are submitted in
+    descending order of the size of the run files (longest processing time first),
+    so that the largest runs do not end up as stragglers at the end of the job.
+    An exception raised by the analysis of a run is recorded in the EnsembleResult
+    instead of aborting the analysis of the other runs.
+
+    ...
+
+    Attributes
+    ----------
+    runs : List[RunDirectory]
+        The runs of the ensemble.
+    analysis : Callable[[RunDirectory], Any]
+        The analysis of a single run.
+    weights : np.ndarray
+        The weight of each run.
+    n_workers : int
+        The number of worker processes.
+    """
+
+    def __init__(self,
+                 runs: Sequence[str | RunDirectory],
+                 analysis: Callable[[RunDirectory], Any],
+                 weights: Sequence[Real] | np.ndarray | None = None,
+                 n_workers: int | None = None
+                 ) -> None:
+        """
+        Initializes the EnsembleAnalysis with the given runs.
+
+        With n_workers > 1 the analysis is sent to the worker processes and therefore
+        has to be picklable (e.g. a module level function).
+
+        Parameters
+        ----------
+        runs : Sequence[str | RunDirectory]
+            The run directories.
+        analysis : Callable[[RunDirectory], Any]
+            The analysis of a single run, returning a number, a NumPy array or a mergeable
+            accumulator (see merge_partials).
+        weights : Sequence[Real] | np.ndarray | None, optional
+            The weight of each run, by default None (all runs are weighted equally)
+        n_workers : int | None, optional
+            The number of worker processes, by default None (the number of CPUs)
+
+        Raises
+        ------
+        AnalysisError
+            If no run is given or the number of weights does not match the number of runs.
+        """
+        if len(runs) == 0:
+            raise AnalysisError("An ensemble needs at least one run.")
+
+        self.runs = [run if isinstance(run, RunDirectory) else RunDirectory(run)
+                     for run in runs]
+
+        if weights is None:
+            weights = np.ones(len(self.runs))
+
+        weights = np.asarray(weights, dtype=np.float64)
+        if weights.shape != (len(self.runs),) or np.any(weights < 0.0):
+            raise AnalysisError(
+                f"{len(self.runs)} non-negative weights are needed, one for each run.")
+
+        self.analysis = analysis
+        self.weights = weights
+        self.n_workers = n_workers if n_workers is not None else os.cpu_count() or 1
+
+    def schedule(self) -> List[int]:
+        """
+        Returns the order in which the runs are submitted.
+
+        Returns
+        -------
+        List[int]
+            The indices of the runs in descending order of their size.
+        """
+        sizes = np.array([run.size for run in self.runs])
+
+        return [int(i) for i in np.argsort(-sizes, kind="stable")]
+
+    def run(self) -> EnsembleResult:
+        """
+        Runs the analysis on all runs.
+
+        Returns
+        -------
+        EnsembleResult
+            The per-run results, the failed runs and the weights.
+        """
+        n_runs = len(self.runs)
+        results = [None] * n_runs
+        errors = {}
+        elapsed = np.zeros(n_runs)
+
+        order = self.schedule()
+        n_workers = min(self.n_workers, n_runs)
+
+        if n_workers == 1:
+            for i in order:
+                results[i], errors[i], elapsed[i] = _run_analysis(self.analysis, self.runs[i])
+        else:
+            with process_pool(n_workers) as executor:
+                futures = {i: executor.submit(_run_analysis, self.analysis, self.runs[i])
+                           for i in order}
+
+                for i, future in futures.items():
+                    try:
+                        results[i], errors[i], elapsed[i] = future.result()
+                    except Exception as exception:
+                        # e.g. a crashed worker process or an unpicklable result
+                        errors[i] = f"{type(exception).__name__}: {exception}"
+
+        errors = {i: error for i, error in errors.items() if error is not None}
+
+        return EnsembleResult(self.runs, results, self.weights, errors, elapsed)
+
+
+class EnsembleResult:
+    """
+    A class storing the per-run results of an EnsembleAnalysis.
+
+    Failed runs are excluded from the merged result and from the ensemble statistics.
+
+    ...
+
+    Attributes
+    ----------
+    runs : List[RunDirectory]
+        The runs of the ensemble.
+    results : List[Any]
+        The result of each run, None for failed runs.
+    weights : np.ndarray
+        The weight of each run.
+    errors : Dict[int, str]
+        The error message (including the traceback) of each failed run.
+    elapsed : np.ndarray
+        The wall time of the analysis of each run in seconds.
+    """
+
+    def __init__(self,
+                 runs: List[RunDirectory],
+                 results: List[Any],
+                 weights: np.ndarray,
+                 errors: Dict[int, str],
+                 elapsed: np.ndarray
+                 ) -> None:
+        """
+        Initializes the EnsembleResult with the given parameters.
+
+        Parameters
+        ----------
+        runs : List[RunDirectory]
+            The runs of the ensemble.
+        results : List[Any]
+            The result of each run, None for failed runs.
+        weights : np.ndarray
+            The weight of each run.
+        errors : Dict[int, str]
+            The error message of each failed run.
+        elapsed : np.ndarray
+            The wall time of the analysis of each run in seconds.
+        """
+        self.runs = runs
+        self.results = results
+        self.weights = weights
+        self.errors = errors
+        self.elapsed = elapsed
+
+    @property
+    def succeeded(self) -> List[int]:
+        """
+        List[int]: The indices of the successfully analysed runs.
+        """
+        return [i for i in range(len(self.runs)) if i not in self.errors]
+
+    @property
+    def failed(self) -> List[RunDirectory]:
+        """
+        List[RunDirectory]: The runs whose analysis failed.
+        """
+        return [self.runs[i] for i in sorted(self.errors)]
+
+    def merged(self) -> Any:
+        """
+        Returns the weighted merge of the results of all successful runs.
+
+        Numerical results are averaged with the weights of the runs. Mergeable
+        accumulators are merged with merge_partials, which is only possible for
+        equal weights.
+
+        Returns
+        -------
+        Any
+            The merged result.
+
+        Raises
+        ------
+        AnalysisError
+            If no run succeeded or accumulators with different weights are merged.
+        """
+        succeeded = self._check_succeeded()
+
+        if _is_numeric(self.results[succeeded[0]]):
+            return self._mean(succeeded)
+
+        if not np.allclose(self.weights[succeeded], self.weights[succeeded[0]]):
+            raise AnalysisError("Accumulators can only be merged with equal run weights.")
+
+        return merge_partials([copy.deepcopy(self.results[i]) for i in succeeded])
+
+    def mean(self) -> Real | np.ndarray:
+        """
+        Returns the weighted mean of the numerical results of the successful runs.
+
+        Returns
+        -------
+        Real | np.ndarray
+            The weighted ensemble mean.
+        """
+        return self._mean(self._check_succeeded(numeric=True))
+
+    def std(self) -> Real | np.ndarray:
+        """
+        Returns the weighted standard deviation of the numerical results between the runs.
+
+        The unbiased estimator for reliability weights is used, which reduces to the
+        sample standard deviation for equal weights.
+
+        Returns
+        -------
+        Real | np.ndarray
+            The weighted standard deviation between the runs.
+
+        Raises
+        ------
+        AnalysisError
+            If less than two runs succeeded.
+        """
+        succeeded = self._check_succeeded(numeric=True)
+
+        if len(succeeded) < 2:
+            raise AnalysisError("The standard deviation needs at least two successful runs.")
+
+        weights = self.weights[succeeded]
+        values = np.array([self.results[i] for i in succeeded], dtype=np.float64)
+
+        v1, v2 = np.sum(weights), np.sum(weights**2)
+        deviations = values - self._mean(succeeded)
+
+        return np.sqrt(np.tensordot(weights, deviations**2, axes=1) / (v1 - v2 / v1))
+
+    def sem(self) -> Real | np.ndarray:
+        """
+        Returns the standard error of the weighted ensemble mean.
+
+        The runs are independent, so that the error is the standard deviation between
+        the runs divided by the square root of the effective number of runs.
+
+        Returns
+        -------
+        Real | np.ndarray
+            The standard error of the weighted mean.
+        """
+        weights = self.weights[self.succeeded]
+
+        return self.std() * np.sqrt(np.sum(weights**2)) / np.sum(weights)
+
+    def summary(self) -> str:
+        """
+        Returns a table of the per-run status and the ensemble statistics.
+
+        Scalar results are listed for each run and summarized by their mean and
+        standard error.
+
+        Returns
+        -------
+        str
+            The summary.
+        """
+        lines = [f"{'run':<24} {'size/MB':>10} {'weight':>8} {'time/s':>8}  result"]
+
+        for i, run in enumerate(self.runs):
+            if i in self.errors:
+                result = "FAILED: " + self.errors[i].strip().splitlines()[-1]
+            elif _is_scalar(self.results[i]):
+                result = f"{float(self.results[i]):.8g}"
+            else:
+                result = "ok"
+
+            lines.append(
+                f"{run.name:<24} {run.size / 1e6:>10.3f} {self.weights[i]:>8.3g} {self.elapsed[i]:>8.2f}  {result}")
+
+        succeeded = self.succeeded
+        lines.append(f"{len(succeeded)} of {len(self.runs)} runs succeeded")
+
+        if len(succeeded) > 1 and all(_is_scalar(self.results[i]) for i in succeeded):
+            lines.append(f"ensemble mean: {float(self.mean()):.8g} +- {float(self.sem()):.8g}")
+
+        return "\n".join(lines)
+
+    def _check_succeeded(self, numeric: bool = False) -> List[int]:
+        """
+        Returns the indices of the successful runs and checks the results.
+
+        Parameters
+        ----------
+        numeric : bool, optional
+            Whether the results have to be numerical, by default False
+
+        Returns
+        -------
+        List[int]
+            The indices of the successful runs.
+
+        Raises
+        ------
+        AnalysisError
+            If no run succeeded or the results are not numerical.
+        """
+        succeeded = self.succeeded
+
+        if len(succeeded) == 0:
+            raise AnalysisError("The analysis of all runs failed.")
+
+        if numeric and not all(_is_numeric(self.results[i]) for i in succeeded):
+            raise AnalysisError("Ensemble statistics are only available for numerical results.")
+
+        return succeeded
+
+    def _mean(self, succeeded: List[int]) -> Real | np.ndarray:
+        weights = self.weights[succeeded]
+        values = np.array([self.results[i] for i in succeeded], dtype=np.float64)
+
+        return np.tensordot(weights, values, axes=1) / np.sum(weights)
+
+
+def _run_analysis(analysis: Callable[[RunDirectory], Any], run: RunDirectory) -> tuple:
+    """
+    Runs the analysis of a single run and catches its exceptions (executed by the worker processes).
+
+    Parameters
+    ----------
+    analysis : Callable[[RunDirectory], Any]
+        The analysis of a single run.
+    run : RunDirectory
+        The run to analyse.
+
+    Returns
+    -------
+    tuple
+        The result (None if failed), the error message (None if succeeded) and the wall time.
+    """
+    start = time.perf_counter()
+
+    try:
+        result = analysis(run)
+    except Exception:
+        return None, traceback.format_exc(), time.perf_counter() - start
+
+    return result, None, time.perf_counter() - start
+
+
+def _is_numeric(result: Any) -> bool:
+    return isinstance(result, (np.ndarray, numbers.Number))
+
+
+def _is_scalar(result: Any) -> bool:
+    return isinstance(result, numbers.Number) or (isinstance(result, np.ndarray) and result.size == 1)
@@ -0,0 +1,22 @@
+"""
+A module containing different exceptions related to the analysis subpackage.
+
+...
+
+Classes
+-------
+AnalysisError
+    Exception raised for errors related to the analysis subpackage
+"""
+
+from ..exceptions import PQException
+
+
+class AnalysisError(PQException):
+    """
+    Exception raised for errors related to the analysis subpackage
+    """
+
+    def __init__(self, message):
+        self.message = message
+        super().__init__(self.message)
@@ -0,0 +1,226 @@
+"""
+A module containing the single-node map/reduce driver for streaming trajectory analyses.
+
+...
+
+Functions
+---------
+map_reduce
+    Runs a streaming analysis on frame ranges of a trajectory and merges the partial results.
+frame_ranges
+    Splits a number of frames into contiguous frame ranges.
+merge_partials
+    Merges the partial results of an analysis.
+"""
+
+import functools
+import os
+import numbers
+import operator
+
+import numpy as np
+
+from beartype.typing import Any, Callable, List
+
+from . import AnalysisError
+from ..io import TrajectoryReader
+from ..traj import MDEngineFormat, Frame
+from ..utils import process_pool
+
+
+def map_reduce(reader: TrajectoryReader,
+               accumulator_factory: Callable[[], Any],
+               update: Callable[[Any, Frame], Any],
+               md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+               n_workers: int | None = None,
+               n_chunks: int | None = None,
+               n_buffers: int = 1
+               ) -> Any:
+    """
+    Runs a streaming analysis on frame ranges of a trajectory and merges the partial results.
+
+    The analysis is given by an accumulator_factory creating an empty partial result
+    and an update function adding one frame to it (the same protocol as
+    BlockResampling.from_frames). The frames are split into n_chunks contiguous ranges
+    using the TrajectoryIndex of each file. Every worker process streams the frames of
+    its ranges with reused frame buffers, so that the memory does not grow with the
+    length of the trajectory. The partial results are finally merged with merge_partials
+    in the order of the frame ranges.
+
+    With n_workers=1 the frames are streamed sequentially in the calling process without
+    building an index.
+
+    Partial results other than numbers and NumPy arrays follow the merge protocol:
+    merge(other) adds the partial result of the directly following frame range to the
+    partial result in place and returns it. Order dependent results like time series
+    are appended, so that the merged result does not depend on how the frames were
+    split. All accumulators of the analyses in PQAnalysis.analysis follow this protocol.
+
+    Examples
+    --------
+    >>> def count(histogram, frame):
+    ...     return histogram + np.histogram(frame.pos[:, 2], bins=50, range=(0, 20))[0]
+    >>> histogram = map_reduce(TrajectoryReader("md-01.xyz"), lambda: np.zeros(50), count)
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    accumulator_factory : Callable[[], Any]
+        Creates an empty partial result.
+    update : Callable[[Any, Frame], Any]
+        Called with (accumulator, frame) for each frame. If it returns a value other than
+        None, the value replaces the accumulator (e.g. for NumPy arrays: acc + frame_counts).
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+    n_chunks : int | None, optional
+        The number of frame ranges, by default None (one range per worker)
+    n_buffers : int, optional
+        The number of reused frame buffers of each worker (see TrajectoryReader.iter_frames),
+        by default 1. Use 0 if the update function stores references to the frames.
+
+    Returns
+    -------
+    Any
+        The merged partial result of all frames.
+
+    Note
+    ----
+    With n_workers > 1 the accumulator_factory and the update function are sent to the
+    worker processes and therefore have to be picklable (e.g. module level functions).
+    """
+    if n_workers is None:
+        n_workers = os.cpu_count() or 1
+
+    if n_workers == 1 and n_chunks is None:
+        return _map_frame_range(reader, None, accumulator_factory, update, md_format, n_buffers)
+
+    n_frames = sum(index.n_frames for index in reader.indices())
+    ranges = frame_ranges(n_frames, n_chunks if n_chunks is not None else n_workers)
+
+    if n_workers == 1 or len(ranges) == 1:
+        partials = [_map_frame_range(reader, frames, accumulator_factory, update, md_format, n_buffers)
+                    for frames in ranges]
+    else:
+        with process_pool(min(n_workers, len(ranges))) as executor:
+            partials = list(executor.map(_map_frame_range,
+                                         [reader] * len(ranges),
+                                         ranges,
+                                         [accumulator_factory] * len(ranges),
+                                         [update] * len(ranges),
+                                         [md_format] * len(ranges),
+                                         [n_buffers] * len(ranges)))
+
+    return merge_partials(partials)
+
+
+def frame_ranges(n_frames: int, n_chunks: int) -> List[slice]:
+    """
+    Splits a number of frames into contiguous frame ranges.
+
+    The lengths of the ranges differ by at most one frame. Empty ranges are omitted.
+
+    Parameters
+    ----------
+    n_frames : int
+        The number of frames.
+    n_chunks : int
+        The number of ranges.
+
+    Returns
+    -------
+    List[slice]
+        The frame ranges in ascending order.
+
+    Raises
+    ------
+    AnalysisError
+        If n_chunks is smaller than 1.
+    """
+    if n_chunks < 1:
+        raise AnalysisError("The number of frame ranges has to be at least 1.")
+
+    bounds = np.arange(n_chunks + 1) * n_frames // n_chunks
+
+    ranges = [slice(int(start), int(stop))
+              for start, stop in zip(bounds[:-1], bounds[1:]) if stop > start]
+
+    return ranges if len(ranges) > 0 else [slice(0, 0)]
+
+
+def merge_partials(partials: List[Any]) -> Any:
+    """
+    Merges the partial results of an analysis.
+
+    Numbers and NumPy arrays are summed. All other partial results have to follow the
+    merge protocol of map_reduce; they are merged into the first partial result in the
+    order of the list.
+
+    Parameters
+    ----------
+    partials : List[Any]
+        The partial results.
+
+    Returns
+    -------
+    Any
+        The merged result.
+
+    Raises
+    ------
+    AnalysisError
+        If no partial result is given.
+    """
+    if len(partials) == 0:
+        raise AnalysisError("There are no partial results to merge.")
+
+    if isinstance(partials[0], (np.ndarray, numbers.Number)):
+        return functools.reduce(operator.add, partials)
+
+    merged = partials[0]
+    for partial in partials[1:]:
+        merged.merge(partial)
+
+    return merged
+
+
+def _map_frame_range(reader: TrajectoryReader,
+                     frames: slice | None,
+                     accumulator_factory: Callable[[], Any],
+                     update: Callable[[Any, Frame], Any],
+                     md_format: MDEngineFormat | str,
+                     n_buffers: int
+                     ) -> Any:
+    """
+    Runs the analysis on one frame range (executed by the worker processes).
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    frames : slice | None
+        The frame range, None for all frames.
+    accumulator_factory : Callable[[], Any]
+        Creates an empty partial result.
+    update : Callable[[Any, Frame], Any]
+        Adds one frame to the partial result.
+    md_format : MDEngineFormat | str
+        The format of the md engine.
+    n_buffers : int
+        The number of reused frame buffers.
+
+    Returns
+    -------
+    Any
+        The partial result of the frame range.
+    """
+    accumulator = accumulator_factory()
+
+    for frame in reader.iter_frames(md_format, n_buffers=n_buffers, frames=frames):
+        result = update(accumulator, frame)
+        if result is not None:
+            accumulator = result
+
+    return accumulator
@@ -0,0 +1,325 @@
+"""
+A module containing the per-frame minimum distance between selections of atoms.
+
+...
+
+Classes
+-------
+MinimumDistanceAccumulator
+    A class collecting the minimum distances and closest atom pairs of all frames.
+
+Functions
+---------
+make_whole
+    Returns the positions of a group of atoms made whole across the periodic boundaries.
+minimum_distances
+    Computes the minimum distances of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import List, Tuple
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import minimum_distance, minimum_image, self_image_distance
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def make_whole(pos: Np2DNumberArray, box_matrix: Np3x3NumberArray) -> Np2DNumberArray:
+    """
+    Returns the positions of a group of atoms made whole across the periodic boundaries.
+
+    Each position is imaged to its predecessor, so that a molecule stored in bonded
+    order (e.g. a solute or a polymer) stays whole even if it is larger than half of
+    the box. The first position is not moved.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3).
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+
+    Returns
+    -------
+    Np2DNumberArray
+        The whole positions of shape (n, 3).
+    """
+    pos = np.asarray(pos, dtype=np.float64).reshape(-1, 3)
+
+    if len(pos) < 2:
+        return pos.copy()
+
+    steps = minimum_image(np.diff(pos, axis=0), box_matrix)
+
+    return np.concatenate([pos[:1], pos[0] + np.cumsum(steps, axis=0)])
+
+
+class MinimumDistanceAccumulator:
+    """
+    A class collecting the minimum distances and closest atom pairs of all frames.
+
+    For each frame the closest pair between the two selections (or within the first
+    selection if atoms2 is None) is searched with kernels.minimum_distance and
+    optionally the closest distance of the first selection to its own periodic images
+    with kernels.self_image_distance, e.g. to check that a solute never sees its image.
+    Only the distance and the atom pair are stored per frame, so that long trajectories
+    are processed at the speed of reading the frames. The accumulator follows the merge
+    protocol of map_reduce, where merge appends the frames of a later frame range.
+
+    ...
+
+    Attributes
+    ----------
+    atoms1 : List[str] | Np1DIntArray | None
+        The first selection.
+    atoms2 : List[str] | Np1DIntArray | None
+        The second selection, None for the closest pair within the first selection.
+    self_image : bool
+        Whether the distance of the first selection to its periodic images is computed.
+    whole : bool
+        Whether the first selection is already whole, otherwise it is made whole with make_whole.
+    distances : List[float]
+        The minimum distance of each frame.
+    pairs : List[Np1DIntArray]
+        The atom indices of the closest pair of each frame.
+    image_distances : List[float]
+        The self image distance of each frame.
+    image_pairs : List[Np1DIntArray]
+        The atom indices of the closest pair to the periodic image of each frame.
+    images : List[Np1DIntArray]
+        The lattice translation of the second atom of each image pair.
+    indices1 : Np1DIntArray | None
+        The indices of the first selection, determined with the first frame.
+    indices2 : Np1DIntArray | None
+        The indices of the second selection, determined with the first frame.
+    """
+
+    def __init__(self,
+                 atoms1: List[str] | Np1DIntArray | None = None,
+                 atoms2: List[str] | Np1DIntArray | None = None,
+                 self_image: bool = False,
+                 whole: bool = False
+                 ) -> None:
+        """
+        Initializes the MinimumDistanceAccumulator without frames.
+
+        Parameters
+        ----------
+        atoms1 : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the first selection, by default None (all atoms)
+        atoms2 : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the second selection, by default None
+            (the closest pair within the first selection)
+        self_image : bool, optional
+            Whether the distance of the first selection to its periodic images is computed,
+            by default False
+        whole : bool, optional
+            Whether the first selection is already whole, by default False
+        """
+        self.atoms1 = atoms1
+        self.atoms2 = atoms2
+        self.self_image = self_image
+        self.whole = whole
+
+        self.distances = []
+        self.pairs = []
+
+        self.image_distances = []
+        self.image_pairs = []
+        self.images = []
+
+        self.indices1 = None
+        self.indices2 = None
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the minimum distances of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+
+        Raises
+        ------
+        AnalysisError
+            If the self image distance is requested for a frame without periodic boundary conditions.
+        """
+        if self.indices1 is None:
+            self.indices1 = np.asarray(frame.system.indices_from_atoms(self.atoms1))
+
+            if self.atoms2 is not None:
+                self.indices2 = np.asarray(frame.system.indices_from_atoms(self.atoms2))
+
+        box_matrix = frame.cell.box_matrix if frame.PBC else None
+
+        pos1 = frame.pos[self.indices1]
+
+        if self.indices2 is None:
+            pair, distance = minimum_distance(pos1, None, box_matrix)
+            self.pairs.append(self.indices1[pair])
+        else:
+            pair, distance = minimum_distance(pos1, frame.pos[self.indices2], box_matrix)
+            self.pairs.append(np.array([self.indices1[pair[0]], self.indices2[pair[1]]]))
+
+        self.distances.append(distance)
+
+        if not self.self_image:
+            return
+
+        if box_matrix is None:
+            raise AnalysisError(
+                "The self image distance needs periodic boundary conditions.")
+
+        if not self.whole:
+            pos1 = make_whole(pos1, box_matrix)
+
+        pair, image, distance = self_image_distance(pos1, box_matrix)
+
+        self.image_pairs.append(self.indices1[pair])
+        self.images.append(image)
+        self.image_distances.append(distance)
+
+    def merge(self, other: MinimumDistanceAccumulator) -> MinimumDistanceAccumulator:
+        """
+        Appends the minimum distances of a later frame range.
+
+        Parameters
+        ----------
+        other : MinimumDistanceAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        MinimumDistanceAccumulator
+            This accumulator.
+        """
+        self.distances.extend(other.distances)
+        self.pairs.extend(other.pairs)
+
+        self.image_distances.extend(other.image_distances)
+        self.image_pairs.extend(other.image_pairs)
+        self.images.extend(other.images)
+
+        if self.indices1 is None:
+            self.indices1 = other.indices1
+            self.indices2 = other.indices2
+
+        return self
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return len(self.distances)
+
+    def time_series(self, self_image: bool = False) -> Tuple[Np1DNumberArray, Np2DIntArray]:
+        """
+        Returns the minimum distance and the closest atom pair of each frame.
+
+        Parameters
+        ----------
+        self_image : bool, optional
+            Whether the self image distances are returned, by default False
+
+        Returns
+        -------
+        distances : Np1DNumberArray
+            The minimum distance of each frame.
+        pairs : Np2DIntArray
+            The atom indices of the closest pair of each frame of shape (n_frames, 2).
+
+        Raises
+        ------
+        AnalysisError
+            If the self image distances were not computed.
+        """
+        if self_image and not self.self_image:
+            raise AnalysisError("The self image distances were not computed, use self_image=True.")
+
+        distances = self.image_distances if self_image else self.distances
+        pairs = self.image_pairs if self_image else self.pairs
+
+        return np.array(distances, dtype=np.float64), np.array(pairs, dtype=np.int64).reshape(-1, 2)
+
+    def closest_frame(self, self_image: bool = False) -> Tuple[int, Np1DIntArray, float]:
+        """
+        Returns the frame of the overall minimum distance.
+
+        Parameters
+        ----------
+        self_image : bool, optional
+            Whether the minimum of the self image distances is returned, by default False
+
+        Returns
+        -------
+        frame : int
+            The index of the frame.
+        pair : Np1DIntArray
+            The atom indices of the closest pair.
+        distance : float
+            The minimum distance.
+
+        Raises
+        ------
+        AnalysisError
+            If no frame was added.
+        """
+        if self.n_frames == 0:
+            raise AnalysisError("No frames were added to the accumulator.")
+
+        distances, pairs = self.time_series(self_image)
+        frame = int(np.argmin(distances))
+
+        return frame, pairs[frame], float(distances[frame])
+
+
+def minimum_distances(reader: TrajectoryReader,
+                      atoms1: List[str] | Np1DIntArray | None = None,
+                      atoms2: List[str] | Np1DIntArray | None = None,
+                      self_image: bool = False,
+                      whole: bool = False,
+                      md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                      n_workers: int | None = None
+                      ) -> MinimumDistanceAccumulator:
+    """
+    Computes the minimum distances of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    MinimumDistanceAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    atoms1 : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the first selection, by default None (all atoms)
+    atoms2 : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the second selection, by default None
+    self_image : bool, optional
+        Whether the distance of the first selection to its periodic images is computed,
+        by default False
+    whole : bool, optional
+        Whether the first selection is already whole, by default False
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    MinimumDistanceAccumulator
+        The minimum distances of all frames.
+    """
+    factory = functools.partial(MinimumDistanceAccumulator, atoms1, atoms2, self_image, whole)
+
+    return map_reduce(reader, factory, MinimumDistanceAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
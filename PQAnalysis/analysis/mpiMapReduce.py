@@ -0,0 +1,130 @@
+"""
+A module containing the MPI-distributed map/reduce driver for streaming trajectory analyses.
+
+The driver needs the optional dependency mpi4py. The script using it is started
+with one process per rank, e.g. 'mpirun -n 4 python analysis.py'.
+
+...
+
+Functions
+---------
+mpi_map_reduce
+    Runs a streaming analysis on the frame ranges of all MPI ranks and merges the partial results.
+"""
+
+import numbers
+
+import numpy as np
+
+from beartype.typing import Any, Callable
+
+from . import AnalysisError, frame_ranges, merge_partials
+from .mapReduce import _map_frame_range
+from ..io import TrajectoryReader
+from ..traj import MDEngineFormat, Frame
+
+try:
+    from mpi4py import MPI
+except ImportError:
+    MPI = None
+
+
+def mpi_map_reduce(reader: TrajectoryReader,
+                   accumulator_factory: Callable[[], Any],
+                   update: Callable[[Any, Frame], Any],
+                   md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                   n_chunks: int | None = None,
+                   n_buffers: int = 1,
+                   comm: Any = None,
+                   root: int = 0,
+                   broadcast: bool = False
+                   ) -> Any:
+    """
+    Runs a streaming analysis on the frame ranges of all MPI ranks and merges the partial results.
+
+    This is the multi-node counterpart of map_reduce with the same analysis protocol
+    (accumulator_factory and update). It has to be called collectively by all ranks
+    of the communicator. The root rank builds (or loads) the persistent TrajectoryIndex
+    of each file, which the other ranks then load from the shared filesystem. The frames
+    are split into n_chunks contiguous ranges and every rank takes a contiguous block of
+    these ranges, so that the order of the ranks is the order of the frames. Every rank
+    streams its frames and the partial results are reduced to the root:
+
+    - NumPy arrays are summed with MPI_Reduce directly on their buffers,
+    - numbers are summed with the pickle based reduce,
+    - mergeable accumulators are gathered and merged with merge_partials in the order
+      of the ranks.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    accumulator_factory : Callable[[], Any]
+        Creates an empty partial result.
+    update : Callable[[Any, Frame], Any]
+        Called with (accumulator, frame) for each frame. If it returns a value other than
+        None, the value replaces the accumulator.
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_chunks : int | None, optional
+        The number of frame ranges, by default None (one range per rank)
+    n_buffers : int, optional
+        The number of reused frame buffers of each rank, by default 1
+    comm : Any, optional
+        The MPI communicator, by default None (MPI.COMM_WORLD)
+    root : int, optional
+        The rank receiving the merged result, by default 0
+    broadcast : bool, optional
+        Whether the merged result is broadcast to all ranks, by default False
+
+    Returns
+    -------
+    Any
+        The merged result of all frames on the root rank (and on all ranks if broadcast
+        is True), None on the other ranks.
+
+    Raises
+    ------
+    AnalysisError
+        If mpi4py is not installed.
+    """
+    if MPI is None:
+        raise AnalysisError(
+            "mpi_map_reduce needs mpi4py. Please install it or use map_reduce instead.")
+
+    if comm is None:
+        comm = MPI.COMM_WORLD
+
+    rank, size = comm.Get_rank(), comm.Get_size()
+
+    n_frames = None
+    if rank == root:
+        n_frames = sum(index.n_frames for index in reader.indices())
+
+    # the broadcast also ensures that the index files are written before they are loaded
+    n_frames = comm.bcast(n_frames, root=root)
+
+    ranges = frame_ranges(n_frames, n_chunks if n_chunks is not None else size)
+
+    first, last = rank * len(ranges) // size, (rank + 1) * len(ranges) // size
+
+    partials = [_map_frame_range(reader, frames, accumulator_factory, update, md_format, n_buffers)
+                for frames in ranges[first:last]]
+
+    # ranks without frame range still contribute an empty partial result
+    partial = merge_partials(partials) if len(partials) > 0 else accumulator_factory()
+
+    if isinstance(partial, np.ndarray):
+        partial = np.ascontiguousarray(partial)
+        result = np.empty_like(partial) if rank == root else None
+        comm.Reduce(partial, result, op=MPI.SUM, root=root)
+    elif isinstance(partial, numbers.Number):
+        result = comm.reduce(partial, op=MPI.SUM, root=root)
+    else:
+        gathered = comm.gather(partial, root=root)
+        result = merge_partials(gathered) if rank == root else None
+
+    if broadcast:
+        result = comm.bcast(result, root=root)
+
+    return result
@@ -0,0 +1,482 @@
+"""
+A module containing local orientational order parameters.
+
+...
+
+Classes
+-------
+OrderParameterAccumulator
+    A class accumulating the distributions and time series of local order parameters.
+
+Functions
+---------
+spherical_harmonics
+    Returns the spherical harmonics Y_lm with m = 0 ... l of the directions of vectors.
+tetrahedral_order
+    Returns the tetrahedral order parameter q of each position.
+steinhardt_order
+    Returns the Steinhardt bond orientational order parameter Q_l of each position.
+order_parameters
+    Computes the order parameters of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+import math
+
+import numpy as np
+
+from beartype.typing import List, Sequence
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import k_nearest_neighbours, minimum_image
+from ..statistics import Histogram
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def spherical_harmonics(l: int, vectors: np.ndarray) -> np.ndarray:
+    """
+    Returns the spherical harmonics Y_lm with m = 0 ... l of the directions of vectors.
+
+    The associated Legendre polynomials are evaluated with the standard three-term
+    recurrence for all vectors at once, and the azimuthal factor exp(i m phi) as power
+    of (x + i y) / sqrt(x^2 + y^2). The harmonics with negative m follow from
+    Y_l,-m = (-1)^m conj(Y_lm). The Condon-Shortley phase is included.
+
+    Parameters
+    ----------
+    l : int
+        The degree of the spherical harmonics.
+    vectors : np.ndarray
+        The (not necessarily normalized, but non-zero) vectors of shape (..., 3).
+
+    Returns
+    -------
+    np.ndarray
+        The complex spherical harmonics of shape (..., l + 1).
+
+    Raises
+    ------
+    AnalysisError
+        If l is negative.
+    """
+    if l < 0:
+        raise AnalysisError("The degree of the spherical harmonics has to be non-negative.")
+
+    vectors = np.asarray(vectors, dtype=np.float64)
+
+    r = np.linalg.norm(vectors, axis=-1)
+    rho = np.hypot(vectors[..., 0], vectors[..., 1])
+
+    cos_theta = vectors[..., 2] / r
+    sin_theta = rho / r
+
+    # the azimuth is arbitrary on the z axis, where all harmonics with m > 0 vanish
+    with np.errstate(divide="ignore", invalid="ignore"):
+        phase = np.where(rho > 0.0, (vectors[..., 0] + 1j * vectors[..., 1]) / rho, 1.0)
+
+    harmonics = np.empty(cos_theta.shape + (l + 1,), dtype=np.complex128)
+
+    p_mm = np.ones_like(cos_theta)
+
+    for m in range(l + 1):
+        if m > 0:
+            p_mm = -(2 * m - 1) * sin_theta * p_mm
+
+        p_previous, p_lm = p_mm, p_mm
+        if l > m:
+            p_lm = (2 * m + 1) * cos_theta * p_mm
+
+        for degree in range(m + 2, l + 1):
+            p_previous, p_lm = p_lm, ((2 * degree - 1) * cos_theta * p_lm -
+                                      (degree + m - 1) * p_previous) / (degree - m)
+
+        norm = math.sqrt((2 * l + 1) / (4.0 * math.pi) *
+                         math.factorial(l - m) / math.factorial(l + m))
+
+        harmonics[..., m] = norm * p_lm * phase**m
+
+    return harmonics
+
+
+def tetrahedral_order(pos: Np2DNumberArray,
+                      box_matrix: Np3x3NumberArray | None = None
+                      ) -> Np1DNumberArray:
+    """
+    Returns the tetrahedral order parameter q of each position.
+
+    q = 1 - 3/8 sum_{j<k} (cos psi_jk + 1/3)^2, where psi_jk is the angle between the
+    vectors to the neighbours j and k of the four nearest neighbours (Errington and
+    Debenedetti, Nature 409, 318 (2001)). It is 1 for a perfect tetrahedron and 0 on
+    average for random neighbours.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3), e.g. of the oxygen atoms of water.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    Np1DNumberArray
+        The tetrahedral order parameter of each position.
+    """
+    return _tetrahedral_order(_neighbour_vectors(pos, 4, box_matrix))
+
+
+def steinhardt_order(pos: Np2DNumberArray,
+                     l: int,
+                     box_matrix: Np3x3NumberArray | None = None,
+                     n_neighbours: int = 12
+                     ) -> Np1DNumberArray:
+    """
+    Returns the Steinhardt bond orientational order parameter Q_l of each position.
+
+    Q_l = sqrt(4 pi / (2l + 1) sum_m |q_lm|^2) with q_lm the average of Y_lm over the
+    vectors to the n_neighbours nearest neighbours (Steinhardt et al., Phys. Rev. B 28,
+    784 (1983)). The terms with m < 0 equal the terms with m > 0 for real vectors.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3).
+    l : int
+        The degree of the order parameter, e.g. 4 or 6.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+    n_neighbours : int, optional
+        The number of nearest neighbours, by default 12
+
+    Returns
+    -------
+    Np1DNumberArray
+        The order parameter Q_l of each position.
+    """
+    return _steinhardt_order(_neighbour_vectors(pos, n_neighbours, box_matrix), l)
+
+
+def _neighbour_vectors(pos: np.ndarray, k: int, box_matrix: np.ndarray | None) -> np.ndarray:
+    """
+    Returns the minimum image vectors to the k nearest neighbours sorted by distance.
+
+    Parameters
+    ----------
+    pos : np.ndarray
+        The positions of shape (n, 3).
+    k : int
+        The number of neighbours.
+    box_matrix : np.ndarray | None
+        The box matrix of the cell, None without periodic boundary conditions.
+
+    Returns
+    -------
+    np.ndarray
+        The vectors of shape (n, k, 3).
+    """
+    pos = np.asarray(pos, dtype=np.float64).reshape(-1, 3)
+
+    indices, _ = k_nearest_neighbours(pos, k, box_matrix)
+
+    vectors = (pos[indices] - pos[:, np.newaxis, :]).reshape(-1, 3)
+
+    if box_matrix is not None:
+        vectors = minimum_image(vectors, box_matrix)
+
+    return vectors.reshape(len(pos), k, 3)
+
+
+def _tetrahedral_order(vectors: np.ndarray) -> np.ndarray:
+    """
+    Returns the tetrahedral order parameter from the vectors to the four nearest neighbours.
+
+    Parameters
+    ----------
+    vectors : np.ndarray
+        The vectors of shape (n, >=4, 3) sorted by distance.
+
+    Returns
+    -------
+    np.ndarray
+        The tetrahedral order parameter of shape (n,).
+    """
+    units = vectors[:, :4] / np.linalg.norm(vectors[:, :4], axis=-1, keepdims=True)
+
+    first, second = np.triu_indices(4, k=1)
+    cosines = np.sum(units[:, first] * units[:, second], axis=-1)
+
+    return 1.0 - 3.0 / 8.0 * np.sum((cosines + 1.0 / 3.0)**2, axis=1)
+
+
+def _steinhardt_order(vectors: np.ndarray, l: int) -> np.ndarray:
+    """
+    Returns the Steinhardt order parameter Q_l from the vectors to the neighbours.
+
+    Parameters
+    ----------
+    vectors : np.ndarray
+        The vectors of shape (n, n_neighbours, 3).
+    l : int
+        The degree of the order parameter.
+
+    Returns
+    -------
+    np.ndarray
+        The order parameter Q_l of shape (n,).
+    """
+    q_lm = np.mean(spherical_harmonics(l, vectors), axis=1)
+
+    power = np.abs(q_lm)**2
+    power[:, 1:] *= 2.0
+
+    return np.sqrt(4.0 * np.pi / (2 * l + 1) * np.sum(power, axis=1))
+
+
+class OrderParameterAccumulator:
+    """
+    A class accumulating the distributions and time series of local order parameters.
+
+    For each frame the order parameters of the selected atoms (e.g. the oxygen atoms,
+    which represent the water molecules) are computed with their nearest neighbours
+    among the selected atoms. The nearest neighbours are searched once per frame for
+    all order parameters. The values of all frames are binned into one Histogram per
+    order parameter and the mean of each frame is stored as time series. Optionally,
+    the values of all atoms and frames are kept.
+
+    ...
+
+    Attributes
+    ----------
+    atoms : List[str] | Np1DIntArray | None
+        The selection of the atoms.
+    tetrahedral : bool
+        Whether the tetrahedral order parameter q is computed.
+    l_values : Tuple[int, ...]
+        The degrees of the Steinhardt order parameters Q_l.
+    n_neighbours : int
+        The number of neighbours of the Steinhardt order parameters.
+    histograms : Dict[str, Histogram]
+        The histograms of the order parameters 'q' and 'Q4', 'Q6', ...
+    means : Dict[str, List[float]]
+        The mean of each order parameter in each frame.
+    values : Dict[str, List[Np1DNumberArray]] | None
+        The values of each order parameter in each frame, None if they are not kept.
+    indices : Np1DIntArray | None
+        The indices of the selected atoms, determined with the first frame.
+    """
+
+    def __init__(self,
+                 atoms: List[str] | Np1DIntArray | None = None,
+                 tetrahedral: bool = True,
+                 l_values: Sequence[int] = (4, 6),
+                 n_neighbours: int = 12,
+                 n_bins: int = 100,
+                 keep_values: bool = False
+                 ) -> None:
+        """
+        Initializes the OrderParameterAccumulator with empty histograms.
+
+        Parameters
+        ----------
+        atoms : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the selected atoms, by default None (all atoms)
+        tetrahedral : bool, optional
+            Whether the tetrahedral order parameter q is computed, by default True
+        l_values : Sequence[int], optional
+            The degrees of the Steinhardt order parameters Q_l, by default (4, 6)
+        n_neighbours : int, optional
+            The number of neighbours of the Steinhardt order parameters, by default 12
+        n_bins : int, optional
+            The number of bins of the histograms, by default 100
+        keep_values : bool, optional
+            Whether the values of all atoms and frames are kept, by default False
+
+        Raises
+        ------
+        AnalysisError
+            If no order parameter is selected.
+        """
+        if not tetrahedral and len(l_values) == 0:
+            raise AnalysisError("At least one order parameter has to be computed.")
+
+        self.atoms = atoms
+        self.tetrahedral = tetrahedral
+        self.l_values = tuple(int(l) for l in l_values)
+        self.n_neighbours = n_neighbours
+
+        # q lies in [-3, 1] and Q_l in [0, 1]
+        self.histograms = {}
+        if tetrahedral:
+            self.histograms["q"] = Histogram((-3.0, 1.0), n_bins)
+        for l in self.l_values:
+            self.histograms[f"Q{l}"] = Histogram((0.0, 1.0), n_bins)
+
+        self.means = {name: [] for name in self.histograms}
+        self.values = {name: [] for name in self.histograms} if keep_values else None
+        self.indices = None
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the order parameters of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+        """
+        if self.indices is None:
+            self.indices = np.asarray(frame.system.indices_from_atoms(self.atoms))
+
+        box_matrix = frame.cell.box_matrix if frame.PBC else None
+
+        k = max(4 if self.tetrahedral else 0, self.n_neighbours if len(self.l_values) > 0 else 0)
+        vectors = _neighbour_vectors(frame.pos[self.indices], k, box_matrix)
+
+        results = {}
+        if self.tetrahedral:
+            results["q"] = _tetrahedral_order(vectors)
+        for l in self.l_values:
+            results[f"Q{l}"] = _steinhardt_order(vectors[:, :self.n_neighbours], l)
+
+        for name, values in results.items():
+            self.histograms[name].add(values)
+            self.means[name].append(float(np.mean(values)))
+
+            if self.values is not None:
+                self.values[name].append(values)
+
+    def merge(self, other: OrderParameterAccumulator) -> OrderParameterAccumulator:
+        """
+        Merges the results of a later frame range into this accumulator.
+
+        Parameters
+        ----------
+        other : OrderParameterAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        OrderParameterAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        AnalysisError
+            If the accumulators compute different order parameters.
+        """
+        if self.histograms.keys() != other.histograms.keys() or \
+                (self.values is None) != (other.values is None):
+            raise AnalysisError(
+                "Only accumulators of the same order parameters can be merged.")
+
+        for name, histogram in self.histograms.items():
+            histogram.merge(other.histograms[name])
+            self.means[name].extend(other.means[name])
+
+            if self.values is not None:
+                self.values[name].extend(other.values[name])
+
+        if self.indices is None:
+            self.indices = other.indices
+
+        return self
+
+    def time_series(self, name: str) -> Np1DNumberArray:
+        """
+        Returns the mean of an order parameter in each frame.
+
+        Parameters
+        ----------
+        name : str
+            The order parameter, 'q' or 'Q4', 'Q6', ...
+
+        Returns
+        -------
+        Np1DNumberArray
+            The mean of each frame.
+        """
+        return np.array(self._check_name(name).means[name])
+
+    def per_atom(self, name: str) -> Np2DNumberArray:
+        """
+        Returns the kept values of an order parameter of all frames.
+
+        Parameters
+        ----------
+        name : str
+            The order parameter, 'q' or 'Q4', 'Q6', ...
+
+        Returns
+        -------
+        Np2DNumberArray
+            The values of shape (n_frames, n_selected_atoms).
+
+        Raises
+        ------
+        AnalysisError
+            If the values were not kept.
+        """
+        if self._check_name(name).values is None:
+            raise AnalysisError(
+                "The values of the single atoms were not kept, use keep_values=True.")
+
+        return np.array(self.values[name]).reshape(len(self.values[name]), -1)
+
+    def _check_name(self, name: str) -> OrderParameterAccumulator:
+        if name not in self.histograms:
+            raise AnalysisError(
+                f"The order parameter {name} was not computed, available are {list(self.histograms)}.")
+
+        return self
+
+
+def order_parameters(reader: TrajectoryReader,
+                     atoms: List[str] | Np1DIntArray | None = None,
+                     tetrahedral: bool = True,
+                     l_values: Sequence[int] = (4, 6),
+                     n_neighbours: int = 12,
+                     n_bins: int = 100,
+                     keep_values: bool = False,
+                     md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                     n_workers: int | None = None
+                     ) -> OrderParameterAccumulator:
+    """
+    Computes the order parameters of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    OrderParameterAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    atoms : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the selected atoms, by default None (all atoms)
+    tetrahedral : bool, optional
+        Whether the tetrahedral order parameter q is computed, by default True
+    l_values : Sequence[int], optional
+        The degrees of the Steinhardt order parameters Q_l, by default (4, 6)
+    n_neighbours : int, optional
+        The number of neighbours of the Steinhardt order parameters, by default 12
+    n_bins : int, optional
+        The number of bins of the histograms, by default 100
+    keep_values : bool, optional
+        Whether the values of all atoms and frames are kept, by default False
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    OrderParameterAccumulator
+        The accumulated order parameters of all frames.
+    """
+    factory = functools.partial(OrderParameterAccumulator, atoms, tetrahedral,
+                                tuple(l_values), n_neighbours, n_bins, keep_values)
+
+    return map_reduce(reader, factory, OrderParameterAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
@@ -0,0 +1,372 @@
+"""
+A module containing reorientational correlation functions of molecular vectors.
+
+...
+
+Classes
+-------
+ReorientationAccumulator
+    A class collecting the molecular unit vectors of all frames.
+
+Functions
+---------
+molecular_vectors
+    Returns unit vectors of all molecules, e.g. bond vectors or dipole axes.
+legendre_correlation
+    Computes the Legendre reorientational correlation function of unit vector time series.
+reorientation
+    Collects the molecular unit vectors of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import List, Tuple
+from numbers import Real
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import minimum_image
+from ..statistics import correlation
+from ..topology import MoleculeTopology
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def molecular_vectors(pos: Np2DNumberArray,
+                      topology: MoleculeTopology,
+                      box_matrix: Np3x3NumberArray | None = None,
+                      pairs: List[Tuple[int, int]] | np.ndarray | None = None,
+                      weights: np.ndarray | None = None
+                      ) -> Np2DNumberArray:
+    """
+    Returns unit vectors of all molecules, e.g. bond vectors or dipole axes.
+
+    All atoms of a molecule are imaged relative to its first atom, so that molecules
+    broken by the periodic boundary conditions are handled. The vectors are either
+
+    - the vectors between pairs of atoms given by their position within the molecule,
+      e.g. pairs=[(0, 1), (0, 2)] for both O-H bonds of water molecules stored as O H H, or
+    - the weighted sum of the imaged atom positions, e.g. the dipole axis with the
+      partial charges as weights (which does not depend on the origin for neutral
+      molecules).
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of all atoms of shape (n_atoms, 3).
+    topology : MoleculeTopology
+        The topology of the molecules.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+    pairs : List[Tuple[int, int]] | np.ndarray | None, optional
+        The atom pairs (from, to) within each molecule, by default None
+    weights : np.ndarray | None, optional
+        The weight of each atom of pos, e.g. the partial charges, by default None
+
+    Returns
+    -------
+    Np2DNumberArray
+        The unit vectors of shape (n_molecules * n_pairs, 3), molecule major, or
+        (n_molecules, 3) for weights.
+
+    Raises
+    ------
+    AnalysisError
+        If not exactly one of pairs and weights is given, a pair index exceeds the size of
+        a molecule or a vector has zero length.
+    """
+    if (pairs is None) == (weights is None):
+        raise AnalysisError("Exactly one of pairs and weights has to be given.")
+
+    pos = np.asarray(pos, dtype=np.float64)
+    first = topology.offsets[:-1]
+
+    if pairs is not None:
+        pairs = np.asarray(pairs, dtype=np.int64).reshape(-1, 2)
+
+        if np.any(pairs < 0) or np.any(pairs.max(initial=0) >= topology.sizes):
+            raise AnalysisError(
+                "The atom pairs have to be within the atoms of all molecules.")
+
+        start = topology.indices[first[:, np.newaxis] + pairs[:, 0]]
+        stop = topology.indices[first[:, np.newaxis] + pairs[:, 1]]
+
+        vectors = (pos[stop] - pos[start]).reshape(-1, 3)
+
+        if box_matrix is not None:
+            vectors = minimum_image(vectors, box_matrix)
+    else:
+        origins = pos[topology.indices[np.repeat(first, topology.sizes)]]
+        relative = pos[topology.indices] - origins
+
+        if box_matrix is not None:
+            relative = minimum_image(relative, box_matrix)
+
+        atom_weights = np.asarray(weights, dtype=np.float64)[topology.indices]
+        vectors = np.add.reduceat(atom_weights[:, np.newaxis] * relative, first, axis=0)
+
+    lengths = np.linalg.norm(vectors, axis=1)
+
+    if np.any(lengths == 0.0):
+        raise AnalysisError("The molecular vectors must not have zero length.")
+
+    return vectors / lengths[:, np.newaxis]
+
+
+def legendre_correlation(vectors: np.ndarray,
+                         order: int = 2,
+                         n_lags: int | None = None,
+                         batch_size: int | None = None,
+                         n_workers: int = 1
+                         ) -> Np1DNumberArray:
+    """
+    Computes the Legendre reorientational correlation function of unit vector time series.
+
+    C_l(t) = < P_l(u(s) . u(s+t)) > averaged over all time origins and vectors with the
+    first or second Legendre polynomial. P1 is the correlation of the vectors themselves.
+    P2 = (3 x^2 - 1) / 2 follows from the correlation of the six independent components
+    of the outer product u u^T, since (u . v)^2 = sum_ab u_a u_b v_a v_b. Both are computed
+    with the FFT engine of statistics.correlation in batches of vectors, which are
+    transformed by n_workers threads.
+
+    Parameters
+    ----------
+    vectors : np.ndarray
+        The unit vectors of shape (n_frames, n_vectors, 3).
+    order : int, optional
+        The order of the Legendre polynomial, 1 or 2, by default 2
+    n_lags : int | None, optional
+        The number of lags, by default None (all frames)
+    batch_size : int | None, optional
+        The number of vectors transformed at once, by default None (see correlation)
+    n_workers : int, optional
+        The number of threads, by default 1
+
+    Returns
+    -------
+    Np1DNumberArray
+        The correlation function of shape (n_lags,), which is 1 at lag 0.
+
+    Raises
+    ------
+    AnalysisError
+        If the order is not 1 or 2 or the vectors do not have the shape (n_frames, n_vectors, 3).
+    """
+    vectors = np.asarray(vectors, dtype=np.float64)
+
+    if vectors.ndim != 3 or vectors.shape[2] != 3:
+        raise AnalysisError(
+            f"The vectors need the shape (n_frames, n_vectors, 3), got {vectors.shape}.")
+
+    if order == 1:
+        return correlation(vectors, n_lags=n_lags, batch_size=batch_size, n_workers=n_workers)
+
+    if order != 2:
+        raise AnalysisError("Only the Legendre polynomials of order 1 and 2 are supported.")
+
+    x, y, z = np.moveaxis(vectors, -1, 0)
+    root2 = np.sqrt(2.0)
+
+    # the off-diagonal components appear twice in the full outer product
+    components = np.stack([x * x, y * y, z * z, root2 * x * y, root2 * x * z, root2 * y * z],
+                          axis=-1)
+
+    squared = correlation(components, n_lags=n_lags, batch_size=batch_size, n_workers=n_workers)
+
+    return 1.5 * squared - 0.5
+
+
+class ReorientationAccumulator:
+    """
+    A class collecting the molecular unit vectors of all frames.
+
+    The vectors of each frame are computed with molecular_vectors and stored in
+    float64, i.e. with 24 bytes per vector and frame, since the FFT based correlation
+    needs the complete time series.
+
+    ...
+
+    Attributes
+    ----------
+    topology : MoleculeTopology
+        The topology of the molecules.
+    pairs : np.ndarray | None
+        The atom pairs within each molecule.
+    weights : np.ndarray | None
+        The weight of each atom.
+    vectors : List[Np2DNumberArray]
+        The unit vectors of each frame.
+    """
+
+    def __init__(self,
+                 topology: MoleculeTopology,
+                 pairs: List[Tuple[int, int]] | np.ndarray | None = None,
+                 weights: np.ndarray | None = None
+                 ) -> None:
+        """
+        Initializes the ReorientationAccumulator without frames.
+
+        Parameters
+        ----------
+        topology : MoleculeTopology
+            The topology of the molecules.
+        pairs : List[Tuple[int, int]] | np.ndarray | None, optional
+            The atom pairs within each molecule, by default None
+        weights : np.ndarray | None, optional
+            The weight of each atom, e.g. the partial charges, by default None
+
+        Raises
+        ------
+        AnalysisError
+            If not exactly one of pairs and weights is given.
+        """
+        if (pairs is None) == (weights is None):
+            raise AnalysisError("Exactly one of pairs and weights has to be given.")
+
+        self.topology = topology
+        self.pairs = None if pairs is None else np.asarray(pairs, dtype=np.int64)
+        self.weights = None if weights is None else np.asarray(weights, dtype=np.float64)
+        self.vectors = []
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the molecular vectors of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+        """
+        box_matrix = frame.cell.box_matrix if frame.PBC else None
+
+        self.vectors.append(molecular_vectors(frame.pos, self.topology, box_matrix,
+                                              self.pairs, self.weights))
+
+    def merge(self, other: ReorientationAccumulator) -> ReorientationAccumulator:
+        """
+        Appends the vectors of a later frame range.
+
+        Parameters
+        ----------
+        other : ReorientationAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        ReorientationAccumulator
+            This accumulator.
+        """
+        self.vectors.extend(other.vectors)
+
+        return self
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return len(self.vectors)
+
+    def correlation(self,
+                    order: int = 2,
+                    n_lags: int | None = None,
+                    n_workers: int = 1
+                    ) -> Np1DNumberArray:
+        """
+        Returns the Legendre reorientational correlation function of the collected vectors.
+
+        Parameters
+        ----------
+        order : int, optional
+            The order of the Legendre polynomial, 1 or 2, by default 2
+        n_lags : int | None, optional
+            The number of lags, by default None (all frames)
+        n_workers : int, optional
+            The number of threads, by default 1
+
+        Returns
+        -------
+        Np1DNumberArray
+            The correlation function of shape (n_lags,).
+
+        Raises
+        ------
+        AnalysisError
+            If no frame was added.
+        """
+        if self.n_frames == 0:
+            raise AnalysisError("No frames were added to the accumulator.")
+
+        return legendre_correlation(np.stack(self.vectors), order, n_lags, n_workers=n_workers)
+
+    def relaxation_time(self, order: int = 2, time_step: Real = 1.0, n_workers: int = 1) -> float:
+        """
+        Returns the integrated reorientational relaxation time.
+
+        The correlation function is integrated with the trapezoidal rule up to its first
+        zero crossing, so that the noisy tail does not contribute.
+
+        Parameters
+        ----------
+        order : int, optional
+            The order of the Legendre polynomial, 1 or 2, by default 2
+        time_step : Real, optional
+            The time between two frames, by default 1.0
+        n_workers : int, optional
+            The number of threads, by default 1
+
+        Returns
+        -------
+        float
+            The relaxation time in the unit of time_step.
+        """
+        values = self.correlation(order, n_workers=n_workers)
+
+        negative = np.flatnonzero(values <= 0.0)
+        if len(negative) > 0:
+            values = values[:negative[0] + 1]
+
+        return float(time_step * (np.sum(values) - 0.5 * (values[0] + values[-1])))
+
+
+def reorientation(reader: TrajectoryReader,
+                  topology: MoleculeTopology,
+                  pairs: List[Tuple[int, int]] | np.ndarray | None = None,
+                  weights: np.ndarray | None = None,
+                  md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                  n_workers: int | None = None
+                  ) -> ReorientationAccumulator:
+    """
+    Collects the molecular unit vectors of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce. The correlation
+    functions are then obtained with ReorientationAccumulator.correlation.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    topology : MoleculeTopology
+        The topology of the molecules.
+    pairs : List[Tuple[int, int]] | np.ndarray | None, optional
+        The atom pairs within each molecule, by default None
+    weights : np.ndarray | None, optional
+        The weight of each atom, e.g. the partial charges, by default None
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    ReorientationAccumulator
+        The vectors of all frames.
+    """
+    factory = functools.partial(ReorientationAccumulator, topology, pairs, weights)
+
+    return map_reduce(reader, factory, ReorientationAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
@@ -0,0 +1,384 @@
+"""
+A module containing the per-species statistics of (radical) Voronoi cells.
+
+...
+
+Classes
+-------
+VoronoiAccumulator
+    A class accumulating the Voronoi volumes, local densities and neighbour counts per species.
+
+Functions
+---------
+voronoi
+    Computes the Voronoi statistics of all frames of a trajectory in parallel.
+"""
+
+from __future__ import annotations
+
+import functools
+
+import numpy as np
+
+from beartype.typing import Dict, List, Tuple
+from numbers import Real
+
+from . import AnalysisError, map_reduce
+from ..io import TrajectoryReader
+from ..kernels import voronoi_cells
+from ..statistics import Histogram, MomentAccumulator
+from ..traj import Frame, MDEngineFormat
+from ..types import Np1DIntArray, Np1DNumberArray
+
+
+class VoronoiAccumulator:
+    """
+    A class accumulating the Voronoi volumes, local densities and neighbour counts per species.
+
+    For each frame all atoms are tessellated with kernels.voronoi_cells, optionally
+    with the radical (power) tessellation of the given radius of each atom name. The
+    volume, the local density (the inverse volume) and the number of natural
+    neighbours (the faces of the cell) of the selected atoms are streamed into one
+    MomentAccumulator per atom name and the neighbour counts into one Histogram per
+    atom name, so that the memory does not grow with the number of frames. Only the
+    mean volume of each species in each frame is kept as time series.
+
+    In the radical tessellation an atom can be hidden by larger neighbours, i.e. its
+    cell is empty. The zero volume and neighbour count of hidden atoms enter the
+    volume and neighbour statistics, but hidden atoms are skipped in the local
+    densities, which are undefined for them.
+
+    ...
+
+    Attributes
+    ----------
+    atoms : List[str] | Np1DIntArray | None
+        The selection of the atoms, whose statistics are accumulated.
+    radii : Dict[str, Real] | None
+        The radius of each atom name for the radical tessellation, None for the Voronoi tessellation.
+    min_area : Real
+        The smallest area of a face, whose neighbour is counted.
+    volumes : Dict[str, MomentAccumulator]
+        The statistics of the cell volumes of each atom name.
+    densities : Dict[str, MomentAccumulator]
+        The statistics of the local densities of each atom name without hidden atoms.
+    neighbours : Dict[str, MomentAccumulator]
+        The statistics of the neighbour counts of each atom name.
+    histograms : Dict[str, Histogram]
+        The histogram of the neighbour counts of each atom name.
+    means : Dict[str, List[float]]
+        The mean cell volume of each atom name in each frame.
+    indices : Np1DIntArray | None
+        The indices of the selected atoms, determined with the first frame.
+    """
+
+    def __init__(self,
+                 atoms: List[str] | Np1DIntArray | None = None,
+                 radii: Dict[str, Real] | None = None,
+                 min_area: Real = 0.0,
+                 max_neighbours: int = 40
+                 ) -> None:
+        """
+        Initializes the VoronoiAccumulator without frames.
+
+        Parameters
+        ----------
+        atoms : List[str] | Np1DIntArray | None, optional
+            The atom type names or indices of the selected atoms, by default None (all atoms)
+        radii : Dict[str, Real] | None, optional
+            The radius of each atom name for the radical tessellation, by default None
+            (Voronoi tessellation)
+        min_area : Real, optional
+            The smallest area of a face, whose neighbour is counted, by default 0.0
+        max_neighbours : int, optional
+            The largest neighbour count of the histograms, by default 40
+
+        Raises
+        ------
+        AnalysisError
+            If the largest neighbour count is not positive.
+        """
+        if max_neighbours < 1:
+            raise AnalysisError("The largest neighbour count has to be positive.")
+
+        self.atoms = atoms
+        self.radii = radii
+        self.min_area = min_area
+        self.max_neighbours = max_neighbours
+
+        self.volumes = {}
+        self.densities = {}
+        self.neighbours = {}
+        self.histograms = {}
+        self.means = {}
+
+        self.indices = None
+        self._names = None
+        self._radii = None
+
+    def _setup(self, frame: Frame) -> None:
+        """
+        Resolves the selection, the atom names and the radii with the first frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The first frame.
+
+        Raises
+        ------
+        AnalysisError
+            If an atom name has no radius.
+        """
+        self.indices = np.asarray(frame.system.indices_from_atoms(self.atoms))
+
+        names = np.array([atom.name for atom in frame.system.atoms])
+
+        if self.radii is not None:
+            missing = sorted(set(names) - set(self.radii))
+
+            if len(missing) > 0:
+                raise AnalysisError(
+                    f"The radical Voronoi tessellation needs a radius for the atom names {missing}.")
+
+            self._radii = np.array([self.radii[name] for name in names], dtype=np.float64)
+
+        self._names = names[self.indices]
+
+    def update(self, frame: Frame) -> None:
+        """
+        Adds the Voronoi cells of a frame.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame.
+
+        Raises
+        ------
+        AnalysisError
+            If the frame has no periodic boundary conditions.
+        """
+        if not frame.PBC:
+            raise AnalysisError(
+                "The Voronoi tessellation needs periodic boundary conditions.")
+
+        if self.indices is None:
+            self._setup(frame)
+
+        volumes, faces, areas = voronoi_cells(frame.pos, frame.cell.box_matrix, self._radii)
+
+        counts = np.bincount(faces[areas >= self.min_area, 0], minlength=len(volumes))
+
+        volumes = volumes[self.indices]
+        counts = counts[self.indices]
+
+        for name in np.unique(self._names):
+            selected = self._names == name
+
+            if name not in self.volumes:
+                self._add_species(name)
+
+            self.volumes[name].add(volumes[selected])
+            self.densities[name].add(1.0 / volumes[selected & (volumes > 0.0)])
+            self.neighbours[name].add(counts[selected])
+            self.histograms[name].add(counts[selected])
+            self.means[name].append(float(np.mean(volumes[selected])))
+
+    def _add_species(self, name: str) -> None:
+        """
+        Adds empty statistics of an atom name.
+
+        Parameters
+        ----------
+        name : str
+            The atom name.
+        """
+        self.volumes[name] = MomentAccumulator(())
+        self.densities[name] = MomentAccumulator(())
+        self.neighbours[name] = MomentAccumulator(())
+
+        # one bin per neighbour count
+        self.histograms[name] = Histogram((-0.5, self.max_neighbours + 0.5), self.max_neighbours + 1)
+        self.means[name] = []
+
+    def merge(self, other: VoronoiAccumulator) -> VoronoiAccumulator:
+        """
+        Merges the statistics of a later frame range into this accumulator.
+
+        Parameters
+        ----------
+        other : VoronoiAccumulator
+            The accumulator of the later frames.
+
+        Returns
+        -------
+        VoronoiAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        AnalysisError
+            If the accumulators have histograms of different neighbour counts.
+        """
+        if self.max_neighbours != other.max_neighbours:
+            raise AnalysisError(
+                "Only accumulators with the same largest neighbour count can be merged.")
+
+        for name in other.volumes:
+            if name not in self.volumes:
+                self._add_species(name)
+
+            self.volumes[name].merge(other.volumes[name])
+            self.densities[name].merge(other.densities[name])
+            self.neighbours[name].merge(other.neighbours[name])
+            self.histograms[name].merge(other.histograms[name])
+            self.means[name].extend(other.means[name])
+
+        if self.indices is None:
+            self.indices = other.indices
+            self._names = other._names
+            self._radii = other._radii
+
+        return self
+
+    @property
+    def species(self) -> List[str]:
+        """
+        List[str]: The sorted atom names of the selected atoms.
+        """
+        return sorted(self.volumes)
+
+    @property
+    def n_frames(self) -> int:
+        """
+        int: The number of frames.
+        """
+        return max((len(means) for means in self.means.values()), default=0)
+
+    def time_series(self, name: str) -> Np1DNumberArray:
+        """
+        Returns the mean cell volume of an atom name in each frame.
+
+        Parameters
+        ----------
+        name : str
+            The atom name.
+
+        Returns
+        -------
+        Np1DNumberArray
+            The mean volume of each frame.
+        """
+        return np.array(self._check_name(name).means[name])
+
+    def neighbour_distribution(self, name: str) -> Tuple[Np1DIntArray, Np1DNumberArray]:
+        """
+        Returns the probability of each neighbour count of an atom name.
+
+        Parameters
+        ----------
+        name : str
+            The atom name.
+
+        Returns
+        -------
+        counts : Np1DIntArray
+            The neighbour counts 0 ... max_neighbours.
+        probabilities : Np1DNumberArray
+            The probability of each neighbour count, normalized including the larger counts.
+        """
+        histogram = self._check_name(name).histograms[name]
+
+        return np.arange(self.max_neighbours + 1), histogram.counts / histogram.total
+
+    def summary(self) -> Dict[str, Dict[str, float]]:
+        """
+        Returns the mean and standard deviation of all statistics of each atom name.
+
+        Returns
+        -------
+        Dict[str, Dict[str, float]]
+            The values 'volume', 'volume_std', 'density', 'density_std', 'neighbours'
+            and 'neighbours_std' of each atom name, NaN if no atom contributed.
+        """
+        summary = {}
+
+        for name in self.species:
+            summary[name] = {}
+
+            for key, statistics in (("volume", self.volumes),
+                                    ("density", self.densities),
+                                    ("neighbours", self.neighbours)):
+                # the density of a species, whose atoms are all hidden, is undefined
+                summary[name][key] = float(statistics[name].mean) if statistics[name].weight > 0.0 else np.nan
+                summary[name][f"{key}_std"] = float(statistics[name].std())
+
+        return summary
+
+    def _check_name(self, name: str) -> VoronoiAccumulator:
+        """
+        Checks that the statistics of an atom name were accumulated.
+
+        Parameters
+        ----------
+        name : str
+            The atom name.
+
+        Returns
+        -------
+        VoronoiAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        AnalysisError
+            If no selected atom has the atom name.
+        """
+        if name not in self.volumes:
+            raise AnalysisError(
+                f"No statistics of the atom name {name} were accumulated, available are {self.species}.")
+
+        return self
+
+
+def voronoi(reader: TrajectoryReader,
+            atoms: List[str] | Np1DIntArray | None = None,
+            radii: Dict[str, Real] | None = None,
+            min_area: Real = 0.0,
+            max_neighbours: int = 40,
+            md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+            n_workers: int | None = None
+            ) -> VoronoiAccumulator:
+    """
+    Computes the Voronoi statistics of all frames of a trajectory in parallel.
+
+    The frames are distributed over worker processes with map_reduce, see
+    VoronoiAccumulator for the parameters.
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    atoms : List[str] | Np1DIntArray | None, optional
+        The atom type names or indices of the selected atoms, by default None (all atoms)
+    radii : Dict[str, Real] | None, optional
+        The radius of each atom name for the radical tessellation, by default None
+    min_area : Real, optional
+        The smallest area of a face, whose neighbour is counted, by default 0.0
+    max_neighbours : int, optional
+        The largest neighbour count of the histograms, by default 40
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    n_workers : int | None, optional
+        The number of worker processes, by default None (the number of CPUs)
+
+    Returns
+    -------
+    VoronoiAccumulator
+        The Voronoi statistics of all frames.
+    """
+    factory = functools.partial(VoronoiAccumulator, atoms, radii, min_area, max_neighbours)
+
+    return map_reduce(reader, factory, VoronoiAccumulator.update,
+                      md_format=md_format, n_workers=n_workers)
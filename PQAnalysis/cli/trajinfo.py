@@ -0,0 +1,304 @@
+"""
+Prints a summary of one or multiple trajectory files.
+
+For each trajectory file the number of frames, the number of atoms, the
+species composition of the first frame, the ranges of the box lengths, box
+angles and box volume, whether the cell is constant, the file size and the
+estimated memory needed to load the full trajectory are reported.
+
+The summary is computed from a header-only scan of the trajectory file,
+which is stored as persistent frame offset index next to the trajectory file
+('<filename>.pqidx'), and the atom names of the first frame. Multiple files
+are scanned in parallel. For the QMCFC md engine format the dummy atom X,
+which is the first atom of each frame, is not counted, as it is dropped by
+the trajectory readers.
+"""
+
+import argparse
+import os
+import sys
+import numpy as np
+
+from collections import Counter
+from beartype.typing import List, Dict, Any, Tuple
+
+from ..io import TrajectoryIndex, BaseWriter
+from ..core import Atom
+from ..traj import MDEngineFormat
+from ..utils import process_pool
+
+
+def main():
+    """
+    Wrapper for the command line interface of trajinfo.
+    """
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('trajectory_file', type=str, nargs='+',
+                        help='The trajectory file(s) to summarize.')
+    parser.add_argument('-o', '--output', type=str, default=None,
+                        help='The output file. If not specified, the output is printed to stdout.')
+    parser.add_argument('-j', '--n-workers', type=int, default=None,
+                        help='The number of processes used to scan the files. Default is the number of CPUs.')
+    parser.add_argument('--md-format', type=str, default="pimd-qmcf",
+                        help='The md engine format of the trajectory file(s).')
+    args = parser.parse_args()
+
+    trajinfo(args.trajectory_file, args.output, args.n_workers, md_format=args.md_format)
+
+
+def trajinfo(trajectory_files: List[str],
+             output: str | None = None,
+             n_workers: int | None = None,
+             persistent_index: bool = True,
+             md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF
+             ) -> None:
+    """
+    Prints a summary of one or multiple trajectory files.
+
+    Parameters
+    ----------
+    trajectory_files : List[str]
+        The trajectory file(s) to summarize.
+    output : str | None, optional
+        The output file. If not specified, the output is printed to stdout.
+    n_workers : int | None, optional
+        The number of processes used to scan the files, by default None (number of CPUs)
+    persistent_index : bool, optional
+        Whether the frame offset index should be stored next to the trajectory files, by default True
+    md_format : MDEngineFormat | str, optional
+        The md engine format of the trajectory file(s), by default MDEngineFormat.PIMD_QMCF
+    """
+    for filename in trajectory_files:
+        if not os.path.isfile(filename):
+            raise FileNotFoundError(f"File {filename} not found.")
+
+    if n_workers is None:
+        n_workers = os.cpu_count() or 1
+
+    jobs = [(filename, persistent_index, md_format) for filename in trajectory_files]
+
+    if n_workers == 1 or len(jobs) == 1:
+        infos = [trajectory_info(*job) for job in jobs]
+    else:
+        with process_pool(min(n_workers, len(jobs))) as executor:
+            infos = list(executor.map(trajectory_info, *zip(*jobs)))
+
+    writer = BaseWriter(output)
+    writer.open()
+
+    print("\n\n".join(format_trajectory_info(info) for info in infos), file=writer.file)
+
+    writer.close()
+
+
+def trajectory_info(filename: str,
+                    persistent_index: bool = True,
+                    md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF
+                    ) -> Dict[str, Any]:
+    """
+    Computes the summary of a trajectory file from its frame offset index.
+
+    Parameters
+    ----------
+    filename : str
+        The trajectory file.
+    persistent_index : bool, optional
+        Whether the frame offset index should be loaded from/stored to disk, by default True
+    md_format : MDEngineFormat | str, optional
+        The md engine format of the trajectory file, by default MDEngineFormat.PIMD_QMCF.
+        For QMCFC the dummy atom X is not counted.
+
+    Returns
+    -------
+    Dict[str, Any]
+        The summary of the trajectory file.
+    """
+    index = TrajectoryIndex.from_file(filename, persistent=persistent_index)
+
+    # the dummy atom X of QMCFC is dropped by the trajectory readers
+    n_dummy = 1 if MDEngineFormat(md_format) == MDEngineFormat.QMCFC else 0
+
+    info = {
+        "filename": filename,
+        "file_size": os.path.getsize(filename),
+        "n_frames": index.n_frames,
+        "n_atoms": (int(np.min(index.n_atoms)) - n_dummy, int(np.max(index.n_atoms)) - n_dummy)
+        if index.n_frames > 0 else (0, 0),
+        "species": {},
+        "cell": None,
+        "constant_cell": None,
+        "memory": 0,
+    }
+
+    if index.n_frames == 0:
+        return info
+
+    names = _first_frame_atom_names(index)[n_dummy:]
+    info["species"] = dict(Counter(names))
+
+    cells = index.effective_cell_parameters()
+    if not np.all(np.isnan(cells[:, 0])):
+        cells = cells[~np.isnan(cells[:, 0])]
+        info["cell"] = {
+            "a": _ranges(cells[:, 0]),
+            "b": _ranges(cells[:, 1]),
+            "c": _ranges(cells[:, 2]),
+            "alpha": _ranges(cells[:, 3]),
+            "beta": _ranges(cells[:, 4]),
+            "gamma": _ranges(cells[:, 5]),
+            "volume": _ranges(_volumes(cells)),
+        }
+        info["constant_cell"] = bool(np.allclose(cells, cells[0]))
+
+    info["memory"] = _estimate_memory(index, names[0] if names else "X", n_dummy)
+
+    return info
+
+
+def format_trajectory_info(info: Dict[str, Any]) -> str:
+    """
+    Formats the summary of a trajectory file as human readable text.
+
+    Parameters
+    ----------
+    info : Dict[str, Any]
+        The summary as returned by trajectory_info.
+
+    Returns
+    -------
+    str
+        The formatted summary.
+    """
+    n_atoms_min, n_atoms_max = info["n_atoms"]
+    n_atoms = f"{n_atoms_min}" if n_atoms_min == n_atoms_max else f"{n_atoms_min} - {n_atoms_max}"
+    species = ", ".join(f"{name}: {count}" for name, count in info["species"].items())
+
+    lines = [
+        f"file:              {info['filename']}",
+        f"file size:         {_format_bytes(info['file_size'])}",
+        f"frames:            {info['n_frames']}",
+        f"atoms:             {n_atoms}",
+        f"species:           {species}",
+    ]
+
+    if info["cell"] is None:
+        lines.append("cell:              no cell information")
+    else:
+        lines.append(f"constant cell:     {'yes' if info['constant_cell'] else 'no'}")
+        lines.append(f"{'':19}{'min':>14} {'max':>14} {'mean':>14}")
+        for key in ["a", "b", "c", "alpha", "beta", "gamma", "volume"]:
+            minimum, maximum, mean = info["cell"][key]
+            lines.append(f"{key + ':':19}{minimum:14.6f} {maximum:14.6f} {mean:14.6f}")
+
+    lines.append(f"estimated memory:  {_format_bytes(info['memory'])}")
+
+    return "\n".join(lines)
+
+
+def _first_frame_atom_names(index: TrajectoryIndex) -> List[str]:
+    """
+    Reads only the atom names of the first frame.
+
+    Parameters
+    ----------
+    index : TrajectoryIndex
+        The index of the trajectory file.
+
+    Returns
+    -------
+    List[str]
+        The atom names of the first frame.
+    """
+    lines = index.read_bytes(0).decode().split('\n')
+    return [line.split(maxsplit=1)[0] for line in lines[2:2 + int(index.n_atoms[0])]]
+
+
+def _volumes(cells: np.ndarray) -> np.ndarray:
+    """
+    Computes the volumes of the cells from the cell parameters.
+
+    Parameters
+    ----------
+    cells : np.ndarray
+        The box lengths and box angles of shape (n_frames, 6).
+
+    Returns
+    -------
+    np.ndarray
+        The volumes of the cells.
+    """
+    cos = np.cos(np.deg2rad(cells[:, 3:6]))
+    factor = 1 - np.sum(cos**2, axis=1) + 2 * np.prod(cos, axis=1)
+
+    return np.prod(cells[:, 0:3], axis=1) * np.sqrt(factor)
+
+
+def _ranges(values: np.ndarray) -> Tuple[float, float, float]:
+    """
+    Returns the minimum, maximum and mean of the given values.
+
+    Parameters
+    ----------
+    values : np.ndarray
+        The values to compute the ranges of.
+
+    Returns
+    -------
+    Tuple[float, float, float]
+        The minimum, maximum and mean of the values.
+    """
+    return float(np.min(values)), float(np.max(values)), float(np.mean(values))
+
+
+def _estimate_memory(index: TrajectoryIndex, atom_name: str, n_dummy: int = 0) -> int:
+    """
+    Estimates the memory needed to load the full trajectory with TrajectoryReader.
+
+    The estimate includes the float64 positions and the Atom objects of all frames.
+
+    Parameters
+    ----------
+    index : TrajectoryIndex
+        The index of the trajectory file.
+    atom_name : str
+        A representative atom name used to measure the size of an Atom object.
+    n_dummy : int, optional
+        The number of dummy atoms per frame, which are not loaded, by default 0
+
+    Returns
+    -------
+    int
+        The estimated memory in bytes.
+    """
+    atom = Atom(atom_name, use_guess_element=False)
+    atom_size = sys.getsizeof(atom) + sys.getsizeof(atom.__dict__) + \
+        sys.getsizeof(atom.name)
+
+    # positions + atom objects + list entries per atom
+    per_atom = 3 * np.dtype(np.float64).itemsize + atom_size + 8
+
+    return int((np.sum(index.n_atoms) - n_dummy * index.n_frames) * per_atom)
+
+
+def _format_bytes(n_bytes: int) -> str:
+    """
+    Formats a number of bytes with a binary prefix.
+
+    Parameters
+    ----------
+    n_bytes : int
+        The number of bytes.
+
+    Returns
+    -------
+    str
+        The formatted number of bytes, e.g. '1.50 MiB'.
+    """
+    size = float(n_bytes)
+    for unit in ["B", "KiB", "MiB", "GiB", "TiB"]:
+        if size < 1024 or unit == "TiB":
+            break
+        size /= 1024
+
+    return f"{n_bytes} B" if unit == "B" else f"{size:.2f} {unit}"
@@ -0,0 +1,345 @@
+"""
+Extracts selected frames of one or multiple trajectory files.
+
+The frames can be selected by a range (--start, --stop) with an optional
+--stride or by an explicit list of frame indices (--frames). The frame
+indices start from 0 and are counted consecutively over all given trajectory
+files. Negative indices count from the end of the trajectory.
+
+The frames are located via a persistent frame offset index, which is stored
+next to each trajectory file ('<filename>.pqidx') and reused as long as the
+trajectory file is not modified. If the md engine format of the output is the
+same as the one of the input, the raw bytes of the selected frames are copied
+without parsing them.
+
+With the --restart option a restart file is written for each selected frame
+('<prefix>-<frame>.rst'). The restart files are written in parallel.
+"""
+
+import argparse
+import os
+import sys
+import numpy as np
+
+from beartype.typing import List, Tuple, Callable
+
+from ..io import TrajectoryReader, TrajectoryWriter, RestartFileWriter, TrajectoryIndex, FrameReader, BaseWriter
+from ..traj import MDEngineFormat
+from ..core import Cell
+from ..utils import process_pool
+
+
+def main():
+    """
+    Wrapper for the command line interface of trajslice.
+    """
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('trajectory_file', type=str, nargs='+',
+                        help='The trajectory file(s) to extract the frames from.')
+    parser.add_argument('--start', type=int, default=None,
+                        help='The first frame to extract.')
+    parser.add_argument('--stop', type=int, default=None,
+                        help='The frame to stop before (exclusive).')
+    parser.add_argument('--stride', type=int, default=None,
+                        help='Extract only every n-th frame.')
+    parser.add_argument('--frames', type=int, nargs='+', default=None,
+                        help='An explicit list of frames to extract. Cannot be combined with --start, --stop and --stride.')
+    parser.add_argument('-o', '--output', type=str, default=None,
+                        help='The output file. If not specified, the output is printed to stdout.')
+    parser.add_argument('--md-format', type=str, default="pimd-qmcf",
+                        help='The md engine format of the trajectory file(s).')
+    parser.add_argument('--output-md-format', type=str, default=None,
+                        help='The md engine format of the output. If not specified, the input format is used.')
+    parser.add_argument('--restart', type=str, default=None,
+                        help='Write a restart file \'<RESTART>-<frame>.rst\' for each selected frame instead of a trajectory.')
+    parser.add_argument('-j', '--n-workers', type=int, default=None,
+                        help='The number of processes used to write the restart files. Default is the number of CPUs.')
+    args = parser.parse_args()
+
+    if args.frames is not None and any(x is not None for x in [args.start, args.stop, args.stride]):
+        parser.error("--frames cannot be combined with --start, --stop or --stride.")
+
+    trajslice(args.trajectory_file,
+              output=args.output,
+              frames=args.frames,
+              start=args.start,
+              stop=args.stop,
+              stride=args.stride,
+              md_format=args.md_format,
+              output_md_format=args.output_md_format,
+              restart=args.restart,
+              n_workers=args.n_workers)
+
+
+def trajslice(trajectory_files: List[str],
+              output: str | None = None,
+              frames: List[int] | None = None,
+              start: int | None = None,
+              stop: int | None = None,
+              stride: int | None = None,
+              md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+              output_md_format: MDEngineFormat | str | None = None,
+              restart: str | None = None,
+              n_workers: int | None = None,
+              persistent_index: bool = True
+              ) -> None:
+    """
+    Extracts selected frames of one or multiple trajectory files.
+
+    Parameters
+    ----------
+    trajectory_files : List[str]
+        The trajectory file(s) to extract the frames from.
+    output : str | None, optional
+        The output file. If not specified, the output is printed to stdout.
+    frames : List[int] | None, optional
+        An explicit list of frames to extract. If given, start, stop and stride are ignored.
+    start : int | None, optional
+        The first frame to extract, by default None (first frame)
+    stop : int | None, optional
+        The frame to stop before, by default None (end of trajectory)
+    stride : int | None, optional
+        Extract only every n-th frame, by default None (every frame)
+    md_format : MDEngineFormat | str, optional
+        The md engine format of the trajectory file(s), by default MDEngineFormat.PIMD_QMCF
+    output_md_format : MDEngineFormat | str | None, optional
+        The md engine format of the output, by default None (same as md_format)
+    restart : str | None, optional
+        If given, a restart file '<restart>-<frame>.rst' is written for each selected frame
+        instead of a trajectory, by default None
+    n_workers : int | None, optional
+        The number of processes used to write the restart files, by default None (number of CPUs)
+    persistent_index : bool, optional
+        Whether the frame offset index should be stored next to the trajectory files, by default True
+    """
+    md_format = MDEngineFormat(md_format)
+    if output_md_format is None:
+        output_md_format = md_format
+    output_md_format = MDEngineFormat(output_md_format)
+
+    if frames is None:
+        frames = slice(start, stop, stride)
+
+    reader = TrajectoryReader(trajectory_files)
+    indices = reader.indices(persistent_index)
+    located = reader._locate_frames(indices, frames)
+
+    if restart is not None:
+        _write_restart_files(located, indices, restart,
+                             md_format, output_md_format, n_workers)
+    elif md_format == output_md_format:
+        _copy_frames(located, output)
+    else:
+        trajectory = reader.read_frames(
+            frames, md_format=md_format, persistent_index=persistent_index)
+        writer = TrajectoryWriter(output, format=output_md_format)
+        writer.write(trajectory)
+
+
+def _copy_frames(located: List[Tuple[TrajectoryIndex, int, Cell]], output: str | None) -> None:
+    """
+    Copies the raw bytes of the located frames to the output.
+
+    Contiguous frames of the same file are copied as one byte range. Only frames
+    which inherit their cell from a previous frame get a rewritten header line, so
+    that the output is self-contained.
+
+    Parameters
+    ----------
+    located : List[Tuple[TrajectoryIndex, int, Cell]]
+        The located frames as returned by TrajectoryReader._locate_frames.
+    output : str | None
+        The output file. If None, the output is printed to stdout.
+    """
+    # checks the mode and the existence of the output file
+    BaseWriter(output)
+
+    if output is None:
+        out_file = None
+        write_chunk = sys.stdout.buffer.write
+    else:
+        out_file = open(output, 'wb')
+        write_chunk = out_file.write
+
+    last_byte = [b'\n']
+
+    def write(chunk: bytes) -> None:
+        write_chunk(chunk)
+        last_byte[0] = chunk[-1:]
+
+    def end_of_frames() -> None:
+        # a file without trailing newline would otherwise break the following frame
+        if last_byte[0] != b'\n':
+            write(b'\n')
+
+    try:
+        run = None
+        for index, frame, cell in located:
+            start, stop = int(index.offsets[frame]), int(index.offsets[frame + 1])
+
+            if np.isnan(index.cells[frame][0]) and cell != Cell():
+                if run is not None:
+                    _copy_byte_range(*run, write)
+                    end_of_frames()
+                    run = None
+                _copy_with_header(index, frame, cell, write)
+                end_of_frames()
+            elif run is not None and run[0] is index and run[2] == start:
+                run = (index, run[1], stop)
+            else:
+                if run is not None:
+                    _copy_byte_range(*run, write)
+                    end_of_frames()
+                run = (index, start, stop)
+
+        if run is not None:
+            _copy_byte_range(*run, write)
+            end_of_frames()
+    finally:
+        if out_file is not None:
+            out_file.close()
+
+
+def _copy_byte_range(index: TrajectoryIndex, start: int, stop: int, write: Callable, chunk_size: int = 1 << 24) -> None:
+    """
+    Copies the byte range start:stop of the indexed file in chunks.
+
+    Parameters
+    ----------
+    index : TrajectoryIndex
+        The index of the file to copy from.
+    start : int
+        The first byte to copy.
+    stop : int
+        The byte to stop before.
+    write : Callable
+        The function writing a chunk of bytes to the output.
+    chunk_size : int, optional
+        The maximum number of bytes copied at once, by default 16 MiB
+    """
+    with open(index.filename, 'rb') as file:
+        file.seek(start)
+        remaining = stop - start
+        while remaining > 0:
+            chunk = file.read(min(chunk_size, remaining))
+            if not chunk:
+                break
+            write(chunk)
+            remaining -= len(chunk)
+
+
+def _copy_with_header(index: TrajectoryIndex, frame: int, cell: Cell, write: Callable) -> None:
+    """
+    Copies a frame and replaces its header line with one containing the given cell.
+
+    Parameters
+    ----------
+    index : TrajectoryIndex
+        The index of the file to copy from.
+    frame : int
+        The frame to copy.
+    cell : Cell
+        The cell inherited from a previous frame.
+    write : Callable
+        The function writing a chunk of bytes to the output.
+    """
+    frame_bytes = index.read_bytes(frame)
+    body = frame_bytes[frame_bytes.index(b'\n') + 1:]
+    header = f"{index.n_atoms[frame]} {cell.x} {cell.y} {cell.z} {cell.alpha} {cell.beta} {cell.gamma}\n"
+
+    write(header.encode() + body)
+
+
+def _write_restart_files(located: List[Tuple[TrajectoryIndex, int, Cell]],
+                         indices: List[TrajectoryIndex],
+                         restart: str,
+                         md_format: MDEngineFormat,
+                         output_md_format: MDEngineFormat,
+                         n_workers: int | None
+                         ) -> None:
+    """
+    Writes a restart file for each located frame in parallel.
+
+    Parameters
+    ----------
+    located : List[Tuple[TrajectoryIndex, int, Cell]]
+        The located frames as returned by TrajectoryReader._locate_frames.
+    indices : List[TrajectoryIndex]
+        The indices of all trajectory files, used to compute the global frame numbers.
+    restart : str
+        The prefix of the restart files.
+    md_format : MDEngineFormat
+        The md engine format of the trajectory files.
+    output_md_format : MDEngineFormat
+        The md engine format of the restart files.
+    n_workers : int | None
+        The number of processes, by default None (number of CPUs)
+    """
+    starts = {id(index): start for index, start in zip(
+        indices, np.cumsum([0] + [index.n_frames for index in indices]))}
+
+    jobs = []
+    for index, frame, cell in located:
+        global_frame = int(starts[id(index)] + frame)
+        jobs.append((index.filename,
+                     int(index.offsets[frame]),
+                     int(index.offsets[frame + 1]),
+                     cell,
+                     md_format,
+                     output_md_format,
+                     f"{restart}-{global_frame}.rst"))
+
+    if n_workers is None:
+        n_workers = os.cpu_count() or 1
+
+    if n_workers == 1 or len(jobs) <= 1:
+        for job in jobs:
+            _write_restart_file(*job)
+    else:
+        with process_pool(n_workers) as executor:
+            # list() re-raises the first exception of a worker
+            list(executor.map(_write_restart_file, *zip(*jobs)))
+
+
+def _write_restart_file(filename: str,
+                        start: int,
+                        stop: int,
+                        cell: Cell,
+                        md_format: MDEngineFormat,
+                        output_md_format: MDEngineFormat,
+                        restart_filename: str
+                        ) -> None:
+    """
+    Parses a single frame from the given byte range and writes it as restart file.
+
+    Parameters
+    ----------
+    filename : str
+        The trajectory file.
+    start : int
+        The first byte of the frame.
+    stop : int
+        The byte to stop before.
+    cell : Cell
+        The effective cell of the frame.
+    md_format : MDEngineFormat
+        The md engine format of the trajectory file.
+    output_md_format : MDEngineFormat
+        The md engine format of the restart file.
+    restart_filename : str
+        The name of the restart file.
+    """
+    with open(filename, 'rb') as file:
+        file.seek(start)
+        frame_string = file.read(stop - start).decode()
+
+    reader = TrajectoryReader(filename)
+    frame = reader._parse_frame(frame_string, FrameReader(), md_format)
+
+    if frame.cell == Cell():
+        frame.cell = cell
+
+    writer = RestartFileWriter(restart_filename, format=output_md_format)
+    writer.write(frame)
+
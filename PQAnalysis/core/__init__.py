@@ -1,7 +1,7 @@
 from .exceptions import ElementNotFoundError, AtomicSystemPositionsError, AtomicSystemMassError
-from .atom import Atom
+from .atom import Atom, resolve_elements
 from .cell import Cell
-from .atomicSystem import AtomicSystem
+from .atomicSystem import AtomicSystem, AtomicSystemView
 
 from beartype.vale import Is
 from typing import Annotated
@@ -25,16 +25,23 @@ Functions
 guess_element
     Guesses the symbol, atomic number and mass of an atom from its name or
     atomic number.
+resolve_elements
+    Maps an array of element names to element codes, i.e. indices into the
+    periodic table arrays element_symbols, element_numbers, element_masses
+    and element_covalent_radii.
 
 """
 
 from __future__ import annotations
 
+import numpy as np
+
 from multimethod import multimethod
-from beartype.typing import Any, Tuple
+from beartype.typing import Any, Tuple, List
 from numbers import Real
 
 from . import ElementNotFoundError
+from ..types import Np1DIntArray
 
 
 def is_same_element_type(atom1: Atom, atom2: Atom) -> bool:
@@ -81,21 +88,57 @@ def guess_element(id: int | str) -> Tuple[str, int, Real]:
         If the given identifier is not a valid element identifier.
     """
     if isinstance(id, int):
-        try:
-            index = list(atomicNumbers.values()).index(id)
-            symbol = list(atomicNumbers)[index]
-            mass = atomicMasses[symbol]
-            return symbol, id, mass
-        except Exception:
-            raise ElementNotFoundError(id)
-    elif isinstance(id, str):
-        try:
-            symbol = id.lower()
-            atomic_number = atomicNumbers[symbol]
-            mass = atomicMasses[symbol]
-            return symbol, atomic_number, mass
-        except Exception:
-            raise ElementNotFoundError(id)
+        code = _element_codes_by_number.get(id)
+    else:
+        code = _element_codes_by_symbol.get(id.lower())
+
+    if code is None:
+        raise ElementNotFoundError(id)
+
+    return str(element_symbols[code]), int(element_numbers[code]), float(element_masses[code])
+
+
+def resolve_elements(names: List[str] | np.ndarray, strict: bool = True) -> Np1DIntArray:
+    """
+    Maps element names to element codes in one vectorized call.
+
+    The element code is the index of the element in the periodic table arrays
+    element_symbols, element_numbers, element_masses and element_covalent_radii,
+    so that e.g. the masses of all atoms are obtained by element_masses[codes].
+    Each distinct name is looked up only once, independent of the number of atoms.
+
+    Parameters
+    ----------
+    names : List[str] | np.ndarray
+        The element names (case insensitive, e.g. ['C', 'H', 'h']).
+    strict : bool, optional
+        If True, an ElementNotFoundError is raised for unknown names. If False,
+        unknown names are mapped to -1, by default True
+
+    Returns
+    -------
+    Np1DIntArray
+        The element codes of the given names.
+
+    Raises
+    ------
+    ElementNotFoundError
+        If strict is True and a name is not a valid element identifier.
+    """
+    names = np.asarray(names, dtype=str)
+
+    if names.size == 0:
+        return np.zeros(0, dtype=np.int64)
+
+    unique_names, inverse = np.unique(names, return_inverse=True)
+
+    unique_codes = np.array([_element_codes_by_symbol.get(name.lower(), -1)
+                            for name in unique_names], dtype=np.int64)
+
+    if strict and np.any(unique_codes < 0):
+        raise ElementNotFoundError(unique_names[unique_codes < 0][0])
+
+    return unique_codes[inverse.reshape(-1)]
 
 
 class Atom:
@@ -342,3 +385,43 @@ atomicNumbers = {"h":     1,  "d":     1,  "t":    1,
                  "bk":   97,  "cf":   98,  "es":  99,
                  "fm":  100,  "md":  101,  "no": 102,
                  "q":   999,   "x":  999,   "cav": 1000, "sup": 1000000, "dum": 1}
+
+# covalent radii in Angstrom (B. Cordero et al., Dalton Trans., 2008, 2832-2838)
+# elements without a tabulated radius and pseudo atoms are set to nan
+covalentRadii = {"h":  0.31, "d":  0.31, "t":  0.31, "he": 0.28, "li": 1.28,
+                 "be": 0.96, "b":  0.84, "c":  0.76, "n":  0.71, "o":  0.66,
+                 "f":  0.57, "ne": 0.58, "na": 1.66, "mg": 1.41, "al": 1.21,
+                 "si": 1.11, "p":  1.07, "s":  1.05, "cl": 1.02, "ar": 1.06,
+                 "k":  2.03, "ca": 1.76, "sc": 1.70, "ti": 1.60, "v":  1.53,
+                 "cr": 1.39, "mn": 1.39, "fe": 1.32, "co": 1.26, "ni": 1.24,
+                 "cu": 1.32, "zn": 1.22, "ga": 1.22, "ge": 1.20, "as": 1.19,
+                 "se": 1.20, "br": 1.20, "kr": 1.16, "rb": 2.20, "sr": 1.95,
+                 "y":  1.90, "zr": 1.75, "nb": 1.64, "mo": 1.54, "tc": 1.47,
+                 "ru": 1.46, "rh": 1.42, "pd": 1.39, "ag": 1.45, "cd": 1.44,
+                 "in": 1.42, "sn": 1.39, "sb": 1.39, "te": 1.38, "i":  1.39,
+                 "xe": 1.40, "cs": 2.44, "ba": 2.15, "la": 2.07, "ce": 2.04,
+                 "pr": 2.03, "nd": 2.01, "pm": 1.99, "sm": 1.98, "eu": 1.98,
+                 "gd": 1.96, "tb": 1.94, "dy": 1.92, "ho": 1.92, "er": 1.89,
+                 "tm": 1.90, "yb": 1.87, "lu": 1.87, "hf": 1.75, "ta": 1.70,
+                 "w":  1.62, "re": 1.51, "os": 1.44, "ir": 1.41, "pt": 1.36,
+                 "au": 1.36, "hg": 1.32, "tl": 1.45, "pb": 1.46, "bi": 1.48,
+                 "po": 1.40, "at": 1.50, "rn": 1.50, "fr": 2.60, "ra": 2.21,
+                 "ac": 2.15, "th": 2.06, "pa": 2.00, "u":  1.96, "np": 1.90,
+                 "pu": 1.87, "am": 1.80, "cm": 1.69}
+
+# periodic table as arrays indexed by the element code (see resolve_elements)
+element_symbols = np.array(list(atomicNumbers))
+element_numbers = np.array([atomicNumbers[symbol]
+                           for symbol in element_symbols], dtype=np.int64)
+element_masses = np.array([atomicMasses[symbol]
+                          for symbol in element_symbols], dtype=np.float64)
+element_covalent_radii = np.array([covalentRadii.get(symbol, np.nan)
+                                   for symbol in element_symbols], dtype=np.float64)
+
+_element_codes_by_symbol = {str(symbol): code
+                            for code, symbol in enumerate(element_symbols)}
+
+# the first symbol of an atomic number wins (e.g. 1 -> 'h' and not 'd')
+_element_codes_by_number = {}
+for _code, _number in enumerate(element_numbers):
+    _element_codes_by_number.setdefault(int(_number), _code)
@@ -1 +1 @@
-from .atomicSystem import AtomicSystem
+from .atomicSystem import AtomicSystem, AtomicSystemView
@@ -14,7 +14,7 @@ import numpy as np
 from beartype.typing import List
 from beartype.door import is_bearable
 
-from ..atom import Atom, is_same_element_type
+from ..atom import Atom
 from ...types import Np1DIntArray
 
 
@@ -122,9 +122,13 @@ class _IndexingMixin:
         Np1DIntArray
             The indices of the atoms with the given element types.
         """
+        # atoms without element information are marked with -1, so that they
+        # only match elements without element information (as in is_same_element_type)
+        atomic_numbers = np.fromiter((-1 if atom.atomic_number is None else atom.atomic_number
+                                      for atom in self.atoms), dtype=np.int64, count=len(self.atoms))
+
         indices = []
         for element in elements:
-            bool_indices = np.array(
-                [is_same_element_type(atom, element) for atom in self.atoms])
-            indices.append(np.argwhere(bool_indices).flatten())
+            atomic_number = -1 if element.atomic_number is None else element.atomic_number
+            indices.append(np.flatnonzero(atomic_numbers == atomic_number))
         return np.sort(np.concatenate(indices))
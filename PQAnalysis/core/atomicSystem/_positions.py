@@ -13,12 +13,15 @@ import numpy as np
 
 from multimethod import multimethod
 from beartype.typing import List, Tuple
+from numbers import Real
 from beartype.door import is_bearable
 
 from ._decorators import check_atoms_pos
 
 from ..atom import Atom
-from ...types import Np2DIntArray, Np2DNumberArray, Np1DIntArray
+from ..cell import Cell
+from ... import kernels
+from ...types import Np2DIntArray, Np2DNumberArray, Np1DIntArray, Np1DNumberArray
 
 
 class _PositionsMixin:
@@ -55,20 +58,24 @@ class _PositionsMixin:
         nearest_neighbours = []
         nearest_neighbours_distances = []
 
-        for atom_position in self.pos[indices]:
-            delta_pos = self.pos - atom_position
+        # the distance matrix is evaluated in blocks of rows to limit the memory
+        block_size = max(1, (1 << 22) // max(self.n_atoms, 1))
 
-            delta_pos = self.cell.image(delta_pos)
+        for start in range(0, len(indices), block_size):
+            distances = kernels.distances(self.pos[indices[start:start + block_size]],
+                                          self.pos,
+                                          self.cell.box_matrix)
 
-            distances = np.linalg.norm(delta_pos, axis=1)
+            nearest_neighbours_block = np.argsort(distances, axis=1)[:, 1:n+1]
 
-            nearest_neighbours_atom = np.argsort(distances)[1:n+1]
-
-            nearest_neighbours.append(nearest_neighbours_atom)
+            nearest_neighbours.append(nearest_neighbours_block)
             nearest_neighbours_distances.append(
-                distances[nearest_neighbours_atom])
+                np.take_along_axis(distances, nearest_neighbours_block, axis=1))
+
+        if len(nearest_neighbours) == 0:
+            return np.zeros((0, n), dtype=int), np.zeros((0, n))
 
-        return np.array(nearest_neighbours), np.array(nearest_neighbours_distances)
+        return np.concatenate(nearest_neighbours), np.concatenate(nearest_neighbours_distances)
 
     def nearest_neighbours(self,
                            n: int = 1,
@@ -107,3 +114,67 @@ class _PositionsMixin:
         indices = self.indices_from_atoms(atoms, use_full_atom_info)
 
         return self._nearest_neighbours(n=n, indices=indices)
+
+    @check_atoms_pos
+    def distance_histogram(self,
+                           r_max: Real,
+                           n_bins: int,
+                           atoms1: List[Atom] | List[str] | Np1DIntArray | None = None,
+                           atoms2: List[Atom] | List[str] | Np1DIntArray | None = None,
+                           r_min: Real = 0.0,
+                           use_full_atom_info: bool = False,
+                           cell: Cell | None = None
+                           ) -> Np1DNumberArray:
+        """
+        Returns the histogram of the minimum image distances between two selections of atoms.
+
+        The selections are specified as in nearest_neighbours. If atoms2 is None, the distances
+        of all unique pairs within the first selection are binned. Otherwise all pairs between
+        the two selections are binned, except for pairs of an atom with itself.
+
+        The histogram is computed by PQAnalysis.kernels.distance_histogram, which uses a cell
+        list if the cell is large enough compared to r_max.
+
+        Parameters
+        ----------
+        r_max : Real
+            The upper (exclusive) limit of the histogram.
+        n_bins : int
+            The number of bins.
+        atoms1 : List[Atom] | List[str] | Np1DIntArray | None, optional
+            The first selection, by default None (all atoms)
+        atoms2 : List[Atom] | List[str] | Np1DIntArray | None, optional
+            The second selection, by default None (same as the first selection)
+        r_min : Real, optional
+            The lower limit of the histogram, by default 0.0
+        use_full_atom_info : bool, optional
+            If the full atom object should be used to match the atoms, by default False
+        cell : Cell | None, optional
+            The cell used for the periodic boundary conditions, by default None (cell of the system)
+
+        Returns
+        -------
+        Np1DNumberArray
+            The number of pairs in each bin as float64 array of shape (n_bins,).
+        """
+        if cell is None:
+            cell = self.cell
+
+        box_matrix = cell.box_matrix if cell != Cell() else None
+
+        indices1 = self.indices_from_atoms(atoms1, use_full_atom_info)
+
+        if atoms2 is None:
+            return kernels.distance_histogram(self.pos[indices1], None, r_max, n_bins,
+                                              box_matrix, r_min=r_min)
+
+        indices2 = self.indices_from_atoms(atoms2, use_full_atom_info)
+
+        histogram = kernels.distance_histogram(self.pos[indices1], self.pos[indices2], r_max, n_bins,
+                                               box_matrix, r_min=r_min)
+
+        # atoms contained in both selections are paired with themselves at zero distance
+        if r_min <= 0.0:
+            histogram[0] -= len(np.intersect1d(indices1, indices2))
+
+        return histogram
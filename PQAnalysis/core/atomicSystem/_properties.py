@@ -90,7 +90,10 @@ class _PropertiesMixin:
         if self.n_atoms == 0:
             return np.zeros(3)
 
-        pos = self.cell.image(self.pos - self.pos[0]) + self.pos[0]
+        # accumulate in float64 also for float32 positions
+        pos = np.asarray(self.pos, dtype=np.float64)
+
+        pos = self.cell.image(pos - pos[0]) + pos[0]
 
         pos = np.sum(
             pos * self.atomic_masses[:, None], axis=0) / self.mass
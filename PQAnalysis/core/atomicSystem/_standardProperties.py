@@ -9,6 +9,8 @@ _StandardPropertiesMixin
     A mixin class containing the standard properties of an atomic system (i.e. standard getter and setter methods).
 """
 
+import numpy as np
+
 from beartype.typing import List
 
 from ..atom import Atom
@@ -80,6 +82,24 @@ class _StandardPropertiesMixin:
         """
         return self._charges
 
+    @property
+    def dtype(self) -> np.dtype:
+        """
+        Returns the floating point type of the positions, velocities, forces and charges of the system.
+
+        The arrays of the system created with a dtype all have this type. Otherwise, the
+        common type of the non-empty arrays is returned, e.g. float32 for a system with
+        float32 velocities only.
+
+        Returns
+        -------
+        np.dtype
+            The floating point type of the arrays of the system.
+        """
+        arrays = [array for array in (self._pos, self._vel, self._forces, self._charges) if np.size(array) > 0]
+
+        return np.result_type(*arrays) if len(arrays) > 0 else self._pos.dtype
+
     @property
     def cell(self) -> Cell:
         """
@@ -7,6 +7,8 @@ Classes
 -------
 AtomicSystem
     A class for storing atomic systems.
+AtomicSystemView
+    A lightweight view on an index selection of an AtomicSystem.
 """
 
 from __future__ import annotations
@@ -43,7 +45,8 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
                  vel: Np2DNumberArray | None = None,
                  forces: Np2DNumberArray | None = None,
                  charges: Np1DNumberArray | None = None,
-                 cell: Cell = Cell()
+                 cell: Cell = Cell(),
+                 dtype: type | np.dtype | None = None
                  ) -> None:
         """
         Initializes the AtomicSystem with the given parameters.
@@ -62,6 +65,10 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
             A 1d numpy.ndarray containing the charges of the atoms, by default np.zeros(0).
         cell : Cell, optional
             The unit cell of the system. Defaults to a Cell with no periodic boundary conditions, by default Cell()
+        dtype : type | np.dtype | None, optional
+            The floating point type of pos, vel, forces and charges. If None, the arrays are stored as given
+            (the default arrays are float64), by default None. With np.float32 the memory of the system is halved,
+            while accumulations like the center of mass are still performed in float64.
         """
         if atoms is None:
             atoms = []
@@ -78,6 +85,12 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
         if charges is None:
             charges = np.zeros(0)
 
+        if dtype is not None:
+            pos = np.asarray(pos, dtype=dtype)
+            vel = np.asarray(vel, dtype=dtype)
+            forces = np.asarray(forces, dtype=dtype)
+            charges = np.asarray(charges, dtype=dtype)
+
         self._atoms = atoms
         self._pos = pos
         self._vel = vel
@@ -131,6 +144,30 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
 
         return is_equal
 
+    def astype(self, dtype: type | np.dtype) -> AtomicSystem:
+        """
+        Returns a new AtomicSystem with pos, vel, forces and charges converted to the given floating point type.
+
+        The atoms list and the cell are shared with the original AtomicSystem.
+
+        Parameters
+        ----------
+        dtype : type | np.dtype
+            The floating point type of the new arrays.
+
+        Returns
+        -------
+        AtomicSystem
+            The new AtomicSystem with the converted arrays.
+        """
+        return AtomicSystem(atoms=self.atoms,
+                            pos=self.pos,
+                            vel=self.vel,
+                            forces=self.forces,
+                            charges=self.charges,
+                            cell=self.cell,
+                            dtype=dtype)
+
     # TODO: add possibility to index with atom list etc... similar to nearest neighbours
     @multimethod
     def __getitem__(self, key: Atom) -> AtomicSystem:
@@ -156,6 +193,12 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
         """
         Returns a new AtomicSystem with the given key.
 
+        For int and slice keys (and index arrays forming a regular progression, e.g. np.arange(2, 10, 2))
+        the arrays of the new AtomicSystem are NumPy views on the arrays of this AtomicSystem - no data is
+        copied. Therefore, in-place modifications of the arrays of the new AtomicSystem are also visible in
+        this AtomicSystem. For all other index arrays an AtomicSystemView is returned, which copies the
+        selected entries from this AtomicSystem on the first access of the corresponding attribute.
+
         Parameters
         ----------
         key : int | slice | Np1DIntArray
@@ -165,38 +208,256 @@ class AtomicSystem(_PropertiesMixin, _StandardPropertiesMixin, _IndexingMixin, _
         -------
         AtomicSystem
             The new AtomicSystem with the given key.
+
+        Raises
+        ------
+        IndexError
+            If an index is out of bounds.
         """
+        n_entries = self._n_entries
 
         if isinstance(key, int):
-            keys = np.array([key])
-        elif isinstance(key, slice):
-            keys = np.array(range(self.n_atoms)[key])
-        else:
-            keys = np.array(key)
-
-        if self.atoms != []:
-            atoms = [self.atoms[key] for key in keys]
-        else:
-            atoms = None
-
-        if np.shape(self.pos)[0] > 0:
-            pos = self.pos[keys]
-        else:
-            pos = None
-
-        if np.shape(self.vel)[0] > 0:
-            vel = self.vel[keys]
-        else:
-            vel = None
-
-        if np.shape(self.forces)[0] > 0:
-            forces = self.forces[keys]
-        else:
-            forces = None
-
-        if np.shape(self.charges)[0] > 0:
-            charges = self.charges[keys]
-        else:
-            charges = None
-
-        return AtomicSystem(atoms=atoms, pos=pos, vel=vel, forces=forces, charges=charges, cell=self.cell)
+            if key >= n_entries or key < -n_entries:
+                raise IndexError(
+                    f"index {key} is out of bounds for axis 0 with size {n_entries}")
+
+            key = key % n_entries
+            key = slice(key, key + 1)
+
+        elif not isinstance(key, slice):
+            keys = _normalize_indices(np.asarray(key), n_entries)
+            key = _indices_to_slice(keys)
+
+            if key is None:
+                return AtomicSystemView(self, keys)
+
+        return AtomicSystem(atoms=self.atoms[key] if self.atoms != [] else None,
+                            pos=self.pos[key] if np.shape(self.pos)[0] > 0 else None,
+                            vel=self.vel[key] if np.shape(self.vel)[0] > 0 else None,
+                            forces=self.forces[key] if np.shape(self.forces)[0] > 0 else None,
+                            charges=self.charges[key] if np.shape(self.charges)[0] > 0 else None,
+                            cell=self.cell)
+
+    @property
+    def _n_entries(self) -> int:
+        """
+        The length of the longest per atom attribute.
+
+        Usually this is equal to n_atoms, but an AtomicSystem can also be
+        constructed without atoms (e.g. only with positions).
+
+        Returns
+        -------
+        int
+            The number of entries which can be indexed.
+        """
+        return max(len(self._atoms), np.shape(self._pos)[0], np.shape(self._vel)[0],
+                   np.shape(self._forces)[0], np.shape(self._charges)[0])
+
+
+class _ParentAttribute:
+    """
+    A descriptor gathering the selected entries of an attribute of the parent of an AtomicSystemView.
+
+    The entries are gathered on the first access and cached on the view, assignments
+    replace the cached value. The empty defaults stored by the initializer of AtomicSystem
+    are discarded, as a view holds no data of its own until it is accessed.
+    """
+
+    def __set_name__(self, owner: type, name: str) -> None:
+        self.name = name.lstrip("_")
+
+    def __get__(self, view: AtomicSystemView | None, owner: type) -> Any:
+        if view is None:
+            return self
+
+        if self.name not in view._gathered:
+            view._gathered[self.name] = view._gather(self.name)
+
+        return view._gathered[self.name]
+
+    def __set__(self, view: AtomicSystemView, value: Any) -> None:
+        if "_gathered" in view.__dict__:
+            view._gathered[self.name] = value
+
+
+class AtomicSystemView(AtomicSystem):
+    """
+    A lightweight view on an index selection of an AtomicSystem.
+
+    Only the parent AtomicSystem and the selected indices are stored on creation. The atoms,
+    positions, velocities, forces and charges of the selection are copied from the parent
+    on their first access and cached on the view, so that attributes which are never used
+    are never copied. From then on the view owns the copied data: in-place modifications
+    of it are kept by the view and do not modify the parent, and modifications of the parent
+    are no longer reflected in it. The cell is not shared, the view is initialized with the
+    cell of the parent.
+
+    Views of views are collapsed, so that a view always refers to an AtomicSystem holding the data.
+
+    ...
+
+    Attributes
+    ----------
+    parent : AtomicSystem
+        The AtomicSystem the view refers to.
+    indices : Np1DIntArray
+        The (non-negative) indices of the selected atoms in the parent.
+    """
+
+    def __init__(self, parent: AtomicSystem, indices: Np1DIntArray) -> None:
+        """
+        Initializes the AtomicSystemView with the given parent and indices.
+
+        Parameters
+        ----------
+        parent : AtomicSystem
+            The AtomicSystem to create the view of.
+        indices : Np1DIntArray
+            The indices of the selected atoms in the parent.
+        """
+        if isinstance(parent, AtomicSystemView):
+            indices = parent.indices[indices]
+            parent = parent.parent
+
+        super().__init__(cell=parent.cell)
+
+        self.parent = parent
+        self.indices = indices
+        self._gathered = {}
+
+    def copy(self) -> AtomicSystem:
+        """
+        Materializes the view into an independent AtomicSystem.
+
+        Returns
+        -------
+        AtomicSystem
+            A new AtomicSystem containing copies of all selected data.
+        """
+        return AtomicSystem(atoms=list(self._atoms),
+                            pos=self._pos.copy(),
+                            vel=self._vel.copy(),
+                            forces=self._forces.copy(),
+                            charges=self._charges.copy(),
+                            cell=self.cell)
+
+    def _gather(self, name: str) -> Any:
+        """
+        Gathers the selected entries of the given attribute of the parent.
+
+        Parameters
+        ----------
+        name : str
+            The name of the attribute (atoms, pos, vel, forces or charges).
+
+        Returns
+        -------
+        Any
+            The selected entries of the attribute.
+        """
+        value = getattr(self.parent, name)
+
+        if len(value) == 0:
+            return value
+
+        if name == "atoms":
+            return [value[index] for index in self.indices]
+
+        return value[self.indices]
+
+    _atoms = _ParentAttribute()
+    _pos = _ParentAttribute()
+    _vel = _ParentAttribute()
+    _forces = _ParentAttribute()
+    _charges = _ParentAttribute()
+
+    @property
+    def n_atoms(self) -> int:
+        """
+        Returns the number of atoms in the view without gathering the atoms.
+
+        Returns
+        -------
+        int
+            The number of atoms in the view.
+        """
+        if "atoms" in self._gathered:
+            return len(self._gathered["atoms"])
+
+        if len(self.parent.atoms) == 0:
+            return 0
+
+        return len(self.indices)
+
+    @property
+    def dtype(self) -> np.dtype:
+        """
+        Returns the floating point type of the arrays of the parent without gathering them.
+
+        Returns
+        -------
+        np.dtype
+            The floating point type of the arrays of the system.
+        """
+        return self.parent.dtype
+
+
+def _normalize_indices(indices: Np1DIntArray, n_entries: int) -> Np1DIntArray:
+    """
+    Converts negative indices to non-negative ones and checks the bounds.
+
+    Parameters
+    ----------
+    indices : Np1DIntArray
+        The indices to normalize.
+    n_entries : int
+        The number of entries which can be indexed.
+
+    Returns
+    -------
+    Np1DIntArray
+        The non-negative indices.
+
+    Raises
+    ------
+    IndexError
+        If an index is out of bounds.
+    """
+    indices = indices.astype(np.int64, copy=False)
+
+    out_of_bounds = (indices >= n_entries) | (indices < -n_entries)
+    if np.any(out_of_bounds):
+        raise IndexError(
+            f"index {indices[out_of_bounds][0]} is out of bounds for axis 0 with size {n_entries}")
+
+    return np.where(indices < 0, indices + n_entries, indices)
+
+
+def _indices_to_slice(indices: Np1DIntArray) -> slice | None:
+    """
+    Converts an index array forming a regular increasing progression into an equivalent slice.
+
+    Parameters
+    ----------
+    indices : Np1DIntArray
+        The non-negative indices.
+
+    Returns
+    -------
+    slice | None
+        The equivalent slice or None if the indices do not form a regular increasing progression.
+    """
+    if len(indices) == 0:
+        return slice(0, 0)
+
+    if len(indices) == 1:
+        return slice(int(indices[0]), int(indices[0]) + 1)
+
+    steps = np.diff(indices)
+    step = int(steps[0])
+
+    if step <= 0 or np.any(steps != step):
+        return None
+
+    return slice(int(indices[0]), int(indices[-1]) + 1, step)
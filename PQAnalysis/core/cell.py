@@ -18,6 +18,7 @@ from beartype.typing import Any
 from numbers import Real
 
 from ..types import Np3x3NumberArray, Np2DNumberArray, Np1DNumberArray
+from ..kernels import minimum_image
 
 
 class Cell:
@@ -166,6 +167,8 @@ class Cell:
         """
         Returns the image of the given position in the unit cell.
 
+        All positions are imaged at once by the minimum image kernel of PQAnalysis.kernels.
+
         Parameters
         ----------
         pos : Np2DNumberArray, Np1DNumberArray
@@ -179,16 +182,7 @@ class Cell:
 
         original_shape = np.shape(pos)
 
-        if original_shape == (3,):
-            pos = np.reshape(pos, (1, 3))
-
-        fractional_pos = np.array(
-            [np.linalg.inv(self.box_matrix) @ pos_i for pos_i in pos])
-
-        fractional_pos -= np.round(fractional_pos)
-
-        pos = np.array(
-            [self.box_matrix @ fractional_pos_i for fractional_pos_i in fractional_pos])
+        pos = minimum_image(np.reshape(pos, (-1, 3)), self.box_matrix)
 
         return np.reshape(pos, original_shape)
 
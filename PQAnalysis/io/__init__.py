@@ -4,10 +4,14 @@ from .exceptions import MoldescriptorReaderError
 from .exceptions import RestartFileReaderError
 from .exceptions import RestartFileWriterError
 from .exceptions import TrajectoryReaderError
+from .exceptions import TrajectoryIndexError
 
 
 from .base import BaseReader, BaseWriter
+from .frameBufferRing import FrameBufferRing
 from .frameReader import FrameReader
+from .trajectoryIndex import TrajectoryIndex
+from .frameBlockReader import FrameBlockReader
 from .moldescriptorReader import MoldescriptorReader
 from .restartWriter import RestartFileWriter
 from .restartReader import RestartFileReader
@@ -17,6 +17,8 @@ RestartFileWriterError
     Exception raised for errors related to the RestartFileWriter class
 TrajectoryReaderError
     Exception raised for errors related to the TrajectoryReader class
+TrajectoryIndexError
+    Exception raised for errors related to the TrajectoryIndex class
 """
 
 from ..exceptions import PQException
@@ -80,3 +82,13 @@ class TrajectoryReaderError(PQException):
     def __init__(self, message: str) -> None:
         self.message = message
         super().__init__(self.message)
+
+
+class TrajectoryIndexError(PQException):
+    """
+    Exception raised for errors related to the TrajectoryIndex class
+    """
+
+    def __init__(self, message: str) -> None:
+        self.message = message
+        super().__init__(self.message)
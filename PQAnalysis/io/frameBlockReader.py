@@ -0,0 +1,231 @@
+"""
+A module containing a read-ahead reader splitting trajectory files into frames.
+
+...
+
+Classes
+-------
+FrameBlockReader
+    A class for reading the frames of a trajectory file as bytes with a read-ahead thread.
+"""
+
+import queue
+import threading
+
+import numpy as np
+
+from beartype.typing import Generator, List, Tuple
+
+from . import TrajectoryReaderError
+
+
+class FrameBlockReader:
+    """
+    A class for reading the frames of a trajectory file as bytes with a read-ahead thread.
+
+    The file is read in large binary blocks by a background thread, which stays up to
+    `prefetch` blocks ahead of the consumer. Thereby, the latency of the disk (or of a
+    network file system) overlaps with the parsing of the already read frames.
+
+    The frame boundaries are found directly in the byte buffer: all line breaks of a
+    block are located at once with NumPy and a frame consists of its header line, the
+    comment line and as many atom lines as given in the header line. Blank lines between
+    frames are skipped, as in TrajectoryIndex. The bytes of an incomplete frame are kept
+    as list of blocks until the blocks contain enough line breaks to complete it, so that
+    frames larger than a block are joined and scanned only once.
+
+    ...
+
+    Attributes
+    ----------
+    filename : str
+        The name of the file to read from.
+    block_size : int
+        The number of bytes read at once.
+    prefetch : int
+        The maximum number of blocks read ahead of the consumer.
+    """
+
+    def __init__(self, filename: str, block_size: int = 1 << 24, prefetch: int = 2) -> None:
+        """
+        Initializes the FrameBlockReader with the given parameters.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file to read from.
+        block_size : int, optional
+            The number of bytes read at once, by default 16 MiB
+        prefetch : int, optional
+            The maximum number of blocks read ahead of the consumer, by default 2
+
+        Raises
+        ------
+        ValueError
+            If block_size or prefetch is smaller than 1.
+        """
+        if block_size < 1 or prefetch < 1:
+            raise ValueError("block_size and prefetch have to be at least 1.")
+
+        self.filename = filename
+        self.block_size = block_size
+        self.prefetch = prefetch
+
+    def __iter__(self) -> Generator[bytes, None, None]:
+        """
+        Yields the bytes of each frame of the file.
+
+        The last frame is yielded as it is, even if it is incomplete, so that the
+        error is raised by the parser of the frame.
+
+        Yields
+        ------
+        bytes
+            The bytes of one frame including its line breaks.
+
+        Raises
+        ------
+        TrajectoryReaderError
+            If the first entry of a header line is not an integer.
+        """
+        blocks = queue.Queue(maxsize=self.prefetch)
+        stop = threading.Event()
+
+        thread = threading.Thread(
+            target=self._read_blocks, args=(blocks, stop), daemon=True)
+        thread.start()
+
+        try:
+            # the bytes of the incomplete frame and the line breaks needed to complete it
+            pending = []
+            n_missing = 1
+
+            while True:
+                block = blocks.get()
+
+                if isinstance(block, BaseException):
+                    raise block
+
+                if block is None:
+                    break
+
+                pending.append(block)
+                n_missing -= block.count(b'\n')
+
+                if n_missing <= 0:
+                    frames, remainder, n_missing = self._split_frames(b''.join(pending))
+                    pending = [remainder]
+                    yield from frames
+
+            remainder = b''.join(pending)
+
+            if remainder.strip() != b'':
+                if not remainder.endswith(b'\n'):
+                    remainder += b'\n'
+
+                frames, remainder, _ = self._split_frames(remainder)
+                yield from frames
+
+                if remainder.strip() != b'':
+                    yield remainder
+        finally:
+            stop.set()
+            thread.join()
+
+    def _read_blocks(self, blocks: queue.Queue, stop: threading.Event) -> None:
+        """
+        Reads the file block by block into the queue (executed by the read-ahead thread).
+
+        The end of the file is marked with None. Exceptions are passed to the consumer
+        through the queue.
+
+        Parameters
+        ----------
+        blocks : queue.Queue
+            The queue the read blocks are put into.
+        stop : threading.Event
+            Set by the consumer if no further blocks are needed.
+        """
+        def put(item) -> bool:
+            while not stop.is_set():
+                try:
+                    blocks.put(item, timeout=0.1)
+                    return True
+                except queue.Full:
+                    continue
+
+            return False
+
+        try:
+            with open(self.filename, 'rb') as file:
+                while True:
+                    block = file.read(self.block_size)
+
+                    if len(block) == 0:
+                        break
+
+                    if not put(block):
+                        return
+
+            put(None)
+        except Exception as exception:
+            put(exception)
+
+    @staticmethod
+    def _split_frames(buffer: bytes) -> Tuple[List[bytes], bytes, int]:
+        """
+        Splits the buffer into complete frames and the remaining bytes.
+
+        Parameters
+        ----------
+        buffer : bytes
+            The buffer to split.
+
+        Returns
+        -------
+        frames : List[bytes]
+            The complete frames of the buffer.
+        remainder : bytes
+            The bytes after the last complete frame.
+        n_missing : int
+            The number of line breaks missing in the remainder to complete its frame.
+
+        Raises
+        ------
+        TrajectoryReaderError
+            If the first entry of a header line is not an integer.
+        """
+        line_ends = np.flatnonzero(
+            np.frombuffer(buffer, dtype=np.uint8) == ord('\n'))
+        n_lines = len(line_ends)
+
+        frames = []
+        start = 0
+        line = 0
+        while line < n_lines:
+            header = buffer[start:line_ends[line]].split(maxsplit=1)
+
+            # blank lines between frames are skipped
+            if len(header) == 0:
+                start = int(line_ends[line]) + 1
+                line += 1
+                continue
+
+            try:
+                n_atoms = int(header[0])
+            except ValueError:
+                raise TrajectoryReaderError(
+                    f"Invalid header line of frame: '{buffer[start:line_ends[line]].decode()}'.")
+
+            last_line = line + n_atoms + 1
+            if last_line >= n_lines:
+                return frames, buffer[start:], last_line - n_lines + 1
+
+            end = int(line_ends[last_line]) + 1
+            frames.append(buffer[start:end])
+
+            start = end
+            line = last_line + 1
+
+        # at least the line break of the next header line is missing
+        return frames, buffer[start:], 1
@@ -0,0 +1,83 @@
+"""
+A module containing a ring of reusable per-frame buffers.
+
+...
+
+Classes
+-------
+FrameBufferRing
+    A ring of preallocated arrays for streaming frame readers.
+"""
+
+import numpy as np
+
+from beartype.typing import Tuple
+
+
+class FrameBufferRing:
+    """
+    A ring of preallocated arrays for streaming frame readers.
+
+    Every call of next() returns an array of the next buffer of the ring. After n_buffers
+    calls the first buffer is handed out (and overwritten by the reader) again. Hence, an
+    array returned by next() stays valid until n_buffers further arrays have been requested.
+    A buffer only grows if a larger array is requested, so that a stream of frames with
+    the same number of atoms does not allocate any array after the first n_buffers frames.
+
+    ...
+
+    Attributes
+    ----------
+    n_buffers : int
+        The number of buffers in the ring.
+    dtype : np.dtype
+        The floating point type of the buffers.
+    """
+
+    def __init__(self, n_buffers: int, dtype: type | np.dtype = np.float64) -> None:
+        """
+        Initializes the FrameBufferRing with n_buffers empty buffers.
+
+        Parameters
+        ----------
+        n_buffers : int
+            The number of buffers in the ring, i.e. the number of frames a returned array stays valid.
+        dtype : type | np.dtype, optional
+            The floating point type of the buffers, by default np.float64
+
+        Raises
+        ------
+        ValueError
+            If n_buffers is smaller than 1.
+        """
+        if n_buffers < 1:
+            raise ValueError("n_buffers has to be at least 1.")
+
+        self.n_buffers = n_buffers
+        self.dtype = np.dtype(dtype)
+
+        self._buffers = [np.empty(0, dtype=self.dtype) for _ in range(n_buffers)]
+        self._current = -1
+
+    def next(self, shape: int | Tuple[int, ...]) -> np.ndarray:
+        """
+        Returns an uninitialized array of the given shape stored in the next buffer of the ring.
+
+        Parameters
+        ----------
+        shape : int | Tuple[int, ...]
+            The shape of the requested array.
+
+        Returns
+        -------
+        np.ndarray
+            A view on the next buffer with the given shape.
+        """
+        size = int(np.prod(shape))
+
+        self._current = (self._current + 1) % self.n_buffers
+
+        if self._buffers[self._current].size < size:
+            self._buffers[self._current] = np.empty(size, dtype=self.dtype)
+
+        return self._buffers[self._current][:size].reshape(shape)
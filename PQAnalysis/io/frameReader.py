@@ -16,6 +16,7 @@ import numpy as np
 from beartype.typing import List, Tuple
 
 from . import FrameReaderError
+from .frameBufferRing import FrameBufferRing
 from ..core import AtomicSystem, Atom, Cell, ElementNotFoundError
 from ..types import Np2DNumberArray, Np1DNumberArray
 from ..traj import Frame, TrajectoryFormat
@@ -24,8 +25,46 @@ from ..traj import Frame, TrajectoryFormat
 class FrameReader:
     """
     FrameReader reads a frame from a string.
+
+    ...
+
+    Attributes
+    ----------
+    dtype : np.dtype
+        The floating point type of the arrays created for the positions, velocities,
+        forces and charges. Default is np.float64.
+    buffers : FrameBufferRing | None
+        The ring of reused arrays if the reader was created with n_buffers > 0, otherwise None.
     """
 
+    def __init__(self, dtype: type | np.dtype = np.float64, n_buffers: int = 0) -> None:
+        """
+        Initializes the FrameReader with the given floating point type.
+
+        Using np.float32 halves the memory of the read frames. As the values in the
+        trajectory files are usually given with at most 6-8 significant digits no
+        information is lost for most applications.
+
+        With n_buffers > 0 the reader does not allocate new arrays for each frame, but
+        fills the arrays of a FrameBufferRing with n_buffers buffers. The arrays of a
+        read frame are then only valid until n_buffers further frames have been read.
+        Additionally, the list of Atom objects is shared with the previous frame if
+        the atom names did not change. This mode is meant for streaming, where each
+        frame is reduced before the next ones are read.
+
+        Parameters
+        ----------
+        dtype : type | np.dtype, optional
+            The floating point type of the read arrays, by default np.float64
+        n_buffers : int, optional
+            The number of reused frame buffers, by default 0 (new arrays for every frame)
+        """
+        self.dtype = np.dtype(dtype)
+        self.buffers = FrameBufferRing(n_buffers, self.dtype) if n_buffers > 0 else None
+
+        self._cached_names = None
+        self._cached_atoms = None
+
     def read(self, frame_string: str, format: TrajectoryFormat | str = TrajectoryFormat.XYZ) -> Frame:
         """
         Reads a frame from a string.
@@ -81,12 +120,9 @@ class FrameReader:
 
         xyz, atoms = self._read_xyz(splitted_frame_string, n_atoms)
 
-        try:
-            atoms = [Atom(atom) for atom in atoms]
-        except ElementNotFoundError:
-            atoms = [Atom(atom, use_guess_element=False) for atom in atoms]
+        atoms = self._to_atoms(atoms)
 
-        return Frame(AtomicSystem(atoms=atoms, pos=xyz, cell=cell))
+        return Frame(AtomicSystem(atoms=atoms, pos=xyz, cell=cell, dtype=self.dtype))
 
     def read_velocities(self, frame_string: str) -> Frame:
         """
@@ -110,12 +146,9 @@ class FrameReader:
 
         vel, atoms = self._read_xyz(splitted_frame_string, n_atoms)
 
-        try:
-            atoms = [Atom(atom) for atom in atoms]
-        except ElementNotFoundError:
-            atoms = [Atom(atom, use_guess_element=False) for atom in atoms]
+        atoms = self._to_atoms(atoms)
 
-        return Frame(AtomicSystem(atoms=atoms, vel=vel, cell=cell))
+        return Frame(AtomicSystem(atoms=atoms, vel=vel, cell=cell, dtype=self.dtype))
 
     def read_forces(self, frame_string: str) -> Frame:
         """
@@ -139,12 +172,9 @@ class FrameReader:
 
         forces, atoms = self._read_xyz(splitted_frame_string, n_atoms)
 
-        try:
-            atoms = [Atom(atom) for atom in atoms]
-        except ElementNotFoundError:
-            atoms = [Atom(atom, use_guess_element=False) for atom in atoms]
+        atoms = self._to_atoms(atoms)
 
-        return Frame(AtomicSystem(atoms=atoms, forces=forces, cell=cell))
+        return Frame(AtomicSystem(atoms=atoms, forces=forces, cell=cell, dtype=self.dtype))
 
     def read_charges(self, frame_string: str) -> Frame:
         """
@@ -168,12 +198,9 @@ class FrameReader:
 
         charges, atoms = self._read_scalar(splitted_frame_string, n_atoms)
 
-        try:
-            atoms = [Atom(atom) for atom in atoms]
-        except ElementNotFoundError:
-            atoms = [Atom(atom, use_guess_element=False) for atom in atoms]
+        atoms = self._to_atoms(atoms)
 
-        return Frame(AtomicSystem(atoms=atoms, charges=charges, cell=cell))
+        return Frame(AtomicSystem(atoms=atoms, charges=charges, cell=cell, dtype=self.dtype))
 
     def _read_header_line(self, header_line: str) -> Tuple[int, Cell]:
         """
@@ -245,17 +272,15 @@ class FrameReader:
             If the given string does not contain the correct number of lines.
         """
 
-        xyz = np.zeros((n_atoms, 3))
-        atoms = []
-        for i in range(n_atoms):
-            line = splitted_frame_string[2+i]
+        lines = [line.split() for line in splitted_frame_string[2:2+n_atoms]]
 
-            if len(line.split()) != 4:
-                raise FrameReaderError(
-                    'Invalid file format in xyz coordinates of Frame.')
+        if len(lines) != n_atoms or any(len(line) != 4 for line in lines):
+            raise FrameReaderError(
+                'Invalid file format in xyz coordinates of Frame.')
 
-            xyz[i] = np.array([float(x) for x in line.split()[1:4]])
-            atoms.append(line.split()[0])
+        xyz = self._allocate((n_atoms, 3))
+        xyz[...] = [line[1:4] for line in lines] if n_atoms > 0 else 0.0
+        atoms = [line[0] for line in lines]
 
         return xyz, atoms
 
@@ -283,16 +308,65 @@ class FrameReader:
             If the given string does not contain the correct number of lines.
         """
 
-        scalar = np.zeros((n_atoms))
-        atoms = []
-        for i in range(n_atoms):
-            line = splitted_frame_string[2+i]
+        lines = [line.split() for line in splitted_frame_string[2:2+n_atoms]]
 
-            if len(line.split()) != 2:
-                raise FrameReaderError(
-                    'Invalid file format in scalar values of Frame.')
+        if len(lines) != n_atoms or any(len(line) != 2 for line in lines):
+            raise FrameReaderError(
+                'Invalid file format in scalar values of Frame.')
 
-            scalar[i] = float(line.split()[1])
-            atoms.append(line.split()[0])
+        scalar = self._allocate(n_atoms)
+        scalar[...] = [line[1] for line in lines]
+        atoms = [line[0] for line in lines]
 
         return scalar, atoms
+
+    def _allocate(self, shape: int | Tuple[int, ...]) -> np.ndarray:
+        """
+        Returns an array of the given shape for the values of the next frame.
+
+        Parameters
+        ----------
+        shape : int | Tuple[int, ...]
+            The shape of the array.
+
+        Returns
+        -------
+        np.ndarray
+            A new array or, if the reader has buffers, the next buffer of the ring.
+        """
+        if self.buffers is None:
+            return np.empty(shape, dtype=self.dtype)
+
+        return self.buffers.next(shape)
+
+    def _to_atoms(self, names: List[str]) -> List[Atom]:
+        """
+        Creates the Atom objects of the given atom names.
+
+        If the names are no valid element identifiers, the atoms are created without
+        guessing the element. If the reader has buffers and the names are the same as
+        in the previous frame, the Atom objects of the previous frame are returned.
+
+        Parameters
+        ----------
+        names : List[str]
+            The names of the atoms.
+
+        Returns
+        -------
+        List[Atom]
+            The atoms of the frame.
+        """
+        if self.buffers is not None and names == self._cached_names:
+            return self._cached_atoms
+
+        try:
+            atoms = [Atom(name) for name in names]
+        except ElementNotFoundError:
+            atoms = [Atom(name, use_guess_element=False) for name in names]
+
+        if self.buffers is not None:
+            self._cached_names = names
+            self._cached_atoms = atoms
+
+        return atoms
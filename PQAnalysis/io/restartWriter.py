@@ -12,6 +12,7 @@ import numpy as np
 from . import BaseWriter, RestartFileWriterError
 from ..traj import MDEngineFormat, Frame
 from ..core import Cell
+from ..kernels import format_restart_lines
 
 
 class RestartFileWriter(BaseWriter):
@@ -90,33 +91,22 @@ class RestartFileWriter(BaseWriter):
                     "The number of mol_types does not match the number of atoms.")
             mol_types = frame.topology.mol_types
 
-        for i in range(frame.n_atoms):
-            atom = frame.system.atoms[i]
-            pos = frame.system.pos[i]
-
-            try:
-                vel = frame.system.vel[i]
-            except:
-                vel = np.zeros(3)
-
-            try:
-                force = frame.system.forces[i]
-            except:
-                force = np.zeros(3)
-
-            mol_type = mol_types[i]
-            print(f"{atom.name}    {i}    {mol_type}",
-                  file=self.file, end="    ")
-            print(
-                f"{pos[0]} {pos[1]} {pos[2]}", file=self.file, end=" ")
-            print(
-                f"{vel[0]} {vel[1]} {vel[2]}", file=self.file, end=" ")
-            print(
-                f"{force[0]} {force[1]} {force[2]}", file=self.file, end=" ")
-
-            if self.format == MDEngineFormat.PIMD_QMCF:
-                print(file=self.file)
-            else:
-                print(f"{pos[0]} {pos[1]} {pos[2]}", file=self.file, end=" ")
-                print(f"{vel[0]} {vel[1]} {vel[2]}", file=self.file, end=" ")
-                print(f"{force[0]} {force[1]} {force[2]}", file=self.file)
+        pos = frame.system.pos
+        vel = frame.system.vel
+        forces = frame.system.forces
+
+        if len(vel) != frame.n_atoms:
+            vel = np.zeros((frame.n_atoms, 3))
+
+        if len(forces) != frame.n_atoms:
+            forces = np.zeros((frame.n_atoms, 3))
+
+        lines = format_restart_lines([atom.name for atom in frame.system.atoms],
+                                     mol_types,
+                                     pos,
+                                     vel,
+                                     forces,
+                                     extended=self.format != MDEngineFormat.PIMD_QMCF)
+
+        if len(lines) > 0:
+            print("\n".join(lines), file=self.file)
@@ -0,0 +1,435 @@
+"""
+A module containing the TrajectoryIndex class.
+
+...
+
+Classes
+-------
+TrajectoryIndex
+    A class for storing the byte offsets and header information of all frames of a trajectory file.
+
+Functions
+---------
+frame_selection_to_indices
+    Converts a frame selection into an array of (non-negative) frame indices.
+"""
+
+from __future__ import annotations
+
+import os
+import numpy as np
+
+from itertools import islice
+from beartype.typing import List, Tuple, BinaryIO
+
+from . import TrajectoryIndexError
+from ..core import Cell
+from ..types import Np1DIntArray, Np2DNumberArray
+
+
+def frame_selection_to_indices(key: int | slice | List[int] | Np1DIntArray, n_frames: int) -> Np1DIntArray:
+    """
+    Converts a frame selection into an array of (non-negative) frame indices.
+
+    Parameters
+    ----------
+    key : int | slice | List[int] | Np1DIntArray
+        The frames to select. Negative indices count from the end of the trajectory.
+    n_frames : int
+        The number of frames of the trajectory.
+
+    Returns
+    -------
+    Np1DIntArray
+        The selected frame indices in the given order.
+
+    Raises
+    ------
+    IndexError
+        If a frame index is out of range.
+    """
+    if isinstance(key, slice):
+        return np.arange(n_frames, dtype=np.int64)[key]
+
+    indices = np.atleast_1d(np.array(key, dtype=np.int64))
+
+    if np.any(indices >= n_frames) or np.any(indices < -n_frames):
+        raise IndexError(
+            f"Frame index out of range for trajectory with {n_frames} frames.")
+
+    return np.where(indices < 0, indices + n_frames, indices)
+
+
+class TrajectoryIndex:
+    """
+    A class for storing the byte offsets and header information of all frames of a trajectory file.
+
+    The index is built by a header-only scan of the trajectory file. For each frame only the header
+    line is parsed, all atom lines are skipped without being split or converted. This makes it possible
+    to access arbitrary frames of a trajectory file without reading all preceding frames.
+
+    The index can be stored persistently next to the trajectory file (default: '<filename>.pqidx').
+    A stored index is only reused if the size and the modification time of the trajectory file did
+    not change since the index was built.
+
+    ...
+
+    Attributes
+    ----------
+    filename : str
+        The name of the indexed trajectory file.
+    offsets : Np1DIntArray
+        The byte offsets of the frames. The array has n_frames + 1 entries, where the last entry is the
+        size of the trajectory file, so that frame i is stored in the byte range offsets[i]:offsets[i+1].
+    n_atoms : Np1DIntArray
+        The number of atoms of each frame.
+    cells : Np2DNumberArray
+        The box lengths and box angles of each frame as an array of shape (n_frames, 6). Frames without
+        cell information in their header line are marked with np.nan.
+    """
+
+    index_suffix = ".pqidx"
+    _version = 1
+
+    def __init__(self,
+                 filename: str,
+                 offsets: Np1DIntArray,
+                 n_atoms: Np1DIntArray,
+                 cells: Np2DNumberArray
+                 ) -> None:
+        """
+        Initializes the TrajectoryIndex with the given parameters.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the indexed trajectory file.
+        offsets : Np1DIntArray
+            The byte offsets of the frames including the end of the last frame.
+        n_atoms : Np1DIntArray
+            The number of atoms of each frame.
+        cells : Np2DNumberArray
+            The box lengths and box angles of each frame.
+        """
+        self.filename = filename
+        self.offsets = offsets
+        self.n_atoms = n_atoms
+        self.cells = cells
+
+    @classmethod
+    def build(cls, filename: str) -> TrajectoryIndex:
+        """
+        Builds the index of the given trajectory file with a header-only scan.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the trajectory file.
+
+        Returns
+        -------
+        TrajectoryIndex
+            The index of the trajectory file.
+
+        Raises
+        ------
+        TrajectoryIndexError
+            If a header line of the trajectory file is not valid.
+        TrajectoryIndexError
+            If the last frame of the trajectory file is incomplete.
+        """
+        offsets = []
+        n_atoms = []
+        cells = []
+
+        with open(filename, 'rb') as file:
+            offset = 0
+            for line in file:
+                line_offset = offset
+                offset += len(line)
+
+                header = line.split()
+
+                # blank lines between frames are ignored as in TrajectoryReader
+                if len(header) == 0:
+                    continue
+
+                n_atoms_frame, cell = cls._parse_header(header)
+
+                # skip the comment line and all atom lines without parsing them
+                n_lines = n_atoms_frame + 1
+                skipped_lines = list(islice(file, n_lines))
+                offset += sum(map(len, skipped_lines))
+
+                if len(skipped_lines) != n_lines:
+                    raise TrajectoryIndexError(
+                        f"The last frame of trajectory file {filename} is incomplete.")
+
+                offsets.append(line_offset)
+                n_atoms.append(n_atoms_frame)
+                cells.append(cell)
+
+            offsets.append(offset)
+
+        return cls(filename,
+                   np.array(offsets, dtype=np.int64),
+                   np.array(n_atoms, dtype=np.int64),
+                   np.array(cells, dtype=np.float64).reshape(-1, 6))
+
+    @classmethod
+    def _parse_header(cls, header: List[bytes]) -> Tuple[int, List[float]]:
+        """
+        Parses the already splitted header line of a frame.
+
+        The header line semantics are the same as in FrameReader._read_header_line.
+
+        Parameters
+        ----------
+        header : List[bytes]
+            The splitted header line.
+
+        Returns
+        -------
+        n_atoms : int
+            The number of atoms of the frame.
+        cell : list of float
+            The box lengths and box angles of the frame, np.nan if no cell is given.
+
+        Raises
+        ------
+        TrajectoryIndexError
+            If the header line is not valid.
+        """
+        try:
+            n_atoms = int(header[0])
+
+            if len(header) == 1:
+                cell = [np.nan] * 6
+            elif len(header) == 4:
+                cell = [float(x) for x in header[1:4]] + [90.0, 90.0, 90.0]
+            elif len(header) == 7:
+                cell = [float(x) for x in header[1:7]]
+            else:
+                raise ValueError()
+        except ValueError:
+            raise TrajectoryIndexError(
+                f"Invalid header line of frame: '{b' '.join(header).decode()}'.")
+
+        return n_atoms, cell
+
+    @classmethod
+    def from_file(cls,
+                  filename: str,
+                  index_filename: str | None = None,
+                  persistent: bool = True
+                  ) -> TrajectoryIndex:
+        """
+        Returns the index of the given trajectory file.
+
+        If a valid persistent index is found, it is loaded. Otherwise the index is built and
+        - if persistent is True - stored for later use. If the index cannot be stored (e.g.
+        because of a read only directory) the index is still returned.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the trajectory file.
+        index_filename : str | None, optional
+            The name of the index file, by default None ('<filename>.pqidx')
+        persistent : bool, optional
+            Whether to load and store the index from/to the index file, by default True
+
+        Returns
+        -------
+        TrajectoryIndex
+            The index of the trajectory file.
+        """
+        if not persistent:
+            return cls.build(filename)
+
+        if index_filename is None:
+            index_filename = filename + cls.index_suffix
+
+        index = cls.load(filename, index_filename)
+
+        if index is None:
+            index = cls.build(filename)
+            try:
+                index.save(index_filename)
+            except OSError:
+                pass
+
+        return index
+
+    def save(self, index_filename: str | None = None) -> None:
+        """
+        Stores the index in the given index file.
+
+        Parameters
+        ----------
+        index_filename : str | None, optional
+            The name of the index file, by default None ('<filename>.pqidx')
+        """
+        if index_filename is None:
+            index_filename = self.filename + self.index_suffix
+
+        stat = os.stat(self.filename)
+
+        with open(index_filename, 'wb') as file:
+            np.savez(file,
+                     version=self._version,
+                     file_size=stat.st_size,
+                     mtime_ns=stat.st_mtime_ns,
+                     offsets=self.offsets,
+                     n_atoms=self.n_atoms,
+                     cells=self.cells)
+
+    @classmethod
+    def load(cls, filename: str, index_filename: str | None = None) -> TrajectoryIndex | None:
+        """
+        Loads the index of the given trajectory file from the given index file.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the trajectory file.
+        index_filename : str | None, optional
+            The name of the index file, by default None ('<filename>.pqidx')
+
+        Returns
+        -------
+        TrajectoryIndex | None
+            The loaded index or None if no index file exists or it is outdated.
+        """
+        if index_filename is None:
+            index_filename = filename + cls.index_suffix
+
+        if not os.path.isfile(index_filename):
+            return None
+
+        stat = os.stat(filename)
+
+        try:
+            with np.load(index_filename) as data:
+                if int(data["version"]) != cls._version:
+                    return None
+                if int(data["file_size"]) != stat.st_size:
+                    return None
+                if int(data["mtime_ns"]) != stat.st_mtime_ns:
+                    return None
+
+                return cls(filename, data["offsets"], data["n_atoms"], data["cells"])
+        except (OSError, KeyError, ValueError):
+            return None
+
+    def frame_indices(self, key: int | slice | List[int] | Np1DIntArray) -> Np1DIntArray:
+        """
+        Converts a frame selection into an array of (non-negative) frame indices.
+
+        Parameters
+        ----------
+        key : int | slice | List[int] | Np1DIntArray
+            The frames to select. Negative indices count from the end of the trajectory.
+
+        Returns
+        -------
+        Np1DIntArray
+            The selected frame indices in the given order.
+        """
+        return frame_selection_to_indices(key, self.n_frames)
+
+    def effective_cell_parameters(self) -> Np2DNumberArray:
+        """
+        Returns the box lengths and box angles of each frame as assigned by TrajectoryReader.
+
+        Frames without cell information in their header line inherit the cell of the
+        previous frame, frames before the first cell information are marked with np.nan.
+
+        Returns
+        -------
+        Np2DNumberArray
+            The cell parameters of each frame as an array of shape (n_frames, 6).
+        """
+        valid = ~np.isnan(self.cells[:, 0])
+        last_valid = np.maximum.accumulate(np.where(valid, np.arange(self.n_frames), -1))
+
+        filled = self.cells[np.maximum(last_valid, 0)]
+        filled[last_valid < 0] = np.nan
+
+        return filled
+
+    def effective_cells(self, frames: Np1DIntArray | None = None) -> List[Cell]:
+        """
+        Returns the cell of the given frames as it would be assigned by TrajectoryReader.
+
+        Frames without cell information in their header line inherit the cell of the
+        previous frame, frames before the first cell information get Cell(). Cell objects
+        are only created for the given frames.
+
+        Parameters
+        ----------
+        frames : Np1DIntArray | None, optional
+            The (non-negative) indices of the frames, by default None (all frames)
+
+        Returns
+        -------
+        List[Cell]
+            The cell of each given frame.
+        """
+        parameters = self.effective_cell_parameters()
+
+        if frames is not None:
+            parameters = parameters[frames]
+
+        return [Cell() if np.isnan(cell[0]) else Cell(*cell) for cell in parameters]
+
+    def read_bytes(self, frame: int, file: BinaryIO | None = None) -> bytes:
+        """
+        Reads the raw bytes of the given frame.
+
+        Parameters
+        ----------
+        frame : int
+            The index of the frame.
+        file : BinaryIO | None, optional
+            The trajectory file opened in binary mode, by default None (the file is opened
+            for this frame only). Reading many frames through one open file avoids
+            reopening the file for every frame.
+
+        Returns
+        -------
+        bytes
+            The raw bytes of the frame including the header line.
+        """
+        if file is None:
+            with open(self.filename, 'rb') as file:
+                return self.read_bytes(frame, file)
+
+        frame = int(self.frame_indices(frame)[0])
+        start, stop = self.offsets[frame], self.offsets[frame + 1]
+
+        file.seek(start)
+        return file.read(stop - start)
+
+    @property
+    def n_frames(self) -> int:
+        """
+        Returns the number of frames in the trajectory file.
+
+        Returns
+        -------
+        int
+            The number of frames in the trajectory file.
+        """
+        return len(self.n_atoms)
+
+    def __len__(self) -> int:
+        """
+        Returns the number of frames in the trajectory file.
+
+        Returns
+        -------
+        int
+            The number of frames in the trajectory file.
+        """
+        return self.n_frames
@@ -9,11 +9,16 @@ TrajectoryReader
     A class for reading a trajectory from a file.
 """
 
-from beartype.typing import List
+import numpy as np
 
-from . import BaseReader, TrajectoryReaderError, FrameReader
-from ..traj import Trajectory, TrajectoryFormat, MDEngineFormat
+from contextlib import ExitStack
+from beartype.typing import List, Tuple, Generator
+
+from . import BaseReader, TrajectoryReaderError, FrameReader, TrajectoryIndex, FrameBlockReader
+from .trajectoryIndex import frame_selection_to_indices
+from ..traj import Trajectory, TrajectoryFormat, MDEngineFormat, Frame
 from ..core import Cell
+from ..types import Np1DIntArray
 
 
 class TrajectoryReader(BaseReader):
@@ -30,9 +35,18 @@ class TrajectoryReader(BaseReader):
         The name of the file to read from.
     frames : list of Frame
         The list of frames read from the file.
+    dtype : np.dtype
+        The floating point type of the read arrays.
+    read_ahead : bool
+        Whether the files are read in large blocks by a read-ahead thread (see FrameBlockReader).
     """
 
-    def __init__(self, filename: str | List[str], format: TrajectoryFormat | str = TrajectoryFormat.XYZ) -> None:
+    def __init__(self,
+                 filename: str | List[str],
+                 format: TrajectoryFormat | str = TrajectoryFormat.XYZ,
+                 dtype: type | np.dtype = np.float64,
+                 read_ahead: bool = False
+                 ) -> None:
         """
         Initializes the TrajectoryReader with the given filename.
 
@@ -40,10 +54,21 @@ class TrajectoryReader(BaseReader):
         ----------
         filename : str or list of str
             The name of the file to read from or a list of filenames to read from.
+        format : TrajectoryFormat | str, optional
+            The format of the trajectory, by default TrajectoryFormat.XYZ
+        dtype : type | np.dtype, optional
+            The floating point type of the read arrays, by default np.float64.
+            With np.float32 the memory of the trajectory is halved.
+        read_ahead : bool, optional
+            Whether the files are read in large binary blocks by a read-ahead thread, by default False.
+            The frames are then delimited by the number of atoms in their header lines (as in
+            TrajectoryIndex) instead of by the lines starting with an integer.
         """
         super().__init__(filename)
         self.frames = []
         self.format = format
+        self.dtype = np.dtype(dtype)
+        self.read_ahead = read_ahead
 
     def read(self, md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF) -> Trajectory:
         """
@@ -77,6 +102,192 @@ class TrajectoryReader(BaseReader):
             self.filename = None
             return traj
 
+    def read_frames(self,
+                    frames: int | slice | List[int] | Np1DIntArray,
+                    md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                    persistent_index: bool = True
+                    ) -> Trajectory:
+        """
+        Reads only the selected frames from the file(s).
+
+        The frames are located via the TrajectoryIndex of each file, so that only the
+        selected frames are parsed. If the trajectory is split into multiple files, the
+        frames are numbered consecutively over all files. Frames without cell information
+        get the cell of the previous frame in the same file, exactly as with read().
+
+        Parameters
+        ----------
+        frames : int | slice | List[int] | Np1DIntArray
+            The frames to read. Negative indices count from the end of the trajectory.
+        md_format : MDEngineFormat | str, optional
+            The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+        persistent_index : bool, optional
+            Whether the index of each file should be stored next to the file, by default True
+
+        Returns
+        -------
+        Trajectory
+            The trajectory containing the selected frames in the given order.
+        """
+        indices = self.indices(persistent_index)
+        frame_reader = FrameReader(self.dtype)
+
+        traj = Trajectory()
+        for frame_string, cell in self._read_located_frames(self._locate_frames(indices, frames)):
+            frame = self._parse_frame(frame_string, frame_reader, md_format)
+
+            if frame.cell == Cell():
+                frame.cell = cell
+
+            traj.append(frame)
+
+        return traj
+
+    def iter_frames(self,
+                    md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                    n_buffers: int = 0,
+                    frames: int | slice | List[int] | Np1DIntArray | None = None
+                    ) -> Generator[Frame, None, None]:
+        """
+        Reads the frames of the file(s) one after another without storing the whole trajectory.
+
+        Frames without cell information get the cell of the previous frame of the same
+        file, exactly as with read().
+
+        With n_buffers > 0 the frames are read into a ring of n_buffers reused buffers
+        (see FrameReader), which avoids the allocation of new arrays for every frame.
+        The arrays of a yielded frame are then only valid until n_buffers further frames
+        have been read, i.e. with n_buffers=1 each frame has to be reduced (or copied)
+        before the next one is requested.
+
+        If frames is given, only the selected frames are located via the TrajectoryIndex
+        of each file and parsed, e.g. a contiguous frame range of a parallel worker.
+
+        Parameters
+        ----------
+        md_format : MDEngineFormat | str, optional
+            The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+        n_buffers : int, optional
+            The number of reused frame buffers, by default 0 (new arrays for every frame)
+        frames : int | slice | List[int] | Np1DIntArray | None, optional
+            The global frame selection, by default None (all frames)
+
+        Yields
+        ------
+        Frame
+            The frames of the trajectory in the order of the file(s).
+        """
+        frame_reader = FrameReader(self.dtype, n_buffers=n_buffers)
+
+        if frames is not None:
+            located = self._locate_frames(self.indices(), frames)
+
+            for frame_string, cell in self._read_located_frames(located):
+                frame = self._parse_frame(frame_string, frame_reader, md_format)
+
+                if frame.cell == Cell():
+                    frame.cell = cell
+
+                yield frame
+
+            return
+
+        filenames = self.filenames if self.multiple_files else [self.filename]
+
+        for filename in filenames:
+            previous_cell = None
+
+            for frame_string in self._frame_strings(filename):
+                frame = self._parse_frame(frame_string, frame_reader, md_format)
+
+                if previous_cell is not None and frame.cell == Cell():
+                    frame.cell = previous_cell
+
+                previous_cell = frame.cell
+
+                yield frame
+
+    def indices(self, persistent: bool = True) -> List[TrajectoryIndex]:
+        """
+        Returns the TrajectoryIndex of each file of the reader.
+
+        Parameters
+        ----------
+        persistent : bool, optional
+            Whether the index of each file should be loaded from/stored to disk, by default True
+
+        Returns
+        -------
+        List[TrajectoryIndex]
+            The indices of all files in the order of the files.
+        """
+        filenames = self.filenames if self.multiple_files else [self.filename]
+
+        return [TrajectoryIndex.from_file(filename, persistent=persistent) for filename in filenames]
+
+    @classmethod
+    def _locate_frames(cls,
+                       indices: List[TrajectoryIndex],
+                       frames: int | slice | List[int] | Np1DIntArray
+                       ) -> List[Tuple[TrajectoryIndex, int, Cell]]:
+        """
+        Maps global frame indices to the index of the file, the frame in that file and its effective cell.
+
+        The cells are only created for the selected frames.
+
+        Parameters
+        ----------
+        indices : List[TrajectoryIndex]
+            The indices of all files.
+        frames : int | slice | List[int] | Np1DIntArray
+            The global frame selection.
+
+        Returns
+        -------
+        List[Tuple[TrajectoryIndex, int, Cell]]
+            A list of (TrajectoryIndex, local frame index, Cell) for each selected frame.
+        """
+        n_frames = [index.n_frames for index in indices]
+        global_frames = frame_selection_to_indices(frames, sum(n_frames))
+
+        starts = np.cumsum([0] + n_frames)
+        file_indices = np.searchsorted(starts, global_frames, side="right") - 1
+        frames = global_frames - starts[file_indices]
+
+        cells = np.empty(len(global_frames), dtype=object)
+        for file_index, index in enumerate(indices):
+            selected = file_indices == file_index
+            if np.any(selected):
+                cells[selected] = index.effective_cells(frames[selected])
+
+        return [(indices[file_index], int(frame), cell)
+                for file_index, frame, cell in zip(file_indices, frames, cells)]
+
+    @staticmethod
+    def _read_located_frames(located: List[Tuple[TrajectoryIndex, int, Cell]]
+                             ) -> Generator[Tuple[str, Cell], None, None]:
+        """
+        Reads the strings of the located frames keeping each file open for the whole read.
+
+        Parameters
+        ----------
+        located : List[Tuple[TrajectoryIndex, int, Cell]]
+            The located frames as returned by _locate_frames.
+
+        Yields
+        ------
+        Tuple[str, Cell]
+            The string and the effective cell of each located frame.
+        """
+        with ExitStack() as stack:
+            files = {}
+
+            for index, frame, cell in located:
+                if index.filename not in files:
+                    files[index.filename] = stack.enter_context(open(index.filename, 'rb'))
+
+                yield index.read_bytes(frame, files[index.filename]).decode(), cell
+
     def _read_single_file(self, md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF) -> Trajectory:
         """
         Reads the trajectory from the file.
@@ -93,29 +304,55 @@ class TrajectoryReader(BaseReader):
         Trajectory
             The trajectory read from the file.
         """
-        frame_reader = FrameReader()
-        with open(self.filename, 'r') as f:
+        frame_reader = FrameReader(self.dtype)
+
+        for frame_string in self._frame_strings(self.filename):
+            self._read_single_frame(frame_string, frame_reader, md_format)
+
+        traj = Trajectory(self.frames)
+        self.frames = []
+
+        return traj
+
+    def _frame_strings(self, filename: str) -> Generator[str, None, None]:
+        """
+        Yields the string of each frame of the given file.
+
+        A new frame starts at each line whose first entry is an integer (the number of atoms).
+        If the reader uses read-ahead, the frames are split by the FrameBlockReader instead.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file to read from.
+
+        Yields
+        ------
+        str
+            The concatenated lines of one frame.
+        """
+        if self.read_ahead:
+            for frame_bytes in FrameBlockReader(filename):
+                yield frame_bytes.decode()
+
+            return
+
+        with open(filename, 'r') as f:
 
             # Concatenate lines of the same frame
-            frame_string = ''
+            frame_lines = []
             for line in f:
                 if line.strip() == '':
-                    frame_string += line
+                    frame_lines.append(line)
                 elif line.split()[0].isdigit():
-                    if frame_string != '':
-                        self._read_single_frame(
-                            frame_string, frame_reader, md_format)
+                    if len(frame_lines) != 0:
+                        yield ''.join(frame_lines)
 
-                    frame_string = line
+                    frame_lines = [line]
                 else:
-                    frame_string += line
+                    frame_lines.append(line)
 
-            self._read_single_frame(frame_string, frame_reader, md_format)
-
-        traj = Trajectory(self.frames)
-        self.frames = []
-
-        return traj
+            yield ''.join(frame_lines)
 
     def _read_single_frame(self, frame_string: str, frame_reader: FrameReader,  md_format: MDEngineFormat | str) -> None:
         """
@@ -126,6 +363,36 @@ class TrajectoryReader(BaseReader):
         frame_string : str
             The string containing the frame information.
 
+        Raises
+        ------
+        TrajectoryReaderError
+            If the first atom in the frame is not X for QMCFC.
+        """
+        self.frames.append(self._parse_frame(
+            frame_string, frame_reader, md_format))
+
+        # If the read frame does not have cell information, use the cell information of the previous frame
+        if len(self.frames) > 1 and self.frames[-1].cell == Cell():
+            self.frames[-1].cell = self.frames[-2].cell
+
+    def _parse_frame(self, frame_string: str, frame_reader: FrameReader, md_format: MDEngineFormat | str) -> Frame:
+        """
+        Parses a single frame from the given string.
+
+        Parameters
+        ----------
+        frame_string : str
+            The string containing the frame information.
+        frame_reader : FrameReader
+            The FrameReader used to parse the frame.
+        md_format : MDEngineFormat | str
+            The format of the md engine.
+
+        Returns
+        -------
+        Frame
+            The parsed frame without the X particle for QMCFC.
+
         Raises
         ------
         TrajectoryReaderError
@@ -134,15 +401,11 @@ class TrajectoryReader(BaseReader):
         frame = frame_reader.read(frame_string, format=self.format)
 
         # to make sure X particle is not included in the trajectory for QMCFC
-        if MDEngineFormat(md_format) == MDEngineFormat.PIMD_QMCF:
-            self.frames.append(frame)
-        elif MDEngineFormat(md_format) == MDEngineFormat.QMCFC:
+        if MDEngineFormat(md_format) == MDEngineFormat.QMCFC:
             if frame.atoms[0].name.upper() != 'X':
                 raise TrajectoryReaderError(
                     "The first atom in one of the frames is not X. Please use pimd_qmcf (default) md engine instead")
-            else:
-                self.frames.append(frame[1:])
 
-        # If the read frame does not have cell information, use the cell information of the previous frame
-        if len(self.frames) > 1 and self.frames[-1].cell == Cell():
-            self.frames[-1].cell = self.frames[-2].cell
+            frame = frame[1:]
+
+        return frame
@@ -9,12 +9,17 @@ TrajectoryWriter
     A class for writing a trajectory to a file.
 """
 
-from beartype.typing import List
+import os
+
+from collections import deque
+from beartype.typing import List, Tuple
 
 from . import BaseWriter
 from ..traj import Trajectory, TrajectoryFormat, MDEngineFormat, Frame
 from ..core import Cell, Atom
+from ..kernels import format_atom_lines
 from ..types import Np2DNumberArray, Np1DNumberArray
+from ..utils import process_pool
 
 
 def write_trajectory(traj,
@@ -43,6 +48,7 @@ def write_trajectory(traj,
 
     writer = TrajectoryWriter(filename, format=format)
     writer.write(traj, type=type)
+    writer.close()
 
 
 class TrajectoryWriter(BaseWriter):
@@ -78,6 +84,10 @@ class TrajectoryWriter(BaseWriter):
     ----------
     format : MDEngineFormat
         The format of the md engine for the output file. The default is MDEngineFormat.PIMD_QMCF.
+    n_workers : int
+        The number of processes formatting the frames. With 1 (default) the frames are formatted sequentially.
+    chunk_size : int | None
+        The number of frames formatted by one task of a worker process, None to split the trajectory evenly.
     """
 
     _format: MDEngineFormat
@@ -86,11 +96,24 @@ class TrajectoryWriter(BaseWriter):
     def __init__(self,
                  filename: str | None = None,
                  format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
-                 mode: str = 'w'
+                 mode: str = 'w',
+                 n_workers: int | None = 1,
+                 chunk_size: int | None = None
                  ) -> None:
         """
         It sets the file to write to - either a file or stdout (if filename is None) - and the mode of the file.
 
+        Converting the values to text is CPU bound. With n_workers > 1 chunks of frames are
+        therefore formatted in parallel by worker processes, while the results are written
+        to the file in the original order of the frames. The output is identical to the
+        sequential output. The worker processes are started with the first parallel write
+        and reused by all later writes until close() is called, which the writer does on
+        leaving a with block.
+
+        The workers are started with utils.process_pool, i.e. not forked from the calling
+        process. Therefore, a script using n_workers > 1 has to guard its main code with
+        'if __name__ == "__main__":' and cannot be run from stdin.
+
         Parameters
         ----------
         filename : str, optional
@@ -99,11 +122,42 @@ class TrajectoryWriter(BaseWriter):
             The format of the md engine for the output file. The default is MDEngineFormat.PIMD_QMCF.
         mode : str, optional
             The mode of the file. Either 'w' for write or 'a' for append.
+        n_workers : int | None, optional
+            The number of processes formatting the frames, by default 1 (sequential). If None, the
+            number of CPUs is used.
+        chunk_size : int | None, optional
+            The number of frames formatted by one task, by default None (four tasks per worker).
         """
 
         super().__init__(filename, mode)
 
         self.format = MDEngineFormat(format)
+        self.n_workers = n_workers if n_workers is not None else os.cpu_count() or 1
+        self.chunk_size = chunk_size
+
+        self._executor = None
+
+    def __enter__(self) -> "TrajectoryWriter":
+        """
+        Returns the writer, which is closed on leaving the with block.
+        """
+        return self
+
+    def __exit__(self, *_) -> None:
+        """
+        Closes the file and shuts down the worker processes.
+        """
+        self.close()
+
+    def close(self) -> None:
+        """
+        Closes the file to write to and shuts down the worker processes.
+        """
+        super().close()
+
+        if self._executor is not None:
+            self._executor.shutdown()
+            self._executor = None
 
     def write(self, trajectory: Trajectory | Frame, type: TrajectoryFormat | str = TrajectoryFormat.XYZ) -> None:
         """
@@ -128,8 +182,6 @@ class TrajectoryWriter(BaseWriter):
         elif self._type == TrajectoryFormat.CHARGE:
             self.write_charges(trajectory)
 
-        self.close()
-
     def write_positions(self, trajectory: Trajectory) -> None:
         """
         Writes the positions of the trajectory to the file.
@@ -140,13 +192,7 @@ class TrajectoryWriter(BaseWriter):
             The trajectory to write.
         """
         self._type = TrajectoryFormat.XYZ
-        self.open()
-        for frame in trajectory:
-            self._write_header(frame.n_atoms, frame.cell)
-            self._write_comment(frame)
-            self._write_xyz(frame.pos, frame.atoms)
-
-        self.close()
+        self._write_frames(trajectory)
 
     def write_velocities(self, trajectory: Trajectory) -> None:
         """
@@ -158,13 +204,7 @@ class TrajectoryWriter(BaseWriter):
             The trajectory to write.
         """
         self._type = TrajectoryFormat.VEL
-        self.open()
-        for frame in trajectory:
-            self._write_header(frame.n_atoms, frame.cell)
-            self._write_comment(frame)
-            self._write_xyz(frame.vel, frame.atoms)
-
-        self.close()
+        self._write_frames(trajectory)
 
     def write_forces(self, trajectory: Trajectory) -> None:
         """
@@ -176,13 +216,7 @@ class TrajectoryWriter(BaseWriter):
             The trajectory to write.
         """
         self._type = TrajectoryFormat.FORCE
-        self.open()
-        for frame in trajectory:
-            self._write_header(frame.n_atoms, frame.cell)
-            self._write_comment(frame)
-            self._write_xyz(frame.forces, frame.atoms)
-
-        self.close()
+        self._write_frames(trajectory)
 
     def write_charges(self, trajectory: Trajectory) -> None:
         """
@@ -194,13 +228,145 @@ class TrajectoryWriter(BaseWriter):
             The trajectory to write.
         """
         self._type = TrajectoryFormat.CHARGE
+        self._write_frames(trajectory)
+
+    def _write_frames(self, trajectory: Trajectory) -> None:
+        """
+        Writes all frames of the trajectory in the current type to the file.
+
+        If the writer has more than one worker, chunks of frames are formatted in parallel.
+        Only the header lines, the atom names and the written values of the frames are sent
+        to the workers. At most two chunks per worker are pending at the same time and the
+        formatted chunks are written in the order of the trajectory.
+
+        Parameters
+        ----------
+        trajectory : Trajectory
+            The trajectory to write.
+        """
         self.open()
-        for frame in trajectory:
-            self._write_header(frame.n_atoms, frame.cell)
-            self._write_comment(frame)
-            self._write_scalar(frame.charges, frame.atoms)
 
-        self.close()
+        frames = list(trajectory)
+
+        if self.n_workers == 1 or len(frames) <= 1:
+            for frame in frames:
+                parts = self._split_frame(frame, self.format, self._type)
+                print(self._join_frame(*parts), end="", file=self.file)
+        else:
+            chunk_size = self.chunk_size
+            if chunk_size is None:
+                chunk_size = max(1, -(-len(frames) // (4 * self.n_workers)))
+
+            # frames sharing their atoms share the list of names, which is pickled only once per chunk
+            names = {}
+            for frame in frames:
+                names.setdefault(id(frame.atoms), [atom.name for atom in frame.atoms])
+
+            if self._executor is None:
+                self._executor = process_pool(self.n_workers)
+
+            pending = deque()
+            for start in range(0, len(frames), chunk_size):
+                chunk = [self._split_frame(frame, self.format, self._type, names[id(frame.atoms)])
+                         for frame in frames[start:start + chunk_size]]
+                pending.append(self._executor.submit(self._format_chunk, chunk))
+
+                if len(pending) >= 2 * self.n_workers:
+                    print(pending.popleft().result(), end="", file=self.file)
+
+            while len(pending) > 0:
+                print(pending.popleft().result(), end="", file=self.file)
+
+        # only the file is closed, the worker processes are kept for the next write
+        super().close()
+
+    @classmethod
+    def _split_frame(cls,
+                     frame: Frame,
+                     format: MDEngineFormat,
+                     type: TrajectoryFormat,
+                     names: List[str] | None = None
+                     ) -> Tuple[List[str], List[str], Np1DNumberArray | Np2DNumberArray]:
+        """
+        Splits a frame into its leading lines, its atom names and the values to write.
+
+        Parameters
+        ----------
+        frame : Frame
+            The frame to split.
+        format : MDEngineFormat
+            The format of the md engine for the output file.
+        type : TrajectoryFormat
+            The type of the data to write.
+        names : List[str] | None, optional
+            The names of the atoms of the frame, by default None (taken from the atoms)
+
+        Returns
+        -------
+        lines : List[str]
+            The header line, the comment line and for 'qmcfc' positions the X line.
+        names : List[str]
+            The names of the atoms.
+        values : Np1DNumberArray | Np2DNumberArray
+            The positions, velocities, forces or charges of the atoms.
+        """
+        lines = [cls._format_header(frame.n_atoms, frame.cell),
+                 cls._format_comment(frame, type)]
+
+        if format == MDEngineFormat.QMCFC and type == TrajectoryFormat.XYZ:
+            lines.append("X   0.0 0.0 0.0")
+
+        if names is None:
+            names = [atom.name for atom in frame.atoms]
+
+        if type == TrajectoryFormat.XYZ:
+            values = frame.pos
+        elif type == TrajectoryFormat.VEL:
+            values = frame.vel
+        elif type == TrajectoryFormat.FORCE:
+            values = frame.forces
+        else:
+            values = frame.charges
+
+        return lines, names, values[:len(names)]
+
+    @staticmethod
+    def _join_frame(lines: List[str], names: List[str], values: Np1DNumberArray | Np2DNumberArray) -> str:
+        """
+        Returns the text of a frame split by _split_frame.
+
+        Parameters
+        ----------
+        lines : List[str]
+            The leading lines of the frame.
+        names : List[str]
+            The names of the atoms.
+        values : Np1DNumberArray | Np2DNumberArray
+            The values of the atoms.
+
+        Returns
+        -------
+        str
+            The text of the frame including the final newline character.
+        """
+        return "\n".join(lines + format_atom_lines(names, values)) + "\n"
+
+    @classmethod
+    def _format_chunk(cls, chunk: List[Tuple[List[str], List[str], Np1DNumberArray | Np2DNumberArray]]) -> str:
+        """
+        Returns the text of a chunk of split frames (executed by the worker processes).
+
+        Parameters
+        ----------
+        chunk : List[Tuple[List[str], List[str], Np1DNumberArray | Np2DNumberArray]]
+            The frames split by _split_frame.
+
+        Returns
+        -------
+        str
+            The text of all frames of the chunk.
+        """
+        return "".join(cls._join_frame(*parts) for parts in chunk)
 
     def _write_header(self, n_atoms: int, cell: Cell = Cell()) -> None:
         """
@@ -213,12 +379,29 @@ class TrajectoryWriter(BaseWriter):
         cell : Cell
             The cell of the frame. Default is Cell().
         """
+        print(self._format_header(n_atoms, cell), file=self.file)
+
+    @staticmethod
+    def _format_header(n_atoms: int, cell: Cell = Cell()) -> str:
+        """
+        Returns the header line of the frame.
+
+        Parameters
+        ----------
+        n_atoms : int
+            The number of atoms in the frame.
+        cell : Cell
+            The cell of the frame. Default is Cell().
 
+        Returns
+        -------
+        str
+            The header line without newline character.
+        """
         if cell != Cell():
-            print(
-                f"{n_atoms} {cell.x} {cell.y} {cell.z} {cell.alpha} {cell.beta} {cell.gamma}", file=self.file)
-        else:
-            print(f"{n_atoms}", file=self.file)
+            return f"{n_atoms} {cell.x} {cell.y} {cell.z} {cell.alpha} {cell.beta} {cell.gamma}"
+
+        return f"{n_atoms}"
 
     def _write_comment(self, frame: Frame) -> None:
         """
@@ -229,13 +412,30 @@ class TrajectoryWriter(BaseWriter):
         frame : Frame
             The frame to write the comment line of.
         """
+        print(self._format_comment(frame, self._type), file=self.file)
+
+    @staticmethod
+    def _format_comment(frame: Frame, type: TrajectoryFormat) -> str:
+        """
+        Returns the comment line of the frame.
 
-        if self._type == TrajectoryFormat.FORCE:
+        Parameters
+        ----------
+        frame : Frame
+            The frame to write the comment line of.
+        type : TrajectoryFormat
+            The type of the data to write.
+
+        Returns
+        -------
+        str
+            The comment line without newline character.
+        """
+        if type == TrajectoryFormat.FORCE:
             sum_forces = sum(frame.forces)
-            print(
-                f"sum of forces: {sum_forces[0]} {sum_forces[1]} {sum_forces[2]}", file=self.file)
-        else:
-            print("", file=self.file)
+            return f"sum of forces: {sum_forces[0]} {sum_forces[1]} {sum_forces[2]}"
+
+        return ""
 
     def _write_xyz(self, xyz: Np2DNumberArray, atoms: List[Atom]) -> None:
         """
@@ -250,13 +450,42 @@ class TrajectoryWriter(BaseWriter):
         atoms : Elements
             The elements of the frame.
         """
+        for line in self._format_xyz(xyz, atoms, self.format, self._type):
+            print(line, file=self.file)
+
+    @staticmethod
+    def _format_xyz(xyz: Np2DNumberArray,
+                    atoms: List[Atom],
+                    format: MDEngineFormat,
+                    type: TrajectoryFormat
+                    ) -> List[str]:
+        """
+        Returns the xyz lines of the frame.
 
-        if self.format == MDEngineFormat.QMCFC and self._type == TrajectoryFormat.XYZ:
-            print("X   0.0 0.0 0.0", file=self.file)
+        If format is 'qmcfc', an additional X 0.0 0.0 0.0 line is prepended for positions.
 
-        for i in range(len(atoms)):
-            print(
-                f"{atoms[i].name} {xyz[i][0]} {xyz[i][1]} {xyz[i][2]}", file=self.file)
+        Parameters
+        ----------
+        xyz : np.array
+            The xyz data of the atoms (either positions, velocities or forces).
+        atoms : Elements
+            The elements of the frame.
+        format : MDEngineFormat
+            The format of the md engine for the output file.
+        type : TrajectoryFormat
+            The type of the data to write.
+
+        Returns
+        -------
+        List[str]
+            The lines without newline characters.
+        """
+        lines = format_atom_lines([atom.name for atom in atoms], xyz[:len(atoms)])
+
+        if format == MDEngineFormat.QMCFC and type == TrajectoryFormat.XYZ:
+            lines.insert(0, "X   0.0 0.0 0.0")
+
+        return lines
 
     def _write_scalar(self, scalar: Np1DNumberArray, atoms: List[Atom]) -> None:
         """
@@ -269,10 +498,27 @@ class TrajectoryWriter(BaseWriter):
         atoms : Elements
             The elements of the frame.
         """
+        for line in self._format_scalar(scalar, atoms):
+            print(line, file=self.file)
+
+    @staticmethod
+    def _format_scalar(scalar: Np1DNumberArray, atoms: List[Atom]) -> List[str]:
+        """
+        Returns the scalar lines of the frame.
+
+        Parameters
+        ----------
+        scalar : np.array
+            scalar data of the atoms (atm only charges).
+        atoms : Elements
+            The elements of the frame.
 
-        for i in range(len(atoms)):
-            print(
-                f"{atoms[i].name} {scalar[i]}", file=self.file)
+        Returns
+        -------
+        List[str]
+            The lines without newline characters.
+        """
+        return format_atom_lines([atom.name for atom in atoms], scalar[:len(atoms)])
 
     @property
     def format(self) -> MDEngineFormat:
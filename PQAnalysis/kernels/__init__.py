@@ -0,0 +1,10 @@
+from .exceptions import KernelBackendError
+from .backends import available_backends, get_backend, set_backend
+from .cellList import CellList
+from .distances import minimum_image, paired_distances, distances, distance_histogram, cutoff_pairs
+from .neighbours import k_nearest_neighbours, minimum_distance, self_image_distance
+from .groups import group_centers_of_mass
+from .graphs import connected_components
+from .voronoi import voronoi_cells
+from .grids import fractional_grid, surface_distances, covering_diameters
+from .formatting import format_restart_lines, format_atom_lines
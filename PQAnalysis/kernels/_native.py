@@ -0,0 +1,292 @@
+"""
+The native (C++/OpenMP) implementation of the kernels.
+
+The kernels are compiled from src/distances.cpp into the extension module
+PQAnalysis.kernels._distances while installing PQAnalysis. The exported C
+functions are called via ctypes, which releases the GIL during the call, so
+that the OpenMP threads are not serialized by the interpreter. If the
+extension module was not built, lib is None and the backend is not available.
+
+The restart and atom lines are formatted with the NumPy implementation, as their
+formatting is dominated by the conversion of the values to Python strings. The
+Voronoi cells use the buffer sizes of the NumPy implementation.
+
+All functions expect C-contiguous float64 arrays as prepared by the public
+functions of PQAnalysis.kernels.
+"""
+
+import ctypes
+import numpy as np
+
+from beartype.typing import Tuple
+
+from .cellList import CellList
+from ._numpy import format_restart_lines, format_atom_lines, _voronoi_faces
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray, Np2DIntArray
+
+name = "native"
+
+
+def _load_library() -> ctypes.CDLL | None:
+    try:
+        from . import _distances
+        lib = ctypes.CDLL(_distances.__file__)
+    except (ImportError, OSError):
+        return None
+
+    double_p = np.ctypeslib.ndpointer(dtype=np.float64, flags="C_CONTIGUOUS")
+    int64_p = np.ctypeslib.ndpointer(dtype=np.int64, flags="C_CONTIGUOUS")
+    int64 = ctypes.c_int64
+    c_int = ctypes.c_int
+    c_double = ctypes.c_double
+
+    lib.pq_n_threads.argtypes = []
+    lib.pq_n_threads.restype = c_int
+
+    lib.pq_minimum_image.argtypes = [
+        double_p, int64, double_p, double_p, double_p]
+    lib.pq_minimum_image.restype = None
+
+    lib.pq_paired_distances.argtypes = [
+        double_p, double_p, int64, double_p, double_p, c_int, double_p]
+    lib.pq_paired_distances.restype = None
+
+    lib.pq_distances.argtypes = [
+        double_p, int64, double_p, int64, double_p, double_p, c_int, double_p]
+    lib.pq_distances.restype = None
+
+    lib.pq_distance_histogram.argtypes = [
+        double_p, int64, double_p, int64, double_p, double_p, c_int,
+        c_int, c_double, c_double, int64, double_p]
+    lib.pq_distance_histogram.restype = None
+
+    lib.pq_cutoff_pair_counts.argtypes = [
+        double_p, int64, double_p, int64, double_p, double_p, c_int,
+        c_int, c_double, int64_p]
+    lib.pq_cutoff_pair_counts.restype = None
+
+    lib.pq_cutoff_pairs.argtypes = [
+        double_p, int64, double_p, int64, double_p, double_p, c_int,
+        c_int, c_double, int64_p, int64_p, double_p]
+    lib.pq_cutoff_pairs.restype = None
+
+    lib.pq_cell_list_histogram.argtypes = [
+        double_p, int64_p, int64, double_p, int64_p, int64, int64_p,
+        double_p, double_p, c_int, c_double, c_double, int64, double_p]
+    lib.pq_cell_list_histogram.restype = None
+
+    lib.pq_cell_list_pair_counts.argtypes = [
+        double_p, int64_p, int64, double_p, int64_p, int64, int64_p,
+        double_p, double_p, c_int, c_double, int64_p]
+    lib.pq_cell_list_pair_counts.restype = None
+
+    lib.pq_cell_list_pairs.argtypes = [
+        double_p, int64_p, int64, double_p, int64_p, int64, int64_p,
+        double_p, double_p, c_int, c_double, int64_p, int64_p, double_p]
+    lib.pq_cell_list_pairs.restype = None
+
+    lib.pq_connected_components.argtypes = [int64, int64_p, int64, int64_p]
+    lib.pq_connected_components.restype = None
+
+    lib.pq_voronoi_cells.argtypes = [
+        double_p, double_p, int64_p, int64, int64, c_double, int64,
+        double_p, double_p, int64_p, double_p]
+    lib.pq_voronoi_cells.restype = None
+
+    lib.pq_cell_list_voronoi.argtypes = [
+        double_p, int64, int64_p, int64_p, int64_p, int64_p, int64, double_p,
+        double_p, double_p, c_double, int64, int64,
+        double_p, double_p, int64_p, double_p]
+    lib.pq_cell_list_voronoi.restype = None
+
+    lib.pq_group_centers_of_mass.argtypes = [
+        double_p, double_p, int64, int64, double_p, double_p, double_p]
+    lib.pq_group_centers_of_mass.restype = None
+
+    return lib
+
+
+lib = _load_library()
+
+available = lib is not None
+
+supports_cell_list = True
+
+
+def n_threads() -> int:
+    return lib.pq_n_threads()
+
+
+def minimum_image(dpos: Np2DNumberArray,
+                  box: Np3x3NumberArray,
+                  inv_box: Np3x3NumberArray
+                  ) -> Np2DNumberArray:
+    result = np.empty_like(dpos)
+    lib.pq_minimum_image(dpos, len(dpos), box, inv_box, result)
+    return result
+
+
+def paired_distances(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray,
+                     box: Np3x3NumberArray,
+                     inv_box: Np3x3NumberArray,
+                     periodic: bool
+                     ) -> Np1DNumberArray:
+    result = np.empty(len(pos1))
+    lib.pq_paired_distances(pos1, pos2, len(pos1),
+                            box, inv_box, periodic, result)
+    return result
+
+
+def distances(pos1: Np2DNumberArray,
+              pos2: Np2DNumberArray,
+              box: Np3x3NumberArray,
+              inv_box: Np3x3NumberArray,
+              periodic: bool
+              ) -> Np2DNumberArray:
+    result = np.empty((len(pos1), len(pos2)))
+    lib.pq_distances(pos1, len(pos1), pos2, len(pos2),
+                     box, inv_box, periodic, result)
+    return result
+
+
+def distance_histogram(pos1: Np2DNumberArray,
+                       pos2: Np2DNumberArray,
+                       box: Np3x3NumberArray,
+                       inv_box: Np3x3NumberArray,
+                       periodic: bool,
+                       same: bool,
+                       r_min: float,
+                       r_max: float,
+                       n_bins: int
+                       ) -> Np1DNumberArray:
+    hist = np.empty(n_bins)
+    lib.pq_distance_histogram(pos1, len(pos1), pos2, len(pos2), box, inv_box,
+                              periodic, same, r_min, r_max, n_bins, hist)
+    return hist
+
+
+def cutoff_pairs(pos1: Np2DNumberArray,
+                 pos2: Np2DNumberArray,
+                 box: Np3x3NumberArray,
+                 inv_box: Np3x3NumberArray,
+                 periodic: bool,
+                 same: bool,
+                 cutoff: float
+                 ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    counts = np.empty(len(pos1), dtype=np.int64)
+    lib.pq_cutoff_pair_counts(pos1, len(pos1), pos2, len(pos2), box, inv_box,
+                              periodic, same, cutoff, counts)
+
+    # the pairs of row i are written to offsets[i]:offsets[i+1], so that the
+    # result is ordered as in the NumPy backend independent of the threading
+    offsets = np.zeros(len(pos1) + 1, dtype=np.int64)
+    np.cumsum(counts, out=offsets[1:])
+
+    pairs = np.empty((offsets[-1], 2), dtype=np.int64)
+    pair_distances = np.empty(offsets[-1])
+    lib.pq_cutoff_pairs(pos1, len(pos1), pos2, len(pos2), box, inv_box,
+                        periodic, same, cutoff, offsets, pairs, pair_distances)
+
+    return pairs, pair_distances
+
+
+def cell_list_histogram(cells1: CellList,
+                        cells2: CellList,
+                        box: Np3x3NumberArray,
+                        inv_box: Np3x3NumberArray,
+                        same: bool,
+                        r_min: float,
+                        r_max: float,
+                        n_bins: int
+                        ) -> Np1DNumberArray:
+    hist = np.empty(n_bins)
+    lib.pq_cell_list_histogram(cells1.sorted_pos, cells1.offsets, cells1.n_atoms,
+                               cells2.sorted_pos, cells2.offsets, cells2.n_atoms,
+                               cells1.shape, box, inv_box,
+                               same, r_min, r_max, n_bins, hist)
+    return hist
+
+
+def cell_list_pairs(cells1: CellList,
+                    cells2: CellList,
+                    box: Np3x3NumberArray,
+                    inv_box: Np3x3NumberArray,
+                    same: bool,
+                    cutoff: float
+                    ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    atom_cells = cells1.atom_cells()
+
+    counts = np.empty(cells1.n_atoms, dtype=np.int64)
+    lib.pq_cell_list_pair_counts(cells1.sorted_pos, atom_cells, cells1.n_atoms,
+                                 cells2.sorted_pos, cells2.offsets, cells2.n_atoms,
+                                 cells1.shape, box, inv_box, same, cutoff, counts)
+
+    offsets = np.zeros(cells1.n_atoms + 1, dtype=np.int64)
+    np.cumsum(counts, out=offsets[1:])
+
+    pairs = np.empty((offsets[-1], 2), dtype=np.int64)
+    pair_distances = np.empty(offsets[-1])
+    lib.pq_cell_list_pairs(cells1.sorted_pos, atom_cells, cells1.n_atoms,
+                           cells2.sorted_pos, cells2.offsets, cells2.n_atoms,
+                           cells1.shape, box, inv_box, same, cutoff, offsets,
+                           pairs, pair_distances)
+
+    return pairs, pair_distances
+
+
+def connected_components(n_nodes: int, edges: Np2DIntArray) -> Np1DIntArray:
+    labels = np.empty(n_nodes, dtype=np.int64)
+    lib.pq_connected_components(n_nodes, edges, len(edges), labels)
+    return labels
+
+
+def group_centers_of_mass(pos: Np2DNumberArray,
+                          masses: Np1DNumberArray,
+                          group: int,
+                          box: Np3x3NumberArray,
+                          inv_box: Np3x3NumberArray
+                          ) -> Np2DNumberArray:
+    com = np.empty((len(pos) // group, 3))
+    lib.pq_group_centers_of_mass(pos, masses, len(com), group, box, inv_box, com)
+    return com
+
+
+def _voronoi_outputs(n: int, max_faces: int) -> Tuple[np.ndarray, np.ndarray, np.ndarray, np.ndarray]:
+    return (np.empty(n), np.empty(n), np.full((n, max_faces), -1, dtype=np.int64),
+            np.zeros((n, max_faces)))
+
+
+def voronoi_cells(normals: np.ndarray,
+                  heights: Np2DNumberArray,
+                  counts: Np1DIntArray,
+                  bound: float
+                  ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    n, m = heights.shape
+    max_faces = _voronoi_faces(m)
+
+    volumes, radii, faces, areas = _voronoi_outputs(n, max_faces)
+    lib.pq_voronoi_cells(normals, heights, np.ascontiguousarray(counts, dtype=np.int64), n, m,
+                         bound, max_faces, volumes, radii, faces, areas)
+
+    return volumes, radii, faces, areas
+
+
+def cell_list_voronoi(cells: CellList,
+                      atoms: Np1DIntArray,
+                      weights: Np1DNumberArray,
+                      box: Np3x3NumberArray,
+                      inv_box: Np3x3NumberArray,
+                      bound: float
+                      ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    neighbour_cells = np.ascontiguousarray(cells.neighbour_cells())
+    max_candidates = int(np.max(np.diff(cells.offsets)[neighbour_cells].sum(axis=1)))
+    max_faces = _voronoi_faces(max_candidates)
+
+    volumes, radii, faces, areas = _voronoi_outputs(len(atoms), max_faces)
+    lib.pq_cell_list_voronoi(cells.sorted_pos, cells.n_atoms, cells.offsets, cells.atom_cells(),
+                             neighbour_cells, np.ascontiguousarray(atoms, dtype=np.int64), len(atoms),
+                             np.ascontiguousarray(weights, dtype=np.float64), box, inv_box, bound,
+                             max_candidates, max_faces, volumes, radii, faces, areas)
+
+    return volumes, radii, faces, areas
@@ -0,0 +1,587 @@
+"""
+The Numba implementation of the kernels.
+
+The loops are compiled with numba.njit on their first call and parallelized
+with numba.prange. Histograms are accumulated in one private histogram per
+chunk of rows, which are summed at the end. The backend is only available if
+Numba is installed (numba is None otherwise).
+
+Numba cannot reproduce the shortest float representation of Python, which
+the restart and trajectory files are written with, therefore
+format_restart_lines and format_atom_lines are the ones of the NumPy backend.
+The Voronoi cells are clipped with the scalar routine of the NumPy backend,
+which is compiled here.
+
+All functions expect C-contiguous float64 arrays as prepared by the public
+functions of PQAnalysis.kernels.
+"""
+
+import numpy as np
+
+from beartype.typing import Tuple
+
+from .cellList import CellList
+from ._numpy import format_restart_lines, format_atom_lines, _clip_voronoi_cell, _voronoi_faces
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray, Np2DIntArray
+
+try:
+    import numba
+except ImportError:
+    numba = None
+
+name = "numba"
+
+available = numba is not None
+
+supports_cell_list = True
+
+
+def _jit(function):
+    """
+    Compiles the function lazily with Numba (if installed).
+    """
+    if numba is None:
+        return function
+
+    return numba.njit(parallel=True, cache=True, fastmath=False)(function)
+
+
+def _inline(function):
+    """
+    Compiles a helper function, which is inlined into the calling kernels.
+    """
+    if numba is None:
+        return function
+
+    return numba.njit(inline="always", cache=True)(function)
+
+
+def _serial(function):
+    """
+    Compiles a sequential kernel with Numba (if installed).
+    """
+    if numba is None:
+        return function
+
+    return numba.njit(cache=True)(function)
+
+
+_prange = range if numba is None else numba.prange
+
+
+@_inline
+def _image(box, inv_box, dx, dy, dz):
+    fx = inv_box[0, 0] * dx + inv_box[0, 1] * dy + inv_box[0, 2] * dz
+    fy = inv_box[1, 0] * dx + inv_box[1, 1] * dy + inv_box[1, 2] * dz
+    fz = inv_box[2, 0] * dx + inv_box[2, 1] * dy + inv_box[2, 2] * dz
+
+    fx -= np.rint(fx)
+    fy -= np.rint(fy)
+    fz -= np.rint(fz)
+
+    return (box[0, 0] * fx + box[0, 1] * fy + box[0, 2] * fz,
+            box[1, 0] * fx + box[1, 1] * fy + box[1, 2] * fz,
+            box[2, 0] * fx + box[2, 1] * fy + box[2, 2] * fz)
+
+
+@_inline
+def _distance(box, inv_box, periodic, x1, y1, z1, x2, y2, z2):
+    dx, dy, dz = x1 - x2, y1 - y2, z1 - z2
+
+    if periodic:
+        dx, dy, dz = _image(box, inv_box, dx, dy, dz)
+
+    return np.sqrt(dx * dx + dy * dy + dz * dz)
+
+
+@_inline
+def _bin(r, r_min, r_max, inv_width, n_bins):
+    if r < r_min or r >= r_max:
+        return -1
+
+    return min(int((r - r_min) * inv_width), n_bins - 1)
+
+
+@_jit
+def _minimum_image(dpos, box, inv_box):
+    result = np.empty_like(dpos)
+
+    for i in _prange(dpos.shape[0]):
+        dx, dy, dz = _image(box, inv_box, dpos[i, 0], dpos[i, 1], dpos[i, 2])
+        result[i, 0] = dx
+        result[i, 1] = dy
+        result[i, 2] = dz
+
+    return result
+
+
+@_jit
+def _paired_distances(pos1, pos2, box, inv_box, periodic):
+    result = np.empty(pos1.shape[0])
+
+    for i in _prange(pos1.shape[0]):
+        result[i] = _distance(box, inv_box, periodic,
+                              pos1[i, 0], pos1[i, 1], pos1[i, 2],
+                              pos2[i, 0], pos2[i, 1], pos2[i, 2])
+
+    return result
+
+
+@_jit
+def _distances(pos1, pos2, box, inv_box, periodic):
+    result = np.empty((pos1.shape[0], pos2.shape[0]))
+
+    for i in _prange(pos1.shape[0]):
+        for j in range(pos2.shape[0]):
+            result[i, j] = _distance(box, inv_box, periodic,
+                                     pos1[i, 0], pos1[i, 1], pos1[i, 2],
+                                     pos2[j, 0], pos2[j, 1], pos2[j, 2])
+
+    return result
+
+
+@_jit
+def _distance_histogram(pos1, pos2, box, inv_box, periodic, same, r_min, r_max, n_bins, n_chunks):
+    inv_width = n_bins / (r_max - r_min)
+    n1, n2 = pos1.shape[0], pos2.shape[0]
+
+    # one private histogram per chunk of rows
+    local = np.zeros((n_chunks, n_bins))
+
+    for chunk in _prange(n_chunks):
+        for i in range(chunk, n1, n_chunks):
+            j_start = i + 1 if same else 0
+
+            for j in range(j_start, n2):
+                r = _distance(box, inv_box, periodic,
+                              pos1[i, 0], pos1[i, 1], pos1[i, 2],
+                              pos2[j, 0], pos2[j, 1], pos2[j, 2])
+
+                bin = _bin(r, r_min, r_max, inv_width, n_bins)
+                if bin >= 0:
+                    local[chunk, bin] += 1.0
+
+    return local.sum(axis=0)
+
+
+@_jit
+def _cell_list_histogram(pos1, offsets1, pos2, offsets2, shape, box, inv_box,
+                         same, r_min, r_max, n_bins, n_chunks):
+    inv_width = n_bins / (r_max - r_min)
+    nx, ny, nz = shape[0], shape[1], shape[2]
+    n_cells = nx * ny * nz
+
+    local = np.zeros((n_chunks, n_bins))
+
+    for chunk in _prange(n_chunks):
+        for c in range(chunk, n_cells, n_chunks):
+            cx = c // (ny * nz)
+            cy = (c // nz) % ny
+            cz = c % nz
+
+            for ox in range(-1, 2):
+                for oy in range(-1, 2):
+                    for oz in range(-1, 2):
+                        neighbour = (((cx + ox) % nx) * ny +
+                                     (cy + oy) % ny) * nz + (cz + oz) % nz
+
+                        for i in range(offsets1[c], offsets1[c + 1]):
+                            j_start = offsets2[neighbour]
+                            if same and j_start <= i:
+                                j_start = i + 1
+
+                            for j in range(j_start, offsets2[neighbour + 1]):
+                                r = _distance(box, inv_box, True,
+                                              pos1[0, i], pos1[1, i], pos1[2, i],
+                                              pos2[0, j], pos2[1, j], pos2[2, j])
+
+                                bin = _bin(r, r_min, r_max, inv_width, n_bins)
+                                if bin >= 0:
+                                    local[chunk, bin] += 1.0
+
+    return local.sum(axis=0)
+
+
+@_jit
+def _cutoff_pair_counts(pos1, pos2, box, inv_box, periodic, same, cutoff):
+    counts = np.zeros(pos1.shape[0], dtype=np.int64)
+
+    for i in _prange(pos1.shape[0]):
+        j_start = i + 1 if same else 0
+        count = 0
+
+        for j in range(j_start, pos2.shape[0]):
+            r = _distance(box, inv_box, periodic,
+                          pos1[i, 0], pos1[i, 1], pos1[i, 2],
+                          pos2[j, 0], pos2[j, 1], pos2[j, 2])
+            if r < cutoff:
+                count += 1
+
+        counts[i] = count
+
+    return counts
+
+
+@_jit
+def _cutoff_pairs(pos1, pos2, box, inv_box, periodic, same, cutoff, offsets):
+    pairs = np.empty((offsets[-1], 2), dtype=np.int64)
+    pair_distances = np.empty(offsets[-1])
+
+    for i in _prange(pos1.shape[0]):
+        j_start = i + 1 if same else 0
+        k = offsets[i]
+
+        for j in range(j_start, pos2.shape[0]):
+            r = _distance(box, inv_box, periodic,
+                          pos1[i, 0], pos1[i, 1], pos1[i, 2],
+                          pos2[j, 0], pos2[j, 1], pos2[j, 2])
+            if r < cutoff:
+                pairs[k, 0] = i
+                pairs[k, 1] = j
+                pair_distances[k] = r
+                k += 1
+
+    return pairs, pair_distances
+
+
+@_inline
+def _visit_count(pos1, i, c, pos2, offsets2, shape, box, inv_box, same, cutoff,
+                 pairs, pair_distances, k):
+    """
+    Counts (or stores, if pairs has rows) the cell list pairs of the sorted atom i.
+    """
+    nx, ny, nz = shape[0], shape[1], shape[2]
+    cx = c // (ny * nz)
+    cy = (c // nz) % ny
+    cz = c % nz
+
+    for ox in range(-1, 2):
+        for oy in range(-1, 2):
+            for oz in range(-1, 2):
+                neighbour = (((cx + ox) % nx) * ny +
+                             (cy + oy) % ny) * nz + (cz + oz) % nz
+
+                j_start = offsets2[neighbour]
+                if same and j_start <= i:
+                    j_start = i + 1
+
+                for j in range(j_start, offsets2[neighbour + 1]):
+                    r = _distance(box, inv_box, True,
+                                  pos1[0, i], pos1[1, i], pos1[2, i],
+                                  pos2[0, j], pos2[1, j], pos2[2, j])
+
+                    if r < cutoff:
+                        if pairs.shape[0] > 0:
+                            pairs[k, 0] = i
+                            pairs[k, 1] = j
+                            pair_distances[k] = r
+                        k += 1
+
+    return k
+
+
+@_jit
+def _cell_list_pair_counts(pos1, cells1, pos2, offsets2, shape, box, inv_box, same, cutoff):
+    counts = np.zeros(pos1.shape[1], dtype=np.int64)
+    no_pairs = np.empty((0, 2), dtype=np.int64)
+    no_distances = np.empty(0)
+
+    for i in _prange(pos1.shape[1]):
+        counts[i] = _visit_count(pos1, i, cells1[i], pos2, offsets2, shape, box, inv_box,
+                                 same, cutoff, no_pairs, no_distances, 0)
+
+    return counts
+
+
+@_jit
+def _cell_list_pairs(pos1, cells1, pos2, offsets2, shape, box, inv_box, same, cutoff, offsets):
+    pairs = np.empty((offsets[-1], 2), dtype=np.int64)
+    pair_distances = np.empty(offsets[-1])
+
+    for i in _prange(pos1.shape[1]):
+        _visit_count(pos1, i, cells1[i], pos2, offsets2, shape, box, inv_box,
+                     same, cutoff, pairs, pair_distances, offsets[i])
+
+    return pairs, pair_distances
+
+
+@_serial
+def _connected_components(n_nodes, edges):
+    labels = np.arange(n_nodes)
+
+    for e in range(edges.shape[0]):
+        # find the roots with path halving
+        a = edges[e, 0]
+        while labels[a] != a:
+            labels[a] = labels[labels[a]]
+            a = labels[a]
+
+        b = edges[e, 1]
+        while labels[b] != b:
+            labels[b] = labels[labels[b]]
+            b = labels[b]
+
+        # the smaller root becomes the root of the union
+        if a < b:
+            labels[b] = a
+        elif b < a:
+            labels[a] = b
+
+    # the parents have smaller indices, so that one ascending pass flattens the trees
+    for i in range(n_nodes):
+        labels[i] = labels[labels[i]]
+
+    return labels
+
+
+@_jit
+def _group_centers_of_mass(pos, masses, group, box, inv_box):
+    n_groups = pos.shape[0] // group
+    com = np.empty((n_groups, 3))
+
+    for g in _prange(n_groups):
+        first = g * group
+        x0, y0, z0 = pos[first, 0], pos[first, 1], pos[first, 2]
+
+        sx, sy, sz, total = 0.0, 0.0, 0.0, 0.0
+
+        for i in range(first, first + group):
+            dx, dy, dz = _image(box, inv_box,
+                                pos[i, 0] - x0, pos[i, 1] - y0, pos[i, 2] - z0)
+            sx += masses[i] * (dx + x0)
+            sy += masses[i] * (dy + y0)
+            sz += masses[i] * (dz + z0)
+            total += masses[i]
+
+        cx, cy, cz = _image(box, inv_box, sx / total, sy / total, sz / total)
+        com[g, 0] = cx
+        com[g, 1] = cy
+        com[g, 2] = cz
+
+    return com
+
+
+_clip_cell = _serial(_clip_voronoi_cell)
+
+
+@_jit
+def _voronoi_cells(normals, heights, counts, bound, max_faces, n_chunks):
+    n = heights.shape[0]
+    volumes = np.zeros(n)
+    radii = np.zeros(n)
+    faces = np.full((n, max_faces), -1, dtype=np.int64)
+    areas = np.zeros((n, max_faces))
+
+    chunk_size = (n + n_chunks - 1) // n_chunks
+
+    for chunk in _prange(n_chunks):
+        # the clipping buffers are shared by all atoms of a chunk
+        vertices = np.zeros((max_faces, max_faces, 3))
+        n_vertices = np.zeros(max_faces, dtype=np.int64)
+        face_normals = np.zeros((max_faces, 3))
+        face_heights = np.zeros(max_faces)
+        face_ids = np.zeros(max_faces, dtype=np.int64)
+        polygon = np.zeros((max_faces, 3))
+        points = np.zeros((2 * max_faces, 3))
+
+        for i in range(chunk * chunk_size, min(n, (chunk + 1) * chunk_size)):
+            volume, radius = _clip_cell(normals[i], heights[i], counts[i], bound, faces[i], areas[i],
+                                        vertices, n_vertices, face_normals, face_heights,
+                                        face_ids, polygon, points)
+            volumes[i] = volume
+            radii[i] = radius
+
+    return volumes, radii, faces, areas
+
+
+@_jit
+def _cell_list_voronoi(pos, offsets, atom_cells, neighbour_cells, atoms, weights, box, inv_box,
+                       bound, max_candidates, max_faces, n_chunks):
+    n = atoms.shape[0]
+    volumes = np.zeros(n)
+    radii = np.zeros(n)
+    faces = np.full((n, max_faces), -1, dtype=np.int64)
+    areas = np.zeros((n, max_faces))
+
+    chunk_size = (n + n_chunks - 1) // n_chunks
+
+    for chunk in _prange(n_chunks):
+        vertices = np.zeros((max_faces, max_faces, 3))
+        n_vertices = np.zeros(max_faces, dtype=np.int64)
+        face_normals = np.zeros((max_faces, 3))
+        face_heights = np.zeros(max_faces)
+        face_ids = np.zeros(max_faces, dtype=np.int64)
+        polygon = np.zeros((max_faces, 3))
+        points = np.zeros((2 * max_faces, 3))
+
+        candidate_heights = np.zeros(max_candidates)
+        candidate_normals = np.zeros((max_candidates, 3))
+        candidate_atoms = np.zeros(max_candidates, dtype=np.int64)
+
+        for q in range(chunk * chunk_size, min(n, (chunk + 1) * chunk_size)):
+            i = atoms[q]
+            count = 0
+
+            for c in neighbour_cells[atom_cells[i]]:
+                for j in range(offsets[c], offsets[c + 1]):
+                    dx, dy, dz = _image(box, inv_box, pos[0, j] - pos[0, i],
+                                        pos[1, j] - pos[1, i], pos[2, j] - pos[2, i])
+                    r = np.sqrt(dx * dx + dy * dy + dz * dz)
+
+                    if j == i or r == 0.0:
+                        continue
+
+                    candidate_heights[count] = (r * r + weights[i] - weights[j]) / (2.0 * r)
+                    candidate_normals[count, 0] = dx / r
+                    candidate_normals[count, 1] = dy / r
+                    candidate_normals[count, 2] = dz / r
+                    candidate_atoms[count] = j
+                    count += 1
+
+            # the planes are clipped in the order of their distance to the atom
+            order = np.argsort(candidate_heights[:count])
+
+            volume, radius = _clip_cell(candidate_normals[order], candidate_heights[order], count,
+                                        bound, faces[q], areas[q], vertices, n_vertices,
+                                        face_normals, face_heights, face_ids, polygon, points)
+            volumes[q] = volume
+            radii[q] = radius
+
+            for f in range(max_faces):
+                if faces[q, f] >= 0:
+                    faces[q, f] = candidate_atoms[order[faces[q, f]]]
+
+    return volumes, radii, faces, areas
+
+
+def _n_chunks() -> int:
+    return 4 * numba.get_num_threads()
+
+
+def minimum_image(dpos: Np2DNumberArray,
+                  box: Np3x3NumberArray,
+                  inv_box: Np3x3NumberArray
+                  ) -> Np2DNumberArray:
+    return _minimum_image(dpos, box, inv_box)
+
+
+def paired_distances(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray,
+                     box: Np3x3NumberArray,
+                     inv_box: Np3x3NumberArray,
+                     periodic: bool
+                     ) -> Np1DNumberArray:
+    return _paired_distances(pos1, pos2, box, inv_box, periodic)
+
+
+def distances(pos1: Np2DNumberArray,
+              pos2: Np2DNumberArray,
+              box: Np3x3NumberArray,
+              inv_box: Np3x3NumberArray,
+              periodic: bool
+              ) -> Np2DNumberArray:
+    return _distances(pos1, pos2, box, inv_box, periodic)
+
+
+def distance_histogram(pos1: Np2DNumberArray,
+                       pos2: Np2DNumberArray,
+                       box: Np3x3NumberArray,
+                       inv_box: Np3x3NumberArray,
+                       periodic: bool,
+                       same: bool,
+                       r_min: float,
+                       r_max: float,
+                       n_bins: int
+                       ) -> Np1DNumberArray:
+    return _distance_histogram(pos1, pos2, box, inv_box, periodic, same,
+                               r_min, r_max, n_bins, _n_chunks())
+
+
+def cell_list_histogram(cells1: CellList,
+                        cells2: CellList,
+                        box: Np3x3NumberArray,
+                        inv_box: Np3x3NumberArray,
+                        same: bool,
+                        r_min: float,
+                        r_max: float,
+                        n_bins: int
+                        ) -> Np1DNumberArray:
+    return _cell_list_histogram(cells1.sorted_pos, cells1.offsets,
+                                cells2.sorted_pos, cells2.offsets,
+                                cells1.shape, box, inv_box,
+                                same, r_min, r_max, n_bins, _n_chunks())
+
+
+def cutoff_pairs(pos1: Np2DNumberArray,
+                 pos2: Np2DNumberArray,
+                 box: Np3x3NumberArray,
+                 inv_box: Np3x3NumberArray,
+                 periodic: bool,
+                 same: bool,
+                 cutoff: float
+                 ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    counts = _cutoff_pair_counts(
+        pos1, pos2, box, inv_box, periodic, same, cutoff)
+
+    # the pairs of row i are written to offsets[i]:offsets[i+1]
+    offsets = np.zeros(len(pos1) + 1, dtype=np.int64)
+    np.cumsum(counts, out=offsets[1:])
+
+    return _cutoff_pairs(pos1, pos2, box, inv_box, periodic, same, cutoff, offsets)
+
+
+def cell_list_pairs(cells1: CellList,
+                    cells2: CellList,
+                    box: Np3x3NumberArray,
+                    inv_box: Np3x3NumberArray,
+                    same: bool,
+                    cutoff: float
+                    ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    atom_cells = cells1.atom_cells()
+
+    counts = _cell_list_pair_counts(cells1.sorted_pos, atom_cells, cells2.sorted_pos,
+                                    cells2.offsets, cells1.shape, box, inv_box, same, cutoff)
+
+    # the pairs of the sorted atom i are written to offsets[i]:offsets[i+1]
+    offsets = np.zeros(len(counts) + 1, dtype=np.int64)
+    np.cumsum(counts, out=offsets[1:])
+
+    return _cell_list_pairs(cells1.sorted_pos, atom_cells, cells2.sorted_pos, cells2.offsets,
+                            cells1.shape, box, inv_box, same, cutoff, offsets)
+
+
+def connected_components(n_nodes: int, edges: Np2DIntArray) -> Np1DIntArray:
+    return _connected_components(n_nodes, edges)
+
+
+def group_centers_of_mass(pos: Np2DNumberArray,
+                          masses: Np1DNumberArray,
+                          group: int,
+                          box: Np3x3NumberArray,
+                          inv_box: Np3x3NumberArray
+                          ) -> Np2DNumberArray:
+    return _group_centers_of_mass(pos, masses, group, box, inv_box)
+
+
+def voronoi_cells(normals: np.ndarray,
+                  heights: Np2DNumberArray,
+                  counts: Np1DIntArray,
+                  bound: float
+                  ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    return _voronoi_cells(normals, heights, counts, bound,
+                          _voronoi_faces(heights.shape[1]), _n_chunks())
+
+
+def cell_list_voronoi(cells: CellList,
+                      atoms: Np1DIntArray,
+                      weights: Np1DNumberArray,
+                      box: Np3x3NumberArray,
+                      inv_box: Np3x3NumberArray,
+                      bound: float
+                      ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    neighbour_cells = cells.neighbour_cells()
+    max_candidates = int(np.max(np.diff(cells.offsets)[neighbour_cells].sum(axis=1)))
+
+    return _cell_list_voronoi(cells.sorted_pos, cells.offsets, cells.atom_cells(), neighbour_cells,
+                              atoms, weights, box, inv_box, bound, max_candidates,
+                              _voronoi_faces(max_candidates), _n_chunks())
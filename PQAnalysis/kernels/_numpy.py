@@ -0,0 +1,519 @@
+"""
+The NumPy implementation of the kernels.
+
+This backend is always available. The pair loops are evaluated in blocks of
+rows, so that the temporary arrays stay small independent of the system size.
+
+The Voronoi cells are clipped atom by atom in plain Python by
+_clip_voronoi_cell, which is written with scalar loops, so that the Numba
+backend compiles the very same routine.
+
+All functions expect C-contiguous float64 arrays as prepared by the public
+functions of PQAnalysis.kernels.
+"""
+
+import math
+
+import numpy as np
+
+from beartype.typing import Tuple, List
+
+from .cellList import CellList
+from ..types import Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray, Np2DIntArray, Np1DIntArray
+
+name = "numpy"
+
+available = True
+
+# the blocked pair loops of distance_histogram and cutoff_pairs are used instead of cell lists
+supports_cell_list = False
+
+# maximum number of pair distances evaluated at once
+_block_size = 1 << 20
+
+
+def minimum_image(dpos: Np2DNumberArray,
+                  box: Np3x3NumberArray,
+                  inv_box: Np3x3NumberArray
+                  ) -> Np2DNumberArray:
+    fractional_pos = dpos @ inv_box.T
+    fractional_pos -= np.round(fractional_pos)
+    return fractional_pos @ box.T
+
+
+def paired_distances(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray,
+                     box: Np3x3NumberArray,
+                     inv_box: Np3x3NumberArray,
+                     periodic: bool
+                     ) -> Np1DNumberArray:
+    dpos = pos1 - pos2
+    if periodic:
+        dpos = minimum_image(dpos, box, inv_box)
+    return np.sqrt(np.sum(dpos**2, axis=1))
+
+
+def _row_blocks(n1: int, n2: int):
+    rows = max(1, _block_size // max(n2, 1))
+    for start in range(0, n1, rows):
+        yield start, min(start + rows, n1)
+
+
+def _block_distances(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray,
+                     box: Np3x3NumberArray,
+                     inv_box: Np3x3NumberArray,
+                     periodic: bool
+                     ) -> Np2DNumberArray:
+    dpos = (pos1[:, None, :] - pos2[None, :, :]).reshape(-1, 3)
+    if periodic:
+        dpos = minimum_image(dpos, box, inv_box)
+    return np.sqrt(np.sum(dpos**2, axis=1)).reshape(len(pos1), len(pos2))
+
+
+def distances(pos1: Np2DNumberArray,
+              pos2: Np2DNumberArray,
+              box: Np3x3NumberArray,
+              inv_box: Np3x3NumberArray,
+              periodic: bool
+              ) -> Np2DNumberArray:
+    result = np.empty((len(pos1), len(pos2)))
+    for start, stop in _row_blocks(len(pos1), len(pos2)):
+        result[start:stop] = _block_distances(
+            pos1[start:stop], pos2, box, inv_box, periodic)
+    return result
+
+
+def _upper_mask(start: int, stop: int, n2: int) -> np.ndarray:
+    return np.arange(n2)[None, :] > np.arange(start, stop)[:, None]
+
+
+def distance_histogram(pos1: Np2DNumberArray,
+                       pos2: Np2DNumberArray,
+                       box: Np3x3NumberArray,
+                       inv_box: Np3x3NumberArray,
+                       periodic: bool,
+                       same: bool,
+                       r_min: float,
+                       r_max: float,
+                       n_bins: int
+                       ) -> Np1DNumberArray:
+    inv_width = n_bins / (r_max - r_min)
+    hist = np.zeros(n_bins)
+
+    for start, stop in _row_blocks(len(pos1), len(pos2)):
+        r = _block_distances(pos1[start:stop], pos2, box, inv_box, periodic)
+
+        if same:
+            r = r[_upper_mask(start, stop, len(pos2))]
+
+        r = r[(r >= r_min) & (r < r_max)]
+        bins = np.minimum(((r - r_min) * inv_width).astype(np.int64), n_bins - 1)
+        hist += np.bincount(bins, minlength=n_bins)
+
+    return hist
+
+
+def cutoff_pairs(pos1: Np2DNumberArray,
+                 pos2: Np2DNumberArray,
+                 box: Np3x3NumberArray,
+                 inv_box: Np3x3NumberArray,
+                 periodic: bool,
+                 same: bool,
+                 cutoff: float
+                 ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    pairs = [np.zeros((0, 2), dtype=np.int64)]
+    pair_distances = [np.zeros(0)]
+
+    for start, stop in _row_blocks(len(pos1), len(pos2)):
+        r = _block_distances(pos1[start:stop], pos2, box, inv_box, periodic)
+
+        mask = r < cutoff
+        if same:
+            mask &= _upper_mask(start, stop, len(pos2))
+
+        i, j = np.nonzero(mask)
+        pairs.append(np.column_stack((i + start, j)).astype(np.int64))
+        pair_distances.append(r[i, j])
+
+    return np.concatenate(pairs), np.concatenate(pair_distances)
+
+
+def connected_components(n_nodes: int, edges: Np2DIntArray) -> Np1DIntArray:
+    labels = np.arange(n_nodes)
+
+    # the roots of each edge are hooked onto the smaller root and the trees are
+    # flattened by pointer jumping, until no edge connects two trees
+    while True:
+        first, second = labels[edges[:, 0]], labels[edges[:, 1]]
+        different = first != second
+
+        if not np.any(different):
+            return labels
+
+        np.minimum.at(labels, np.maximum(first, second)[different],
+                      np.minimum(first, second)[different])
+
+        while True:
+            jumped = labels[labels]
+
+            if np.array_equal(jumped, labels):
+                break
+
+            labels = jumped
+
+
+def group_centers_of_mass(pos: Np2DNumberArray,
+                          masses: Np1DNumberArray,
+                          group: int,
+                          box: Np3x3NumberArray,
+                          inv_box: Np3x3NumberArray
+                          ) -> Np2DNumberArray:
+    pos = pos.reshape(-1, group, 3)
+    masses = masses.reshape(-1, group)
+
+    reference = pos[:, :1, :]
+    dpos = minimum_image((pos - reference).reshape(-1, 3), box, inv_box)
+    pos = dpos.reshape(-1, group, 3) + reference
+
+    com = np.sum(pos * masses[:, :, None], axis=1) / \
+        np.sum(masses, axis=1)[:, None]
+
+    return minimum_image(com, box, inv_box)
+
+
+def _clip_voronoi_cell(normals, heights, count, bound, candidates, areas,
+                       vertices, n_vertices, face_normals, face_heights, face_ids,
+                       polygon, points):
+    """
+    Clips the cube [-bound, bound]^3 around an atom by the planes of its candidates.
+
+    The cell is stored as a list of faces, each a convex polygon. Each plane
+    x . normals[k] <= heights[k] clips all faces (Sutherland-Hodgman) and the points
+    on the plane are ordered by their angle around their centroid to form the new
+    face. The planes are sorted by height, so that the clipping stops at the first
+    plane beyond the farthest vertex. Faces of vertices closer than 1e-10 * bound are
+    merged. The buffers are provided by the caller, faces that vanish are reused.
+
+    Returns the volume and the distance of the farthest vertex (inf if the buffers
+    were too small) and writes the candidate index k and the area of each face
+    larger than 1e-10 * bound^2 to candidates and areas, which are padded with -1
+    and 0 by the caller.
+    """
+    max_faces = vertices.shape[0]
+    max_vertices = vertices.shape[1]
+    tolerance = 1e-10 * bound
+
+    for axis in range(3):
+        u = (axis + 1) % 3
+        v = (axis + 2) % 3
+
+        for side in range(2):
+            f = 2 * axis + side
+            sign = 2.0 * side - 1.0
+
+            face_normals[f, :] = 0.0
+            face_normals[f, axis] = sign
+            face_heights[f] = bound
+            face_ids[f] = -1
+            n_vertices[f] = 4
+
+            for corner in range(4):
+                vertices[f, corner, axis] = sign * bound
+                vertices[f, corner, u] = bound if corner == 1 or corner == 2 else -bound
+                vertices[f, corner, v] = bound if corner >= 2 else -bound
+
+    n_faces = 6
+    radius = math.sqrt(3.0) * bound
+
+    for k in range(count):
+        h = heights[k]
+
+        if h >= radius:
+            break
+
+        nx = normals[k, 0]
+        ny = normals[k, 1]
+        nz = normals[k, 2]
+
+        n_points = 0
+
+        for f in range(n_faces):
+            m = n_vertices[f]
+
+            if m == 0:
+                continue
+
+            outside = False
+            for a in range(m):
+                if vertices[f, a, 0] * nx + vertices[f, a, 1] * ny + vertices[f, a, 2] * nz - h > tolerance:
+                    outside = True
+                    break
+
+            if not outside:
+                for a in range(m):
+                    s = vertices[f, a, 0] * nx + vertices[f, a, 1] * ny + vertices[f, a, 2] * nz - h
+
+                    if s >= -tolerance:
+                        if n_points == points.shape[0]:
+                            return 0.0, math.inf
+
+                        for c in range(3):
+                            points[n_points, c] = vertices[f, a, c]
+                        n_points += 1
+
+                continue
+
+            n_out = 0
+            for a in range(m):
+                b = a + 1 if a + 1 < m else 0
+
+                s_a = vertices[f, a, 0] * nx + vertices[f, a, 1] * ny + vertices[f, a, 2] * nz - h
+                s_b = vertices[f, b, 0] * nx + vertices[f, b, 1] * ny + vertices[f, b, 2] * nz - h
+
+                if s_a <= tolerance:
+                    if n_out == max_vertices or n_points == points.shape[0]:
+                        return 0.0, math.inf
+
+                    for c in range(3):
+                        polygon[n_out, c] = vertices[f, a, c]
+                    n_out += 1
+
+                    if s_a >= -tolerance:
+                        for c in range(3):
+                            points[n_points, c] = vertices[f, a, c]
+                        n_points += 1
+
+                if (s_a < -tolerance and s_b > tolerance) or (s_a > tolerance and s_b < -tolerance):
+                    if n_out == max_vertices or n_points == points.shape[0]:
+                        return 0.0, math.inf
+
+                    t = s_a / (s_a - s_b)
+                    for c in range(3):
+                        polygon[n_out, c] = vertices[f, a, c] + t * (vertices[f, b, c] - vertices[f, a, c])
+
+                    for c in range(3):
+                        points[n_points, c] = polygon[n_out, c]
+                    n_out += 1
+                    n_points += 1
+
+            n_vertices[f] = n_out if n_out >= 3 else 0
+            for a in range(n_out):
+                for c in range(3):
+                    vertices[f, a, c] = polygon[a, c]
+
+        if n_points >= 3:
+            slot = -1
+            for f in range(n_faces):
+                if n_vertices[f] == 0:
+                    slot = f
+                    break
+
+            if slot < 0:
+                if n_faces == max_faces:
+                    return 0.0, math.inf
+
+                slot = n_faces
+                n_faces += 1
+
+            cx = 0.0
+            cy = 0.0
+            cz = 0.0
+            for p in range(n_points):
+                cx += points[p, 0]
+                cy += points[p, 1]
+                cz += points[p, 2]
+            cx /= n_points
+            cy /= n_points
+            cz /= n_points
+
+            # an orthonormal basis (u, w) of the plane
+            if abs(nx) < 0.9:
+                ux, uy, uz = 0.0, nz, -ny
+            else:
+                ux, uy, uz = -nz, 0.0, nx
+            norm = math.sqrt(ux * ux + uy * uy + uz * uz)
+            ux /= norm
+            uy /= norm
+            uz /= norm
+            wx = ny * uz - nz * uy
+            wy = nz * ux - nx * uz
+            wz = nx * uy - ny * ux
+
+            angles = np.empty(n_points)
+            for p in range(n_points):
+                dx = points[p, 0] - cx
+                dy = points[p, 1] - cy
+                dz = points[p, 2] - cz
+                angles[p] = math.atan2(dx * wx + dy * wy + dz * wz, dx * ux + dy * uy + dz * uz)
+
+            n_unique = 0
+            for p in np.argsort(angles):
+                if n_unique > 0 and \
+                        abs(points[p, 0] - vertices[slot, n_unique - 1, 0]) <= tolerance and \
+                        abs(points[p, 1] - vertices[slot, n_unique - 1, 1]) <= tolerance and \
+                        abs(points[p, 2] - vertices[slot, n_unique - 1, 2]) <= tolerance:
+                    continue
+
+                if n_unique == max_vertices:
+                    return 0.0, math.inf
+
+                for c in range(3):
+                    vertices[slot, n_unique, c] = points[p, c]
+                n_unique += 1
+
+            if n_unique > 1 and \
+                    abs(vertices[slot, 0, 0] - vertices[slot, n_unique - 1, 0]) <= tolerance and \
+                    abs(vertices[slot, 0, 1] - vertices[slot, n_unique - 1, 1]) <= tolerance and \
+                    abs(vertices[slot, 0, 2] - vertices[slot, n_unique - 1, 2]) <= tolerance:
+                n_unique -= 1
+
+            if n_unique >= 3:
+                n_vertices[slot] = n_unique
+                face_normals[slot, 0] = nx
+                face_normals[slot, 1] = ny
+                face_normals[slot, 2] = nz
+                face_heights[slot] = h
+                face_ids[slot] = k
+            else:
+                n_vertices[slot] = 0
+
+        radius = 0.0
+        for f in range(n_faces):
+            for a in range(n_vertices[f]):
+                r = vertices[f, a, 0]**2 + vertices[f, a, 1]**2 + vertices[f, a, 2]**2
+                radius = max(radius, r)
+        radius = math.sqrt(radius)
+
+        if radius == 0.0:
+            return 0.0, 0.0
+
+    volume = 0.0
+    n_out = 0
+    for f in range(n_faces):
+        m = n_vertices[f]
+
+        ax = 0.0
+        ay = 0.0
+        az = 0.0
+        for a in range(m):
+            b = a + 1 if a + 1 < m else 0
+            ax += vertices[f, a, 1] * vertices[f, b, 2] - vertices[f, a, 2] * vertices[f, b, 1]
+            ay += vertices[f, a, 2] * vertices[f, b, 0] - vertices[f, a, 0] * vertices[f, b, 2]
+            az += vertices[f, a, 0] * vertices[f, b, 1] - vertices[f, a, 1] * vertices[f, b, 0]
+
+        area = 0.5 * abs(ax * face_normals[f, 0] + ay * face_normals[f, 1] + az * face_normals[f, 2])
+        volume += face_heights[f] * area / 3.0
+
+        if face_ids[f] >= 0 and area > tolerance * bound:
+            candidates[n_out] = face_ids[f]
+            areas[n_out] = area
+            n_out += 1
+
+    return volume, radius
+
+
+def _voronoi_faces(n_candidates: int) -> int:
+    """
+    Returns the number of face slots of the clipping buffers of a Voronoi cell.
+    """
+    return 6 + min(n_candidates, 122)
+
+
+def voronoi_cells(normals: np.ndarray,
+                  heights: Np2DNumberArray,
+                  counts: Np1DIntArray,
+                  bound: float
+                  ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    n, m = heights.shape
+    max_faces = _voronoi_faces(m)
+
+    volumes = np.zeros(n)
+    radii = np.zeros(n)
+    faces = np.full((n, max_faces), -1, dtype=np.int64)
+    areas = np.zeros((n, max_faces))
+
+    vertices = np.zeros((max_faces, max_faces, 3))
+    buffers = (np.zeros(max_faces, dtype=np.int64), np.zeros((max_faces, 3)),
+               np.zeros(max_faces), np.zeros(max_faces, dtype=np.int64),
+               np.zeros((max_faces, 3)), np.zeros((2 * max_faces, 3)))
+
+    for i in range(n):
+        volumes[i], radii[i] = _clip_voronoi_cell(normals[i], heights[i], counts[i], bound,
+                                                  faces[i], areas[i], vertices, *buffers)
+
+    return volumes, radii, faces, areas
+
+
+def cell_list_voronoi(cells: CellList,
+                      atoms: Np1DIntArray,
+                      weights: Np1DNumberArray,
+                      box: Np3x3NumberArray,
+                      inv_box: Np3x3NumberArray,
+                      bound: float
+                      ) -> Tuple[Np1DNumberArray, Np1DNumberArray, Np2DIntArray, Np2DNumberArray]:
+    pos = cells.sorted_pos.T
+    table = cells.cell_table(sorted_indices=True)
+
+    candidates = table[cells.neighbour_cells()[cells.atom_cells()[atoms]]].reshape(len(atoms), -1)
+
+    dpos = minimum_image((pos[np.maximum(candidates, 0)] - pos[atoms, np.newaxis, :]).reshape(-1, 3),
+                         box, inv_box).reshape(candidates.shape + (3,))
+
+    distances = np.linalg.norm(dpos, axis=-1)
+    valid = (candidates >= 0) & (distances > 0.0)
+
+    with np.errstate(all="ignore"):
+        differences = weights[atoms, np.newaxis] - weights[candidates]
+        heights = np.where(valid, (distances**2 + differences) / (2.0 * distances), np.inf)
+        normals = dpos / distances[..., np.newaxis]
+
+    # the planes are clipped in the order of their distance to the atom
+    order = np.argsort(heights, axis=1, kind="stable")
+    counts = np.count_nonzero(valid, axis=1)
+    order = order[:, :max(int(counts.max(initial=0)), 1)]
+
+    heights = np.ascontiguousarray(np.take_along_axis(heights, order, axis=1))
+    normals = np.ascontiguousarray(np.take_along_axis(normals, order[..., np.newaxis], axis=1))
+    candidates = np.take_along_axis(candidates, order, axis=1)
+
+    volumes, radii, faces, areas = voronoi_cells(normals, heights, counts, bound)
+
+    faces = np.where(faces >= 0, np.take_along_axis(candidates, np.maximum(faces, 0), axis=1), -1)
+
+    return volumes, radii, faces, areas
+
+
+def _to_strings(array: np.ndarray) -> List[str]:
+    # str of Python floats/ints is identical to str of float64/int64 scalars,
+    # but float32 scalars have to stay NumPy scalars to keep their shortest repr
+    if array.dtype == np.float64 or np.issubdtype(array.dtype, np.integer):
+        return list(map(str, array.tolist()))
+
+    return list(map(str, array))
+
+
+def format_restart_lines(names: List[str],
+                         mol_types: Np1DIntArray,
+                         pos: Np2DNumberArray,
+                         vel: Np2DNumberArray,
+                         forces: Np2DNumberArray,
+                         extended: bool
+                         ) -> List[str]:
+    columns = [_to_strings(array[:, k])
+               for array in (pos, vel, forces) for k in range(3)]
+    mol_types = _to_strings(mol_types)
+
+    lines = []
+    for i, values in enumerate(zip(*columns)):
+        values = " ".join(values)
+        line = f"{names[i]}    {i}    {mol_types[i]}    {values} "
+        lines.append(line + values if extended else line)
+
+    return lines
+
+
+def format_atom_lines(names: List[str], values: Np2DNumberArray) -> List[str]:
+    columns = [_to_strings(values[:, k]) for k in range(values.shape[1])]
+
+    return [f"{name} {' '.join(line_values)}" for name, line_values in zip(names, zip(*columns))]
@@ -0,0 +1,129 @@
+"""
+A module for selecting the implementation of the kernels at runtime.
+
+Each backend is a module implementing the same set of kernel functions. The
+'numpy' backend is always available, the 'native' backend only if the C++
+kernels were compiled during the installation and the 'numba' backend only
+if Numba is installed. By default the fastest available backend is used,
+which can be overridden with the environment variable
+PQANALYSIS_KERNEL_BACKEND or with set_backend. The backend modules are
+imported on their first use, so that e.g. Numba is not imported if the native
+backend is selected.
+
+...
+
+Functions
+---------
+available_backends
+    Returns the names of all available backends.
+get_backend
+    Returns the name of the currently used backend.
+set_backend
+    Selects the backend used by all kernel functions.
+"""
+
+import importlib
+import os
+
+from types import ModuleType
+from beartype.typing import List
+
+from . import KernelBackendError
+
+# ordered from the fastest to the slowest backend
+_backends = ("native", "numba", "numpy")
+
+# the imported backend modules, None if the backend is not available
+_modules = {}
+
+_current = None
+
+
+def _load(name: str) -> ModuleType | None:
+    """
+    Imports the module of a backend on its first use.
+
+    Parameters
+    ----------
+    name : str
+        The name of the backend.
+
+    Returns
+    -------
+    ModuleType | None
+        The module of the backend, None if the backend is not available.
+    """
+    if name not in _modules:
+        module = importlib.import_module(f"._{name}", __package__)
+        _modules[name] = module if module.available else None
+
+    return _modules[name]
+
+
+def available_backends() -> List[str]:
+    """
+    Returns the names of all available backends.
+
+    Returns
+    -------
+    List[str]
+        The names of all available backends, ordered from the fastest to the slowest.
+    """
+    return [name for name in _backends if _load(name) is not None]
+
+
+def get_backend() -> str:
+    """
+    Returns the name of the currently used backend.
+
+    Returns
+    -------
+    str
+        The name of the currently used backend.
+    """
+    return current().name
+
+
+def set_backend(name: str | None = None) -> None:
+    """
+    Selects the backend used by all kernel functions.
+
+    Parameters
+    ----------
+    name : str | None, optional
+        The name of the backend. If None, the fastest available backend is selected, by default None
+
+    Raises
+    ------
+    KernelBackendError
+        If the backend is not known or not available.
+    """
+    global _current
+
+    if name is None:
+        name = next(name for name in _backends if _load(name) is not None)
+
+    if name not in _backends:
+        raise KernelBackendError(
+            f"Unknown kernel backend '{name}'. Known backends are: {', '.join(_backends)}.")
+
+    if _load(name) is None:
+        raise KernelBackendError(
+            f"The kernel backend '{name}' is not available. Available backends are: {', '.join(available_backends())}.")
+
+    _current = _load(name)
+
+
+def current() -> ModuleType:
+    """
+    Returns the module of the currently used backend.
+
+    Returns
+    -------
+    ModuleType
+        The module of the currently used backend.
+    """
+    if _current is None:
+        set_backend(os.environ.get("PQANALYSIS_KERNEL_BACKEND") or None)
+
+    return _current
@@ -0,0 +1,242 @@
+"""
+A module containing the CellList class.
+
+...
+
+Classes
+-------
+CellList
+    A class for sorting positions into a periodic grid of cells.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from numbers import Real
+
+from ..types import Np1DIntArray, Np2DIntArray, Np2DNumberArray, Np3x3NumberArray
+
+
+class CellList:
+    """
+    A class for sorting positions into a periodic grid of cells.
+
+    The grid divides the (possibly triclinic) unit cell along its fractional
+    coordinates into shape[0] x shape[1] x shape[2] cells, whose perpendicular
+    widths are at least the given cutoff. Therefore, all pairs closer than the
+    cutoff are found in the 27 cells surrounding a cell, if each dimension of
+    the grid has at least 3 cells (see is_usable). The grid has at most max_cells
+    cells, coarser grids are used for small cutoffs in large cells.
+
+    The sorted positions are stored as structure of arrays of shape (3, n), so
+    that the x, y and z coordinates of all atoms of a cell are contiguous.
+
+    ...
+
+    Attributes
+    ----------
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+    shape : Np1DIntArray
+        The number of cells along each box vector.
+    order : Np1DIntArray
+        The indices of the positions sorted by their cell.
+    offsets : Np1DIntArray
+        The atoms of cell c are order[offsets[c]:offsets[c+1]].
+    sorted_pos : Np2DNumberArray
+        The sorted positions as array of shape (3, n).
+    max_cells : int
+        The maximum number of cells of a grid.
+    """
+
+    max_cells = 1 << 18
+
+    def __init__(self, pos: Np2DNumberArray, box_matrix: Np3x3NumberArray, cutoff: Real) -> None:
+        """
+        Sorts the given positions into a grid with cells not smaller than cutoff.
+
+        Parameters
+        ----------
+        pos : Np2DNumberArray
+            The positions of shape (n, 3).
+        box_matrix : Np3x3NumberArray
+            The box matrix of the cell.
+        cutoff : Real
+            The minimum perpendicular width of the cells.
+        """
+        pos = np.ascontiguousarray(pos, dtype=np.float64).reshape(-1, 3)
+
+        self.box_matrix = np.asarray(box_matrix, dtype=np.float64)
+        self.shape = self.grid_shape(box_matrix, cutoff)
+
+        flat_indices = self.cell_indices(pos)
+
+        self.order = np.argsort(flat_indices, kind="stable")
+
+        self.offsets = np.zeros(self.n_cells + 1, dtype=np.int64)
+        np.cumsum(np.bincount(flat_indices, minlength=self.n_cells),
+                  out=self.offsets[1:])
+
+        self.sorted_pos = np.ascontiguousarray(pos[self.order].T)
+
+    def cell_indices(self, pos: Np2DNumberArray) -> Np1DIntArray:
+        """
+        Returns the flat index of the cell containing each of the given positions.
+
+        The positions are wrapped into the unit cell, so that any position can be
+        located, e.g. the positions of a second selection queried against this grid.
+
+        Parameters
+        ----------
+        pos : Np2DNumberArray
+            The positions of shape (n, 3).
+
+        Returns
+        -------
+        Np1DIntArray
+            The flat cell index of each position.
+        """
+        fractional_pos = np.reshape(pos, (-1, 3)) @ np.linalg.inv(self.box_matrix).T
+        fractional_pos -= np.floor(fractional_pos)
+
+        cell_indices = np.minimum((fractional_pos * self.shape).astype(np.int64),
+                                  self.shape - 1)
+
+        return np.ravel_multi_index(cell_indices.T, self.shape)
+
+    def neighbour_cells(self) -> Np2DIntArray:
+        """
+        Returns the flat indices of the 27 cells surrounding (and including) each cell.
+
+        The neighbours are periodic images, so that they are only distinct if the
+        grid has at least 3 cells in each dimension (see is_usable).
+
+        Returns
+        -------
+        Np2DIntArray
+            The neighbour cells of shape (n_cells, 27).
+        """
+        cells = np.stack(np.unravel_index(np.arange(self.n_cells), self.shape), axis=1)
+        offsets = np.stack(np.meshgrid([-1, 0, 1], [-1, 0, 1], [-1, 0, 1],
+                                       indexing="ij"), axis=-1).reshape(-1, 3)
+
+        neighbours = (cells[:, np.newaxis, :] + offsets) % self.shape
+
+        return np.ravel_multi_index(tuple(np.moveaxis(neighbours, -1, 0)), self.shape)
+
+    def cell_table(self, sorted_indices: bool = False) -> Np2DIntArray:
+        """
+        Returns the indices of the positions of each cell padded with -1.
+
+        Parameters
+        ----------
+        sorted_indices : bool, optional
+            Whether the indices into sorted_pos are returned instead of the original
+            indices, by default False
+
+        Returns
+        -------
+        Np2DIntArray
+            The indices of shape (n_cells, max_atoms_per_cell).
+        """
+        counts = np.diff(self.offsets)
+        table = np.full((self.n_cells, max(int(np.max(counts, initial=0)), 1)), -1, dtype=np.int64)
+
+        slots = np.arange(self.n_atoms) - np.repeat(self.offsets[:-1], counts)
+        table[self.atom_cells(), slots] = np.arange(self.n_atoms) if sorted_indices else self.order
+
+        return table
+
+    def atom_cells(self) -> Np1DIntArray:
+        """
+        Returns the cell of each sorted position.
+
+        Returns
+        -------
+        Np1DIntArray
+            The flat cell index of each position of sorted_pos.
+        """
+        return np.repeat(np.arange(self.n_cells), np.diff(self.offsets))
+
+    @classmethod
+    def grid_shape(cls, box_matrix: Np3x3NumberArray, cutoff: Real) -> Np1DIntArray:
+        """
+        Returns the largest grid of at most max_cells cells which are not narrower than cutoff.
+
+        Parameters
+        ----------
+        box_matrix : Np3x3NumberArray
+            The box matrix of the cell.
+        cutoff : Real
+            The minimum perpendicular width of the cells.
+
+        Returns
+        -------
+        Np1DIntArray
+            The number of cells along each box vector.
+        """
+        a, b, c = box_matrix.T
+
+        # the huge box of Cell() overflows, which results in a single cell
+        with np.errstate(all="ignore"):
+            volume = abs(np.linalg.det(box_matrix))
+
+            # perpendicular distances between opposite faces of the unit cell
+            widths = volume / np.array([np.linalg.norm(np.cross(b, c)),
+                                        np.linalg.norm(np.cross(c, a)),
+                                        np.linalg.norm(np.cross(a, b))])
+
+            shape = np.floor(widths / cutoff)
+
+        shape = np.clip(np.nan_to_num(shape, posinf=1), 1, 1 << 20)
+
+        # the grid is coarsened evenly, which only widens the cells
+        while np.prod(shape) > cls.max_cells:
+            factor = np.cbrt(cls.max_cells / np.prod(shape))
+            shape = np.maximum(np.floor(shape * factor), 1)
+
+        return shape.astype(np.int64)
+
+    @classmethod
+    def is_usable(cls, box_matrix: Np3x3NumberArray, cutoff: Real) -> bool:
+        """
+        Whether a cell list with the given cutoff has at least 3 cells in each dimension.
+
+        Parameters
+        ----------
+        box_matrix : Np3x3NumberArray
+            The box matrix of the cell.
+        cutoff : Real
+            The minimum perpendicular width of the cells.
+
+        Returns
+        -------
+        bool
+            Whether the 27 neighbour cells of each cell are distinct.
+        """
+        return bool(np.all(cls.grid_shape(box_matrix, cutoff) >= 3))
+
+    @property
+    def n_cells(self) -> int:
+        """
+        The total number of cells.
+
+        Returns
+        -------
+        int
+            The total number of cells.
+        """
+        return int(np.prod(self.shape))
+
+    @property
+    def n_atoms(self) -> int:
+        """
+        The number of sorted positions.
+
+        Returns
+        -------
+        int
+            The number of sorted positions.
+        """
+        return len(self.order)
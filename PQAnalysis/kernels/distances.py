@@ -0,0 +1,246 @@
+"""
+A module containing the distance kernels.
+
+The kernels compute minimum image displacements and distances for whole
+arrays of positions of shape (n, 3) at once. The periodic boundary conditions
+are given by the box matrix of a Cell (box vectors as columns) or None for
+non-periodic systems. The minimum image is obtained as in Cell.image by
+rounding the fractional displacement to the nearest integer vector.
+
+The computation is delegated to the backend selected in
+PQAnalysis.kernels.backends.
+
+...
+
+Functions
+---------
+minimum_image
+    Returns the minimum image of the given displacement vectors.
+paired_distances
+    Returns the minimum image distances between corresponding rows of two position arrays.
+distances
+    Returns the minimum image distance matrix between two position arrays.
+distance_histogram
+    Returns the histogram of the minimum image distances between two position arrays.
+cutoff_pairs
+    Returns all pairs of two position arrays closer than a cutoff.
+"""
+
+import numpy as np
+
+from beartype.typing import Tuple
+from numbers import Real
+
+from .backends import current
+from .cellList import CellList
+from ..types import Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray, Np2DIntArray
+
+
+def _prepare_positions(pos: Np2DNumberArray) -> Np2DNumberArray:
+    return np.ascontiguousarray(pos, dtype=np.float64).reshape(-1, 3)
+
+
+def _prepare_box(box_matrix: Np3x3NumberArray | None) -> Tuple[np.ndarray, np.ndarray, bool]:
+    if box_matrix is None:
+        return np.eye(3), np.eye(3), False
+
+    box = np.ascontiguousarray(box_matrix, dtype=np.float64)
+    return box, np.ascontiguousarray(np.linalg.inv(box)), True
+
+
+def minimum_image(dpos: Np2DNumberArray, box_matrix: Np3x3NumberArray) -> Np2DNumberArray:
+    """
+    Returns the minimum image of the given displacement vectors.
+
+    Parameters
+    ----------
+    dpos : Np2DNumberArray
+        The displacement vectors of shape (n, 3).
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+
+    Returns
+    -------
+    Np2DNumberArray
+        The minimum image displacement vectors of shape (n, 3).
+    """
+    box, inv_box, _ = _prepare_box(box_matrix)
+    return current().minimum_image(_prepare_positions(dpos), box, inv_box)
+
+
+def paired_distances(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray,
+                     box_matrix: Np3x3NumberArray | None = None
+                     ) -> Np1DNumberArray:
+    """
+    Returns the minimum image distances between corresponding rows of two position arrays.
+
+    Parameters
+    ----------
+    pos1 : Np2DNumberArray
+        The first positions of shape (n, 3).
+    pos2 : Np2DNumberArray
+        The second positions of shape (n, 3).
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    Np1DNumberArray
+        The distances |pos1[i] - pos2[i]| of shape (n,).
+
+    Raises
+    ------
+    ValueError
+        If the position arrays are not of the same length.
+    """
+    pos1, pos2 = _prepare_positions(pos1), _prepare_positions(pos2)
+
+    if len(pos1) != len(pos2):
+        raise ValueError("The position arrays must be of the same length.")
+
+    return current().paired_distances(pos1, pos2, *_prepare_box(box_matrix))
+
+
+def distances(pos1: Np2DNumberArray,
+              pos2: Np2DNumberArray,
+              box_matrix: Np3x3NumberArray | None = None
+              ) -> Np2DNumberArray:
+    """
+    Returns the minimum image distance matrix between two position arrays.
+
+    Parameters
+    ----------
+    pos1 : Np2DNumberArray
+        The first positions of shape (n1, 3).
+    pos2 : Np2DNumberArray
+        The second positions of shape (n2, 3).
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    Np2DNumberArray
+        The distances of shape (n1, n2).
+    """
+    pos1, pos2 = _prepare_positions(pos1), _prepare_positions(pos2)
+    return current().distances(pos1, pos2, *_prepare_box(box_matrix))
+
+
+def distance_histogram(pos1: Np2DNumberArray,
+                       pos2: Np2DNumberArray | None,
+                       r_max: Real,
+                       n_bins: int,
+                       box_matrix: Np3x3NumberArray | None = None,
+                       r_min: Real = 0.0
+                       ) -> Np1DNumberArray:
+    """
+    Returns the histogram of the minimum image distances between two position arrays.
+
+    The range [r_min, r_max) is divided into n_bins bins of equal width. For periodic
+    systems in which a CellList with cutoff r_max has at least 3 cells per dimension,
+    backends supporting cell lists only evaluate the pairs of neighbouring cells.
+    Otherwise all pairs are evaluated. Both variants give identical histograms.
+
+    Parameters
+    ----------
+    pos1 : Np2DNumberArray
+        The first positions of shape (n1, 3).
+    pos2 : Np2DNumberArray | None
+        The second positions of shape (n2, 3). If None, the unique pairs i < j of pos1 are binned.
+    r_max : Real
+        The upper (exclusive) limit of the histogram.
+    n_bins : int
+        The number of bins.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+    r_min : Real, optional
+        The lower limit of the histogram, by default 0.0
+
+    Returns
+    -------
+    Np1DNumberArray
+        The number of pairs in each bin as float64 array of shape (n_bins,).
+
+    Raises
+    ------
+    ValueError
+        If n_bins is not positive or r_max is not larger than r_min.
+    """
+    if n_bins <= 0 or r_max <= r_min:
+        raise ValueError(
+            "The histogram needs a positive number of bins and r_max > r_min.")
+
+    pos1 = _prepare_positions(pos1)
+    same = pos2 is None
+    pos2 = pos1 if same else _prepare_positions(pos2)
+
+    box, inv_box, periodic = _prepare_box(box_matrix)
+    backend = current()
+
+    if periodic and backend.supports_cell_list and CellList.is_usable(box, r_max):
+        cells1 = CellList(pos1, box, r_max)
+        cells2 = cells1 if same else CellList(pos2, box, r_max)
+
+        return backend.cell_list_histogram(cells1, cells2, box, inv_box,
+                                           same, float(r_min), float(r_max), int(n_bins))
+
+    return backend.distance_histogram(pos1, pos2, box, inv_box, periodic,
+                                      same, float(r_min), float(r_max), int(n_bins))
+
+
+def cutoff_pairs(pos1: Np2DNumberArray,
+                 pos2: Np2DNumberArray | None,
+                 cutoff: Real,
+                 box_matrix: Np3x3NumberArray | None = None
+                 ) -> Tuple[Np2DIntArray, Np1DNumberArray]:
+    """
+    Returns all pairs of two position arrays closer than a cutoff.
+
+    For periodic systems in which a CellList with the cutoff has at least 3 cells per
+    dimension, backends supporting cell lists only evaluate the pairs of neighbouring
+    cells. Otherwise all pairs are evaluated. Both variants give identical pairs.
+
+    Parameters
+    ----------
+    pos1 : Np2DNumberArray
+        The first positions of shape (n1, 3).
+    pos2 : Np2DNumberArray | None
+        The second positions of shape (n2, 3). If None, the unique pairs i < j of pos1 are returned.
+    cutoff : Real
+        The (exclusive) cutoff distance.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    pairs : Np2DIntArray
+        The indices (i, j) of the pairs into pos1 and pos2 of shape (n_pairs, 2), sorted by i and j.
+    distances : Np1DNumberArray
+        The distances of the pairs of shape (n_pairs,).
+    """
+    pos1 = _prepare_positions(pos1)
+    same = pos2 is None
+    pos2 = pos1 if same else _prepare_positions(pos2)
+
+    box, inv_box, periodic = _prepare_box(box_matrix)
+    backend = current()
+
+    if periodic and backend.supports_cell_list and cutoff > 0.0 and CellList.is_usable(box, cutoff):
+        cells1 = CellList(pos1, box, cutoff)
+        cells2 = cells1 if same else CellList(pos2, box, cutoff)
+
+        sorted_pairs, pair_distances = backend.cell_list_pairs(cells1, cells2, box, inv_box,
+                                                               same, float(cutoff))
+
+        # the pairs of the sorted positions are mapped back and sorted as without cell list
+        pairs = np.column_stack((cells1.order[sorted_pairs[:, 0]],
+                                 cells2.order[sorted_pairs[:, 1]]))
+        if same:
+            pairs.sort(axis=1)
+
+        order = np.lexsort((pairs[:, 1], pairs[:, 0]))
+
+        return pairs[order], pair_distances[order]
+
+    return backend.cutoff_pairs(pos1, pos2, box, inv_box, periodic, same, float(cutoff))
@@ -0,0 +1,21 @@
+"""
+A module containing different exceptions related to the kernels subpackage.
+
+...
+
+Classes
+-------
+KernelBackendError
+    Exception raised if a kernel backend is not known or not available
+"""
+
+from PQAnalysis.exceptions import PQException
+
+
+class KernelBackendError(PQException):
+    """
+    Exception raised if a kernel backend is not known or not available
+    """
+
+    def __init__(self, message: str) -> None:
+        super().__init__(message)
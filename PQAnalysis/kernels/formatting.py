@@ -0,0 +1,98 @@
+"""
+A module containing kernels for formatting output lines.
+
+The computation is delegated to the backend selected in
+PQAnalysis.kernels.backends.
+
+...
+
+Functions
+---------
+format_restart_lines
+    Returns the atom lines of a restart file.
+format_atom_lines
+    Returns the atom lines of a trajectory file.
+"""
+
+import numpy as np
+
+from beartype.typing import List
+
+from .backends import current
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray
+
+
+def format_restart_lines(names: List[str],
+                         mol_types: Np1DIntArray,
+                         pos: Np2DNumberArray,
+                         vel: Np2DNumberArray,
+                         forces: Np2DNumberArray,
+                         extended: bool = False
+                         ) -> List[str]:
+    """
+    Returns the atom lines of a restart file.
+
+    Each line contains the name, the index and the moltype of the atom followed by its
+    position, velocity and force. The values are formatted with their shortest
+    representation (as str does) to be identical with the output of previous versions.
+
+    Parameters
+    ----------
+    names : List[str]
+        The names of the atoms.
+    mol_types : Np1DIntArray
+        The moltypes of the atoms.
+    pos : Np2DNumberArray
+        The positions of shape (n_atoms, 3).
+    vel : Np2DNumberArray
+        The velocities of shape (n_atoms, 3).
+    forces : Np2DNumberArray
+        The forces of shape (n_atoms, 3).
+    extended : bool, optional
+        If True, the position, velocity and force are repeated as required by the
+        QMCFC restart file format, by default False
+
+    Returns
+    -------
+    List[str]
+        The lines without newline characters.
+    """
+    return current().format_restart_lines(names,
+                                          np.asarray(mol_types),
+                                          np.reshape(pos, (-1, 3)),
+                                          np.reshape(vel, (-1, 3)),
+                                          np.reshape(forces, (-1, 3)),
+                                          extended)
+
+
+def format_atom_lines(names: List[str], values: Np1DNumberArray | Np2DNumberArray) -> List[str]:
+    """
+    Returns the atom lines of a trajectory file.
+
+    Each line contains the name of the atom followed by its values separated by single
+    spaces, e.g. 'h 0.0 1.0 2.0' for positions or 'h 0.5' for charges. The values are
+    formatted as in f-strings to be identical with the output of previous versions, i.e.
+    float32 values are written with the shortest representation of the equal float64.
+
+    Parameters
+    ----------
+    names : List[str]
+        The names of the atoms.
+    values : Np1DNumberArray | Np2DNumberArray
+        The values of the atoms, either of shape (n_atoms,) or (n_atoms, n_values).
+
+    Returns
+    -------
+    List[str]
+        The lines without newline characters.
+    """
+    values = np.asarray(values)
+
+    if values.ndim == 1:
+        values = values[:, np.newaxis]
+
+    # format(value, "") converts float32 and float16 scalars to Python floats
+    if values.dtype in (np.float32, np.float16):
+        values = values.astype(np.float64)
+
+    return current().format_atom_lines(names, values)
@@ -0,0 +1,53 @@
+"""
+A module containing kernels operating on graphs of atoms, e.g. bonds or contacts.
+
+The computation is delegated to the backend selected in
+PQAnalysis.kernels.backends.
+
+...
+
+Functions
+---------
+connected_components
+    Returns the connected component of each node of a graph given by its edges.
+"""
+
+import numpy as np
+
+from .backends import current
+from ..types import Np1DIntArray, Np2DIntArray
+
+
+def connected_components(n_nodes: int, edges: Np2DIntArray) -> Np1DIntArray:
+    """
+    Returns the connected component of each node of a graph given by its edges.
+
+    The compiled backends run a union-find with path halving over the edges, in
+    which the smaller root becomes the root of each union. The NumPy backend hooks
+    the roots of all edges at once and compresses the paths by pointer jumping. In
+    both cases each component is labelled by its smallest node, so that the labels
+    do not depend on the backend or the order of the edges.
+
+    Parameters
+    ----------
+    n_nodes : int
+        The number of nodes.
+    edges : Np2DIntArray
+        The edges (i, j) of shape (n_edges, 2), e.g. the pairs of cutoff_pairs.
+
+    Returns
+    -------
+    Np1DIntArray
+        The smallest node of the component of each node of shape (n_nodes,).
+
+    Raises
+    ------
+    ValueError
+        If an edge refers to a node outside of 0 ... n_nodes - 1.
+    """
+    edges = np.ascontiguousarray(edges, dtype=np.int64).reshape(-1, 2)
+
+    if len(edges) > 0 and (edges.min() < 0 or edges.max() >= n_nodes):
+        raise ValueError(f"The edges have to connect nodes between 0 and {n_nodes - 1}.")
+
+    return current().connected_components(int(n_nodes), edges)
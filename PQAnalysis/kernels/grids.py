@@ -0,0 +1,244 @@
+"""
+A module containing kernels on regular grids spanning periodic cells.
+
+The grids are regular in fractional coordinates, so that each grid point of a
+triclinic cell represents the same volume. The distances of the grid points to the
+atoms are searched with cutoff_pairs.
+
+...
+
+Functions
+---------
+fractional_grid
+    Returns the points of a regular grid in fractional coordinates of a cell.
+surface_distances
+    Returns the distance of each point to the nearest atom surface.
+covering_diameters
+    Returns the diameter of the largest empty sphere covering each point of a grid.
+"""
+
+import numpy as np
+
+from beartype.typing import Tuple
+from numbers import Real
+
+from .distances import _prepare_positions, cutoff_pairs
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def fractional_grid(box_matrix: Np3x3NumberArray, spacing: Real) -> Tuple[Np2DNumberArray, Np1DIntArray]:
+    """
+    Returns the points of a regular grid in fractional coordinates of a cell.
+
+    Each box vector is divided into the smallest number of intervals not longer than
+    spacing and the points are placed at the centers of the grid cells, i.e. at the
+    fractional coordinates (i + 0.5) / n. Thus, each point represents the volume of
+    the cell divided by the number of points, also in triclinic cells.
+
+    Parameters
+    ----------
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+    spacing : Real
+        The largest distance of neighbouring points along each box vector.
+
+    Returns
+    -------
+    points : Np2DNumberArray
+        The cartesian grid points of shape (n_points, 3) in C order of the grid.
+    shape : Np1DIntArray
+        The number of points along each box vector.
+
+    Raises
+    ------
+    ValueError
+        If the spacing is not positive.
+    """
+    if spacing <= 0.0:
+        raise ValueError("The spacing of a grid has to be positive.")
+
+    box_matrix = np.asarray(box_matrix, dtype=np.float64)
+
+    shape = np.maximum(np.ceil(np.linalg.norm(box_matrix, axis=0) / spacing), 1).astype(np.int64)
+
+    axes = [(np.arange(n) + 0.5) / n for n in shape]
+    fractional = np.stack(np.meshgrid(*axes, indexing="ij"), axis=-1).reshape(-1, 3)
+
+    return fractional @ box_matrix.T, shape
+
+
+def surface_distances(points: Np2DNumberArray,
+                      pos: Np2DNumberArray,
+                      radii: Np1DNumberArray | None = None,
+                      box_matrix: Np3x3NumberArray | None = None
+                      ) -> Tuple[Np1DNumberArray, Np1DIntArray]:
+    """
+    Returns the distance of each point to the nearest atom surface.
+
+    The distance of a point to the surface of the atom j is |x - x_j| - r_j, which is
+    negative inside of the atom. The atoms closer than a search radius rc are found
+    with cutoff_pairs, which uses a CellList in periodic cells, where rc is estimated
+    from the density to contain about 8 atoms. All atoms beyond rc have a surface
+    farther than rc minus the largest radius, so that the nearest surface is exact if
+    it is closer. The other points (e.g. in the center of large pores) are searched
+    again with rc enlarged by 1.5.
+
+    Parameters
+    ----------
+    points : Np2DNumberArray
+        The points of shape (n_points, 3), e.g. of fractional_grid.
+    pos : Np2DNumberArray
+        The positions of the atoms of shape (n, 3).
+    radii : Np1DNumberArray | None, optional
+        The radius of each atom, by default None (points)
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    distances : Np1DNumberArray
+        The distance of each point to the nearest atom surface.
+    atoms : Np1DIntArray
+        The index of the atom of the nearest surface of each point.
+
+    Raises
+    ------
+    ValueError
+        If there are no atoms or the radii do not match the atoms.
+    """
+    points = _prepare_positions(points)
+    pos = _prepare_positions(pos)
+
+    if len(pos) == 0:
+        raise ValueError("The surface distances need at least one atom.")
+
+    if radii is None:
+        radii = np.zeros(len(pos))
+
+    radii = np.asarray(radii, dtype=np.float64)
+
+    if radii.shape != (len(pos),):
+        raise ValueError("The surface distances need one radius per atom.")
+
+    distances = np.zeros(len(points))
+    atoms = np.zeros(len(points), dtype=np.int64)
+
+    max_radius = np.max(radii)
+
+    if box_matrix is not None:
+        volume = abs(np.linalg.det(np.asarray(box_matrix, dtype=np.float64)))
+    else:
+        volume = np.prod(np.ptp(pos, axis=0) + 1.0)
+
+    rc = (3.0 * 8 * volume / (4.0 * np.pi * len(pos)))**(1.0 / 3.0)
+    remaining = np.arange(len(points))
+
+    while len(remaining) > 0:
+        pairs, center_distances = cutoff_pairs(points[remaining], pos, rc, box_matrix)
+        surfaces = center_distances - radii[pairs[:, 1]]
+
+        # the pairs are sorted by point, so that the nearest surfaces are reduced per point
+        starts = np.flatnonzero(np.diff(pairs[:, 0], prepend=-1) != 0)
+        nearest_surfaces = np.minimum.reduceat(surfaces, starts) if len(starts) > 0 else np.zeros(0)
+
+        is_nearest = np.flatnonzero(surfaces == np.repeat(nearest_surfaces, np.diff(starts, append=len(pairs))))
+        first = is_nearest[np.diff(pairs[is_nearest, 0], prepend=-1) != 0]
+
+        points_found = pairs[first, 0]
+
+        # all atoms beyond rc have a farther surface
+        exact = nearest_surfaces <= rc - max_radius
+        found = remaining[points_found[exact]]
+
+        distances[found] = nearest_surfaces[exact]
+        atoms[found] = pairs[first, 1][exact]
+
+        searched = np.zeros(len(remaining), dtype=bool)
+        searched[points_found[exact]] = True
+
+        remaining = remaining[~searched]
+        rc *= 1.5
+
+    return distances, atoms
+
+
+def covering_diameters(distances: Np1DNumberArray,
+                       shape: Np1DIntArray,
+                       box_matrix: Np3x3NumberArray,
+                       edges: Np1DNumberArray
+                       ) -> Np1DNumberArray:
+    """
+    Returns the diameter of the largest empty sphere covering each point of a grid.
+
+    The empty sphere around a grid point c has the radius d(c) of its distance to the
+    nearest atom surface. A point x is covered by all spheres with |x - c| <= d(c) and
+    its pore diameter is the largest 2 d(c) of these spheres (the geometric pore size
+    distribution of Gelb and Gubbins). The diameters are resolved to the intervals
+    given by edges: in decreasing order of the intervals, the grid points, whose
+    diameter falls into an interval, are dilated by a ball with the radius of the
+    lower edge with an FFT convolution on the periodic grid, and all points not yet
+    covered by a larger sphere are assigned to the interval. Thus, each grid point is
+    covered at least by its own sphere.
+
+    Parameters
+    ----------
+    distances : Np1DNumberArray
+        The distance of each point of the grid to the nearest atom surface, e.g. of
+        surface_distances, in C order of the grid.
+    shape : Np1DIntArray
+        The number of points along each box vector, e.g. of fractional_grid.
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+    edges : Np1DNumberArray
+        The increasing edges of the diameter intervals starting at 0.
+
+    Returns
+    -------
+    Np1DNumberArray
+        The center of the interval of the pore diameter of each point, inf for
+        diameters beyond the last edge and 0 for points inside of an atom.
+
+    Raises
+    ------
+    ValueError
+        If the distances do not match the grid or the edges are not increasing.
+    """
+    distances = np.asarray(distances, dtype=np.float64)
+    shape = tuple(int(n) for n in shape)
+    edges = np.asarray(edges, dtype=np.float64)
+
+    if distances.shape != (int(np.prod(shape)),):
+        raise ValueError("The covering diameters need one distance per grid point.")
+
+    if len(edges) < 2 or edges[0] != 0.0 or np.any(np.diff(edges) <= 0.0):
+        raise ValueError("The edges of the covering diameters have to increase from 0.")
+
+    # the minimum image distance of each grid offset from the origin
+    axes = [((np.arange(n) + n // 2) % n - n // 2) / n for n in shape]
+    offsets = np.stack(np.meshgrid(*axes, indexing="ij"), axis=-1).reshape(-1, 3)
+    offset_distances = np.linalg.norm(offsets @ np.asarray(box_matrix, dtype=np.float64).T, axis=1)
+
+    void = distances > 0.0
+
+    # the last interval collects all diameters beyond the edges
+    levels = np.searchsorted(edges, 2.0 * distances, side="right") - 1
+    centers = np.append(0.5 * (edges[:-1] + edges[1:]), np.inf)
+
+    diameters = np.zeros(len(distances))
+    covered = ~void
+
+    for level in np.unique(levels[void])[::-1]:
+        sphere_centers = void & (levels == level)
+
+        ball = offset_distances <= 0.5 * edges[level] * (1.0 + 1e-10)
+        dilated = np.fft.irfftn(np.fft.rfftn(sphere_centers.reshape(shape)) * np.fft.rfftn(ball.reshape(shape)),
+                                s=shape).reshape(-1) > 0.5
+
+        assigned = dilated & ~covered
+        diameters[assigned] = centers[level]
+        covered |= assigned
+
+        if np.all(covered):
+            break
+
+    return diameters
@@ -0,0 +1,64 @@
+"""
+A module containing kernels operating on groups of atoms.
+
+The computation is delegated to the backend selected in
+PQAnalysis.kernels.backends.
+
+...
+
+Functions
+---------
+group_centers_of_mass
+    Returns the centers of mass of consecutive groups of atoms.
+"""
+
+import numpy as np
+
+from .backends import current
+from ..types import Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+def group_centers_of_mass(pos: Np2DNumberArray,
+                          masses: Np1DNumberArray,
+                          group: int,
+                          box_matrix: Np3x3NumberArray
+                          ) -> Np2DNumberArray:
+    """
+    Returns the centers of mass of consecutive groups of atoms.
+
+    The atoms pos[g*group:(g+1)*group] form group g. As in AtomicSystem.center_of_mass,
+    all atoms of a group are imaged relative to its first atom and the resulting
+    center of mass is imaged into the unit cell. The sums are accumulated in float64.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n_groups * group, 3).
+    masses : Np1DNumberArray
+        The masses of the atoms of shape (n_groups * group,).
+    group : int
+        The number of atoms per group.
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+
+    Returns
+    -------
+    Np2DNumberArray
+        The centers of mass of shape (n_groups, 3).
+
+    Raises
+    ------
+    ValueError
+        If the number of atoms is not a multiple of group or does not match the number of masses.
+    """
+    pos = np.ascontiguousarray(pos, dtype=np.float64).reshape(-1, 3)
+    masses = np.ascontiguousarray(masses, dtype=np.float64)
+
+    if group <= 0 or len(pos) % group != 0 or len(masses) != len(pos):
+        raise ValueError(
+            "The number of positions and masses must be the same multiple of group.")
+
+    box = np.ascontiguousarray(box_matrix, dtype=np.float64)
+    inv_box = np.ascontiguousarray(np.linalg.inv(box))
+
+    return current().group_centers_of_mass(pos, masses, int(group), box, inv_box)
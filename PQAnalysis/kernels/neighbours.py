@@ -0,0 +1,393 @@
+"""
+A module containing the neighbour search kernels.
+
+The neighbour searches are built on the CellList, so that the distances of each
+query position are only evaluated to the positions of its 27 surrounding cells.
+Systems without periodic boundary conditions and boxes that are too small for a
+cell list fall back to blocked evaluations of the full distance matrix.
+
+...
+
+Functions
+---------
+k_nearest_neighbours
+    Returns the k nearest neighbours of each query position.
+minimum_distance
+    Returns the closest pair of two position arrays.
+self_image_distance
+    Returns the closest distance of a group of positions to its own periodic images.
+"""
+
+import numpy as np
+
+from beartype.typing import Tuple
+from math import ceil
+
+from .cellList import CellList
+from .distances import _prepare_positions, distances
+from ..types import Np1DIntArray, Np2DNumberArray, Np3x3NumberArray, Np2DIntArray
+
+
+def k_nearest_neighbours(pos: Np2DNumberArray,
+                         k: int,
+                         box_matrix: Np3x3NumberArray | None = None,
+                         query_pos: Np2DNumberArray | None = None
+                         ) -> Tuple[Np2DIntArray, Np2DNumberArray]:
+    """
+    Returns the k nearest neighbours of each query position.
+
+    The search radius is estimated from the density, so that a sphere of this radius
+    contains about 1.5 * (k + 1) positions on average, and a CellList with cells of this
+    width is built. The candidates of all query positions are gathered from their 27
+    surrounding cells at once with a padded cell table. If the k-th nearest candidate is
+    within the search radius, no position outside of the surrounding cells can be closer,
+    so that the result is exact. The remaining query positions (e.g. in voids) are
+    searched again with a radius enlarged by 1.5.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3) among which the neighbours are searched.
+    k : int
+        The number of neighbours.
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+    query_pos : Np2DNumberArray | None, optional
+        The positions of shape (n_query, 3) whose neighbours are searched, by default None.
+        If None, the neighbours of each position of pos are searched excluding itself.
+
+    Returns
+    -------
+    indices : Np2DIntArray
+        The indices into pos of the neighbours of shape (n_query, k), sorted by distance.
+    distances : Np2DNumberArray
+        The minimum image distances to the neighbours of shape (n_query, k).
+
+    Raises
+    ------
+    ValueError
+        If k is not positive or larger than the number of available neighbours.
+    """
+    pos = _prepare_positions(pos)
+    same = query_pos is None
+    query_pos = pos if same else _prepare_positions(query_pos)
+
+    if k < 1 or k > len(pos) - int(same):
+        raise ValueError(
+            f"{k} nearest neighbours were requested, but only {len(pos) - int(same)} positions are available.")
+
+    indices = np.zeros((len(query_pos), k), dtype=np.int64)
+    neighbour_distances = np.zeros((len(query_pos), k))
+
+    remaining = np.arange(len(query_pos))
+
+    radius = np.nan
+    if box_matrix is not None:
+        box_matrix = np.asarray(box_matrix, dtype=np.float64)
+
+        with np.errstate(all="ignore"):
+            volume = abs(np.linalg.det(box_matrix))
+            radius = (4.5 * (k + 1) * volume / (4.0 * np.pi * len(pos)))**(1.0 / 3.0)
+
+    while len(remaining) > 0 and np.isfinite(radius) and CellList.is_usable(box_matrix, radius):
+        found = _cell_list_search(pos, query_pos, remaining, same, k, box_matrix, radius,
+                                  indices, neighbour_distances)
+
+        remaining = remaining[~found]
+        radius *= 1.5
+
+    if len(remaining) > 0:
+        _brute_force_search(pos, query_pos, remaining, same, k, box_matrix,
+                            indices, neighbour_distances)
+
+    return indices, neighbour_distances
+
+
+def minimum_distance(pos1: Np2DNumberArray,
+                     pos2: Np2DNumberArray | None = None,
+                     box_matrix: Np3x3NumberArray | None = None
+                     ) -> Tuple[Np1DIntArray, float]:
+    """
+    Returns the closest pair of two position arrays.
+
+    The nearest position of pos2 is searched for each position of pos1 with
+    k_nearest_neighbours, i.e. with a CellList for periodic systems, so that the
+    full distance matrix is never evaluated.
+
+    Parameters
+    ----------
+    pos1 : Np2DNumberArray
+        The first positions of shape (n1, 3).
+    pos2 : Np2DNumberArray | None, optional
+        The second positions of shape (n2, 3), by default None (the closest pair i < j of pos1)
+    box_matrix : Np3x3NumberArray | None, optional
+        The box matrix of the cell, by default None (no periodic boundary conditions)
+
+    Returns
+    -------
+    pair : Np1DIntArray
+        The indices (i, j) of the closest pair into pos1 and pos2.
+    distance : float
+        The minimum image distance of the closest pair.
+
+    Raises
+    ------
+    ValueError
+        If there is no pair of positions.
+    """
+    pos1 = _prepare_positions(pos1)
+
+    if len(pos1) == 0:
+        raise ValueError("The minimum distance needs at least one position in each selection.")
+
+    if pos2 is None:
+        indices, neighbour_distances = k_nearest_neighbours(pos1, 1, box_matrix)
+    else:
+        indices, neighbour_distances = k_nearest_neighbours(pos2, 1, box_matrix, pos1)
+
+    i = int(np.argmin(neighbour_distances[:, 0]))
+    pair = np.array([i, indices[i, 0]], dtype=np.int64)
+
+    if pos2 is None:
+        pair.sort()
+
+    return pair, float(neighbour_distances[i, 0])
+
+
+def self_image_distance(pos: Np2DNumberArray,
+                        box_matrix: Np3x3NumberArray
+                        ) -> Tuple[Np1DIntArray, Np1DIntArray, float]:
+    """
+    Returns the closest distance of a group of positions to its own periodic images.
+
+    The positions are taken as they are, i.e. the group (e.g. a solute) has to be whole.
+    The distance is min |pos[j] + box_matrix @ n - pos[i]| over all pairs (including i = j)
+    and all lattice translations n != 0. The shortest box vector is an upper bound of the
+    distance, and the group can only come closer than the current bound to images with
+    |box_matrix @ n| < bound + diameter, which bounds the translations to search in a
+    triclinic cell. Since the translations n and -n give the same distances, only one
+    of them is evaluated. For each remaining translation only the positions within the
+    bounding box of the other copy enlarged by the current bound are compared.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of the whole group of shape (n, 3).
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+
+    Returns
+    -------
+    pair : Np1DIntArray
+        The indices (i, j) of the closest pair.
+    image : Np1DIntArray
+        The lattice translation n of pos[j].
+    distance : float
+        The distance of pos[i] to the image of pos[j].
+
+    Raises
+    ------
+    ValueError
+        If there are no positions.
+    """
+    pos = _prepare_positions(pos)
+    box_matrix = np.asarray(box_matrix, dtype=np.float64)
+
+    if len(pos) == 0:
+        raise ValueError("The self image distance needs at least one position.")
+
+    lower, upper = pos.min(axis=0), pos.max(axis=0)
+    diameter = 2.0 * np.max(np.linalg.norm(pos - 0.5 * (lower + upper), axis=1))
+
+    box_lengths = np.linalg.norm(box_matrix, axis=0)
+    shortest = int(np.argmin(box_lengths))
+
+    # each position is at the length of the shortest box vector from its own image
+    distance = float(box_lengths[shortest])
+    pair = np.zeros(2, dtype=np.int64)
+    image = np.eye(3, dtype=np.int64)[shortest]
+
+    # |box_matrix @ n| >= smallest singular value * max |n_k|
+    n_max = ceil((distance + diameter) / np.linalg.svd(box_matrix, compute_uv=False)[-1])
+
+    images = np.stack(np.meshgrid(*[np.arange(-n_max, n_max + 1)] * 3, indexing="ij"),
+                      axis=-1).reshape(-1, 3)
+
+    # one of each pair of opposite translations, whose first non-zero component is positive
+    first_non_zero = np.take_along_axis(images, np.argmax(images != 0, axis=1)[:, np.newaxis],
+                                        axis=1)[:, 0]
+    images = images[first_non_zero > 0]
+
+    translations = images @ box_matrix.T
+    bounds = np.linalg.norm(translations, axis=1) - diameter
+
+    for index in np.argsort(bounds, kind="stable"):
+        if bounds[index] >= distance:
+            break
+
+        translation = translations[index]
+
+        first = np.flatnonzero(np.all((pos > lower + translation - distance) &
+                                      (pos < upper + translation + distance), axis=1))
+        second = np.flatnonzero(np.all((pos + translation > lower - distance) &
+                                       (pos + translation < upper + distance), axis=1))
+
+        if len(first) == 0 or len(second) == 0:
+            continue
+
+        # the distance matrix is evaluated in blocks of rows to limit the memory
+        block_size = max(1, (1 << 22) // len(second))
+        shifted = pos[second] + translation
+
+        for start in range(0, len(first), block_size):
+            block = first[start:start + block_size]
+            block_distances = distances(pos[block], shifted)
+
+            i, j = np.unravel_index(np.argmin(block_distances), block_distances.shape)
+
+            if block_distances[i, j] < distance:
+                distance = float(block_distances[i, j])
+                pair = np.array([block[i], second[j]], dtype=np.int64)
+                image = images[index]
+
+    return pair, image.copy(), distance
+
+
+def _cell_list_search(pos: np.ndarray,
+                      query_pos: np.ndarray,
+                      queries: np.ndarray,
+                      same: bool,
+                      k: int,
+                      box_matrix: np.ndarray,
+                      radius: float,
+                      indices: np.ndarray,
+                      neighbour_distances: np.ndarray
+                      ) -> np.ndarray:
+    """
+    Searches the k nearest neighbours among the positions of the surrounding cells.
+
+    Parameters
+    ----------
+    pos : np.ndarray
+        The positions among which the neighbours are searched.
+    query_pos : np.ndarray
+        The query positions.
+    queries : np.ndarray
+        The indices of the query positions to search.
+    same : bool
+        Whether the query positions are the positions, i.e. self has to be excluded.
+    k : int
+        The number of neighbours.
+    box_matrix : np.ndarray
+        The box matrix of the cell.
+    radius : float
+        The minimum width of the cells.
+    indices : np.ndarray
+        The neighbour indices of all query positions, filled for the found queries.
+    neighbour_distances : np.ndarray
+        The neighbour distances of all query positions, filled for the found queries.
+
+    Returns
+    -------
+    np.ndarray
+        Whether the exact k nearest neighbours of each searched query were found.
+    """
+    cells = CellList(pos, box_matrix, radius)
+    table = cells.cell_table()
+    neighbour_cells = cells.neighbour_cells()
+    query_cells = cells.cell_indices(query_pos[queries])
+
+    inv_box = np.linalg.inv(box_matrix)
+
+    found = np.zeros(len(queries), dtype=bool)
+
+    n_candidates = neighbour_cells.shape[1] * table.shape[1]
+    batch_size = max(1, (1 << 21) // n_candidates)
+
+    for start in range(0, len(queries), batch_size):
+        batch = slice(start, start + batch_size)
+        batch_queries = queries[batch]
+
+        candidates = table[neighbour_cells[query_cells[batch]]].reshape(len(batch_queries), -1)
+
+        valid = candidates >= 0
+        if same:
+            valid &= candidates != batch_queries[:, np.newaxis]
+
+        dpos = pos[candidates] - query_pos[batch_queries, np.newaxis, :]
+        fractional_dpos = dpos @ inv_box.T
+        fractional_dpos -= np.round(fractional_dpos)
+        candidate_distances = np.linalg.norm(fractional_dpos @ box_matrix.T, axis=-1)
+        candidate_distances[~valid] = np.inf
+
+        if n_candidates < k:
+            continue
+
+        nearest = np.argpartition(candidate_distances, k - 1, axis=1)[:, :k]
+        nearest_distances = np.take_along_axis(candidate_distances, nearest, axis=1)
+
+        order = np.argsort(nearest_distances, axis=1, kind="stable")
+        nearest = np.take_along_axis(nearest, order, axis=1)
+        nearest_distances = np.take_along_axis(nearest_distances, order, axis=1)
+
+        batch_found = nearest_distances[:, -1] <= radius
+
+        found_queries = batch_queries[batch_found]
+        indices[found_queries] = np.take_along_axis(candidates[batch_found],
+                                                    nearest[batch_found], axis=1)
+        neighbour_distances[found_queries] = nearest_distances[batch_found]
+
+        found[batch] = batch_found
+
+    return found
+
+
+def _brute_force_search(pos: np.ndarray,
+                        query_pos: np.ndarray,
+                        queries: np.ndarray,
+                        same: bool,
+                        k: int,
+                        box_matrix: np.ndarray | None,
+                        indices: np.ndarray,
+                        neighbour_distances: np.ndarray
+                        ) -> None:
+    """
+    Searches the k nearest neighbours among all positions.
+
+    Parameters
+    ----------
+    pos : np.ndarray
+        The positions among which the neighbours are searched.
+    query_pos : np.ndarray
+        The query positions.
+    queries : np.ndarray
+        The indices of the query positions to search.
+    same : bool
+        Whether the query positions are the positions, i.e. self has to be excluded.
+    k : int
+        The number of neighbours.
+    box_matrix : np.ndarray | None
+        The box matrix of the cell, None without periodic boundary conditions.
+    indices : np.ndarray
+        The neighbour indices of all query positions, filled for the searched queries.
+    neighbour_distances : np.ndarray
+        The neighbour distances of all query positions, filled for the searched queries.
+    """
+    # the distance matrix is evaluated in blocks of rows to limit the memory
+    block_size = max(1, (1 << 22) // len(pos))
+
+    for start in range(0, len(queries), block_size):
+        block = queries[start:start + block_size]
+
+        block_distances = distances(query_pos[block], pos, box_matrix)
+
+        if same:
+            block_distances[np.arange(len(block)), block] = np.inf
+
+        nearest = np.argpartition(block_distances, k - 1, axis=1)[:, :k]
+        nearest_distances = np.take_along_axis(block_distances, nearest, axis=1)
+
+        order = np.argsort(nearest_distances, axis=1, kind="stable")
+
+        indices[block] = np.take_along_axis(nearest, order, axis=1)
+        neighbour_distances[block] = np.take_along_axis(nearest_distances, order, axis=1)
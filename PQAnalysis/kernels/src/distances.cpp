@@ -0,0 +1,890 @@
+/*
+ * Native kernels of PQAnalysis.
+ *
+ * All functions operate on C-contiguous double arrays of shape (n, 3) and on
+ * the box matrix of a Cell (box vectors as columns) together with its inverse,
+ * both as row-major 3x3 double arrays. Minimum images are obtained the same
+ * way as in Cell.image: the displacement is transformed to fractional
+ * coordinates, rounded to the nearest integer vector and transformed back.
+ *
+ * The functions are exported with C linkage and called via ctypes, which
+ * releases the GIL for the duration of the call. The loops are threaded with
+ * OpenMP and written without branches in the innermost loop, so that the
+ * compiler can vectorize them.
+ */
+
+#include <Python.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(_WIN32)
+#define PQ_EXPORT extern "C" __declspec(dllexport)
+#else
+#define PQ_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace
+{
+    struct Box
+    {
+        double m[9];
+        double inv[9];
+        bool periodic;
+    };
+
+    inline Box make_box(const double *box, const double *inv_box, int periodic)
+    {
+        Box b;
+        for (int k = 0; k < 9; ++k)
+        {
+            b.m[k] = box[k];
+            b.inv[k] = inv_box[k];
+        }
+        b.periodic = periodic != 0;
+        return b;
+    }
+
+    inline void minimum_image(const Box &b, double &dx, double &dy, double &dz)
+    {
+        double fx = b.inv[0] * dx + b.inv[1] * dy + b.inv[2] * dz;
+        double fy = b.inv[3] * dx + b.inv[4] * dy + b.inv[5] * dz;
+        double fz = b.inv[6] * dx + b.inv[7] * dy + b.inv[8] * dz;
+
+        fx -= std::nearbyint(fx);
+        fy -= std::nearbyint(fy);
+        fz -= std::nearbyint(fz);
+
+        dx = b.m[0] * fx + b.m[1] * fy + b.m[2] * fz;
+        dy = b.m[3] * fx + b.m[4] * fy + b.m[5] * fz;
+        dz = b.m[6] * fx + b.m[7] * fy + b.m[8] * fz;
+    }
+
+    inline double distance(const Box &b, const double *p, const double *q)
+    {
+        double dx = p[0] - q[0];
+        double dy = p[1] - q[1];
+        double dz = p[2] - q[2];
+
+        if (b.periodic)
+            minimum_image(b, dx, dy, dz);
+
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+PQ_EXPORT int pq_n_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+PQ_EXPORT void pq_minimum_image(const double *dpos, int64_t n,
+                                const double *box, const double *inv_box,
+                                double *out)
+{
+    const Box b = make_box(box, inv_box, 1);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i)
+    {
+        double dx = dpos[3 * i];
+        double dy = dpos[3 * i + 1];
+        double dz = dpos[3 * i + 2];
+
+        minimum_image(b, dx, dy, dz);
+
+        out[3 * i] = dx;
+        out[3 * i + 1] = dy;
+        out[3 * i + 2] = dz;
+    }
+}
+
+PQ_EXPORT void pq_paired_distances(const double *pos1, const double *pos2, int64_t n,
+                                   const double *box, const double *inv_box, int periodic,
+                                   double *out)
+{
+    const Box b = make_box(box, inv_box, periodic);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i)
+        out[i] = distance(b, pos1 + 3 * i, pos2 + 3 * i);
+}
+
+PQ_EXPORT void pq_distances(const double *pos1, int64_t n1,
+                            const double *pos2, int64_t n2,
+                            const double *box, const double *inv_box, int periodic,
+                            double *out)
+{
+    const Box b = make_box(box, inv_box, periodic);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n1; ++i)
+    {
+        const double *p = pos1 + 3 * i;
+        double *row = out + i * n2;
+
+#pragma omp simd
+        for (int64_t j = 0; j < n2; ++j)
+            row[j] = distance(b, p, pos2 + 3 * j);
+    }
+}
+
+PQ_EXPORT void pq_distance_histogram(const double *pos1, int64_t n1,
+                                     const double *pos2, int64_t n2,
+                                     const double *box, const double *inv_box, int periodic,
+                                     int same, double r_min, double r_max, int64_t n_bins,
+                                     double *hist)
+{
+    const Box b = make_box(box, inv_box, periodic);
+    const double inv_width = n_bins / (r_max - r_min);
+
+    for (int64_t k = 0; k < n_bins; ++k)
+        hist[k] = 0.0;
+
+#pragma omp parallel
+    {
+        // private histogram of each thread, reduced at the end
+        std::vector<double> local(n_bins, 0.0);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int64_t i = 0; i < n1; ++i)
+        {
+            const double *p = pos1 + 3 * i;
+            const int64_t j_start = same ? i + 1 : 0;
+
+            for (int64_t j = j_start; j < n2; ++j)
+            {
+                const double r = distance(b, p, pos2 + 3 * j);
+
+                if (r >= r_min && r < r_max)
+                {
+                    int64_t bin = static_cast<int64_t>((r - r_min) * inv_width);
+                    if (bin >= n_bins)
+                        bin = n_bins - 1;
+                    local[bin] += 1.0;
+                }
+            }
+        }
+
+#pragma omp critical
+        for (int64_t k = 0; k < n_bins; ++k)
+            hist[k] += local[k];
+    }
+}
+
+PQ_EXPORT void pq_cutoff_pair_counts(const double *pos1, int64_t n1,
+                                     const double *pos2, int64_t n2,
+                                     const double *box, const double *inv_box, int periodic,
+                                     int same, double cutoff, int64_t *counts)
+{
+    const Box b = make_box(box, inv_box, periodic);
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t i = 0; i < n1; ++i)
+    {
+        const double *p = pos1 + 3 * i;
+        const int64_t j_start = same ? i + 1 : 0;
+        int64_t count = 0;
+
+        for (int64_t j = j_start; j < n2; ++j)
+            count += distance(b, p, pos2 + 3 * j) < cutoff;
+
+        counts[i] = count;
+    }
+}
+
+PQ_EXPORT void pq_cutoff_pairs(const double *pos1, int64_t n1,
+                               const double *pos2, int64_t n2,
+                               const double *box, const double *inv_box, int periodic,
+                               int same, double cutoff, const int64_t *offsets,
+                               int64_t *pairs, double *dist)
+{
+    const Box b = make_box(box, inv_box, periodic);
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t i = 0; i < n1; ++i)
+    {
+        const double *p = pos1 + 3 * i;
+        const int64_t j_start = same ? i + 1 : 0;
+        int64_t k = offsets[i];
+
+        for (int64_t j = j_start; j < n2; ++j)
+        {
+            const double r = distance(b, p, pos2 + 3 * j);
+
+            if (r < cutoff)
+            {
+                pairs[2 * k] = i;
+                pairs[2 * k + 1] = j;
+                dist[k] = r;
+                ++k;
+            }
+        }
+    }
+}
+
+PQ_EXPORT void pq_cell_list_histogram(const double *pos1, const int64_t *offsets1, int64_t n1,
+                                      const double *pos2, const int64_t *offsets2, int64_t n2,
+                                      const int64_t *shape,
+                                      const double *box, const double *inv_box,
+                                      int same, double r_min, double r_max, int64_t n_bins,
+                                      double *hist)
+{
+    /*
+     * pos1 and pos2 are sorted by cell and stored as structure of arrays
+     * (x of all atoms, then y, then z). offsets[c]:offsets[c+1] is the range
+     * of the atoms in cell c. All grid dimensions have at least 3 cells, so
+     * that the 27 neighbour cells of a cell are distinct.
+     */
+    const Box b = make_box(box, inv_box, 1);
+    const double inv_width = n_bins / (r_max - r_min);
+
+    const int64_t nx = shape[0], ny = shape[1], nz = shape[2];
+    const int64_t n_cells = nx * ny * nz;
+
+    const double *x1 = pos1, *y1 = pos1 + n1, *z1 = pos1 + 2 * n1;
+    const double *x2 = pos2, *y2 = pos2 + n2, *z2 = pos2 + 2 * n2;
+
+    int64_t max_cell_size = 0;
+    for (int64_t c = 0; c < n_cells; ++c)
+        if (offsets2[c + 1] - offsets2[c] > max_cell_size)
+            max_cell_size = offsets2[c + 1] - offsets2[c];
+
+    for (int64_t k = 0; k < n_bins; ++k)
+        hist[k] = 0.0;
+
+#pragma omp parallel
+    {
+        // private histogram and distance buffer of each thread
+        std::vector<double> local(n_bins, 0.0);
+        std::vector<double> buffer(max_cell_size > 0 ? max_cell_size : 1);
+        double *r = buffer.data();
+
+#pragma omp for schedule(dynamic, 1)
+        for (int64_t c = 0; c < n_cells; ++c)
+        {
+            if (offsets1[c] == offsets1[c + 1])
+                continue;
+
+            const int64_t cx = c / (ny * nz);
+            const int64_t cy = (c / nz) % ny;
+            const int64_t cz = c % nz;
+
+            for (int64_t ox = -1; ox <= 1; ++ox)
+                for (int64_t oy = -1; oy <= 1; ++oy)
+                    for (int64_t oz = -1; oz <= 1; ++oz)
+                    {
+                        const int64_t neighbour = (((cx + ox + nx) % nx) * ny + (cy + oy + ny) % ny) * nz + (cz + oz + nz) % nz;
+
+                        for (int64_t i = offsets1[c]; i < offsets1[c + 1]; ++i)
+                        {
+                            int64_t j_start = offsets2[neighbour];
+                            const int64_t j_stop = offsets2[neighbour + 1];
+
+                            if (same && j_start <= i)
+                                j_start = i + 1;
+                            if (j_start >= j_stop)
+                                continue;
+
+                            const double xi = x1[i], yi = y1[i], zi = z1[i];
+                            const int64_t n = j_stop - j_start;
+
+#pragma omp simd
+                            for (int64_t j = 0; j < n; ++j)
+                            {
+                                double dx = xi - x2[j_start + j];
+                                double dy = yi - y2[j_start + j];
+                                double dz = zi - z2[j_start + j];
+
+                                minimum_image(b, dx, dy, dz);
+
+                                r[j] = std::sqrt(dx * dx + dy * dy + dz * dz);
+                            }
+
+                            for (int64_t j = 0; j < n; ++j)
+                            {
+                                if (r[j] >= r_min && r[j] < r_max)
+                                {
+                                    int64_t bin = static_cast<int64_t>((r[j] - r_min) * inv_width);
+                                    if (bin >= n_bins)
+                                        bin = n_bins - 1;
+                                    local[bin] += 1.0;
+                                }
+                            }
+                        }
+                    }
+        }
+
+#pragma omp critical
+        for (int64_t k = 0; k < n_bins; ++k)
+            hist[k] += local[k];
+    }
+}
+
+namespace
+{
+    /*
+     * Calls f(i, j, r) for all pairs of the sorted atom i of the first cell list
+     * with the atoms j of the 27 neighbour cells closer than the cutoff. With
+     * same, both cell lists are identical and only the pairs j > i are visited.
+     */
+    template <typename F>
+    inline void visit_cell_list_pairs(const Box &b, int64_t i,
+                                      const double *pos1, int64_t n1, int64_t c,
+                                      const double *pos2, const int64_t *offsets2, int64_t n2,
+                                      const int64_t *shape, int same, double cutoff, F &&f)
+    {
+        const int64_t nx = shape[0], ny = shape[1], nz = shape[2];
+        const int64_t cx = c / (ny * nz);
+        const int64_t cy = (c / nz) % ny;
+        const int64_t cz = c % nz;
+
+        const double p[3] = {pos1[i], pos1[n1 + i], pos1[2 * n1 + i]};
+
+        for (int64_t ox = -1; ox <= 1; ++ox)
+            for (int64_t oy = -1; oy <= 1; ++oy)
+                for (int64_t oz = -1; oz <= 1; ++oz)
+                {
+                    const int64_t neighbour = (((cx + ox + nx) % nx) * ny + (cy + oy + ny) % ny) * nz + (cz + oz + nz) % nz;
+
+                    int64_t j_start = offsets2[neighbour];
+                    if (same && j_start <= i)
+                        j_start = i + 1;
+
+                    for (int64_t j = j_start; j < offsets2[neighbour + 1]; ++j)
+                    {
+                        const double q[3] = {pos2[j], pos2[n2 + j], pos2[2 * n2 + j]};
+                        const double r = distance(b, p, q);
+
+                        if (r < cutoff)
+                            f(j, r);
+                    }
+                }
+    }
+}
+
+PQ_EXPORT void pq_cell_list_pair_counts(const double *pos1, const int64_t *cells1, int64_t n1,
+                                        const double *pos2, const int64_t *offsets2, int64_t n2,
+                                        const int64_t *shape,
+                                        const double *box, const double *inv_box,
+                                        int same, double cutoff, int64_t *counts)
+{
+    const Box b = make_box(box, inv_box, 1);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t i = 0; i < n1; ++i)
+    {
+        int64_t count = 0;
+
+        visit_cell_list_pairs(b, i, pos1, n1, cells1[i], pos2, offsets2, n2, shape, same, cutoff,
+                              [&](int64_t, double)
+                              {
+                                  ++count;
+                              });
+
+        counts[i] = count;
+    }
+}
+
+PQ_EXPORT void pq_cell_list_pairs(const double *pos1, const int64_t *cells1, int64_t n1,
+                                  const double *pos2, const int64_t *offsets2, int64_t n2,
+                                  const int64_t *shape,
+                                  const double *box, const double *inv_box,
+                                  int same, double cutoff, const int64_t *offsets,
+                                  int64_t *pairs, double *dist)
+{
+    const Box b = make_box(box, inv_box, 1);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t i = 0; i < n1; ++i)
+    {
+        int64_t k = offsets[i];
+
+        visit_cell_list_pairs(b, i, pos1, n1, cells1[i], pos2, offsets2, n2, shape, same, cutoff,
+                              [&](int64_t j, double r)
+                              {
+                                  pairs[2 * k] = i;
+                                  pairs[2 * k + 1] = j;
+                                  dist[k] = r;
+                                  ++k;
+                              });
+    }
+}
+
+PQ_EXPORT void pq_connected_components(int64_t n_nodes, const int64_t *edges, int64_t n_edges,
+                                       int64_t *labels)
+{
+    /*
+     * Sequential union-find with path halving. The root of the union is always
+     * the smaller root, so that each component is labelled by its smallest node.
+     */
+    for (int64_t i = 0; i < n_nodes; ++i)
+        labels[i] = i;
+
+    auto find = [labels](int64_t i)
+    {
+        while (labels[i] != i)
+        {
+            labels[i] = labels[labels[i]];
+            i = labels[i];
+        }
+        return i;
+    };
+
+    for (int64_t e = 0; e < n_edges; ++e)
+    {
+        const int64_t a = find(edges[2 * e]);
+        const int64_t b = find(edges[2 * e + 1]);
+
+        if (a < b)
+            labels[b] = a;
+        else if (b < a)
+            labels[a] = b;
+    }
+
+    for (int64_t i = 0; i < n_nodes; ++i)
+        labels[i] = labels[labels[i]];
+}
+
+PQ_EXPORT void pq_group_centers_of_mass(const double *pos, const double *masses, int64_t n_groups, int64_t group,
+                                        const double *box, const double *inv_box,
+                                        double *com)
+{
+    const Box b = make_box(box, inv_box, 1);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t g = 0; g < n_groups; ++g)
+    {
+        // all atoms of the group are imaged relative to its first atom
+        const double *reference = pos + 3 * g * group;
+        double sx = 0.0, sy = 0.0, sz = 0.0, total = 0.0;
+
+        for (int64_t i = g * group; i < (g + 1) * group; ++i)
+        {
+            double dx = pos[3 * i] - reference[0];
+            double dy = pos[3 * i + 1] - reference[1];
+            double dz = pos[3 * i + 2] - reference[2];
+
+            minimum_image(b, dx, dy, dz);
+
+            sx += masses[i] * (dx + reference[0]);
+            sy += masses[i] * (dy + reference[1]);
+            sz += masses[i] * (dz + reference[2]);
+            total += masses[i];
+        }
+
+        double cx = sx / total, cy = sy / total, cz = sz / total;
+        minimum_image(b, cx, cy, cz);
+
+        com[3 * g] = cx;
+        com[3 * g + 1] = cy;
+        com[3 * g + 2] = cz;
+    }
+}
+
+namespace
+{
+    /*
+     * Clips the cube [-bound, bound]^3 around an atom by the planes of its
+     * candidates, as _clip_voronoi_cell of the NumPy backend. The cell is a list
+     * of convex polygons, which are clipped by each plane with Sutherland-Hodgman.
+     * The points on the plane are ordered by their angle around their centroid to
+     * form the new face. The buffers are kept between the atoms of a thread.
+     */
+    class VoronoiClipper
+    {
+    public:
+        explicit VoronoiClipper(int64_t max_faces)
+            : max_faces(max_faces), vertices(max_faces * max_faces * 3), n_vertices(max_faces),
+              normals(max_faces * 3), heights(max_faces), ids(max_faces),
+              polygon(max_faces * 3), points(2 * max_faces * 3), angles(2 * max_faces),
+              order(2 * max_faces)
+        {
+        }
+
+        /*
+         * Returns the volume and sets the distance of the farthest vertex (inf if
+         * the buffers are too small). The candidate index and the area of each
+         * face are written to face_ids and face_areas (padded by the caller).
+         */
+        double clip(const double *plane_normals, const double *plane_heights, int64_t count,
+                    double bound, int64_t *face_ids, double *face_areas, double &radius)
+        {
+            const double tolerance = 1e-10 * bound;
+            const int64_t max_points = 2 * max_faces;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const int u = (axis + 1) % 3;
+                const int v = (axis + 2) % 3;
+
+                for (int side = 0; side < 2; ++side)
+                {
+                    const int64_t f = 2 * axis + side;
+                    const double sign = 2.0 * side - 1.0;
+
+                    for (int c = 0; c < 3; ++c)
+                        normals[3 * f + c] = c == axis ? sign : 0.0;
+                    heights[f] = bound;
+                    ids[f] = -1;
+                    n_vertices[f] = 4;
+
+                    for (int corner = 0; corner < 4; ++corner)
+                    {
+                        double *vertex = &vertices[(f * max_faces + corner) * 3];
+                        vertex[axis] = sign * bound;
+                        vertex[u] = corner == 1 || corner == 2 ? bound : -bound;
+                        vertex[v] = corner >= 2 ? bound : -bound;
+                    }
+                }
+            }
+
+            int64_t n_faces = 6;
+            radius = std::sqrt(3.0) * bound;
+
+            for (int64_t k = 0; k < count; ++k)
+            {
+                const double h = plane_heights[k];
+
+                if (h >= radius)
+                    break;
+
+                const double *n = plane_normals + 3 * k;
+                int64_t n_points = 0;
+
+                auto height = [&](const double *x)
+                {
+                    return x[0] * n[0] + x[1] * n[1] + x[2] * n[2] - h;
+                };
+
+                for (int64_t f = 0; f < n_faces; ++f)
+                {
+                    const int64_t m = n_vertices[f];
+                    double *face = &vertices[f * max_faces * 3];
+
+                    if (m == 0)
+                        continue;
+
+                    bool outside = false;
+                    for (int64_t a = 0; a < m && !outside; ++a)
+                        outside = height(face + 3 * a) > tolerance;
+
+                    if (!outside)
+                    {
+                        for (int64_t a = 0; a < m; ++a)
+                            if (height(face + 3 * a) >= -tolerance)
+                            {
+                                if (n_points == max_points)
+                                    return overflow(radius);
+
+                                std::copy(face + 3 * a, face + 3 * a + 3, &points[3 * n_points++]);
+                            }
+
+                        continue;
+                    }
+
+                    int64_t n_out = 0;
+                    for (int64_t a = 0; a < m; ++a)
+                    {
+                        const double *va = face + 3 * a;
+                        const double *vb = face + 3 * (a + 1 < m ? a + 1 : 0);
+                        const double s_a = height(va);
+                        const double s_b = height(vb);
+
+                        if (s_a <= tolerance)
+                        {
+                            if (n_out == max_faces || n_points == max_points)
+                                return overflow(radius);
+
+                            std::copy(va, va + 3, &polygon[3 * n_out++]);
+
+                            if (s_a >= -tolerance)
+                                std::copy(va, va + 3, &points[3 * n_points++]);
+                        }
+
+                        if ((s_a < -tolerance && s_b > tolerance) || (s_a > tolerance && s_b < -tolerance))
+                        {
+                            if (n_out == max_faces || n_points == max_points)
+                                return overflow(radius);
+
+                            const double t = s_a / (s_a - s_b);
+                            for (int c = 0; c < 3; ++c)
+                                polygon[3 * n_out + c] = va[c] + t * (vb[c] - va[c]);
+
+                            std::copy(&polygon[3 * n_out], &polygon[3 * n_out] + 3, &points[3 * n_points++]);
+                            ++n_out;
+                        }
+                    }
+
+                    n_vertices[f] = n_out >= 3 ? n_out : 0;
+                    std::copy(polygon.begin(), polygon.begin() + 3 * n_out, face);
+                }
+
+                if (n_points >= 3 && !add_face(n, h, k, n_points, tolerance, n_faces))
+                    return overflow(radius);
+
+                double r2 = 0.0;
+                for (int64_t f = 0; f < n_faces; ++f)
+                    for (int64_t a = 0; a < n_vertices[f]; ++a)
+                    {
+                        const double *x = &vertices[(f * max_faces + a) * 3];
+                        r2 = std::max(r2, x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+                    }
+                radius = std::sqrt(r2);
+
+                if (radius == 0.0)
+                    return 0.0;
+            }
+
+            double volume = 0.0;
+            int64_t n_out = 0;
+
+            for (int64_t f = 0; f < n_faces; ++f)
+            {
+                const int64_t m = n_vertices[f];
+                const double *face = &vertices[f * max_faces * 3];
+                double ax = 0.0, ay = 0.0, az = 0.0;
+
+                for (int64_t a = 0; a < m; ++a)
+                {
+                    const double *va = face + 3 * a;
+                    const double *vb = face + 3 * (a + 1 < m ? a + 1 : 0);
+                    ax += va[1] * vb[2] - va[2] * vb[1];
+                    ay += va[2] * vb[0] - va[0] * vb[2];
+                    az += va[0] * vb[1] - va[1] * vb[0];
+                }
+
+                const double area = 0.5 * std::abs(ax * normals[3 * f] + ay * normals[3 * f + 1] + az * normals[3 * f + 2]);
+                volume += heights[f] * area / 3.0;
+
+                if (ids[f] >= 0 && area > tolerance * bound)
+                {
+                    face_ids[n_out] = ids[f];
+                    face_areas[n_out] = area;
+                    ++n_out;
+                }
+            }
+
+            return volume;
+        }
+
+    private:
+        static double overflow(double &radius)
+        {
+            radius = std::numeric_limits<double>::infinity();
+            return 0.0;
+        }
+
+        bool add_face(const double *n, double h, int64_t k, int64_t n_points, double tolerance,
+                      int64_t &n_faces)
+        {
+            int64_t slot = -1;
+            for (int64_t f = 0; f < n_faces && slot < 0; ++f)
+                if (n_vertices[f] == 0)
+                    slot = f;
+
+            if (slot < 0)
+            {
+                if (n_faces == max_faces)
+                    return false;
+
+                slot = n_faces++;
+            }
+
+            double centroid[3] = {0.0, 0.0, 0.0};
+            for (int64_t p = 0; p < n_points; ++p)
+                for (int c = 0; c < 3; ++c)
+                    centroid[c] += points[3 * p + c] / n_points;
+
+            // an orthonormal basis (u, w) of the plane
+            double u[3] = {0.0, n[2], -n[1]};
+            if (std::abs(n[0]) >= 0.9)
+            {
+                u[0] = -n[2];
+                u[1] = 0.0;
+                u[2] = n[0];
+            }
+            const double norm = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+            for (double &x : u)
+                x /= norm;
+            const double w[3] = {n[1] * u[2] - n[2] * u[1], n[2] * u[0] - n[0] * u[2], n[0] * u[1] - n[1] * u[0]};
+
+            for (int64_t p = 0; p < n_points; ++p)
+            {
+                const double d[3] = {points[3 * p] - centroid[0], points[3 * p + 1] - centroid[1], points[3 * p + 2] - centroid[2]};
+                angles[p] = std::atan2(d[0] * w[0] + d[1] * w[1] + d[2] * w[2], d[0] * u[0] + d[1] * u[1] + d[2] * u[2]);
+            }
+
+            std::iota(order.begin(), order.begin() + n_points, 0);
+            std::stable_sort(order.begin(), order.begin() + n_points,
+                             [this](int64_t a, int64_t b)
+                             { return angles[a] < angles[b]; });
+
+            double *face = &vertices[slot * max_faces * 3];
+            auto same = [tolerance](const double *a, const double *b)
+            {
+                return std::abs(a[0] - b[0]) <= tolerance && std::abs(a[1] - b[1]) <= tolerance &&
+                       std::abs(a[2] - b[2]) <= tolerance;
+            };
+
+            int64_t n_unique = 0;
+            for (int64_t i = 0; i < n_points; ++i)
+            {
+                const double *point = &points[3 * order[i]];
+
+                if (n_unique > 0 && same(point, face + 3 * (n_unique - 1)))
+                    continue;
+
+                if (n_unique == max_faces)
+                    return false;
+
+                std::copy(point, point + 3, face + 3 * n_unique++);
+            }
+
+            if (n_unique > 1 && same(face, face + 3 * (n_unique - 1)))
+                --n_unique;
+
+            if (n_unique < 3)
+            {
+                n_vertices[slot] = 0;
+                return true;
+            }
+
+            n_vertices[slot] = n_unique;
+            std::copy(n, n + 3, &normals[3 * slot]);
+            heights[slot] = h;
+            ids[slot] = k;
+
+            return true;
+        }
+
+        int64_t max_faces;
+        std::vector<double> vertices;
+        std::vector<int64_t> n_vertices;
+        std::vector<double> normals;
+        std::vector<double> heights;
+        std::vector<int64_t> ids;
+        std::vector<double> polygon;
+        std::vector<double> points;
+        std::vector<double> angles;
+        std::vector<int64_t> order;
+    };
+}
+
+PQ_EXPORT void pq_voronoi_cells(const double *normals, const double *heights, const int64_t *counts,
+                                int64_t n, int64_t m, double bound, int64_t max_faces,
+                                double *volumes, double *radii, int64_t *faces, double *areas)
+{
+#pragma omp parallel
+    {
+        VoronoiClipper clipper(max_faces);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int64_t i = 0; i < n; ++i)
+            volumes[i] = clipper.clip(normals + 3 * m * i, heights + m * i, counts[i], bound,
+                                      faces + max_faces * i, areas + max_faces * i, radii[i]);
+    }
+}
+
+PQ_EXPORT void pq_cell_list_voronoi(const double *pos, int64_t n_atoms, const int64_t *offsets,
+                                    const int64_t *atom_cells, const int64_t *neighbour_cells,
+                                    const int64_t *atoms, int64_t n, const double *weights,
+                                    const double *box, const double *inv_box, double bound,
+                                    int64_t max_candidates, int64_t max_faces,
+                                    double *volumes, double *radii, int64_t *faces, double *areas)
+{
+    const Box b = make_box(box, inv_box, 1);
+
+#pragma omp parallel
+    {
+        VoronoiClipper clipper(max_faces);
+
+        std::vector<double> candidate_heights(max_candidates), candidate_normals(3 * max_candidates);
+        std::vector<double> sorted_heights(max_candidates), sorted_normals(3 * max_candidates);
+        std::vector<int64_t> candidate_atoms(max_candidates), order(max_candidates);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int64_t q = 0; q < n; ++q)
+        {
+            const int64_t i = atoms[q];
+            int64_t count = 0;
+
+            for (int64_t c = 0; c < 27; ++c)
+            {
+                const int64_t cell = neighbour_cells[27 * atom_cells[i] + c];
+
+                for (int64_t j = offsets[cell]; j < offsets[cell + 1]; ++j)
+                {
+                    double dx = pos[j] - pos[i];
+                    double dy = pos[n_atoms + j] - pos[n_atoms + i];
+                    double dz = pos[2 * n_atoms + j] - pos[2 * n_atoms + i];
+
+                    minimum_image(b, dx, dy, dz);
+
+                    const double r = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+                    if (j == i || r == 0.0)
+                        continue;
+
+                    candidate_heights[count] = (r * r + weights[i] - weights[j]) / (2.0 * r);
+                    candidate_normals[3 * count] = dx / r;
+                    candidate_normals[3 * count + 1] = dy / r;
+                    candidate_normals[3 * count + 2] = dz / r;
+                    candidate_atoms[count] = j;
+                    ++count;
+                }
+            }
+
+            // the planes are clipped in the order of their distance to the atom
+            std::iota(order.begin(), order.begin() + count, 0);
+            std::stable_sort(order.begin(), order.begin() + count,
+                             [&](int64_t a, int64_t b)
+                             { return candidate_heights[a] < candidate_heights[b]; });
+
+            for (int64_t k = 0; k < count; ++k)
+            {
+                sorted_heights[k] = candidate_heights[order[k]];
+                std::copy(&candidate_normals[3 * order[k]], &candidate_normals[3 * order[k]] + 3,
+                          &sorted_normals[3 * k]);
+            }
+
+            int64_t *atom_faces = faces + max_faces * q;
+
+            volumes[q] = clipper.clip(sorted_normals.data(), sorted_heights.data(), count, bound,
+                                      atom_faces, areas + max_faces * q, radii[q]);
+
+            for (int64_t f = 0; f < max_faces && atom_faces[f] >= 0; ++f)
+                atom_faces[f] = candidate_atoms[order[atom_faces[f]]];
+        }
+    }
+}
+
+/*
+ * The shared library is built as (empty) extension module, so that it is
+ * located and installed by the regular Python import machinery.
+ */
+
+static struct PyModuleDef distances_module = {
+    PyModuleDef_HEAD_INIT,
+    "_distances",
+    "Native kernels of PQAnalysis (accessed via ctypes).",
+    -1,
+    nullptr,
+};
+
+PyMODINIT_FUNC PyInit__distances(void)
+{
+    return PyModule_Create(&distances_module);
+}
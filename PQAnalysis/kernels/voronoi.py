@@ -0,0 +1,274 @@
+"""
+A module containing the Voronoi tessellation kernel for periodic cells.
+
+The Voronoi cell of each atom is obtained by clipping a cube around the atom with
+the bisecting planes of its candidate neighbours, which are gathered from the 27
+surrounding cells of a CellList. The clipping of the cells is delegated to the
+backend selected in PQAnalysis.kernels.backends.
+
+...
+
+Functions
+---------
+voronoi_cells
+    Returns the (radical) Voronoi cell volumes and faces of all atoms of a periodic cell.
+"""
+
+import warnings
+
+import numpy as np
+
+from beartype.typing import Tuple
+
+from .backends import current
+from .cellList import CellList
+from .distances import _prepare_positions
+from ..types import Np1DNumberArray, Np2DIntArray, Np2DNumberArray, Np3x3NumberArray
+
+# the candidate radius is chosen to contain about this many atoms on average
+_n_candidates = 20
+
+# the largest lattice translation of the image search for small systems
+_max_images = 4
+
+# the number of atoms clipped at once
+_batch_size = 1 << 14
+
+
+def voronoi_cells(pos: Np2DNumberArray,
+                  box_matrix: Np3x3NumberArray,
+                  radii: Np1DNumberArray | None = None
+                  ) -> Tuple[Np1DNumberArray, Np2DIntArray, Np1DNumberArray]:
+    """
+    Returns the (radical) Voronoi cell volumes and faces of all atoms of a periodic cell.
+
+    The cell of atom i is bounded by the planes between i and all other atoms (and
+    their periodic images). For the radical (power) tessellation with the radii r the
+    plane to an atom at distance d lies at (d^2 + r_i^2 - r_j^2) / (2d) from atom i,
+    for the plain Voronoi tessellation at d / 2.
+
+    The candidates are the atoms of the 27 cells around each atom of a CellList with
+    cells of the width rc, which is estimated from the density to contain about 20
+    atoms. All atoms closer than rc are candidates, so that a cell is exact if its
+    farthest vertex is closer than the plane of any atom at rc. The other atoms are
+    searched again with rc enlarged by 1.5. Small systems, for which no CellList is
+    usable, are tessellated with the explicit periodic images of all atoms.
+
+    Parameters
+    ----------
+    pos : Np2DNumberArray
+        The positions of shape (n, 3).
+    box_matrix : Np3x3NumberArray
+        The box matrix of the cell.
+    radii : Np1DNumberArray | None, optional
+        The radius of each atom for the radical tessellation, by default None (Voronoi)
+
+    Returns
+    -------
+    volumes : Np1DNumberArray
+        The volume of the cell of each atom of shape (n,), which sum up to the volume of the box.
+    faces : Np2DIntArray
+        The atoms (i, j) of each face of shape (n_faces, 2), sorted by i and j. A face
+        of the cell of i with j is also a face of the cell of j with i, numerically
+        degenerate faces without counterpart are dropped. In small boxes, atom i can
+        share several faces with different images of j or with its own images.
+    areas : Np1DNumberArray
+        The area of each face of shape (n_faces,).
+
+    Warns
+    -----
+    RuntimeWarning
+        If the numpy backend is used, whose clipping of the cells is an interpreted
+        Python loop per atom and orders of magnitude slower than the native and numba
+        backends.
+
+    Raises
+    ------
+    ValueError
+        If there are less than one position, the radii do not match the positions,
+        the cell of an atom could not be determined or the cells do not fill the box
+        (e.g. due to coinciding atoms).
+    """
+    pos = _prepare_positions(pos)
+    box_matrix = np.asarray(box_matrix, dtype=np.float64)
+    inv_box = np.linalg.inv(box_matrix)
+
+    n_atoms = len(pos)
+
+    if n_atoms == 0:
+        raise ValueError("The Voronoi tessellation needs at least one position.")
+
+    if radii is None:
+        weights = np.zeros(n_atoms)
+    else:
+        weights = np.asarray(radii, dtype=np.float64)**2
+
+        if weights.shape != (n_atoms,):
+            raise ValueError("The radical Voronoi tessellation needs one radius per position.")
+
+    # the positions are wrapped into the unit cell for the image search
+    fractional_pos = pos @ inv_box.T
+    pos = (fractional_pos - np.floor(fractional_pos)) @ box_matrix.T
+
+    volumes = np.zeros(n_atoms)
+    faces = []
+    areas = []
+
+    backend = current()
+
+    if backend.name == "numpy":
+        warnings.warn("The Voronoi cells are clipped in pure Python by the numpy backend, which takes "
+                      "milliseconds per atom. Install numba or build the native kernels for large systems.",
+                      RuntimeWarning, stacklevel=2)
+    remaining = np.arange(n_atoms)
+
+    volume = abs(np.linalg.det(box_matrix))
+    rc = (3.0 * _n_candidates * volume / (4.0 * np.pi * n_atoms))**(1.0 / 3.0)
+
+    while len(remaining) > 0 and CellList.is_usable(box_matrix, rc):
+        cells = CellList(pos, box_matrix, rc)
+
+        # the positions of the atoms in the sorted positions of the cell list
+        ranks = np.empty(n_atoms, dtype=np.int64)
+        ranks[cells.order] = np.arange(n_atoms)
+
+        found = np.zeros(len(remaining), dtype=bool)
+
+        for start in range(0, len(remaining), _batch_size):
+            batch = slice(start, start + _batch_size)
+
+            batch_volumes, vertex_radii, batch_faces, batch_areas = backend.cell_list_voronoi(
+                cells, ranks[remaining[batch]], weights[cells.order], box_matrix, inv_box, float(rc))
+
+            batch_faces = np.where(batch_faces >= 0, cells.order[batch_faces], -1)
+
+            found[batch] = _store_cells(remaining[batch], batch_volumes, vertex_radii, batch_faces,
+                                        batch_areas, weights, rc, volumes, faces, areas)
+
+        remaining = remaining[~found]
+        rc *= 1.5
+
+    # the distance between opposite faces of the unit cell
+    width = 1.0 / np.max(np.linalg.norm(inv_box, axis=1))
+
+    for n_images in range(1, _max_images + 1):
+        if len(remaining) == 0:
+            break
+
+        images = np.stack(np.meshgrid(*[np.arange(-n_images, n_images + 1)] * 3, indexing="ij"),
+                          axis=-1).reshape(-1, 3)
+
+        # the candidates are all atoms of all images
+        image_pos = (pos + (images @ box_matrix.T)[:, np.newaxis, :]).reshape(-1, 3)
+        image_atoms = np.tile(np.arange(n_atoms), len(images))
+
+        # the images of all atoms of the unit cell are at least n_images widths apart
+        rc = n_images * width
+        found = np.zeros(len(remaining), dtype=bool)
+
+        batch_size = max(1, (1 << 20) // len(image_pos))
+
+        for start in range(0, len(remaining), batch_size):
+            batch = slice(start, start + batch_size)
+            atoms = remaining[batch]
+
+            dpos = image_pos - pos[atoms, np.newaxis, :]
+            distances = np.linalg.norm(dpos, axis=-1)
+            valid = distances > 0.0
+
+            with np.errstate(all="ignore"):
+                heights = (distances**2 + weights[atoms, np.newaxis] - weights[image_atoms]) / (2.0 * distances)
+                heights[~valid] = np.inf
+                normals = dpos / distances[..., np.newaxis]
+
+            order = np.argsort(heights, axis=1, kind="stable")
+            heights = np.ascontiguousarray(np.take_along_axis(heights, order, axis=1))
+            normals = np.ascontiguousarray(np.take_along_axis(normals, order[..., np.newaxis], axis=1))
+
+            batch_volumes, vertex_radii, batch_faces, batch_areas = backend.voronoi_cells(
+                normals, heights, np.count_nonzero(valid, axis=1), float(rc))
+
+            batch_faces = np.where(batch_faces >= 0,
+                                   image_atoms[np.take_along_axis(order, np.maximum(batch_faces, 0), axis=1)],
+                                   -1)
+
+            found[batch] = _store_cells(atoms, batch_volumes, vertex_radii, batch_faces, batch_areas,
+                                        weights, rc, volumes, faces, areas)
+
+        remaining = remaining[~found]
+
+    if len(remaining) > 0:
+        raise ValueError(f"The Voronoi cell of atom {remaining[0]} could not be determined.")
+
+    # coinciding atoms do not bound each other and their cells overlap
+    if not np.isclose(np.sum(volumes), volume, rtol=1e-8):
+        raise ValueError("The Voronoi cells do not fill the box, probably due to coinciding atoms.")
+
+    faces = np.concatenate(faces) if len(faces) > 0 else np.zeros((0, 2), dtype=np.int64)
+    areas = np.concatenate(areas) if len(areas) > 0 else np.zeros(0)
+
+    # numerically degenerate faces (e.g. of nearly cospherical atoms) can be missing
+    # in the cell of the neighbour and are dropped to keep the faces symmetric
+    keys = faces[:, 0] * n_atoms + faces[:, 1]
+    symmetric = np.isin(keys, faces[:, 1] * n_atoms + faces[:, 0])
+    faces, areas = faces[symmetric], areas[symmetric]
+
+    order = np.lexsort((faces[:, 1], faces[:, 0]))
+
+    return volumes, faces[order], areas[order]
+
+
+def _store_cells(atoms: np.ndarray,
+                 cell_volumes: np.ndarray,
+                 radii: np.ndarray,
+                 cell_faces: np.ndarray,
+                 cell_areas: np.ndarray,
+                 weights: np.ndarray,
+                 rc: float,
+                 volumes: np.ndarray,
+                 faces: list,
+                 areas: list
+                 ) -> np.ndarray:
+    """
+    Stores the clipped cells, which are exact.
+
+    Parameters
+    ----------
+    atoms : np.ndarray
+        The atoms of the clipped cells.
+    cell_volumes : np.ndarray
+        The volume of each clipped cell.
+    radii : np.ndarray
+        The distance of the farthest vertex of each clipped cell.
+    cell_faces : np.ndarray
+        The neighbour atom of each face of each clipped cell padded with -1.
+    cell_areas : np.ndarray
+        The area of each face of each clipped cell.
+    weights : np.ndarray
+        The squared radius of each atom.
+    rc : float
+        The radius within which all atoms were candidates.
+    volumes : np.ndarray
+        The volumes of all atoms, filled for the exact cells.
+    faces : list
+        The list of the face arrays, appended for the exact cells.
+    areas : list
+        The list of the face area arrays, appended for the exact cells.
+
+    Returns
+    -------
+    np.ndarray
+        Whether the cell of each atom is exact.
+    """
+    # no atom beyond rc has a plane closer than this bound
+    bound = 0.5 * rc - 0.5 * (np.max(weights) - weights[atoms]) / rc
+    found = radii <= bound
+
+    volumes[atoms[found]] = cell_volumes[found]
+
+    i, k = np.nonzero((cell_faces >= 0) & found[:, np.newaxis])
+
+    faces.append(np.column_stack((atoms[i], cell_faces[i, k])))
+    areas.append(cell_areas[i, k])
+
+    return found
@@ -1,3 +1,4 @@
 from .exceptions import EnergyError
 
 from .energy import Energy
+from .energyAlignment import EnergyAlignment
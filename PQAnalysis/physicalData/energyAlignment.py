@@ -0,0 +1,291 @@
+"""
+A module containing the EnergyAlignment class.
+
+...
+
+Classes
+-------
+EnergyAlignment
+    A class to align the rows of an energy file with the frames of a trajectory.
+"""
+
+import numpy as np
+
+from beartype.typing import Generator, Iterable, Tuple
+from numbers import Real
+
+from . import Energy, EnergyError
+from ..traj import Frame
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray
+
+
+class EnergyAlignment:
+    """
+    A class to align the rows of an energy file with the frames of a trajectory.
+
+    The energy file is usually written every step, while the trajectory is only
+    written every stride steps. Frame i of the trajectory therefore corresponds to
+    the energy row offset + i * stride. If the stride is not given, it is inferred
+    from the number of energy rows and the number of frames (or from the time
+    between two frames and the SIMULATION-TIME column). By default the frames are
+    assumed to be written at the end of each stride, i.e. offset = stride - 1, so
+    that the last frame corresponds to the last energy row.
+
+    All data returned by the alignment are NumPy views on the data of the Energy
+    object - no energy row is copied.
+
+    ...
+
+    Attributes
+    ----------
+    energy : Energy
+        The aligned energy data.
+    n_frames : int
+        The number of frames of the trajectory.
+    stride : int
+        The number of energy rows per frame.
+    offset : int
+        The energy row of the first frame.
+    """
+
+    def __init__(self,
+                 energy: Energy,
+                 n_frames: int,
+                 stride: int | None = None,
+                 offset: int | None = None,
+                 frame_interval: Real | None = None
+                 ) -> None:
+        """
+        Initializes the EnergyAlignment and infers the stride if not given.
+
+        Parameters
+        ----------
+        energy : Energy
+            The energy data to align.
+        n_frames : int
+            The number of frames of the trajectory.
+        stride : int | None, optional
+            The number of energy rows per frame, by default None (inferred)
+        offset : int | None, optional
+            The energy row of the first frame, by default None (stride - 1)
+        frame_interval : Real | None, optional
+            The simulation time between two frames in the unit of the SIMULATION-TIME
+            column. If given (and stride is None), the stride is inferred from the time
+            between two energy rows instead of from the number of rows, by default None
+
+        Raises
+        ------
+        EnergyError
+            If the stride cannot be inferred or if the frames exceed the energy rows.
+        """
+        n_rows = energy.data.shape[1]
+
+        if stride is None:
+            if frame_interval is not None:
+                stride = self._stride_from_time(energy, frame_interval)
+            else:
+                stride = self._stride_from_counts(energy, n_rows, n_frames)
+
+        if stride < 1:
+            raise EnergyError("The stride has to be at least 1.")
+
+        if offset is None:
+            offset = stride - 1
+
+        if offset < 0 or n_frames < 0 or offset + (n_frames - 1) * stride >= n_rows:
+            raise EnergyError(
+                f"{n_frames} frames with stride {stride} and offset {offset} exceed the {n_rows} energy rows.")
+
+        self.energy = energy
+        self.n_frames = n_frames
+        self.stride = stride
+        self.offset = offset
+
+    @staticmethod
+    def _stride_from_counts(energy: Energy, n_rows: int, n_frames: int) -> int:
+        """
+        Infers the stride from the number of energy rows and frames.
+
+        Parameters
+        ----------
+        energy : Energy
+            The energy data.
+        n_rows : int
+            The number of energy rows.
+        n_frames : int
+            The number of frames.
+
+        Returns
+        -------
+        int
+            The number of energy rows per frame.
+
+        Raises
+        ------
+        EnergyError
+            If the number of rows is not a multiple of the number of frames or if
+            the SIMULATION-TIME column is not evenly spaced.
+        """
+        if n_frames < 1 or n_rows % n_frames != 0:
+            raise EnergyError(
+                f"The stride cannot be inferred from {n_rows} energy rows and {n_frames} frames. Please give the stride explicitly.")
+
+        # the rows are only equivalent to time steps if they are evenly spaced
+        if hasattr(energy, "simulation_time") and len(energy.simulation_time) > 2:
+            differences = np.diff(energy.simulation_time)
+            if not np.allclose(differences, differences[0]):
+                raise EnergyError(
+                    "The SIMULATION-TIME of the energy rows is not evenly spaced. Please give the stride explicitly.")
+
+        return n_rows // n_frames
+
+    @staticmethod
+    def _stride_from_time(energy: Energy, frame_interval: Real) -> int:
+        """
+        Infers the stride from the time between two frames and the SIMULATION-TIME column.
+
+        Parameters
+        ----------
+        energy : Energy
+            The energy data.
+        frame_interval : Real
+            The simulation time between two frames.
+
+        Returns
+        -------
+        int
+            The number of energy rows per frame.
+
+        Raises
+        ------
+        EnergyError
+            If the energy has no SIMULATION-TIME column, the column has less than two
+            rows or the frame interval is not a multiple of the time between two rows.
+        """
+        if not hasattr(energy, "simulation_time") or len(energy.simulation_time) < 2:
+            raise EnergyError(
+                "The stride can only be inferred from the frame interval with at least two SIMULATION-TIME rows.")
+
+        row_interval = np.median(np.diff(energy.simulation_time))
+        stride = int(round(frame_interval / row_interval))
+
+        if stride < 1 or not np.isclose(stride * row_interval, frame_interval):
+            raise EnergyError(
+                f"The frame interval {frame_interval} is not a multiple of the energy row interval {row_interval}.")
+
+        return stride
+
+    @property
+    def rows(self) -> Np1DIntArray:
+        """
+        Np1DIntArray: The energy row of each frame.
+        """
+        return self.offset + self.stride * np.arange(self.n_frames)
+
+    @property
+    def data(self) -> Np2DNumberArray:
+        """
+        Np2DNumberArray: A view on the energy data of all frames with shape (n_properties, n_frames).
+        """
+        stop = self.offset + (self.n_frames - 1) * self.stride + 1 if self.n_frames > 0 else self.offset
+
+        return self.energy.data[:, self.offset:stop:self.stride]
+
+    @property
+    def frame_times(self) -> Np1DNumberArray:
+        """
+        Np1DNumberArray: The SIMULATION-TIME of each frame.
+
+        Raises
+        ------
+        EnergyError
+            If the energy has no SIMULATION-TIME column.
+        """
+        if not hasattr(self.energy, "simulation_time"):
+            raise EnergyError("The energy has no SIMULATION-TIME column.")
+
+        return self.column("SIMULATION-TIME" if "SIMULATION-TIME" in self.energy.info else "SIMULATION TIME")
+
+    def column(self, key) -> Np1DNumberArray:
+        """
+        Returns a view on one property of the energy for all frames.
+
+        Parameters
+        ----------
+        key : Any
+            The name of the property as in the info file or, without info file, the column index.
+
+        Returns
+        -------
+        Np1DNumberArray
+            The values of the property at each frame.
+
+        Raises
+        ------
+        EnergyError
+            If the property is not part of the energy.
+        """
+        index = self.energy.info.get(key) if self.energy.info_given else key
+
+        if not isinstance(index, int) or not 0 <= index < len(self.energy.data):
+            raise EnergyError(f"The energy has no column {key}.")
+
+        return self.data[index]
+
+    def __getitem__(self, frame: int) -> Np1DNumberArray:
+        """
+        Returns a view on the energy row of the given frame.
+
+        Parameters
+        ----------
+        frame : int
+            The index of the frame. Negative indices count from the last frame.
+
+        Returns
+        -------
+        Np1DNumberArray
+            The values of all properties at the given frame.
+        """
+        return self.data[:, frame]
+
+    def __len__(self) -> int:
+        """
+        Returns the number of aligned frames.
+
+        Returns
+        -------
+        int
+            The number of frames.
+        """
+        return self.n_frames
+
+    def iter_frames(self, frames: Iterable[Frame]) -> Generator[Tuple[Frame, Np1DNumberArray], None, None]:
+        """
+        Yields each frame together with a view on its energy row.
+
+        The frames are consumed lazily, so that a streaming reader like
+        TrajectoryReader.iter_frames can be used without reading the whole trajectory.
+
+        Parameters
+        ----------
+        frames : Iterable[Frame]
+            The frames of the trajectory in their original order.
+
+        Yields
+        ------
+        Tuple[Frame, Np1DNumberArray]
+            The frame and the values of all properties at this frame.
+
+        Raises
+        ------
+        EnergyError
+            If there are more frames than aligned frames.
+        """
+        data = self.data
+
+        for i, frame in enumerate(frames):
+            if i >= self.n_frames:
+                raise EnergyError(
+                    f"The trajectory has more frames than the {self.n_frames} aligned frames.")
+
+            yield frame, data[:, i]
@@ -0,0 +1,7 @@
+from .exceptions import StatisticsError
+
+from .correlation import correlation, MultiTauCorrelator
+from .histogram import Histogram
+from .moments import MomentAccumulator
+from .statisticalInefficiency import autocorrelation, statistical_inefficiency, decorrelated_indices, read_decorrelated_frames
+from .blockResampling import BlockResampling, ResamplingResult
@@ -0,0 +1,386 @@
+"""
+A module containing classes for block bootstrap and jackknife error estimates.
+
+...
+
+Classes
+-------
+BlockResampling
+    A class for error estimates from per-block partial results of an analysis.
+ResamplingResult
+    A class storing the estimate, the error and the replicas of a resampling.
+"""
+
+from __future__ import annotations
+
+import copy
+import os
+import numbers
+
+import numpy as np
+
+from beartype.typing import Any, Callable, Iterable, List
+
+from . import StatisticsError
+from ..types import Np2DIntArray
+from ..utils import process_pool
+
+
+def _identity(value: Any) -> Any:
+    return value
+
+
+class ResamplingResult:
+    """
+    A class storing the estimate, the error and the replicas of a resampling.
+
+    ...
+
+    Attributes
+    ----------
+    estimate : np.ndarray
+        The estimate of the analysis for all blocks.
+    error : np.ndarray
+        The standard error of the estimate.
+    replicas : np.ndarray
+        The estimates of all replicas stacked along the first axis.
+    method : str
+        Either 'bootstrap' or 'jackknife'.
+    """
+
+    def __init__(self, estimate: Any, error: Any, replicas: np.ndarray, method: str) -> None:
+        """
+        Initializes the ResamplingResult with the given parameters.
+
+        Parameters
+        ----------
+        estimate : Any
+            The estimate of the analysis for all blocks.
+        error : Any
+            The standard error of the estimate.
+        replicas : np.ndarray
+            The estimates of all replicas stacked along the first axis.
+        method : str
+            Either 'bootstrap' or 'jackknife'.
+        """
+        self.estimate = np.asarray(estimate)
+        self.error = np.asarray(error)
+        self.replicas = replicas
+        self.method = method
+
+    def confidence_interval(self, level: float = 0.95) -> np.ndarray:
+        """
+        Returns the percentile confidence interval of the bootstrap replicas.
+
+        Parameters
+        ----------
+        level : float, optional
+            The confidence level, by default 0.95
+
+        Returns
+        -------
+        np.ndarray
+            The lower and upper bound stacked along the first axis.
+
+        Raises
+        ------
+        StatisticsError
+            If the result was not obtained by bootstrapping.
+        """
+        if self.method != "bootstrap":
+            raise StatisticsError(
+                "Percentile confidence intervals are only available for bootstrap results.")
+
+        alpha = (1.0 - level) / 2.0
+
+        return np.quantile(self.replicas, [alpha, 1.0 - alpha], axis=0)
+
+
+class BlockResampling:
+    """
+    A class for error estimates from per-block partial results of an analysis.
+
+    The trajectory is split into consecutive blocks of frames, which should be longer
+    than the correlation time of the analysed property. The analysis is run once per
+    block and only its partial result (e.g. the histogram counts of an RDF) is stored.
+    Bootstrap and jackknife replicas are then assembled by merging the partial results
+    of the drawn blocks - no frame is read or analysed again. Finally, the estimator
+    computes the quantity of interest (e.g. the normalized RDF or a peak position) from
+    the merged partials of each replica.
+
+    Partial results are either numbers/NumPy arrays, which are merged by (weighted)
+    summation, or mergeable accumulators providing a merge(other) method, which merges
+    other into the accumulator in place.
+
+    ...
+
+    Attributes
+    ----------
+    partials : list
+        The partial result of each block.
+    estimator : Callable
+        The function computing the quantity of interest from merged partials.
+    n_workers : int
+        The number of processes evaluating the replicas.
+    """
+
+    def __init__(self,
+                 partials: List[Any],
+                 estimator: Callable[[Any], Any] | None = None,
+                 n_workers: int | None = 1
+                 ) -> None:
+        """
+        Initializes the BlockResampling with the given partial results.
+
+        With n_workers > 1 the replicas are merged and evaluated in parallel by worker
+        processes. Therefore, the estimator has to be picklable (e.g. a module level
+        function) in this case.
+
+        Parameters
+        ----------
+        partials : List[Any]
+            The partial result of each block.
+        estimator : Callable[[Any], Any] | None, optional
+            The function computing the quantity of interest from merged partials, by default
+            None (the merged partials themselves)
+        n_workers : int | None, optional
+            The number of processes evaluating the replicas, by default 1. If None, the
+            number of CPUs is used.
+
+        Raises
+        ------
+        StatisticsError
+            If less than two partial results are given.
+        """
+        if len(partials) < 2:
+            raise StatisticsError("At least two blocks are needed for resampling.")
+
+        self.partials = partials
+        self.estimator = estimator if estimator is not None else _identity
+        self.n_workers = n_workers if n_workers is not None else os.cpu_count() or 1
+
+    @classmethod
+    def from_frames(cls,
+                    frames: Iterable[Any],
+                    n_blocks: int,
+                    accumulator_factory: Callable[[], Any],
+                    update: Callable[[Any, Any], Any],
+                    estimator: Callable[[Any], Any] | None = None,
+                    n_frames: int | None = None,
+                    n_workers: int | None = 1
+                    ) -> BlockResampling:
+        """
+        Runs an analysis once per block of frames and stores the partial results.
+
+        The frames are consumed lazily, so that a streaming reader (e.g.
+        TrajectoryReader.iter_frames) can be used.
+
+        Parameters
+        ----------
+        frames : Iterable[Any]
+            The frames of the trajectory.
+        n_blocks : int
+            The number of blocks.
+        accumulator_factory : Callable[[], Any]
+            Creates an empty accumulator for a block.
+        update : Callable[[Any, Any], Any]
+            Called with (accumulator, frame) for each frame. If it returns a value other than
+            None, the value replaces the accumulator (e.g. for NumPy arrays: acc + frame_counts).
+        estimator : Callable[[Any], Any] | None, optional
+            The function computing the quantity of interest from merged partials, by default None
+        n_frames : int | None, optional
+            The number of frames, by default None (len(frames))
+        n_workers : int | None, optional
+            The number of processes evaluating the replicas, by default 1
+
+        Returns
+        -------
+        BlockResampling
+            The resampling with one partial result per block.
+
+        Raises
+        ------
+        StatisticsError
+            If there are less frames than blocks or the frames do not yield n_frames frames.
+        """
+        if n_frames is None:
+            n_frames = len(frames)
+
+        if n_frames < n_blocks:
+            raise StatisticsError(
+                f"The {n_frames} frames cannot be split into {n_blocks} blocks.")
+
+        partials = [accumulator_factory() for _ in range(n_blocks)]
+        n_consumed = 0
+
+        for frame in frames:
+            if n_consumed == n_frames:
+                raise StatisticsError(
+                    f"The frames yield more than the given {n_frames} frames.")
+
+            block = n_consumed * n_blocks // n_frames
+
+            result = update(partials[block], frame)
+            if result is not None:
+                partials[block] = result
+
+            n_consumed += 1
+
+        if n_consumed != n_frames:
+            raise StatisticsError(
+                f"The frames yield {n_consumed} instead of the given {n_frames} frames.")
+
+        return cls(partials, estimator, n_workers)
+
+    @property
+    def n_blocks(self) -> int:
+        """
+        int: The number of blocks.
+        """
+        return len(self.partials)
+
+    def estimate(self) -> Any:
+        """
+        Returns the estimate of the analysis for all blocks.
+
+        Returns
+        -------
+        Any
+            The estimator applied to the merged partials of all blocks.
+        """
+        return self.estimator(_merge(self.partials, np.ones(self.n_blocks, dtype=np.int64)))
+
+    def bootstrap(self, n_replicas: int = 1000, seed: int | None = None) -> ResamplingResult:
+        """
+        Computes the block bootstrap estimate of the standard error.
+
+        Each replica draws n_blocks blocks with replacement.
+
+        Parameters
+        ----------
+        n_replicas : int, optional
+            The number of bootstrap replicas, by default 1000
+        seed : int | None, optional
+            The seed of the random number generator, by default None
+
+        Returns
+        -------
+        ResamplingResult
+            The estimate for all blocks, the standard deviation of the replicas and the replicas.
+        """
+        rng = np.random.default_rng(seed)
+
+        drawn = rng.integers(0, self.n_blocks, size=(n_replicas, self.n_blocks))
+        weights = np.zeros((n_replicas, self.n_blocks), dtype=np.int64)
+        np.add.at(weights, (np.arange(n_replicas)[:, np.newaxis], drawn), 1)
+
+        replicas = self._evaluate(weights)
+
+        return ResamplingResult(self.estimate(), np.std(replicas, axis=0, ddof=1), replicas, "bootstrap")
+
+    def jackknife(self) -> ResamplingResult:
+        """
+        Computes the delete-one-block jackknife estimate of the standard error.
+
+        Returns
+        -------
+        ResamplingResult
+            The estimate for all blocks, the jackknife standard error and the replicas.
+        """
+        n = self.n_blocks
+        weights = np.ones((n, n), dtype=np.int64) - np.eye(n, dtype=np.int64)
+
+        replicas = self._evaluate(weights)
+
+        variance = (n - 1) / n * np.sum((replicas - np.mean(replicas, axis=0))**2, axis=0)
+
+        return ResamplingResult(self.estimate(), np.sqrt(variance), replicas, "jackknife")
+
+    def _evaluate(self, weights: Np2DIntArray) -> np.ndarray:
+        """
+        Merges the partials with each row of weights and applies the estimator.
+
+        Parameters
+        ----------
+        weights : Np2DIntArray
+            The number of times each block is part of each replica with shape (n_replicas, n_blocks).
+
+        Returns
+        -------
+        np.ndarray
+            The estimates of all replicas stacked along the first axis.
+        """
+        n_workers = min(self.n_workers, len(weights))
+
+        if n_workers == 1:
+            return np.array(_evaluate_replicas(self.partials, weights, self.estimator))
+
+        chunks = np.array_split(weights, n_workers)
+        with process_pool(n_workers) as executor:
+            results = executor.map(_evaluate_replicas,
+                                   [self.partials] * len(chunks),
+                                   chunks,
+                                   [self.estimator] * len(chunks))
+
+            return np.array([replica for result in results for replica in result])
+
+
+def _evaluate_replicas(partials: List[Any], weights: Np2DIntArray, estimator: Callable[[Any], Any]) -> List[Any]:
+    """
+    Evaluates the estimator for each row of weights (executed by the worker processes).
+
+    Parameters
+    ----------
+    partials : List[Any]
+        The partial result of each block.
+    weights : Np2DIntArray
+        The weights of the blocks for each replica.
+    estimator : Callable[[Any], Any]
+        The function computing the quantity of interest from merged partials.
+
+    Returns
+    -------
+    List[Any]
+        The estimate of each replica.
+    """
+    if _is_numeric(partials[0]):
+        # all replicas are merged at once by a single matrix product
+        stacked = np.array(partials, dtype=np.float64)
+        merged = np.tensordot(weights, stacked, axes=1)
+        return [estimator(replica) for replica in merged]
+
+    return [estimator(_merge(partials, row)) for row in weights]
+
+
+def _merge(partials: List[Any], weights: np.ndarray) -> Any:
+    """
+    Merges the partials, where partial i is merged weights[i] times.
+
+    Parameters
+    ----------
+    partials : List[Any]
+        The partial result of each block.
+    weights : np.ndarray
+        The non-negative integer weight of each block.
+
+    Returns
+    -------
+    Any
+        The merged partial result. The given partials are not modified.
+    """
+    if _is_numeric(partials[0]):
+        return np.tensordot(weights, np.array(partials, dtype=np.float64), axes=1)
+
+    merged = None
+    for partial, weight in zip(partials, weights):
+        for _ in range(int(weight)):
+            if merged is None:
+                merged = copy.deepcopy(partial)
+            else:
+                merged.merge(partial)
+
+    return merged
+
+
+def _is_numeric(partial: Any) -> bool:
+    return isinstance(partial, (np.ndarray, numbers.Number))
@@ -0,0 +1,405 @@
+"""
+A module containing time correlation functions of scalar and vector observables.
+
+...
+
+Classes
+-------
+MultiTauCorrelator
+    A class computing time correlation functions on the fly on a logarithmic lag grid.
+
+Functions
+---------
+correlation
+    Computes the time (cross-)correlation function of many time series with FFTs.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from concurrent.futures import ThreadPoolExecutor
+from beartype.typing import List, Tuple
+
+from . import StatisticsError
+from ..types import Np1DNumberArray, Np2DNumberArray
+
+
+def correlation(a: np.ndarray,
+                b: np.ndarray | None = None,
+                n_lags: int | None = None,
+                average: bool = True,
+                batch_size: int | None = None,
+                n_workers: int = 1
+                ) -> Np1DNumberArray | Np2DNumberArray:
+    """
+    Computes the time (cross-)correlation function of many time series with FFTs.
+
+    The correlation C(t) = < a(s) . b(s+t) >_s is averaged over all time origins s,
+    i.e. each lag is divided by its number of contributing pairs (n - t). For vector
+    observables the dot product over the last axis is used. The zero padded FFTs need
+    O(n log n) operations per series.
+
+    The series are processed in batches, so that the memory of the transforms is
+    bounded, and with n_workers > 1 the batches are transformed by a thread pool
+    (the FFTs of NumPy release the GIL).
+
+    Parameters
+    ----------
+    a : np.ndarray
+        The time series with shape (n_times,), (n_times, n_series) or, for vector
+        observables, (n_times, n_series, dim).
+    b : np.ndarray | None, optional
+        The second time series with the same shape as a, by default None (autocorrelation)
+    n_lags : int | None, optional
+        The number of lags to return, by default None (all n_times lags)
+    average : bool, optional
+        Whether the correlation is averaged over the series, by default True
+    batch_size : int | None, optional
+        The number of series transformed at once, by default None (about 2^24 values per batch)
+    n_workers : int, optional
+        The number of threads transforming the batches, by default 1
+
+    Returns
+    -------
+    Np1DNumberArray | Np2DNumberArray
+        The correlation function with shape (n_lags,) if averaged or if a is 1D,
+        otherwise with shape (n_lags, n_series).
+
+    Raises
+    ------
+    StatisticsError
+        If the shapes of a and b differ, the series are empty or n_lags is out of range.
+    """
+    a, single = _as_series(a)
+    b = a if b is None else _as_series(b)[0]
+
+    if a.shape != b.shape:
+        raise StatisticsError(
+            f"The time series have different shapes {a.shape} and {b.shape}.")
+
+    n_times, n_series, dim = a.shape
+
+    if n_lags is None:
+        n_lags = n_times
+
+    if n_times == 0 or not 1 <= n_lags <= n_times:
+        raise StatisticsError(
+            f"The number of lags has to be between 1 and the number of time steps {n_times}.")
+
+    n_fft = 1 << int(2 * n_times - 1).bit_length()
+
+    if batch_size is None:
+        batch_size = max(1, (1 << 24) // (n_fft * dim))
+
+    batches = [slice(start, min(start + batch_size, n_series))
+               for start in range(0, n_series, batch_size)]
+
+    def correlate(batch: slice) -> np.ndarray:
+        return _correlate_batch(a[:, batch], b[:, batch] if b is not a else None, n_fft, n_lags)
+
+    if n_workers > 1 and len(batches) > 1:
+        with ThreadPoolExecutor(max_workers=n_workers) as executor:
+            results = list(executor.map(correlate, batches))
+    else:
+        results = [correlate(batch) for batch in batches]
+
+    counts = np.arange(n_times, n_times - n_lags, -1, dtype=np.float64)
+
+    if average or single:
+        return sum(np.sum(result, axis=1) for result in results) / (n_series * counts)
+
+    return np.concatenate(results, axis=1) / counts[:, np.newaxis]
+
+
+def _as_series(series: np.ndarray) -> Tuple[np.ndarray, bool]:
+    """
+    Converts time series into an array of shape (n_times, n_series, dim).
+
+    Parameters
+    ----------
+    series : np.ndarray
+        The time series with shape (n_times,), (n_times, n_series) or (n_times, n_series, dim).
+
+    Returns
+    -------
+    series : np.ndarray
+        The time series with shape (n_times, n_series, dim).
+    single : bool
+        Whether a single scalar time series was given.
+
+    Raises
+    ------
+    StatisticsError
+        If the array has more than three dimensions.
+    """
+    series = np.asarray(series, dtype=np.float64)
+
+    if series.ndim == 1:
+        return series[:, np.newaxis, np.newaxis], True
+
+    if series.ndim == 2:
+        return series[:, :, np.newaxis], False
+
+    if series.ndim == 3:
+        return series, False
+
+    raise StatisticsError(
+        f"Time series have to be given with shape (n_times,), (n_times, n_series) or (n_times, n_series, dim), got {series.shape}.")
+
+
+def _correlate_batch(a: np.ndarray, b: np.ndarray | None, n_fft: int, n_lags: int) -> np.ndarray:
+    """
+    Computes the unnormalized correlation sums of a batch of series.
+
+    Parameters
+    ----------
+    a : np.ndarray
+        The batch with shape (n_times, n_batch, dim).
+    b : np.ndarray | None
+        The second batch, None for the autocorrelation.
+    n_fft : int
+        The zero padded length of the transforms.
+    n_lags : int
+        The number of lags.
+
+    Returns
+    -------
+    np.ndarray
+        The sums over all time origins with shape (n_lags, n_batch).
+    """
+    transformed_a = np.fft.rfft(a, n_fft, axis=0)
+
+    if b is None:
+        spectrum = np.sum(transformed_a.real**2 + transformed_a.imag**2, axis=-1)
+    else:
+        spectrum = np.sum(np.conj(transformed_a) * np.fft.rfft(b, n_fft, axis=0), axis=-1)
+
+    return np.fft.irfft(spectrum, n_fft, axis=0)[:n_lags]
+
+
+class MultiTauCorrelator:
+    """
+    A class computing time correlation functions on the fly on a logarithmic lag grid.
+
+    The multi-tau correlator (Ramirez et al., J. Chem. Phys. 133, 154103 (2010))
+    stores n_levels shift registers of n_points values. Level 0 correlates the
+    values of every step for the lags 0 ... n_points-1. Every `factor` values of a
+    level are averaged and passed to the next level, so that level l covers the lags
+    j * factor^l for j = n_points/factor ... n_points-1. The memory is therefore
+    independent of the length of the trajectory and the lags up to
+    n_points * factor^(n_levels-1) steps are covered with a constant relative resolution.
+    The lags of the first level are exact; the coarser levels correlate block averages,
+    which is accurate for correlations decaying slowly compared to the block length.
+
+    All series (e.g. all atoms) are correlated at once with vectorized operations.
+
+    ...
+
+    Attributes
+    ----------
+    n_levels : int
+        The number of levels.
+    n_points : int
+        The number of lags per level.
+    factor : int
+        The number of values averaged when passed to the next level.
+    n_steps : int
+        The number of added time steps.
+    """
+
+    def __init__(self, n_levels: int = 16, n_points: int = 16, factor: int = 2) -> None:
+        """
+        Initializes the MultiTauCorrelator with empty shift registers.
+
+        Parameters
+        ----------
+        n_levels : int, optional
+            The number of levels, by default 16
+        n_points : int, optional
+            The number of lags per level, by default 16
+        factor : int, optional
+            The number of values averaged when passed to the next level, by default 2
+
+        Raises
+        ------
+        StatisticsError
+            If n_points is not a multiple of factor or any parameter is too small.
+        """
+        if n_levels < 1 or factor < 2 or n_points < factor or n_points % factor != 0:
+            raise StatisticsError(
+                "The multi-tau correlator needs n_levels >= 1, factor >= 2 and n_points being a multiple of factor.")
+
+        self.n_levels = n_levels
+        self.n_points = n_points
+        self.factor = factor
+        self.n_steps = 0
+
+        self._shape = None
+
+    def _allocate(self, shape: Tuple[int, ...]) -> None:
+        """
+        Allocates the shift registers and accumulators for values of the given shape.
+
+        Parameters
+        ----------
+        shape : Tuple[int, ...]
+            The shape (n_series, dim) of the values of one time step.
+        """
+        registers = (self.n_levels, self.n_points) + shape
+
+        self._shape = shape
+        self._shift_a = np.zeros(registers)
+        self._shift_b = np.zeros(registers)
+        self._head = np.full(self.n_levels, -1)
+        self._n_values = np.zeros(self.n_levels, dtype=np.int64)
+
+        self._sum_a = np.zeros((self.n_levels,) + shape)
+        self._sum_b = np.zeros((self.n_levels,) + shape)
+        self._n_summed = np.zeros(self.n_levels, dtype=np.int64)
+
+        self._correlation = np.zeros((self.n_levels, self.n_points, shape[0]))
+        self._counts = np.zeros((self.n_levels, self.n_points), dtype=np.int64)
+
+    def add(self, a: np.ndarray | float, b: np.ndarray | float | None = None) -> None:
+        """
+        Adds the values of the next time step.
+
+        Parameters
+        ----------
+        a : np.ndarray | float
+            The values of all series with shape (), (n_series,) or (n_series, dim).
+        b : np.ndarray | float | None, optional
+            The values of the second observable for cross-correlations, by default None
+
+        Raises
+        ------
+        StatisticsError
+            If the shape of the values changes between time steps.
+        """
+        a = np.asarray(a, dtype=np.float64)
+        a = a.reshape((1, 1) if a.ndim == 0 else (a.shape[0], -1))
+        b = a if b is None else np.asarray(b, dtype=np.float64).reshape(a.shape)
+
+        if self._shape is None:
+            self._allocate(a.shape)
+        elif a.shape != self._shape:
+            raise StatisticsError(
+                f"The values have the shape {a.shape}, but the correlator was started with {self._shape}.")
+
+        self.n_steps += 1
+
+        level = 0
+        while level < self.n_levels:
+            self._insert(level, a, b)
+
+            self._sum_a[level] += a
+            self._sum_b[level] += b
+            self._n_summed[level] += 1
+
+            if self._n_summed[level] < self.factor:
+                break
+
+            a = self._sum_a[level] / self.factor
+            b = self._sum_b[level] / self.factor
+
+            self._sum_a[level] = 0.0
+            self._sum_b[level] = 0.0
+            self._n_summed[level] = 0
+
+            level += 1
+
+    def _insert(self, level: int, a: np.ndarray, b: np.ndarray) -> None:
+        """
+        Inserts the values into the shift register of a level and correlates them.
+
+        Parameters
+        ----------
+        level : int
+            The level.
+        a : np.ndarray
+            The (averaged) values of the first observable.
+        b : np.ndarray
+            The (averaged) values of the second observable.
+        """
+        head = (self._head[level] + 1) % self.n_points
+        self._head[level] = head
+        self._shift_a[level, head] = a
+        self._shift_b[level, head] = b
+        self._n_values[level] += 1
+
+        first = 0 if level == 0 else self.n_points // self.factor
+        lags = np.arange(first, min(self._n_values[level], self.n_points))
+
+        if len(lags) == 0:
+            return
+
+        # <a(s) . b(s+t)> with the newest b and the a stored t values ago
+        older = self._shift_a[level, (head - lags) % self.n_points]
+        self._correlation[level, lags] += np.sum(older * b, axis=-1)
+        self._counts[level, lags] += 1
+
+    @property
+    def lags(self) -> Np1DNumberArray:
+        """
+        Np1DNumberArray: The lags in time steps of all correlated points, in ascending order.
+        """
+        return self._grid()[0]
+
+    def correlation(self, average: bool = True) -> Np1DNumberArray | Np2DNumberArray:
+        """
+        Returns the correlation function at the lags with at least one contribution.
+
+        Parameters
+        ----------
+        average : bool, optional
+            Whether the correlation is averaged over the series, by default True
+
+        Returns
+        -------
+        Np1DNumberArray | Np2DNumberArray
+            The correlation function with shape (n_lags,) if averaged, otherwise (n_lags, n_series).
+
+        Raises
+        ------
+        StatisticsError
+            If no time step was added.
+        """
+        if self._shape is None:
+            raise StatisticsError("No values were added to the correlator.")
+
+        _, levels, points = self._grid()
+
+        correlation = self._correlation[levels, points] / \
+            self._counts[levels, points][:, np.newaxis]
+
+        return np.mean(correlation, axis=1) if average else correlation
+
+    def _grid(self) -> Tuple[np.ndarray, List[int], List[int]]:
+        """
+        Returns the lags, levels and points of the shift registers with contributions.
+
+        Returns
+        -------
+        lags : np.ndarray
+            The lags in time steps.
+        levels : List[int]
+            The level of each lag.
+        points : List[int]
+            The point of each lag in its level.
+        """
+        lags, levels, points = [], [], []
+
+        if self._shape is None:
+            return np.array(lags, dtype=np.int64), levels, points
+
+        for level in range(self.n_levels):
+            first = 0 if level == 0 else self.n_points // self.factor
+
+            for point in range(first, self.n_points):
+                if self._counts[level, point] > 0:
+                    lags.append(point * self.factor**level)
+                    levels.append(level)
+                    points.append(point)
+
+        return np.array(lags, dtype=np.int64), levels, points
@@ -0,0 +1,22 @@
+"""
+A module containing different exceptions related to the statistics subpackage.
+
+...
+
+Classes
+-------
+StatisticsError
+    Exception raised for errors related to the statistics subpackage
+"""
+
+from ..exceptions import PQException
+
+
+class StatisticsError(PQException):
+    """
+    Exception raised for errors related to the statistics subpackage
+    """
+
+    def __init__(self, message):
+        self.message = message
+        super().__init__(self.message)
@@ -0,0 +1,317 @@
+"""
+A module containing a mergeable fixed-bin histogram.
+
+...
+
+Classes
+-------
+Histogram
+    A class for weighted 1D, 2D and 3D histograms with fixed bins.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from beartype.typing import Dict, List, Sequence, Tuple
+from numbers import Real
+
+from . import StatisticsError
+
+
+class Histogram:
+    """
+    A class for weighted 1D, 2D and 3D histograms with fixed bins.
+
+    The bins are fixed at construction, so that histograms of different workers,
+    blocks or runs can be merged by adding their counts (merge is associative and
+    commutative). Values are binned vectorized: the bin of each value is computed
+    from its offset to the lower limit and all weights are added with a single
+    bincount. The counts are stored as float64, which represents integer counts
+    exactly up to 2^53. As in np.histogram the bins are half-open except for the last
+    one, which includes the upper limit. Values outside of the ranges (or NaN) are only
+    counted in `outside`.
+
+    ...
+
+    Attributes
+    ----------
+    ranges : np.ndarray
+        The lower and upper limit of each dimension with shape (dim, 2).
+    n_bins : np.ndarray
+        The number of bins of each dimension.
+    counts : np.ndarray
+        The summed weights of each bin with shape n_bins.
+    outside : float
+        The summed weights of the values outside of the ranges.
+    """
+
+    _version = 1
+
+    def __init__(self,
+                 ranges: Tuple[Real, Real] | Sequence[Tuple[Real, Real]] | np.ndarray,
+                 n_bins: int | Sequence[int] | np.ndarray
+                 ) -> None:
+        """
+        Initializes an empty Histogram.
+
+        Parameters
+        ----------
+        ranges : Tuple[Real, Real] | Sequence[Tuple[Real, Real]] | np.ndarray
+            The lower and upper limit of a 1D histogram or of each dimension.
+        n_bins : int | Sequence[int] | np.ndarray
+            The number of bins of all dimensions or of each dimension.
+
+        Raises
+        ------
+        StatisticsError
+            If the histogram has more than three dimensions, the number of bins does not
+            match the dimensions, an upper limit is not larger than the lower limit or a
+            number of bins is not positive.
+        """
+        ranges = np.array(ranges, dtype=np.float64).reshape(-1, 2)
+        dim = len(ranges)
+
+        n_bins = np.array(n_bins, dtype=np.int64)
+
+        if not 1 <= dim <= 3 or n_bins.ndim > 1 or n_bins.size not in (1, dim):
+            raise StatisticsError(
+                "Only 1D, 2D and 3D histograms with one number of bins per dimension are supported.")
+
+        n_bins = np.broadcast_to(n_bins.reshape(-1), (dim,)).copy()
+
+        if np.any(ranges[:, 1] <= ranges[:, 0]) or np.any(n_bins < 1):
+            raise StatisticsError(
+                "Each dimension of a histogram needs a positive number of bins and an upper limit larger than the lower limit.")
+
+        self.ranges = ranges
+        self.n_bins = n_bins
+        self.counts = np.zeros(tuple(n_bins), dtype=np.float64)
+        self.outside = 0.0
+
+    @property
+    def dim(self) -> int:
+        """
+        int: The number of dimensions.
+        """
+        return len(self.n_bins)
+
+    @property
+    def widths(self) -> np.ndarray:
+        """
+        np.ndarray: The bin width of each dimension.
+        """
+        return (self.ranges[:, 1] - self.ranges[:, 0]) / self.n_bins
+
+    @property
+    def edges(self) -> List[np.ndarray]:
+        """
+        List[np.ndarray]: The bin edges of each dimension.
+        """
+        return [np.linspace(low, high, n + 1) for (low, high), n in zip(self.ranges, self.n_bins)]
+
+    @property
+    def centers(self) -> List[np.ndarray]:
+        """
+        List[np.ndarray]: The bin centers of each dimension.
+        """
+        return [0.5 * (edges[1:] + edges[:-1]) for edges in self.edges]
+
+    @property
+    def total(self) -> float:
+        """
+        float: The summed weights of all added values including the values outside of the ranges.
+        """
+        return float(np.sum(self.counts)) + self.outside
+
+    def add(self, values: np.ndarray | Real, weights: np.ndarray | Real | None = None) -> None:
+        """
+        Adds values to the histogram.
+
+        Parameters
+        ----------
+        values : np.ndarray | Real
+            The values with shape (n,) for 1D histograms or (n, dim).
+        weights : np.ndarray | Real | None, optional
+            The weight of each value or one weight for all values, by default None (1.0)
+
+        Raises
+        ------
+        StatisticsError
+            If the values do not match the dimension of the histogram.
+        """
+        values = np.asarray(values, dtype=np.float64)
+
+        if self.dim == 1 and values.ndim <= 1:
+            values = values.reshape(-1, 1)
+
+        if values.ndim != 2 or values.shape[1] != self.dim:
+            raise StatisticsError(
+                f"The values of a {self.dim}D histogram need the shape (n, {self.dim}), got {values.shape}.")
+
+        if weights is None:
+            weights = np.ones(len(values))
+        else:
+            weights = np.broadcast_to(np.asarray(weights, dtype=np.float64), (len(values),))
+
+        # the upper limit belongs to the last bin, as in np.histogram
+        inside = np.all((values >= self.ranges[:, 0]) & (values <= self.ranges[:, 1]), axis=1)
+
+        indices = np.floor((values[inside] - self.ranges[:, 0]) / self.widths).astype(np.int64)
+        indices = np.minimum(indices, self.n_bins - 1)
+
+        flat = np.ravel_multi_index(tuple(indices.T), tuple(self.n_bins))
+
+        self.counts += np.bincount(flat, weights=weights[inside],
+                                   minlength=self.counts.size).reshape(self.counts.shape)
+        self.outside += float(np.sum(weights[~inside]))
+
+    def add_counts(self, counts: np.ndarray, outside: Real = 0.0) -> None:
+        """
+        Adds already binned counts, e.g. the result of kernels.distance_histogram.
+
+        Parameters
+        ----------
+        counts : np.ndarray
+            The counts with the shape of the histogram.
+        outside : Real, optional
+            The weights outside of the ranges, by default 0.0
+
+        Raises
+        ------
+        StatisticsError
+            If the shape of the counts does not match the histogram.
+        """
+        if np.shape(counts) != self.counts.shape:
+            raise StatisticsError(
+                f"The counts have the shape {np.shape(counts)}, but the histogram has the shape {self.counts.shape}.")
+
+        self.counts += counts
+        self.outside += float(outside)
+
+    def merge(self, other: Histogram) -> Histogram:
+        """
+        Merges another histogram with the same bins into this histogram.
+
+        Parameters
+        ----------
+        other : Histogram
+            The histogram to merge.
+
+        Returns
+        -------
+        Histogram
+            This histogram.
+
+        Raises
+        ------
+        StatisticsError
+            If the bins of the histograms differ.
+        """
+        if not np.array_equal(self.n_bins, other.n_bins) or not np.array_equal(self.ranges, other.ranges):
+            raise StatisticsError("Only histograms with identical bins can be merged.")
+
+        self.counts += other.counts
+        self.outside += other.outside
+
+        return self
+
+    def density(self) -> np.ndarray:
+        """
+        Returns the probability density of the binned values.
+
+        The counts are divided by the total weight of the binned values and by the bin
+        volume, so that the density integrates to 1 over the ranges.
+
+        Returns
+        -------
+        np.ndarray
+            The probability density of each bin.
+
+        Raises
+        ------
+        StatisticsError
+            If no value was binned.
+        """
+        binned = np.sum(self.counts)
+
+        if binned <= 0.0:
+            raise StatisticsError("The histogram is empty.")
+
+        return self.counts / (binned * np.prod(self.widths))
+
+    def to_dict(self) -> Dict[str, np.ndarray]:
+        """
+        Returns the state of the histogram as a dictionary of arrays.
+
+        Returns
+        -------
+        Dict[str, np.ndarray]
+            The state of the histogram, see from_dict.
+        """
+        return {
+            "version": np.array(self._version),
+            "ranges": self.ranges,
+            "n_bins": self.n_bins,
+            "counts": self.counts,
+            "outside": np.array(self.outside),
+        }
+
+    @classmethod
+    def from_dict(cls, state: Dict[str, np.ndarray]) -> Histogram:
+        """
+        Restores a histogram from its state.
+
+        Parameters
+        ----------
+        state : Dict[str, np.ndarray]
+            The state returned by to_dict.
+
+        Returns
+        -------
+        Histogram
+            The restored histogram.
+
+        Raises
+        ------
+        StatisticsError
+            If the state was written by an incompatible version.
+        """
+        if int(state["version"]) != cls._version:
+            raise StatisticsError(
+                f"The histogram was stored with version {int(state['version'])}, but version {cls._version} is expected.")
+
+        histogram = cls(state["ranges"], state["n_bins"])
+        histogram.add_counts(np.asarray(state["counts"], dtype=np.float64), float(state["outside"]))
+
+        return histogram
+
+    def save(self, filename: str) -> None:
+        """
+        Stores the histogram in a NumPy .npz file, e.g. as a checkpoint.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file.
+        """
+        with open(filename, 'wb') as file:
+            np.savez(file, **self.to_dict())
+
+    @classmethod
+    def load(cls, filename: str) -> Histogram:
+        """
+        Loads a histogram stored with save.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file.
+
+        Returns
+        -------
+        Histogram
+            The loaded histogram.
+        """
+        with np.load(filename) as data:
+            return cls.from_dict(dict(data))
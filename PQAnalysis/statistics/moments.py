@@ -0,0 +1,290 @@
+"""
+A module containing a mergeable accumulator of the mean and variance.
+
+...
+
+Classes
+-------
+MomentAccumulator
+    A class accumulating the weighted mean and variance of (array valued) samples.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from beartype.typing import Dict, Tuple
+from numbers import Real
+
+from . import StatisticsError
+
+
+class MomentAccumulator:
+    """
+    A class accumulating the weighted mean and variance of (array valued) samples.
+
+    The accumulator stores the summed weights, the mean and the summed squared
+    deviations from the mean (M2) instead of the sums of the values and their
+    squares, which avoids the cancellation of the naive variance formula. A batch of
+    samples is reduced with NumPy and combined with the stored moments by the
+    pairwise update of Chan et al. (generalizing Welford's algorithm), which is also
+    used to merge two accumulators. Thus, merge is associative and the results do not
+    depend on how the samples were split across workers.
+
+    Each element of an array valued sample (e.g. the energy columns of a frame or a
+    per-atom property) is accumulated independently. The shape of the samples is
+    fixed by the first added batch if it is not given.
+
+    ...
+
+    Attributes
+    ----------
+    shape : Tuple[int, ...] | None
+        The shape of a single sample, None before the first sample.
+    weight : np.ndarray | float
+        The summed weights of the samples.
+    mean : np.ndarray | float
+        The weighted mean of the samples.
+    m2 : np.ndarray | float
+        The weighted sum of the squared deviations from the mean.
+    """
+
+    _version = 1
+
+    def __init__(self, shape: Tuple[int, ...] | None = None) -> None:
+        """
+        Initializes an empty MomentAccumulator.
+
+        Parameters
+        ----------
+        shape : Tuple[int, ...] | None, optional
+            The shape of a single sample, by default None (the shape of the first samples)
+        """
+        self.shape = None
+        self.weight = 0.0
+        self.mean = 0.0
+        self.m2 = 0.0
+
+        if shape is not None:
+            self._allocate(tuple(shape))
+
+    def _allocate(self, shape: Tuple[int, ...]) -> None:
+        self.shape = shape
+        self.weight = np.zeros(shape)
+        self.mean = np.zeros(shape)
+        self.m2 = np.zeros(shape)
+
+    def add(self, values: np.ndarray | Real, weights: np.ndarray | Real | None = None) -> None:
+        """
+        Adds a batch of samples.
+
+        Parameters
+        ----------
+        values : np.ndarray | Real
+            The samples stacked along the first axis, i.e. with shape (n, *shape), or
+            a single scalar sample.
+        weights : np.ndarray | Real | None, optional
+            The weight of each sample, by default None (1.0). The weights of shape (n,)
+            are broadcast over the elements of the samples, weights of shape (n, *shape)
+            weight each element.
+
+        Raises
+        ------
+        StatisticsError
+            If the shape of the samples does not match the accumulator.
+        """
+        values = np.asarray(values, dtype=np.float64)
+        if values.ndim == 0:
+            values = values.reshape(1)
+
+        if self.shape is None:
+            self._allocate(values.shape[1:])
+        elif values.shape[1:] != self.shape:
+            raise StatisticsError(
+                f"The samples have the shape {values.shape[1:]}, but the accumulator has the shape {self.shape}.")
+
+        if len(values) == 0:
+            return
+
+        if weights is None:
+            weights = np.ones(values.shape)
+        else:
+            weights = np.asarray(weights, dtype=np.float64)
+            weights = weights.reshape(weights.shape + (1,) * (values.ndim - weights.ndim))
+            weights = np.broadcast_to(weights, values.shape)
+
+        weight = np.sum(weights, axis=0)
+        mean = np.divide(np.sum(weights * values, axis=0), weight,
+                         out=np.zeros(self.shape), where=weight > 0.0)
+        m2 = np.sum(weights * (values - mean)**2, axis=0)
+
+        self._combine(weight, mean, m2)
+
+    def _combine(self, weight: np.ndarray | Real, mean: np.ndarray | Real, m2: np.ndarray | Real) -> None:
+        """
+        Combines the stored moments with the moments of another set of samples.
+
+        Parameters
+        ----------
+        weight : np.ndarray | Real
+            The summed weights of the other samples.
+        mean : np.ndarray | Real
+            The mean of the other samples.
+        m2 : np.ndarray | Real
+            The summed squared deviations of the other samples.
+        """
+        total = self.weight + weight
+        delta = mean - self.mean
+
+        fraction = np.divide(weight, total, out=np.zeros(self.shape), where=total > 0.0)
+
+        self.mean = self.mean + delta * fraction
+        self.m2 = self.m2 + m2 + delta**2 * self.weight * fraction
+        self.weight = total
+
+    def merge(self, other: MomentAccumulator) -> MomentAccumulator:
+        """
+        Merges the samples of another accumulator into this accumulator.
+
+        Parameters
+        ----------
+        other : MomentAccumulator
+            The accumulator to merge.
+
+        Returns
+        -------
+        MomentAccumulator
+            This accumulator.
+
+        Raises
+        ------
+        StatisticsError
+            If the shapes of the accumulators differ.
+        """
+        if other.shape is None:
+            return self
+
+        if self.shape is None:
+            self._allocate(other.shape)
+        elif self.shape != other.shape:
+            raise StatisticsError(
+                f"An accumulator of shape {other.shape} cannot be merged into an accumulator of shape {self.shape}.")
+
+        self._combine(other.weight, other.mean, other.m2)
+
+        return self
+
+    def variance(self, ddof: int = 0) -> np.ndarray | float:
+        """
+        Returns the weighted variance of the samples.
+
+        Parameters
+        ----------
+        ddof : int, optional
+            The delta degrees of freedom, by default 0. With ddof=1 the weights are
+            treated as frequencies, i.e. M2 is divided by (weight - 1).
+
+        Returns
+        -------
+        np.ndarray | float
+            The variance of each element, NaN if the weight is not larger than ddof.
+        """
+        with np.errstate(divide="ignore", invalid="ignore"):
+            return np.where(self.weight > ddof, self.m2 / (self.weight - ddof), np.nan)
+
+    def std(self, ddof: int = 0) -> np.ndarray | float:
+        """
+        Returns the weighted standard deviation of the samples.
+
+        Parameters
+        ----------
+        ddof : int, optional
+            The delta degrees of freedom, by default 0
+
+        Returns
+        -------
+        np.ndarray | float
+            The standard deviation of each element.
+        """
+        return np.sqrt(self.variance(ddof))
+
+    def to_dict(self) -> Dict[str, np.ndarray]:
+        """
+        Returns the state of the accumulator as a dictionary of arrays.
+
+        Returns
+        -------
+        Dict[str, np.ndarray]
+            The state of the accumulator, see from_dict.
+        """
+        return {
+            "version": np.array(self._version),
+            "weight": np.asarray(self.weight),
+            "mean": np.asarray(self.mean),
+            "m2": np.asarray(self.m2),
+            "empty": np.array(self.shape is None),
+        }
+
+    @classmethod
+    def from_dict(cls, state: Dict[str, np.ndarray]) -> MomentAccumulator:
+        """
+        Restores an accumulator from its state.
+
+        Parameters
+        ----------
+        state : Dict[str, np.ndarray]
+            The state returned by to_dict.
+
+        Returns
+        -------
+        MomentAccumulator
+            The restored accumulator.
+
+        Raises
+        ------
+        StatisticsError
+            If the state was written by an incompatible version.
+        """
+        if int(state["version"]) != cls._version:
+            raise StatisticsError(
+                f"The accumulator was stored with version {int(state['version'])}, but version {cls._version} is expected.")
+
+        accumulator = cls()
+
+        if not bool(state["empty"]):
+            accumulator._allocate(np.shape(state["mean"]))
+            accumulator._combine(np.array(state["weight"], dtype=np.float64),
+                                 np.array(state["mean"], dtype=np.float64),
+                                 np.array(state["m2"], dtype=np.float64))
+
+        return accumulator
+
+    def save(self, filename: str) -> None:
+        """
+        Stores the accumulator in a NumPy .npz file, e.g. as a checkpoint.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file.
+        """
+        with open(filename, 'wb') as file:
+            np.savez(file, **self.to_dict())
+
+    @classmethod
+    def load(cls, filename: str) -> MomentAccumulator:
+        """
+        Loads an accumulator stored with save.
+
+        Parameters
+        ----------
+        filename : str
+            The name of the file.
+
+        Returns
+        -------
+        MomentAccumulator
+            The loaded accumulator.
+        """
+        with np.load(filename) as data:
+            return cls.from_dict(dict(data))
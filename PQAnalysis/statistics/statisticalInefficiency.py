@@ -0,0 +1,203 @@
+"""
+A module containing functions to subsample correlated time series.
+
+...
+
+Functions
+---------
+autocorrelation
+    Computes the normalized autocorrelation function of a time series.
+statistical_inefficiency
+    Estimates the statistical inefficiency of one or more time series.
+decorrelated_indices
+    Returns the indices of a decorrelated subset of a time series.
+read_decorrelated_frames
+    Reads only a decorrelated subset of the frames of a trajectory.
+"""
+
+import numpy as np
+
+from beartype.typing import Callable, Tuple
+from numbers import Real
+
+from . import StatisticsError, correlation
+from ..io import TrajectoryReader
+from ..traj import Trajectory, MDEngineFormat, Frame
+from ..types import Np1DNumberArray, Np2DNumberArray, Np1DIntArray
+
+
+def autocorrelation(series: Np1DNumberArray) -> Np1DNumberArray:
+    """
+    Computes the normalized autocorrelation function of a time series.
+
+    The autocovariance is computed with the FFT based correlation in O(n log n) and
+    normalized by the variance, so that the result starts with 1.0.
+
+    Parameters
+    ----------
+    series : Np1DNumberArray
+        The time series.
+
+    Returns
+    -------
+    Np1DNumberArray
+        The autocorrelation function for the lags 0 to n-1. If the series is
+        constant, it is treated as uncorrelated (1.0 followed by zeros).
+    """
+    n = len(series)
+    covariance = correlation(np.asarray(series, dtype=np.float64) - np.mean(series))
+
+    if covariance[0] <= 0.0:
+        return np.eye(1, n)[0]
+
+    return covariance / covariance[0]
+
+
+def statistical_inefficiency(observable: Np1DNumberArray | Np2DNumberArray, mintime: int = 3) -> float:
+    """
+    Estimates the statistical inefficiency of one or more time series.
+
+    The statistical inefficiency g = 1 + 2 sum_t (1 - t/n) C(t) is the number of
+    correlated samples corresponding to one independent sample. The sum over the
+    normalized autocorrelation C(t) is truncated at the first lag t > mintime with
+    C(t) <= 0 (see Chodera et al., J. Chem. Theory Comput. 3, 26 (2007)). For
+    several time series (columns of a 2D array) the largest inefficiency is returned.
+
+    Parameters
+    ----------
+    observable : Np1DNumberArray | Np2DNumberArray
+        The time series of shape (n,) or several time series of shape (n, k), e.g. the
+        energy columns of an EnergyAlignment (alignment.data.T).
+    mintime : int, optional
+        The minimum lag up to which the sum is not truncated, by default 3
+
+    Returns
+    -------
+    float
+        The statistical inefficiency, at least 1.0.
+
+    Raises
+    ------
+    StatisticsError
+        If the time series has less than two samples.
+    """
+    observable = np.asarray(observable, dtype=np.float64)
+
+    if observable.ndim == 1:
+        observable = observable[:, np.newaxis]
+
+    n = len(observable)
+    if n < 2:
+        raise StatisticsError(
+            "The statistical inefficiency needs at least two samples.")
+
+    lags = np.arange(1, n)
+
+    inefficiency = 1.0
+    for series in observable.T:
+        correlation = autocorrelation(series)[1:]
+
+        # truncate at the first non-positive value after mintime
+        negative = np.flatnonzero((correlation <= 0.0) & (lags > mintime))
+        cutoff = negative[0] if len(negative) > 0 else n - 1
+
+        g = 1.0 + 2.0 * np.sum(correlation[:cutoff] * (1.0 - lags[:cutoff] / n))
+        inefficiency = max(inefficiency, g)
+
+    return float(inefficiency)
+
+
+def decorrelated_indices(observable: Np1DNumberArray | Np2DNumberArray,
+                         inefficiency: Real | None = None,
+                         conservative: bool = False
+                         ) -> Np1DIntArray:
+    """
+    Returns the indices of a decorrelated subset of a time series.
+
+    Parameters
+    ----------
+    observable : Np1DNumberArray | Np2DNumberArray
+        The time series of shape (n,) or (n, k), see statistical_inefficiency.
+    inefficiency : Real | None, optional
+        The statistical inefficiency, by default None (estimated from the observable)
+    conservative : bool, optional
+        If True, every ceil(g)-th index is selected. Otherwise the indices are rounded
+        multiples of g, which selects about n/g samples, by default False
+
+    Returns
+    -------
+    Np1DIntArray
+        The sorted indices of the decorrelated samples.
+    """
+    n = len(observable)
+
+    if inefficiency is None:
+        inefficiency = statistical_inefficiency(observable)
+
+    inefficiency = max(float(inefficiency), 1.0)
+
+    if conservative:
+        return np.arange(0, n, int(np.ceil(inefficiency)))
+
+    indices = np.round(np.arange(0.0, n / inefficiency) * inefficiency).astype(np.int64)
+
+    return np.unique(indices[indices < n])
+
+
+def read_decorrelated_frames(reader: TrajectoryReader,
+                             observable: Np1DNumberArray | Np2DNumberArray | Callable[[Frame], Real | Np1DNumberArray],
+                             md_format: MDEngineFormat | str = MDEngineFormat.PIMD_QMCF,
+                             conservative: bool = False
+                             ) -> Tuple[Trajectory, Np1DIntArray]:
+    """
+    Reads only a decorrelated subset of the frames of a trajectory.
+
+    The statistical inefficiency is estimated from the given per-frame observable.
+    The decorrelated frames are then read with TrajectoryReader.read_frames, so that
+    only these frames are parsed. If the observable is a function of a frame, it is
+    evaluated on the frames streamed with reusable buffers (TrajectoryReader.iter_frames).
+
+    Examples
+    --------
+    >>> energy = EnergyFileReader("md-01.en").read()
+    >>> reader = TrajectoryReader("md-01.xyz")
+    >>> alignment = EnergyAlignment(energy, len(reader.indices()[0]))
+    >>> traj, frames = read_decorrelated_frames(reader, alignment.column("E(TOT)"))
+
+    Parameters
+    ----------
+    reader : TrajectoryReader
+        The reader of the trajectory.
+    observable : Np1DNumberArray | Np2DNumberArray | Callable[[Frame], Real | Np1DNumberArray]
+        The observable of each frame (one row per frame) or a function computing it from a frame.
+    md_format : MDEngineFormat | str, optional
+        The format of the md engine, by default MDEngineFormat.PIMD_QMCF
+    conservative : bool, optional
+        Whether every ceil(g)-th frame is selected, by default False (see decorrelated_indices)
+
+    Returns
+    -------
+    traj : Trajectory
+        The decorrelated frames.
+    frames : Np1DIntArray
+        The indices of the decorrelated frames.
+
+    Raises
+    ------
+    StatisticsError
+        If the number of observable values does not match the number of frames.
+    """
+    n_frames = sum(index.n_frames for index in reader.indices())
+
+    if callable(observable):
+        # the values are copied, as the observable may return views on the reused buffer
+        observable = np.array([np.array(observable(frame), dtype=np.float64)
+                              for frame in reader.iter_frames(md_format, n_buffers=1)])
+
+    if len(observable) != n_frames:
+        raise StatisticsError(
+            f"The observable has {len(observable)} values, but the trajectory has {n_frames} frames.")
+
+    frames = decorrelated_indices(observable, conservative=conservative)
+
+    return reader.read_frames(frames, md_format=md_format), frames
@@ -1,4 +1,5 @@
-from .exceptions import MolTypeError
+from .exceptions import MolTypeError, TopologyError
 
 from .topology import Topology
 from .molType import MolType
+from .moleculeTopology import MoleculeTopology
@@ -7,6 +7,8 @@ Classes
 -------
 MolTypeError
     Exception raised for errors related to the MolType class
+TopologyError
+    Exception raised for errors related to the MoleculeTopology class
 """
 
 from ..exceptions import PQException
@@ -20,3 +22,13 @@ class MolTypeError(PQException):
     def __init__(self, message):
         self.message = message
         super().__init__(self.message)
+
+
+class TopologyError(PQException):
+    """
+    Exception raised for errors related to the MoleculeTopology class
+    """
+
+    def __init__(self, message):
+        self.message = message
+        super().__init__(self.message)
@@ -0,0 +1,359 @@
+"""
+A module containing the MoleculeTopology class.
+
+...
+
+Classes
+-------
+MoleculeTopology
+    A class storing the atoms of all molecules of a system in compressed sparse row form.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from beartype.typing import List
+from numbers import Real
+
+from . import MolType, TopologyError
+from ..core import Atom, resolve_elements
+from ..core.atom import element_covalent_radii
+from ..kernels import connected_components, cutoff_pairs
+from ..types import Np1DIntArray, Np1DNumberArray, Np2DNumberArray, Np3x3NumberArray
+
+
+class MoleculeTopology:
+    """
+    A class storing the atoms of all molecules of a system in compressed sparse row form.
+
+    The atom indices of molecule m are indices[offsets[m]:offsets[m+1]], so that
+    per-molecule quantities are computed for all molecules at once with np.add.reduceat
+    or fancy indexing. Molecules of different sizes are supported.
+
+    A topology is obtained from the mol type ids of a restart file and the MolType
+    definitions of a moldescriptor file (from_mol_types), from covalent bonds detected in
+    a frame (from_bonds) or from consecutive groups of a fixed size as used by
+    Frame.compute_com_frame (from_groups).
+
+    ...
+
+    Attributes
+    ----------
+    offsets : Np1DIntArray
+        The start of each molecule in indices with n_molecules + 1 entries.
+    indices : Np1DIntArray
+        The atom indices of all molecules.
+    mol_type_ids : Np1DIntArray
+        The mol type id of each molecule, 0 if the molecule has no mol type.
+    """
+
+    def __init__(self,
+                 offsets: Np1DIntArray,
+                 indices: Np1DIntArray | None = None,
+                 mol_type_ids: Np1DIntArray | None = None
+                 ) -> None:
+        """
+        Initializes the MoleculeTopology from its compressed sparse row arrays.
+
+        Parameters
+        ----------
+        offsets : Np1DIntArray
+            The start of each molecule in indices with n_molecules + 1 entries.
+        indices : Np1DIntArray | None, optional
+            The atom indices of all molecules, by default None (0 ... offsets[-1]-1)
+        mol_type_ids : Np1DIntArray | None, optional
+            The mol type id of each molecule, by default None (0 for all molecules)
+
+        Raises
+        ------
+        TopologyError
+            If the offsets are not increasing from 0 to the number of indices or
+            the number of mol type ids does not match the number of molecules.
+        """
+        offsets = np.asarray(offsets, dtype=np.int64)
+
+        if indices is None:
+            indices = np.arange(offsets[-1] if len(offsets) > 0 else 0)
+
+        indices = np.asarray(indices, dtype=np.int64)
+
+        if len(offsets) == 0 or offsets[0] != 0 or offsets[-1] != len(indices) or \
+                np.any(np.diff(offsets) <= 0):
+            raise TopologyError(
+                "The offsets of a molecule topology have to increase from 0 to the number of atoms.")
+
+        if mol_type_ids is None:
+            mol_type_ids = np.zeros(len(offsets) - 1, dtype=np.int64)
+
+        mol_type_ids = np.asarray(mol_type_ids, dtype=np.int64)
+
+        if len(mol_type_ids) != len(offsets) - 1:
+            raise TopologyError(
+                "The number of mol type ids has to match the number of molecules.")
+
+        self.offsets = offsets
+        self.indices = indices
+        self.mol_type_ids = mol_type_ids
+
+    @classmethod
+    def from_groups(cls, n_atoms: int, group: int) -> MoleculeTopology:
+        """
+        Returns the topology of consecutive groups of atoms of a fixed size.
+
+        Parameters
+        ----------
+        n_atoms : int
+            The number of atoms.
+        group : int
+            The number of atoms per group.
+
+        Returns
+        -------
+        MoleculeTopology
+            The topology with n_atoms / group molecules.
+
+        Raises
+        ------
+        TopologyError
+            If the number of atoms is not a multiple of group.
+        """
+        if group <= 0 or n_atoms % group != 0:
+            raise TopologyError(
+                "The number of atoms has to be a multiple of the group size.")
+
+        return cls(np.arange(0, n_atoms + 1, group))
+
+    @classmethod
+    def from_mol_types(cls, atom_mol_types: Np1DIntArray, mol_types: List[MolType]) -> MoleculeTopology:
+        """
+        Returns the topology of the mol type ids of all atoms.
+
+        As in the QMCF restart file, consecutive atoms of the same mol type form
+        molecules of MolType.n_atoms atoms. Atoms with the mol type id 0 (e.g. the
+        QM atoms) form molecules of a single atom.
+
+        Parameters
+        ----------
+        atom_mol_types : Np1DIntArray
+            The mol type id of each atom, e.g. Frame.topology.mol_types of a restart file.
+        mol_types : List[MolType]
+            The mol types, e.g. read by the MoldescriptorReader.
+
+        Returns
+        -------
+        MoleculeTopology
+            The topology of the molecules.
+
+        Raises
+        ------
+        TopologyError
+            If a mol type id is not defined or a block of atoms of a mol type is
+            not a multiple of its number of atoms.
+        """
+        atom_mol_types = np.asarray(atom_mol_types, dtype=np.int64)
+        sizes_by_id = {mol_type.id: mol_type.n_atoms for mol_type in mol_types}
+
+        # blocks of consecutive atoms with the same mol type id
+        starts = np.flatnonzero(np.diff(atom_mol_types, prepend=-1) != 0)
+        stops = np.append(starts[1:], len(atom_mol_types))
+
+        offsets = [np.zeros(1, dtype=np.int64)]
+        mol_type_ids = []
+
+        for start, stop in zip(starts, stops):
+            mol_type_id = int(atom_mol_types[start])
+
+            if mol_type_id == 0:
+                size = 1
+            elif mol_type_id in sizes_by_id:
+                size = sizes_by_id[mol_type_id]
+            else:
+                raise TopologyError(f"The mol type {mol_type_id} is not defined.")
+
+            if size <= 0 or (stop - start) % size != 0:
+                raise TopologyError(
+                    f"The {stop - start} consecutive atoms of mol type {mol_type_id} are not a multiple of its {size} atoms.")
+
+            offsets.append(np.arange(start + size, stop + 1, size))
+            mol_type_ids.append(np.full((stop - start) // size, mol_type_id))
+
+        return cls(np.concatenate(offsets),
+                   mol_type_ids=np.concatenate(mol_type_ids) if len(mol_type_ids) > 0 else None)
+
+    @classmethod
+    def from_bonds(cls,
+                   pos: Np2DNumberArray,
+                   atoms: List[Atom],
+                   box_matrix: Np3x3NumberArray | None = None,
+                   tolerance: Real = 0.4
+                   ) -> MoleculeTopology:
+        """
+        Returns the topology of the covalently bonded molecules of a frame.
+
+        Two atoms are bonded if their minimum image distance is smaller than the sum of
+        their covalent radii plus tolerance. The molecules are the connected components
+        of the bond graph, ordered by their first atom. Atoms without a tabulated
+        covalent radius (e.g. pseudo atoms) form molecules of a single atom.
+
+        Parameters
+        ----------
+        pos : Np2DNumberArray
+            The positions of shape (n_atoms, 3).
+        atoms : List[Atom]
+            The atoms, whose elements determine the covalent radii.
+        box_matrix : Np3x3NumberArray | None, optional
+            The box matrix of the cell, by default None (no periodic boundary conditions)
+        tolerance : Real, optional
+            The tolerance added to the sum of the covalent radii in Angstrom, by default 0.4
+
+        Returns
+        -------
+        MoleculeTopology
+            The topology of the molecules.
+        """
+        names = [atom.symbol if atom.symbol is not None else atom.name for atom in atoms]
+        codes = resolve_elements(names, strict=False)
+
+        radii = np.where(codes >= 0, element_covalent_radii[np.maximum(codes, 0)], np.nan)
+
+        pairs = np.zeros((0, 2), dtype=np.int64)
+
+        if np.any(np.isfinite(radii)):
+            pairs, distances = cutoff_pairs(pos, None, 2.0 * np.nanmax(radii) + tolerance, box_matrix)
+
+            bonded = distances < radii[pairs[:, 0]] + radii[pairs[:, 1]] + tolerance
+            pairs = pairs[bonded]
+
+        labels = connected_components(len(atoms), pairs)
+
+        indices = np.argsort(labels, kind="stable")
+        offsets = np.append(np.flatnonzero(np.diff(labels[indices], prepend=-1) != 0), len(labels))
+
+        return cls(offsets, indices)
+
+    @property
+    def n_molecules(self) -> int:
+        """
+        int: The number of molecules.
+        """
+        return len(self.offsets) - 1
+
+    @property
+    def n_atoms(self) -> int:
+        """
+        int: The number of atoms of all molecules.
+        """
+        return len(self.indices)
+
+    @property
+    def sizes(self) -> Np1DIntArray:
+        """
+        Np1DIntArray: The number of atoms of each molecule.
+        """
+        return np.diff(self.offsets)
+
+    @property
+    def first_atoms(self) -> Np1DIntArray:
+        """
+        Np1DIntArray: The index of the first atom of each molecule.
+        """
+        return self.indices[self.offsets[:-1]]
+
+    def molecule(self, index: int) -> Np1DIntArray:
+        """
+        Returns the atom indices of a molecule.
+
+        Parameters
+        ----------
+        index : int
+            The index of the molecule.
+
+        Returns
+        -------
+        Np1DIntArray
+            The atom indices of the molecule.
+        """
+        return self.indices[self.offsets[index]:self.offsets[index + 1]]
+
+    def atom_molecules(self) -> Np1DIntArray:
+        """
+        Returns the molecule index of each atom of the topology in the order of indices.
+
+        Returns
+        -------
+        Np1DIntArray
+            The molecule index of each entry of indices.
+        """
+        return np.repeat(np.arange(self.n_molecules), self.sizes)
+
+    def partial_charges(self, mol_types: List[MolType], n_atoms: int | None = None) -> Np1DNumberArray:
+        """
+        Returns the partial charge of each atom from the mol types of the molecules.
+
+        Parameters
+        ----------
+        mol_types : List[MolType]
+            The mol types, e.g. read by the MoldescriptorReader.
+        n_atoms : int | None, optional
+            The number of atoms of the system, by default None (the largest atom index + 1)
+
+        Returns
+        -------
+        Np1DNumberArray
+            The partial charges, 0 for atoms without mol type.
+
+        Raises
+        ------
+        TopologyError
+            If the size of a molecule does not match its mol type.
+        """
+        if n_atoms is None:
+            n_atoms = int(np.max(self.indices, initial=-1)) + 1
+
+        charges = np.zeros(n_atoms)
+
+        for mol_type in mol_types:
+            selected = np.flatnonzero(self.mol_type_ids == mol_type.id)
+
+            if len(selected) == 0:
+                continue
+
+            if np.any(self.sizes[selected] != mol_type.n_atoms):
+                raise TopologyError(
+                    f"The molecules of mol type {mol_type.id} do not have {mol_type.n_atoms} atoms.")
+
+            atoms = self.indices[self.offsets[selected][:, np.newaxis] + np.arange(mol_type.n_atoms)]
+            charges[atoms] = np.asarray(mol_type.partial_charges, dtype=np.float64)
+
+        return charges
+
+    def select(self, mol_type_id: int) -> MoleculeTopology:
+        """
+        Returns the topology of the molecules of a mol type.
+
+        Parameters
+        ----------
+        mol_type_id : int
+            The mol type id.
+
+        Returns
+        -------
+        MoleculeTopology
+            The topology of the selected molecules.
+
+        Raises
+        ------
+        TopologyError
+            If no molecule has the mol type id.
+        """
+        selected = np.flatnonzero(self.mol_type_ids == mol_type_id)
+
+        if len(selected) == 0:
+            raise TopologyError(f"There are no molecules of the mol type {mol_type_id}.")
+
+        atoms = self.indices[np.repeat(self.mol_type_ids == mol_type_id, self.sizes)]
+
+        return MoleculeTopology(np.append(0, np.cumsum(self.sizes[selected])), atoms,
+                                self.mol_type_ids[selected])
+
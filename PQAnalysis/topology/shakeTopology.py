@@ -16,6 +16,7 @@ from ..core import Atom
 from ..traj import Trajectory
 from ..types import Np1DIntArray, Np2DIntArray, Np1DNumberArray
 from ..io import BaseWriter
+from ..kernels import paired_distances
 
 
 class ShakeTopologyGenerator:
@@ -102,14 +103,9 @@ class ShakeTopologyGenerator:
         distances = [distances]
 
         for frame in trajectory[1:]:
-            pos = frame.pos[indices]
-            target_pos = frame.pos[target_indices]
-
-            delta_pos = pos - target_pos
-
-            delta_pos = frame.cell.image(delta_pos)
-
-            distances.append(np.linalg.norm(delta_pos, axis=1))
+            distances.append(paired_distances(frame.pos[indices],
+                                              frame.pos[target_indices],
+                                              frame.cell.box_matrix))
 
         self.indices = indices
         self.target_indices = target_indices
@@ -18,8 +18,9 @@ from multimethod import multimethod
 
 from . import FrameError
 from ..topology import Topology
-from ..core import AtomicSystem, Atom, Cell
-from ..types import Np2DNumberArray, Np1DNumberArray
+from ..core import AtomicSystem, Atom, Cell, AtomicSystemPositionsError, AtomicSystemMassError
+from ..kernels import group_centers_of_mass
+from ..types import Np2DNumberArray, Np1DNumberArray, Np1DIntArray
 
 
 class Frame:
@@ -52,7 +53,9 @@ class Frame:
 
     def compute_com_frame(self, group=None) -> Frame:
         """
-        Computes a new Frame with the center of mass of the system or groups of atoms.  
+        Computes a new Frame with the center of mass of the system or groups of atoms.
+
+        The centers of mass of all groups are computed at once by the group_centers_of_mass kernel.
 
         Parameters
         ----------
@@ -68,7 +71,17 @@ class Frame:
         ------
         FrameError
             If the number of atoms in the selection is not a multiple of group.
+        AtomicSystemPositionsError
+            If the number of atoms is not equal to the number of positions.
+        AtomicSystemMassError
+            If any atom does not have mass information.
         """
+        if self.pos.shape[0] != self.n_atoms:
+            raise AtomicSystemPositionsError()
+
+        if not all(atom.mass is not None for atom in self.atoms):
+            raise AtomicSystemMassError()
+
         if group is None:
             group = self.n_atoms
 
@@ -76,25 +89,13 @@ class Frame:
             raise FrameError(
                 'Number of atoms in selection is not a multiple of group.')
 
-        pos = []
-        names = []
-
-        print(self.n_atoms)
-
-        for i in range(0, self.n_atoms, group):
-            atomic_system = AtomicSystem(
-                atoms=self.atoms[i:i+group], pos=self.pos[i:i+group], cell=self.cell)
-
-            print(atomic_system.center_of_mass)
-            pos.append(atomic_system.center_of_mass)
-            print(pos)
-            names.append(atomic_system.combined_name)
+        pos = group_centers_of_mass(self.pos, self.system.atomic_masses, group, self.cell.box_matrix)
 
+        names = [atom.name for atom in self.atoms]
+        names = [''.join(names[i:i+group]) for i in range(0, self.n_atoms, group)]
         names = [Atom(name, use_guess_element=False) for name in names]
 
-        print(pos)
-
-        return Frame(AtomicSystem(pos=np.array(pos), atoms=names, cell=self.cell))
+        return Frame(AtomicSystem(pos=pos, atoms=names, cell=self.cell))
 
     def __eq__(self, other: Any) -> bool:
         """
@@ -120,7 +121,28 @@ class Frame:
 
         return self.system == other.system and self.topology == other.topology
 
-    def __getitem__(self, key: int | slice | Atom) -> 'Frame':
+    def __getitem__(self, key: int | slice | Atom | Np1DIntArray) -> 'Frame':
+        """
+        Returns a new Frame containing the selected atoms.
+
+        The selection is forwarded to AtomicSystem.__getitem__, i.e. int and slice keys
+        return views on the data of this Frame without copying it.
+
+        Parameters
+        ----------
+        key : int | slice | Atom | Np1DIntArray
+            The atoms to select.
+
+        Returns
+        -------
+        Frame
+            The new Frame containing the selected atoms.
+
+        Raises
+        ------
+        NotImplementedError
+            If the Frame has a topology.
+        """
         if self.topology is None:
             return Frame(system=self.system[key])
         else:
@@ -229,6 +251,18 @@ class Frame:
         """
         return self.system.charges
 
+    @property
+    def dtype(self) -> np.dtype:
+        """
+        The floating point type of the positions, velocities, forces and charges of the system.
+
+        Returns
+        -------
+        np.dtype
+            The floating point type of the arrays of the system.
+        """
+        return self.system.dtype
+
     @property
     def atoms(self) -> List[Atom]:
         """
@@ -64,6 +64,25 @@ class Trajectory:
         else:
             return True
 
+    def astype(self, dtype: type | np.dtype) -> Trajectory:
+        """
+        Returns a new trajectory with all floating point arrays converted to the given type.
+
+        For example traj.astype(np.float32) halves the memory of the positions,
+        velocities, forces and charges of all frames.
+
+        Parameters
+        ----------
+        dtype : type | np.dtype
+            The floating point type of the new arrays.
+
+        Returns
+        -------
+        Trajectory
+            The new trajectory with the converted frames.
+        """
+        return Trajectory([Frame(frame.system.astype(dtype), frame.topology) for frame in self.frames])
+
     def append(self, frame: Frame) -> None:
         """
         Appends a frame to the trajectory.
@@ -1,2 +1,3 @@
 from .common import print_header
 from .decorators import count_decorator, instance_function_count_decorator
+from .parallel import process_pool
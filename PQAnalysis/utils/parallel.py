@@ -0,0 +1,43 @@
+"""
+A module containing helpers for process based parallelism.
+
+...
+
+Functions
+---------
+process_pool
+    Returns a ProcessPoolExecutor whose workers are not forked from the calling process.
+"""
+
+import multiprocessing
+
+from concurrent.futures import ProcessPoolExecutor
+
+
+def process_pool(n_workers: int) -> ProcessPoolExecutor:
+    """
+    Returns a ProcessPoolExecutor whose workers are not forked from the calling process.
+
+    Forking a process whose kernels already started their thread pools (e.g. Numba's
+    TBB or OpenMP threading layer) can deadlock or abort the workers. Therefore, the
+    workers are forked from a clean server process ('forkserver') where available and
+    spawned otherwise. The worker functions and their arguments have to be picklable.
+    As the workers import the main module, scripts starting a pool have to guard their
+    main code with 'if __name__ == "__main__":' and cannot be run from stdin.
+
+    Parameters
+    ----------
+    n_workers : int
+        The number of worker processes.
+
+    Returns
+    -------
+    ProcessPoolExecutor
+        The process pool.
+    """
+    if "forkserver" in multiprocessing.get_all_start_methods():
+        context = multiprocessing.get_context("forkserver")
+    else:
+        context = multiprocessing.get_context("spawn")
+
+    return ProcessPoolExecutor(max_workers=n_workers, mp_context=context)
@@ -0,0 +1,100 @@
+"""
+Microbenchmarks of the kernels of PQAnalysis.kernels.
+
+Each kernel is timed for all available backends (native, numba, numpy) on a
+random periodic (triclinic) system. The timings are printed together with the
+speedup relative to the NumPy backend. The first call of each kernel is not
+timed, so that the compilation of the Numba kernels is excluded.
+
+Usage:
+    python benchmarks/bench_kernels.py [--n-atoms N] [--repeat R]
+"""
+
+import argparse
+import time
+import numpy as np
+
+from PQAnalysis.core import Cell
+from PQAnalysis import kernels
+
+
+def timeit(function, repeat: int) -> float:
+    """
+    Returns the best wall time of repeat calls of function in seconds.
+    """
+    function()  # warm up (e.g. thread pool creation)
+
+    times = []
+    for _ in range(repeat):
+        start = time.perf_counter()
+        function()
+        times.append(time.perf_counter() - start)
+
+    return min(times)
+
+
+def benchmarks(n_atoms: int):
+    """
+    Returns the benchmarked kernel calls as (name, function) pairs.
+    """
+    rng = np.random.default_rng(42)
+
+    # box with the density of liquid water (~0.1 atoms per cubic Angstrom)
+    length = (n_atoms / 0.1) ** (1 / 3)
+    cell = Cell(length, length, length, 85, 95, 100)
+    box_matrix = cell.box_matrix
+
+    pos = rng.uniform(0, length, (n_atoms, 3))
+    selection1 = pos[: n_atoms // 3]
+    selection2 = pos[n_atoms // 3:]
+
+    n_groups = n_atoms // 3
+    masses = np.tile([15.9994, 1.00794, 1.00794], n_groups)
+    names = ["O", "H", "H"] * n_groups
+    mol_types = np.zeros(3 * n_groups, dtype=int)
+
+    return [
+        ("minimum_image", lambda: kernels.minimum_image(pos - pos[::-1], box_matrix)),
+        ("distance_histogram (pairs of one selection)",
+         lambda: kernels.distance_histogram(pos, None, 8.0, 400, box_matrix)),
+        ("distance_histogram (two selections)",
+         lambda: kernels.distance_histogram(selection1, selection2, 8.0, 400, box_matrix)),
+        ("cutoff_pairs",
+         lambda: kernels.cutoff_pairs(selection1, selection2, 3.5, box_matrix)),
+        ("group_centers_of_mass",
+         lambda: kernels.group_centers_of_mass(pos[:3 * n_groups], masses, 3, box_matrix)),
+        ("format_restart_lines",
+         lambda: kernels.format_restart_lines(names, mol_types, pos[:3 * n_groups],
+                                              pos[:3 * n_groups], pos[:3 * n_groups])),
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--n-atoms', type=int, default=6000,
+                        help='The number of atoms of the benchmark system.')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='The number of timed repetitions of each kernel.')
+    args = parser.parse_args()
+
+    backends = kernels.available_backends()
+    previous = kernels.get_backend()
+
+    print(f"{'kernel':45}" + "".join(f"{backend:>20}" for backend in backends))
+
+    for name, function in benchmarks(args.n_atoms):
+        times = {}
+        for backend in backends:
+            kernels.set_backend(backend)
+            times[backend] = timeit(function, args.repeat)
+
+        row = "".join(f"{times[backend]*1e3:12.2f} ms ({times['numpy']/times[backend]:4.1f}x)"
+                      for backend in backends)
+        print(f"{name:45}{row}")
+
+    kernels.set_backend(previous)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,48 @@
+"""
+Builds the optional native kernels of PQAnalysis.
+
+The C++ kernels in PQAnalysis/kernels/src are compiled with OpenMP if a
+compiler is available. If the build fails, PQAnalysis is installed without
+them and the NumPy implementations of PQAnalysis.kernels are used instead.
+
+With PQANALYSIS_MARCH_NATIVE=1 the kernels are compiled for the instruction
+set of the building machine (e.g. AVX2/AVX-512), which is not portable.
+"""
+
+import os
+
+from setuptools import setup, Extension
+from setuptools.command.build_ext import build_ext
+
+
+class OptionalOpenMPBuildExt(build_ext):
+    """
+    Adds the OpenMP flags of the used compiler and never fails the installation.
+    """
+
+    def build_extensions(self):
+        if self.compiler.compiler_type == "msvc":
+            compile_args, link_args = ["/O2", "/openmp", "/std:c++17"], []
+        else:
+            compile_args = ["-O3", "-std=c++17", "-fopenmp", "-fvisibility=hidden"]
+            link_args = ["-fopenmp"]
+
+            if os.environ.get("PQANALYSIS_MARCH_NATIVE") == "1":
+                compile_args.append("-march=native")
+
+        for extension in self.extensions:
+            extension.extra_compile_args = compile_args
+            extension.extra_link_args = link_args
+
+        super().build_extensions()
+
+
+setup(
+    ext_modules=[
+        Extension("PQAnalysis.kernels._distances",
+                  sources=["PQAnalysis/kernels/src/distances.cpp"],
+                  language="c++",
+                  optional=True),
+    ],
+    cmdclass={"build_ext": OptionalOpenMPBuildExt},
+)
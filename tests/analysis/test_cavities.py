@@ -0,0 +1,95 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import AnalysisError, CavityAccumulator, cavities
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _lattice_frames(n_frames):
+    """one Ar atom and one X pseudo atom in a cubic cell of 10 Angstrom, which shrinks by 1 per frame"""
+    frames = []
+    for index in range(n_frames):
+        length = 10.0 - index
+        pos = np.array([[0.25, 0.25, 0.25], [0.25, 0.25, 0.25 + length / 2]])
+        frames.append(Frame(AtomicSystem(pos=pos, atoms=[Atom("Ar"), Atom("X", use_guess_element=False)],
+                                         cell=Cell(length, length, length))))
+
+    return frames
+
+
+def test_cavity_accumulator():
+    frames = _lattice_frames(3)
+
+    accumulator = CavityAccumulator(["Ar"], radii={"Ar": 1.0}, probe_radius=2.0, max_diameter=20.0, n_bins=40)
+    for frame in frames:
+        accumulator.update(frame)
+
+    assert accumulator.n_frames == 3
+
+    # the farthest grid point is the center of the cube around the atom
+    lengths = np.array([10.0, 9.0, 8.0])
+    assert np.allclose(accumulator.time_series("largest_cavity_diameter"), 2.0 * (np.sqrt(3.0) * lengths / 2 - 1.0))
+
+    sphere = 4.0 / 3.0 * np.pi
+    assert np.allclose(accumulator.time_series("void_fraction"), 1.0 - sphere / lengths**3, atol=2e-3)
+    assert np.allclose(accumulator.time_series("accessible_fraction"), 1.0 - 27 * sphere / lengths**3, atol=5e-3)
+    assert np.allclose(accumulator.time_series("accessible_volume"),
+                       accumulator.time_series("accessible_fraction") * lengths**3)
+
+    diameters, density = accumulator.pore_size_distribution()
+    assert np.isclose(np.sum(density) * 0.5, 1.0)
+    assert np.all(density[diameters > 2.0 * np.sqrt(3.0) * 5.0] == 0.0)
+
+    # the histogram does not depend on the split of the frames
+    first = CavityAccumulator(["Ar"], radii={"Ar": 1.0}, probe_radius=2.0, max_diameter=20.0, n_bins=40)
+    second = CavityAccumulator(["Ar"], radii={"Ar": 1.0}, probe_radius=2.0, max_diameter=20.0, n_bins=40)
+    first.update(frames[0])
+    second.update(frames[1])
+
+    # nearly all of the void is covered by the largest empty sphere in the center of the cube
+    diameters, density = first.pore_size_distribution()
+    assert abs(diameters[np.argmax(density)] - 2.0 * (np.sqrt(3.0) * 5.0 - 1.0)) < 0.25
+    assert np.max(density) * 0.5 > 0.95
+    second.update(frames[2])
+
+    assert first.merge(second) is first
+    assert np.allclose(first.histogram.counts, accumulator.histogram.counts)
+    assert np.allclose(first.time_series("void_fraction"), accumulator.time_series("void_fraction"))
+
+    with pytest.raises(AnalysisError) as exception:
+        CavityAccumulator().update(frames[0])
+    assert str(exception.value) == "The cavity analysis needs a radius for the atom names ['X']."
+
+    with pytest.raises(AnalysisError):
+        CavityAccumulator().update(Frame(AtomicSystem(pos=np.zeros((1, 3)), atoms=[Atom("Ar")])))
+
+    with pytest.raises(AnalysisError):
+        accumulator.time_series("volume")
+
+    with pytest.raises(AnalysisError):
+        CavityAccumulator().pore_size_distribution()
+
+    with pytest.raises(AnalysisError):
+        CavityAccumulator(spacing=0.0)
+
+    with pytest.raises(AnalysisError):
+        CavityAccumulator(probe_radius=-1.0)
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_cavities():
+    frames = _lattice_frames(4)
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = cavities(TrajectoryReader("traj.xyz"), radii={"Ar": 1.0, "X": 0.5}, probe_radius=1.0, n_workers=1)
+
+    reference = CavityAccumulator(radii={"Ar": 1.0, "X": 0.5}, probe_radius=1.0)
+    for frame in frames:
+        reference.update(frame)
+
+    assert result.n_frames == 4
+    assert np.allclose(result.histogram.counts, reference.histogram.counts)
+    assert np.allclose(result.time_series("accessible_volume"), reference.time_series("accessible_volume"))
@@ -0,0 +1,108 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import (
+    AnalysisError,
+    ClusterAccumulator,
+    cluster_labels,
+    clusters,
+)
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _splitting_frames():
+    """a cluster of 4 atoms splits into two halves, one of which joins a cluster of 3 atoms"""
+    a = [[2.0, 2.0, 2.0], [3.0, 2.0, 2.0], [2.0, 3.0, 2.0], [3.0, 3.0, 2.0]]
+    b = [[10.0, 10.0, 10.0], [11.0, 10.0, 10.0], [10.0, 11.0, 10.0]]
+    single = [[15.0, 5.0, 5.0]]
+
+    split = a[:2] + [[15.0, 15.0, 15.0], [16.0, 15.0, 15.0]]
+    joined = a[:2] + [[11.0, 11.0, 10.0], [12.0, 11.0, 10.0]]
+
+    positions = [a + b + single, a + b + single, split + b + single, joined + b + single]
+
+    return [Frame(AtomicSystem(pos=np.array(pos), atoms=[Atom("Ar")] * 8, cell=Cell(20, 20, 20)))
+            for pos in positions]
+
+
+def test_cluster_labels():
+    cell = Cell(10, 10, 10)
+    pos = np.array([[0.5, 5.0, 5.0], [5.0, 5.0, 5.0], [9.6, 5.0, 5.0],
+                    [2.0, 2.0, 2.0], [8.7, 5.0, 5.0], [2.0, 2.0, 3.0]])
+
+    assert np.all(cluster_labels(pos, 1.2, cell.box_matrix) == [0, 1, 0, 2, 0, 2])
+    assert np.all(cluster_labels(pos, 1.2) == [0, 1, 2, 3, 2, 3])
+    assert np.all(cluster_labels(pos, 0.5, cell.box_matrix) == np.arange(6))
+
+
+def test_cluster_accumulator():
+    frames = _splitting_frames()
+
+    accumulator = ClusterAccumulator(1.5, track=True)
+    for frame in frames:
+        accumulator.update(frame)
+
+    assert accumulator.n_frames == 4
+    assert np.all(accumulator.largest_cluster() == [4, 4, 3, 5])
+    assert accumulator.n_clusters == [3, 3, 4, 3]
+    assert np.all(accumulator.size_counts == [0, 4, 3, 3, 2, 1])
+
+    sizes, probabilities = accumulator.size_distribution()
+    assert np.all(sizes == [1, 2, 3, 4, 5])
+    assert np.allclose(probabilities, np.array([4, 3, 3, 2, 1]) / 13)
+
+    _, probabilities = accumulator.size_distribution(atom_weighted=True)
+    assert np.allclose(probabilities, np.array([4, 6, 9, 8, 5]) / 32)
+
+    # the first half continues the split cluster, the second half starts a track that ends when it joins
+    assert [ids.tolist() for ids in accumulator.track_ids] == [[0, 1], [0, 1], [0, 2, 1], [0, 1]]
+    assert np.all(accumulator.track_lifetimes() == [4, 4, 1])
+
+    # the tracks do not depend on the split of the frames
+    for splits in ([2], [1, 3], [1, 2, 3]):
+        partials = []
+        for chunk in np.split(np.arange(4), splits):
+            partial = ClusterAccumulator(1.5, track=True)
+            for index in chunk:
+                partial.update(frames[index])
+            partials.append(partial)
+
+        merged = partials[0]
+        for partial in partials[1:]:
+            assert merged.merge(partial) is merged
+
+        assert [ids.tolist() for ids in merged.track_ids] == [[0, 1], [0, 1], [0, 2, 1], [0, 1]]
+        assert merged.n_tracks == 3
+        assert np.all(merged.size_counts == accumulator.size_counts)
+
+    with pytest.raises(AnalysisError):
+        accumulator.merge(ClusterAccumulator(1.5))
+
+    with pytest.raises(AnalysisError):
+        ClusterAccumulator(1.5).track_lifetimes()
+
+    with pytest.raises(AnalysisError):
+        ClusterAccumulator(1.5).size_distribution()
+
+    with pytest.raises(AnalysisError) as exception:
+        ClusterAccumulator(0.0)
+    assert str(exception.value) == "The cutoff of the cluster analysis has to be positive."
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_clusters():
+    frames = _splitting_frames() * 3
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = clusters(TrajectoryReader("traj.xyz"), 1.5, track=True, min_size=3, n_workers=1)
+
+    assert result.n_frames == 12
+    assert np.all(result.largest_cluster() == [4, 4, 3, 5] * 3)
+    assert np.all(result.size_counts == [0, 12, 9, 9, 6, 3])
+
+    # only the clusters of at least 3 atoms are tracked, the cluster of 4 atoms reappears as a new track
+    assert [ids.tolist() for ids in result.track_ids[:5]] == [[0, 1], [0, 1], [1], [1], [2, 1]]
+    assert np.all(result.track_lifetimes() == [2, 12, 2, 2])
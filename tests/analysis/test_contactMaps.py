@@ -0,0 +1,119 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import (
+    AnalysisError,
+    ContactMapAccumulator,
+    group_contacts,
+    contact_maps,
+)
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.topology import MoleculeTopology
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _dimer_frames(n_frames):
+    """four dimers along x in a cell of 20 Angstrom, the last dimer approaches the first across the boundary"""
+    frames = []
+    for index in range(n_frames):
+        x = np.array([1.0, 2.0, 6.0, 7.0, 9.0, 10.0, 17.0 + index, 18.0 + index]) % 20.0
+        pos = np.column_stack((x, np.full(8, 5.0), np.full(8, 5.0)))
+        frames.append(Frame(AtomicSystem(pos=pos, atoms=[Atom("C")] * 8, cell=Cell(20, 20, 20))))
+
+    return frames
+
+
+def test_group_contacts():
+    pos = np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [3.0, 0.0, 0.0], [9.5, 0.0, 0.0], [7.0, 0.0, 0.0]])
+    topology = MoleculeTopology(np.array([0, 2, 3, 5]), np.array([0, 1, 2, 3, 4]))
+
+    assert group_contacts(pos, 2.1, topology).tolist() == [[0, 1]]
+    assert group_contacts(pos, 2.1, topology, box_matrix=Cell(10, 10, 10).box_matrix).tolist() == [[0, 1], [0, 2]]
+
+    # the atoms of the second topology can overlap with the first topology, but are not in contact with themselves
+    second = MoleculeTopology(np.array([0, 1, 2]), np.array([4, 2]))
+    assert group_contacts(pos, 2.1, topology, second).tolist() == [[0, 1]]
+
+
+def test_contact_map_accumulator():
+    frames = _dimer_frames(4)
+
+    accumulator = ContactMapAccumulator(2.5, 2)
+    for frame in frames:
+        accumulator.update(frame)
+
+    assert accumulator.n_frames == 4
+    assert accumulator.shape == (4, 4)
+    assert accumulator.n_contacts == [1, 2, 2, 2]
+
+    pairs, frequencies = accumulator.contacts()
+    assert pairs.tolist() == [[0, 3], [1, 2]]
+    assert np.allclose(frequencies, [0.75, 1.0])
+
+    matrix = accumulator.dense()
+    assert np.allclose(matrix, matrix.T)
+    assert np.isclose(matrix[3, 0], 0.75)
+
+    # the counts do not depend on the split of the frames and the buffer size
+    first = ContactMapAccumulator(2.5, 2)
+    second = ContactMapAccumulator(2.5, 2)
+    second.buffer_size = 0
+
+    for index, frame in enumerate(frames):
+        (first if index % 2 == 0 else second).update(frame)
+
+    assert first.merge(second) is first
+    assert first.merge(ContactMapAccumulator(2.5, 2)) is first
+    assert np.all(first.contacts()[0] == pairs)
+    assert np.allclose(first.contacts()[1], frequencies)
+
+    # the contacts between two sets of groups
+    between = ContactMapAccumulator(2.5, MoleculeTopology(np.array([0, 2]), np.array([0, 1])),
+                                    MoleculeTopology(np.array([0, 2, 4]), np.array([4, 5, 6, 7])))
+    for frame in frames:
+        between.update(frame)
+
+    assert between.shape == (1, 2)
+    assert between.contacts()[0].tolist() == [[0, 1]]
+    assert np.allclose(between.dense(), [[0.0, 0.75]])
+
+    with pytest.raises(AnalysisError):
+        accumulator.merge(between)
+
+    with pytest.raises(AnalysisError):
+        ContactMapAccumulator(2.5, 2).contacts()
+
+    with pytest.raises(AnalysisError) as exception:
+        ContactMapAccumulator(0.0, 2)
+    assert str(exception.value) == "The cutoff of the contact map has to be positive."
+
+
+def test_contact_map_accumulator_large():
+    # 10k groups of single atoms on a cubic lattice in contact with their nearest neighbours
+    n = 22
+    grid = np.stack(np.meshgrid(*[np.arange(n)] * 3, indexing="ij"), axis=-1).reshape(-1, 3)[:10000] * 1.0
+    frame = Frame(AtomicSystem(pos=grid + 0.5, atoms=[Atom("C")] * 10000, cell=Cell(n, n, n)))
+
+    accumulator = ContactMapAccumulator(1.1, 1)
+    accumulator.update(frame)
+
+    pairs, frequencies = accumulator.contacts()
+
+    assert accumulator.shape == (10000, 10000)
+    assert np.all(pairs[:, 0] < pairs[:, 1]) and np.all(frequencies == 1.0)
+    assert len(pairs) == len(np.unique(pairs[:, 0] * 10000 + pairs[:, 1]))
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_contact_maps():
+    frames = _dimer_frames(6)
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = contact_maps(TrajectoryReader("traj.xyz"), 2.5, 2, n_workers=1)
+
+    # the last dimer is in contact with the first from the second frame on
+    assert result.n_frames == 6
+    assert result.contacts()[0].tolist() == [[0, 3], [1, 2]]
+    assert np.allclose(result.contacts()[1], [5.0 / 6.0, 1.0])
@@ -0,0 +1,131 @@
+import os
+import shutil
+
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import RunDirectory, EnsembleAnalysis, EnsembleResult, AnalysisError
+
+
+def _mean_x(run):
+    return np.mean([frame.pos[0, 0] for frame in run.trajectory_reader().read()])
+
+
+def _write_run(path, x_values):
+    os.mkdir(path)
+    with open(os.path.join(path, "md-01.xyz"), "w") as file:
+        for x in x_values:
+            print("1 10.0 10.0 10.0", file=file)
+            print("", file=file)
+            print(f"h {x} 0.0 0.0", file=file)
+
+
+class TestRunDirectory:
+    @pytest.mark.usefixtures("tmpdir")
+    def test__init__(self):
+        with pytest.raises(AnalysisError) as exception:
+            RunDirectory("run-01")
+        assert str(exception.value) == "The run directory run-01 does not exist."
+
+        _write_run("run-01", [1.0, 2.0])
+        for filename in ["md-01.en", "md-02.en", "md-01.rst", "md-02.rst"]:
+            open(os.path.join("run-01", filename), "w").close()
+
+        run = RunDirectory("run-01")
+        assert run.name == "run-01"
+        assert run.trajectory == [os.path.join("run-01", "md-01.xyz")]
+        assert run.energy == [os.path.join("run-01", "md-01.en"),
+                              os.path.join("run-01", "md-02.en")]
+        assert run.info == []
+        assert run.restart == os.path.join("run-01", "md-02.rst")
+        assert run.size == os.path.getsize(os.path.join("run-01", "md-01.xyz"))
+
+        run = RunDirectory("run-01", trajectory="other.xyz", restart=None, energy=[])
+        assert run.trajectory == ["other.xyz"]
+        assert run.energy == []
+
+        with pytest.raises(AnalysisError) as exception:
+            run.read_energy()
+        assert str(exception.value) == "The run run-01 has no energy file."
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_read_energy(self):
+        os.mkdir("run-01")
+        for filename in ["md-01.en", "md-02.en"]:
+            shutil.copy(os.path.join("..", "tests", "data", "readEnergyFile", "md-01.en"),
+                        os.path.join("run-01", filename))
+        shutil.copy(os.path.join("..", "tests", "data", "readEnergyFile", "md-01.info"),
+                    os.path.join("run-01", "md-01.info"))
+
+        run = RunDirectory("run-01")
+        energy = run.read_energy()
+
+        single = RunDirectory("run-01", energy=os.path.join("run-01", "md-01.en")).read_energy()
+        assert energy.data.shape == (single.data.shape[0], 2 * single.data.shape[1])
+        assert energy.info == single.info
+
+
+class TestEnsembleAnalysis:
+    @pytest.mark.usefixtures("tmpdir")
+    def test_run(self):
+        _write_run("run-01", [1.0, 3.0])
+        _write_run("run-02", [4.0, 4.0, 4.0, 4.0])
+        _write_run("run-03", [2.0])
+        os.mkdir("run-04")
+
+        with pytest.raises(AnalysisError) as exception:
+            EnsembleAnalysis([], _mean_x)
+        assert str(exception.value) == "An ensemble needs at least one run."
+
+        with pytest.raises(AnalysisError) as exception:
+            EnsembleAnalysis(["run-01"], _mean_x, weights=[1.0, 2.0])
+        assert str(exception.value) == "1 non-negative weights are needed, one for each run."
+
+        runs = ["run-01", "run-02", "run-03", "run-04"]
+        weights = [1.0, 2.0, 1.0, 1.0]
+
+        for n_workers in [1, 2]:
+            analysis = EnsembleAnalysis(runs, _mean_x, weights, n_workers=n_workers)
+            assert analysis.schedule() == [1, 0, 2, 3]
+
+            result = analysis.run()
+            assert isinstance(result, EnsembleResult)
+
+            # the run without trajectory fails without aborting the others
+            assert result.succeeded == [0, 1, 2]
+            assert result.failed == [analysis.runs[3]]
+            assert "has no trajectory file" in result.errors[3]
+            assert result.results[:3] == [2.0, 4.0, 2.0]
+            assert result.results[3] is None
+
+            assert np.isclose(result.mean(), 3.0)
+            assert np.isclose(result.merged(), 3.0)
+            assert np.isclose(result.std(), np.sqrt(1.6))
+            assert np.isclose(result.sem(), np.sqrt(1.6) * np.sqrt(6.0) / 4.0)
+
+            summary = result.summary()
+            assert "3 of 4 runs succeeded" in summary
+            assert "FAILED: PQAnalysis.analysis.exceptions.AnalysisError" in summary
+            assert "ensemble mean: 3 +- " in summary
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_merged(self):
+        _write_run("run-01", [1.0])
+
+        result = EnsembleResult([RunDirectory("run-01")] * 2, [None, None],
+                                np.ones(2), {0: "error", 1: "error"}, np.zeros(2))
+
+        with pytest.raises(AnalysisError) as exception:
+            result.merged()
+        assert str(exception.value) == "The analysis of all runs failed."
+
+        result = EnsembleResult([RunDirectory("run-01")] * 2, [{"a": 1}, {"a": 2}],
+                                np.array([1.0, 2.0]), {}, np.zeros(2))
+
+        with pytest.raises(AnalysisError) as exception:
+            result.merged()
+        assert str(exception.value) == "Accumulators can only be merged with equal run weights."
+
+        with pytest.raises(AnalysisError) as exception:
+            result.std()
+        assert str(exception.value) == "Ensemble statistics are only available for numerical results."
@@ -0,0 +1,80 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import map_reduce, frame_ranges, merge_partials, AnalysisError
+from PQAnalysis.io import TrajectoryReader
+
+
+def _zeros():
+    return np.zeros(4)
+
+
+def _histogram(histogram, frame):
+    return histogram + np.histogram(frame.pos[:, 0], bins=4, range=(0.0, 4.0))[0]
+
+
+class _Positions:
+    def __init__(self):
+        self.x = []
+
+    def merge(self, other):
+        self.x += other.x
+        return self
+
+
+def _positions():
+    return _Positions()
+
+
+def _append(positions, frame):
+    positions.x.append(float(frame.pos[0, 0]))
+
+
+def _write_trajectory(filename, n_frames):
+    with open(filename, "w") as file:
+        for i in range(n_frames):
+            print("2 10.0 10.0 10.0", file=file)
+            print("", file=file)
+            print(f"h {i % 4 + 0.5} 0.0 0.0", file=file)
+            print(f"o {(i + 1) % 4 + 0.5} 1.0 0.0", file=file)
+
+
+def test_frame_ranges():
+    assert frame_ranges(10, 3) == [slice(0, 3), slice(3, 6), slice(6, 10)]
+    assert frame_ranges(2, 4) == [slice(0, 1), slice(1, 2)]
+    assert frame_ranges(0, 2) == [slice(0, 0)]
+
+    with pytest.raises(AnalysisError) as exception:
+        frame_ranges(10, 0)
+    assert str(exception.value) == "The number of frame ranges has to be at least 1."
+
+
+def test_merge_partials():
+    assert merge_partials([1.0, 2.0, 3.0]) == 6.0
+    assert np.allclose(merge_partials([np.ones(2), np.ones(2)]), [2.0, 2.0])
+
+    first, second = _Positions(), _Positions()
+    first.x, second.x = [1.0], [2.0]
+    assert merge_partials([first, second]) is first
+    assert first.x == [1.0, 2.0]
+
+    with pytest.raises(AnalysisError) as exception:
+        merge_partials([])
+    assert str(exception.value) == "There are no partial results to merge."
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_map_reduce():
+    _write_trajectory("md-01.xyz", 7)
+    _write_trajectory("md-02.xyz", 4)
+    reader = TrajectoryReader(["md-01.xyz", "md-02.xyz"])
+
+    reference = sum(_histogram(np.zeros(4), frame) for frame in reader.read())
+
+    assert np.allclose(map_reduce(reader, _zeros, _histogram, n_workers=1), reference)
+    assert np.allclose(map_reduce(reader, _zeros, _histogram, n_workers=1, n_chunks=3), reference)
+    assert np.allclose(map_reduce(reader, _zeros, _histogram, n_workers=2, n_chunks=5), reference)
+
+    # the frame ranges are merged in order
+    positions = map_reduce(reader, _positions, _append, n_workers=2)
+    assert positions.x == [float(frame.pos[0, 0]) for frame in reader.read()]
@@ -0,0 +1,83 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import (
+    AnalysisError,
+    MinimumDistanceAccumulator,
+    make_whole,
+    minimum_distances,
+)
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _chain_frame(shift):
+    """a chain of 5 C atoms of length 8 broken by the periodic boundary and two O atoms"""
+    chain = np.column_stack([np.arange(5) * 2.0 + shift, np.full(5, 5.0), np.full(5, 5.0)]) % 12.0
+    pos = np.concatenate([chain, [[shift, 9.0, 5.0], [shift + 2.0, 5.0, 8.0]]])
+    atoms = [Atom("C")] * 5 + [Atom("O")] * 2
+
+    return Frame(AtomicSystem(pos=pos, atoms=atoms, cell=Cell(12, 12, 12)))
+
+
+def test_make_whole():
+    cell = Cell(10, 10, 10, 90, 90, 120)
+    pos = np.array([[1.0, 1.0, 1.0], [2.0, 1.0, 1.0], [3.0, 1.0, 1.0], [4.0, 1.0, 1.0]])
+    broken = cell.image(pos - 2.5) + 2.5
+
+    assert np.allclose(make_whole(broken, cell.box_matrix) - broken[0], pos - pos[0])
+    assert np.allclose(make_whole(pos[:1], cell.box_matrix), pos[:1])
+
+
+def test_minimum_distance_accumulator():
+    accumulator = MinimumDistanceAccumulator(["C"], ["O"], self_image=True)
+
+    for shift in [0.0, 6.0, 9.0]:
+        accumulator.update(_chain_frame(shift))
+
+    distances, pairs = accumulator.time_series()
+    assert np.allclose(distances, 3.0)
+    assert np.all(pairs == [1, 6])
+
+    # the chain of length 8 in a box of 12 sees its image at 4, wherever it is broken
+    distances, pairs = accumulator.time_series(self_image=True)
+    assert np.allclose(distances, 4.0)
+    assert np.all(np.sort(pairs, axis=1) == [0, 4])
+    assert np.all(np.abs(np.stack(accumulator.images)) == [1, 0, 0])
+
+    within = MinimumDistanceAccumulator(["C"])
+    within.update(_chain_frame(9.0))
+    assert within.time_series()[0][0] == pytest.approx(2.0)
+    assert within.pairs[0][0] < within.pairs[0][1]
+
+    other = MinimumDistanceAccumulator(["C"], ["O"], self_image=True)
+    other.update(_chain_frame(1.0))
+    assert accumulator.merge(other) is accumulator
+    assert accumulator.closest_frame() == (0, pytest.approx([1, 6]), pytest.approx(3.0))
+    assert accumulator.n_frames == 4
+
+    with pytest.raises(AnalysisError):
+        within.time_series(self_image=True)
+
+    with pytest.raises(AnalysisError):
+        MinimumDistanceAccumulator().closest_frame()
+
+    with pytest.raises(AnalysisError) as exception:
+        MinimumDistanceAccumulator(self_image=True).update(
+            Frame(AtomicSystem(pos=np.zeros((2, 3)), atoms=[Atom("C")] * 2)))
+    assert str(exception.value) == "The self image distance needs periodic boundary conditions."
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_minimum_distances():
+    frames = [_chain_frame(shift) for shift in np.linspace(0.0, 11.0, 12)]
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = minimum_distances(TrajectoryReader("traj.xyz"), ["C"], ["O"], self_image=True, n_workers=1)
+
+    assert result.n_frames == 12
+    assert np.allclose(result.time_series()[0], 3.0)
+    assert np.all(result.time_series()[1] == [1, 6])
+    assert np.allclose(result.time_series(self_image=True)[0], 4.0)
@@ -0,0 +1,84 @@
+import os
+import shutil
+import subprocess
+import sys
+
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import mpi_map_reduce, map_reduce, AnalysisError
+from PQAnalysis.analysis import mpiMapReduce
+from PQAnalysis.io import TrajectoryReader
+
+
+def _zeros():
+    return np.zeros(4)
+
+
+def _histogram(histogram, frame):
+    return histogram + np.histogram(frame.pos[:, 0], bins=4, range=(0.0, 4.0))[0]
+
+
+def _write_trajectory(filename, n_frames):
+    with open(filename, "w") as file:
+        for i in range(n_frames):
+            print("2 10.0 10.0 10.0", file=file)
+            print("", file=file)
+            print(f"h {i % 4 + 0.5} 0.0 0.0", file=file)
+            print(f"o {(i + 1) % 4 + 0.5} 1.0 0.0", file=file)
+
+
+_script = """
+import numpy as np
+from PQAnalysis.analysis import mpi_map_reduce
+from PQAnalysis.io import TrajectoryReader
+
+
+def zeros():
+    return np.zeros(4)
+
+
+def histogram(histogram, frame):
+    return histogram + np.histogram(frame.pos[:, 0], bins=4, range=(0.0, 4.0))[0]
+
+
+result = mpi_map_reduce(TrajectoryReader("md-01.xyz"), zeros, histogram, n_chunks=6, broadcast=True)
+print(" ".join(str(value) for value in result))
+"""
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_mpi_map_reduce_without_mpi4py(monkeypatch):
+    _write_trajectory("md-01.xyz", 3)
+    monkeypatch.setattr(mpiMapReduce, "MPI", None)
+
+    with pytest.raises(AnalysisError) as exception:
+        mpi_map_reduce(TrajectoryReader("md-01.xyz"), _zeros, _histogram)
+    assert str(exception.value) == "mpi_map_reduce needs mpi4py. Please install it or use map_reduce instead."
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_mpi_map_reduce():
+    MPI = pytest.importorskip("mpi4py.MPI")
+
+    _write_trajectory("md-01.xyz", 11)
+    reader = TrajectoryReader("md-01.xyz")
+    reference = map_reduce(reader, _zeros, _histogram, n_workers=1)
+
+    result = mpi_map_reduce(reader, _zeros, _histogram, n_chunks=3, comm=MPI.COMM_SELF)
+    assert np.allclose(result, reference)
+
+    if shutil.which("mpirun") is None:
+        pytest.skip("mpirun is not available")
+
+    with open("script.py", "w") as file:
+        file.write(_script)
+
+    environment = dict(os.environ, PYTHONPATH=os.path.abspath(".."))
+    output = subprocess.run(["mpirun", "-n", "4", sys.executable, "script.py"],
+                            capture_output=True, text=True, env=environment, timeout=300)
+
+    lines = output.stdout.split("\n")[:-1]
+    assert len(lines) == 4
+    for line in lines:
+        assert np.allclose(np.array(line.split(), dtype=float), reference)
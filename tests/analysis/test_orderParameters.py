@@ -0,0 +1,112 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import (
+    AnalysisError,
+    OrderParameterAccumulator,
+    spherical_harmonics,
+    tetrahedral_order,
+    steinhardt_order,
+    order_parameters,
+)
+from PQAnalysis.core import AtomicSystem, Cell, Atom
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _fcc(n):
+    base = np.array([[0, 0, 0], [0, 0.5, 0.5], [0.5, 0, 0.5], [0.5, 0.5, 0]])
+    shifts = np.array([[i, j, k] for i in range(n) for j in range(n) for k in range(n)])
+    return (shifts[:, np.newaxis, :] + base).reshape(-1, 3)
+
+
+def _diamond_frame(n=3):
+    fcc = _fcc(n)
+    pos = np.concatenate([fcc, fcc + 0.25]) * 3.57
+    atoms = [Atom("C")] * len(pos)
+    return Frame(AtomicSystem(pos=pos, atoms=atoms, cell=Cell(3.57 * n, 3.57 * n, 3.57 * n)))
+
+
+def test_spherical_harmonics():
+    vectors = np.array([[1.0, 2.0, 3.0], [0.0, 0.0, 2.0], [-1.0, 0.5, -0.2]])
+    theta = np.arccos(vectors[:, 2] / np.linalg.norm(vectors, axis=1))
+    phi = np.arctan2(vectors[:, 1], vectors[:, 0])
+
+    harmonics = spherical_harmonics(2, vectors)
+
+    assert harmonics.shape == (3, 3)
+    assert np.allclose(harmonics[:, 0], np.sqrt(5 / (16 * np.pi)) * (3 * np.cos(theta)**2 - 1))
+    assert np.allclose(harmonics[:, 1], -np.sqrt(15 / (8 * np.pi))
+                       * np.sin(theta) * np.cos(theta) * np.exp(1j * phi))
+    assert np.allclose(harmonics[:, 2], np.sqrt(15 / (32 * np.pi))
+                       * np.sin(theta)**2 * np.exp(2j * phi))
+
+    assert np.allclose(spherical_harmonics(0, vectors), 1 / np.sqrt(4 * np.pi))
+
+    with pytest.raises(AnalysisError):
+        spherical_harmonics(-1, vectors)
+
+
+def test_perfect_crystals():
+    box_matrix = Cell(4, 4, 4).box_matrix
+    fcc = _fcc(4)
+
+    assert np.allclose(steinhardt_order(fcc, 4, box_matrix), 0.19094, atol=1e-5)
+    assert np.allclose(steinhardt_order(fcc, 6, box_matrix), 0.57452, atol=1e-5)
+
+    frame = _diamond_frame()
+    assert np.allclose(tetrahedral_order(frame.pos, frame.cell.box_matrix), 1.0)
+
+    # an isolated tetrahedron without periodic boundary conditions
+    tetrahedron = np.array([[0, 0, 0], [1, 1, 1], [1, -1, -1], [-1, 1, -1], [-1, -1, 1]])
+    assert np.isclose(tetrahedral_order(tetrahedron)[0], 1.0)
+
+
+def test_accumulator():
+    frame = _diamond_frame()
+
+    accumulator = OrderParameterAccumulator(atoms=["C"], l_values=(6,), n_bins=10,
+                                            keep_values=True)
+    accumulator.update(frame)
+    accumulator.update(frame)
+
+    other = OrderParameterAccumulator(atoms=["C"], l_values=(6,), n_bins=10, keep_values=True)
+    other.update(frame)
+
+    assert accumulator.merge(other) is accumulator
+    assert np.allclose(accumulator.time_series("q"), [1.0, 1.0, 1.0])
+    assert accumulator.per_atom("Q6").shape == (3, frame.n_atoms)
+    assert accumulator.histograms["q"].counts[-1] == 3 * frame.n_atoms
+    assert accumulator.histograms["Q6"].total == 3 * frame.n_atoms
+
+    with pytest.raises(AnalysisError) as exception:
+        accumulator.time_series("Q4")
+    assert str(exception.value) == "The order parameter Q4 was not computed, available are ['q', 'Q6']."
+
+    with pytest.raises(AnalysisError):
+        accumulator.merge(OrderParameterAccumulator(l_values=(4,)))
+
+    with pytest.raises(AnalysisError):
+        OrderParameterAccumulator(tetrahedral=False, l_values=())
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_order_parameters():
+    rng = np.random.default_rng(5)
+    atoms = [Atom("o" if i % 2 == 0 else "h") for i in range(60)]
+
+    frames = [Frame(AtomicSystem(pos=rng.uniform(0, 8, (60, 3)), atoms=atoms, cell=Cell(8.0, 8.0, 8.0)))
+              for _ in range(4)]
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = order_parameters(TrajectoryReader("traj.xyz"), atoms=["o"], l_values=(6,), n_workers=1)
+
+    reference = OrderParameterAccumulator(["o"], l_values=(6,))
+    for frame in frames:
+        reference.update(frame)
+
+    assert np.array_equal(result.indices, np.arange(0, 60, 2))
+    assert np.allclose(result.time_series("q"), reference.time_series("q"))
+    assert np.allclose(result.histograms["Q6"].counts, reference.histograms["Q6"].counts)
+    assert "Q4" not in result.histograms
@@ -0,0 +1,105 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.analysis import (
+    AnalysisError,
+    ReorientationAccumulator,
+    molecular_vectors,
+    legendre_correlation,
+    reorientation,
+)
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.topology import MoleculeTopology
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _rotating_water(n_frames, rate):
+    """two water molecules rotating about z with the given angle per frame"""
+    angles = rate * np.arange(n_frames)
+    frames = []
+
+    for angle in angles:
+        rotation = np.array([[np.cos(angle), -np.sin(angle), 0.0],
+                             [np.sin(angle), np.cos(angle), 0.0],
+                             [0.0, 0.0, 1.0]])
+        water = np.array([[0.0, 0.0, 0.0], [0.96, 0.0, 0.0], [-0.24, 0.93, 0.0]]) @ rotation.T
+        pos = np.concatenate([water + [0.1, 5.0, 5.0], water + [5.0, 5.0, 5.0]])
+        frames.append(pos)
+
+    return np.array(frames)
+
+
+def test_molecular_vectors():
+    cell = Cell(10, 10, 10)
+    # the first molecule is broken by the periodic boundary conditions
+    pos = np.array([[9.9, 5.0, 5.0], [0.86, 5.0, 5.0], [9.66, 5.93, 5.0],
+                    [5.0, 5.0, 5.0], [5.0, 5.96, 5.0], [5.0, 5.0, 4.04]])
+    topology = MoleculeTopology.from_groups(6, 3)
+
+    vectors = molecular_vectors(pos, topology, cell.box_matrix, pairs=[(0, 1), (0, 2)])
+
+    assert vectors.shape == (4, 3)
+    assert np.allclose(vectors[0], [1.0, 0.0, 0.0])
+    assert np.allclose(vectors[2], [0.0, 1.0, 0.0])
+    assert np.allclose(vectors[3], [0.0, 0.0, -1.0])
+
+    charges = np.tile([-0.8, 0.4, 0.4], 2)
+    dipoles = molecular_vectors(pos, topology, cell.box_matrix, weights=charges)
+
+    assert np.allclose(dipoles[1], [0.0, 1.0, -1.0] / np.sqrt(2.0))
+    assert np.allclose(np.linalg.norm(dipoles, axis=1), 1.0)
+
+    with pytest.raises(AnalysisError) as exception:
+        molecular_vectors(pos, topology, pairs=[(0, 3)])
+    assert str(exception.value) == "The atom pairs have to be within the atoms of all molecules."
+
+    with pytest.raises(AnalysisError):
+        molecular_vectors(pos, topology)
+
+
+def test_legendre_correlation():
+    rate = 0.05
+    n_frames = 50
+    angles = rate * np.arange(n_frames)
+    vectors = np.stack([np.cos(angles), np.sin(angles), np.zeros(n_frames)], axis=-1)[:, np.newaxis]
+
+    lags = rate * np.arange(10)
+    assert np.allclose(legendre_correlation(vectors, 1, n_lags=10), np.cos(lags))
+    assert np.allclose(legendre_correlation(vectors, 2, n_lags=10), 1.5 * np.cos(lags)**2 - 0.5)
+
+    # random orientations are uncorrelated
+    rng = np.random.default_rng(2)
+    random = rng.normal(size=(400, 200, 3))
+    random /= np.linalg.norm(random, axis=-1, keepdims=True)
+
+    values = legendre_correlation(random, 2, n_lags=5, batch_size=50, n_workers=2)
+    assert np.isclose(values[0], 1.0)
+    assert np.all(np.abs(values[1:]) < 0.02)
+
+    with pytest.raises(AnalysisError):
+        legendre_correlation(vectors, 3)
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_reorientation():
+    atoms = [Atom(name) for name in ["O", "H", "H"] * 2]
+    frames = [Frame(AtomicSystem(pos=pos, atoms=atoms, cell=Cell(10, 10, 10)))
+              for pos in _rotating_water(20, 0.1)]
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    topology = MoleculeTopology.from_groups(6, 3)
+
+    result = reorientation(TrajectoryReader("traj.xyz"), topology, pairs=[(0, 1)], n_workers=1)
+
+    lags = 0.1 * np.arange(20)
+    assert result.n_frames == 20
+    assert np.allclose(result.correlation(1), np.cos(lags))
+    assert np.allclose(result.correlation(2), 1.5 * np.cos(lags)**2 - 0.5)
+
+    # the P1 correlation cos(0.1 t) is integrated up to its first zero crossing at t = 16
+    assert result.relaxation_time(1, time_step=2.0) == pytest.approx(2.0 * 10.0, rel=0.02)
+
+    with pytest.raises(AnalysisError):
+        ReorientationAccumulator(topology).correlation()
@@ -0,0 +1,115 @@
+import pytest
+import warnings
+import numpy as np
+
+from PQAnalysis.analysis import AnalysisError, VoronoiAccumulator, voronoi
+from PQAnalysis.core import AtomicSystem, Atom, Cell
+from PQAnalysis.io import TrajectoryReader
+from PQAnalysis.io.trajectoryWriter import write_trajectory
+from PQAnalysis.traj import Frame, Trajectory
+
+
+def _cesium_chloride_frames(n_frames, shift=0.0):
+    """a 3x3x3 cesium chloride lattice with the lattice constant 2, the chlorine atoms shifted along x"""
+    cells = np.stack(np.meshgrid(*[np.arange(3)] * 3, indexing="ij"), axis=-1).reshape(-1, 3) * 2.0
+    atoms = [Atom("Cs")] * 27 + [Atom("Cl")] * 27
+
+    frames = []
+    for index in range(n_frames):
+        pos = np.concatenate([cells, cells + 1.0 + [shift * index, 0.0, 0.0]])
+        frames.append(Frame(AtomicSystem(pos=pos, atoms=atoms, cell=Cell(6, 6, 6))))
+
+    return frames
+
+
+def test_voronoi_accumulator():
+    frames = _cesium_chloride_frames(2)
+
+    accumulator = VoronoiAccumulator()
+    for frame in frames:
+        accumulator.update(frame)
+
+    assert accumulator.n_frames == 2
+    assert accumulator.species == ["Cl", "Cs"]
+
+    # the truncated octahedra of the bcc lattice have 8 hexagonal and 6 square faces
+    summary = accumulator.summary()
+    for name in ("Cl", "Cs"):
+        assert np.isclose(summary[name]["volume"], 4.0)
+        assert np.isclose(summary[name]["volume_std"], 0.0, atol=1e-10)
+        assert np.isclose(summary[name]["density"], 0.25)
+        assert np.isclose(summary[name]["neighbours"], 14.0)
+
+    counts, probabilities = accumulator.neighbour_distribution("Cs")
+    assert counts[np.argmax(probabilities)] == 14 and np.isclose(np.max(probabilities), 1.0)
+    assert np.allclose(accumulator.time_series("Cl"), [4.0, 4.0])
+
+    # the larger cesium atoms take volume from the chlorine atoms
+    radical = VoronoiAccumulator(["Cs"], radii={"Cs": 1.7, "Cl": 1.0})
+    radical.update(frames[0])
+
+    assert radical.species == ["Cs"]
+    assert radical.summary()["Cs"]["volume"] > 4.0
+
+    # the chlorine atoms are hidden by the much larger cesium atoms
+    hidden = VoronoiAccumulator(radii={"Cs": 2.5, "Cl": 1.0})
+    with warnings.catch_warnings():
+        warnings.simplefilter("error")
+        hidden.update(frames[0])
+
+    summary = hidden.summary()
+    assert np.isclose(summary["Cl"]["volume"], 0.0) and np.isclose(summary["Cl"]["neighbours"], 0.0)
+    assert hidden.densities["Cl"].weight == 0.0 and np.isnan(summary["Cl"]["density"])
+    assert np.isclose(summary["Cs"]["volume"], 8.0) and np.isclose(summary["Cs"]["density"], 0.125)
+
+    with pytest.raises(AnalysisError) as exception:
+        VoronoiAccumulator(radii={"Cs": 1.7}).update(frames[0])
+    assert str(exception.value) == "The radical Voronoi tessellation needs a radius for the atom names ['Cl']."
+
+    with pytest.raises(AnalysisError) as exception:
+        accumulator.time_series("Na")
+    assert str(exception.value) == "No statistics of the atom name Na were accumulated, available are ['Cl', 'Cs']."
+
+    with pytest.raises(AnalysisError):
+        VoronoiAccumulator().update(Frame(AtomicSystem(pos=np.zeros((1, 3)), atoms=[Atom("Ar")])))
+
+
+def test_voronoi_accumulator_merge():
+    frames = _cesium_chloride_frames(4, shift=0.1)
+
+    accumulator = VoronoiAccumulator()
+    for frame in frames:
+        accumulator.update(frame)
+
+    partials = [VoronoiAccumulator(), VoronoiAccumulator()]
+    for index, frame in enumerate(frames):
+        partials[index // 3].update(frame)
+
+    merged = partials[0].merge(partials[1])
+
+    assert merged is partials[0]
+    assert np.allclose(merged.time_series("Cs"), accumulator.time_series("Cs"))
+
+    for name in accumulator.species:
+        assert np.isclose(merged.volumes[name].variance(), accumulator.volumes[name].variance())
+        assert np.allclose(merged.histograms[name].counts, accumulator.histograms[name].counts)
+
+    with pytest.raises(AnalysisError):
+        merged.merge(VoronoiAccumulator(max_neighbours=20))
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_voronoi():
+    frames = _cesium_chloride_frames(4, shift=0.1)
+    write_trajectory(Trajectory(frames), "traj.xyz")
+
+    result = voronoi(TrajectoryReader("traj.xyz"), ["Cs"], max_neighbours=20, n_workers=1)
+
+    reference = VoronoiAccumulator(["Cs"], max_neighbours=20)
+    for frame in frames:
+        reference.update(frame)
+
+    assert result.n_frames == 4 and result.species == ["Cs"]
+    assert np.allclose(result.time_series("Cs"), reference.time_series("Cs"))
+    assert np.allclose(result.histograms["Cs"].counts, reference.histograms["Cs"].counts)
+    assert len(result.histograms["Cs"].counts) == 21
@@ -0,0 +1,105 @@
+import pytest
+import argparse
+import numpy as np
+
+from unittest import mock
+
+from PQAnalysis.cli.trajinfo import trajinfo, trajectory_info, format_trajectory_info, main
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_trajectory_info():
+    file = open("tmp", "w")
+    print("3 2.0 2.0 2.0", file=file)
+    print("", file=file)
+    print("O 0.0 0.0 0.0", file=file)
+    print("H 0.0 1.0 0.0", file=file)
+    print("H 1.0 0.0 0.0", file=file)
+    print("3", file=file)
+    print("", file=file)
+    print("O 0.0 0.0 0.0", file=file)
+    print("H 0.0 1.0 0.0", file=file)
+    print("H 1.0 0.0 0.0", file=file)
+    print("3 4.0 2.0 2.0 90.0 90.0 60.0", file=file)
+    print("", file=file)
+    print("O 0.0 0.0 0.0", file=file)
+    print("H 0.0 1.0 0.0", file=file)
+    print("H 1.0 0.0 0.0", file=file)
+    file.close()
+
+    info = trajectory_info("tmp", persistent_index=False)
+
+    assert info["filename"] == "tmp"
+    assert info["n_frames"] == 3
+    assert info["n_atoms"] == (3, 3)
+    assert info["species"] == {"O": 1, "H": 2}
+    assert info["constant_cell"] is False
+    assert np.allclose(info["cell"]["a"], (2.0, 4.0, 8.0 / 3.0))
+    assert np.allclose(info["cell"]["gamma"], (60.0, 90.0, 80.0))
+    assert np.allclose(info["cell"]["volume"],
+                       (8.0, 16.0 * np.sin(np.deg2rad(60.0)), (16.0 + 16.0 * np.sin(np.deg2rad(60.0))) / 3.0))
+    assert info["memory"] > 9 * 3 * 8
+
+    text = format_trajectory_info(info)
+    lines = text.split("\n")
+    assert lines[0] == "file:              tmp"
+    assert lines[1] == f"file size:         {info['file_size']} B"
+    assert lines[2] == "frames:            3"
+    assert lines[3] == "atoms:             3"
+    assert lines[4] == "species:           O: 1, H: 2"
+    assert lines[5] == "constant cell:     no"
+    assert lines[7] == "a:                       2.000000       4.000000       2.666667"
+
+    file = open("tmp2", "w")
+    print("1", file=file)
+    print("", file=file)
+    print("Ar 0.0 0.0 0.0", file=file)
+    file.close()
+
+    info = trajectory_info("tmp2", persistent_index=False)
+    assert info["cell"] is None
+    assert "cell:              no cell information" in format_trajectory_info(info)
+
+    # the dummy atom X of QMCFC is not counted
+    file = open("tmp3", "w")
+    print("3 10.0 10.0 10.0", file=file)
+    print("", file=file)
+    print("X 0.0 0.0 0.0", file=file)
+    print("O 0.0 0.0 0.0", file=file)
+    print("H 0.0 1.0 0.0", file=file)
+    file.close()
+
+    info = trajectory_info("tmp3", persistent_index=False, md_format="qmcfc")
+    assert info["n_atoms"] == (2, 2)
+    assert info["species"] == {"O": 1, "H": 1}
+    assert info["memory"] < trajectory_info("tmp3", persistent_index=False)["memory"]
+
+
+@pytest.mark.parametrize("example_dir", ["traj2box"], indirect=False)
+def test_trajinfo(test_with_data_dir, capsys):
+    trajinfo(["acof_triclinic.xyz", "acof_triclinic_2.xyz"], n_workers=2)
+
+    captured = capsys.readouterr()
+    infos = captured.out.split("\n\n")
+
+    assert len(infos) == 2
+    assert "file:              acof_triclinic.xyz\n" in infos[0]
+    assert "file:              acof_triclinic_2.xyz\n" in infos[1]
+    assert "frames:            100\n" in infos[0]
+    assert "atoms:             216\n" in infos[0]
+    assert "species:           C: 108, H: 72, N: 36\n" in infos[0]
+
+
+@pytest.mark.parametrize("example_dir", ["traj2box"], indirect=False)
+def test_main(test_with_data_dir, capsys):
+    main_trajinfo()
+
+    captured = capsys.readouterr()
+    assert captured.out.startswith("file:              acof_triclinic.xyz\n")
+
+
+@mock.patch('argparse.ArgumentParser.parse_args',
+            return_value=argparse.Namespace(trajectory_file=["acof_triclinic.xyz"], output=None, n_workers=None,
+                                            md_format="pimd-qmcf"))
+def main_trajinfo(mock_args):
+    main()
@@ -0,0 +1,74 @@
+import pytest
+import argparse
+import numpy as np
+
+from filecmp import cmp as filecmp
+from unittest import mock
+
+from PQAnalysis.cli.trajslice import trajslice, main
+from PQAnalysis.io import TrajectoryReader, RestartFileReader
+
+
+@pytest.mark.parametrize("example_dir", ["traj2qmcfc"], indirect=False)
+def test_trajslice(test_with_data_dir):
+    trajslice(["acof_triclinic.xyz"], output="test_all.xyz")
+    assert filecmp("acof_triclinic.xyz", "test_all.xyz")
+
+    trajslice(["acof_triclinic.xyz", "acof_triclinic_2.xyz"],
+              output="test_slice.xyz", start=95, stop=105, stride=3)
+
+    reader = TrajectoryReader(["acof_triclinic.xyz", "acof_triclinic_2.xyz"])
+    ref_traj = reader.read()
+
+    traj = TrajectoryReader("test_slice.xyz").read()
+    assert traj == ref_traj[95:105:3]
+
+    trajslice(["acof_triclinic.xyz", "acof_triclinic_2.xyz"],
+              output="test_frames.xyz", frames=[150, 3, -1])
+
+    traj = TrajectoryReader("test_frames.xyz").read()
+    assert traj == ref_traj[150:151] + ref_traj[3:4] + ref_traj[-1:]
+
+    trajslice(["acof_triclinic.xyz", "acof_triclinic_2.xyz"],
+              output="test_traj.qmcfc.xyz", output_md_format="qmcfc")
+    assert filecmp("traj.qmcfc.xyz", "test_traj.qmcfc.xyz")
+
+    trajslice(["acof_triclinic.xyz"], frames=[0, 5], restart="md", n_workers=2)
+
+    for frame in [0, 5]:
+        restart_frame = RestartFileReader(f"md-{frame}.rst").read()
+        assert restart_frame.cell == ref_traj[frame].cell
+        assert np.allclose(restart_frame.pos, ref_traj[frame].pos)
+        assert [atom.name for atom in restart_frame.atoms] == [
+            atom.name for atom in ref_traj[frame].atoms]
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_trajslice_inherited_cell(capsys):
+    file = open("tmp", "w")
+    print("1 1.0 1.0 1.0", file=file)
+    print("", file=file)
+    print("h 0.0 0.0 0.0", file=file)
+    print("1", file=file)
+    print("", file=file)
+    print("h 1.0 0.0 0.0", file=file)
+    file.close()
+
+    trajslice(["tmp"], frames=[1, 0])
+
+    captured = capsys.readouterr()
+    assert captured.out == "1 1.0 1.0 1.0 90.0 90.0 90.0\n\nh 1.0 0.0 0.0\n1 1.0 1.0 1.0\n\nh 0.0 0.0 0.0\n"
+
+
+@pytest.mark.parametrize("example_dir", ["traj2qmcfc"], indirect=False)
+def test_main(test_with_data_dir):
+    main_trajslice()
+
+
+@mock.patch('argparse.ArgumentParser.parse_args',
+            return_value=argparse.Namespace(trajectory_file=["acof_triclinic.xyz"], start=None, stop=None, stride=None,
+                                            frames=None, output="test_all.xyz", md_format="pimd-qmcf",
+                                            output_md_format=None, restart=None, n_workers=None))
+def main_trajslice(mock_args):
+    main()
+    assert filecmp("acof_triclinic.xyz", "test_all.xyz")
@@ -1,7 +1,7 @@
 import pytest
 import numpy as np
 
-from PQAnalysis.core import AtomicSystem, Atom, Cell, AtomicSystemPositionsError, AtomicSystemMassError
+from PQAnalysis.core import AtomicSystem, AtomicSystemView, Atom, Cell, AtomicSystemPositionsError, AtomicSystemMassError
 
 
 class TestAtomicSystem:
@@ -82,6 +82,32 @@ class TestAtomicSystem:
         assert str(
             exception.value) == AtomicSystemMassError.message
 
+    def test_astype(self):
+        atoms = [Atom('C'), Atom('H')]
+        pos = np.array([[0.1, 0.0, 0.0], [1.0, 0.0, 0.0]])
+        system = AtomicSystem(atoms=atoms, pos=pos, cell=Cell(10, 10, 10))
+
+        assert system.dtype == np.float64
+
+        system32 = system.astype(np.float32)
+        assert system32.dtype == np.float32
+        assert system32.pos.dtype == np.float32
+        assert system32.vel.dtype == np.float32
+        assert system32.charges.dtype == np.float32
+        assert system32.atoms is system.atoms
+        assert system32.cell == system.cell
+        assert system32 == system
+
+        # the center of mass is still accumulated in float64
+        assert system32.center_of_mass.dtype == np.float64
+        assert np.allclose(system32.center_of_mass, system.center_of_mass)
+
+        system32 = AtomicSystem(atoms=atoms, pos=pos, dtype=np.float32)
+        assert system32.pos.dtype == np.float32
+
+        # without a dtype the type is the one of the given arrays
+        assert AtomicSystem(atoms=atoms, vel=pos.astype(np.float32)).dtype == np.float32
+
     def test__eq__(self):
         system1 = AtomicSystem()
         system2 = AtomicSystem()
@@ -141,3 +167,47 @@ class TestAtomicSystem:
 
         assert system[Atom(6)] == AtomicSystem(vel=np.array([[0, 0, 0]]), forces=np.array([[0, 0, 0]]), charges=np.array([0]),
                                                atoms=[Atom('C')], cell=Cell(0.75, 0.75, 0.75))
+
+    def test__getitem__views(self):
+        pos = np.arange(30, dtype=np.float64).reshape(10, 3)
+        atoms = [Atom('C')] * 5 + [Atom('H')] * 5
+        system = AtomicSystem(pos=pos, atoms=atoms, cell=Cell(10, 10, 10))
+
+        # int, slice and regular index arrays are views on the positions
+        assert np.shares_memory(system[3].pos, pos)
+        assert np.shares_memory(system[1:8:2].pos, pos)
+        assert np.shares_memory(system[np.array([2, 4, 6])].pos, pos)
+        assert system[np.array([2, 4, 6])] == system[2:8:2]
+
+        # irregular index arrays are views copying the data on the first access
+        view = system[np.array([7, 1, -1])]
+        assert isinstance(view, AtomicSystemView)
+        assert view.n_atoms == 3
+
+        # modifications of the parent before the first access are visible in the view
+        pos[9] = -1.0
+        assert np.allclose(view.pos, [[21, 22, 23], [3, 4, 5], [-1, -1, -1]])
+        assert view.atoms == [Atom('H'), Atom('C'), Atom('H')]
+        assert view.cell == Cell(10, 10, 10)
+        assert view.vel.shape == (0, 3)
+
+        # views of views refer to the original system
+        subview = view[np.array([2, 0])]
+        assert subview.parent is system
+        assert np.allclose(subview.pos, pos[[9, 7]])
+
+        copy = view.copy()
+        assert not isinstance(copy, AtomicSystemView)
+        assert copy == view
+
+        # in-place modifications are kept by the view but do not modify the parent
+        view.pos[0] = 99.0
+        assert view.pos is view.pos
+        assert np.allclose(view.pos[0], [99.0, 99.0, 99.0])
+        assert np.allclose(pos[7], [21.0, 22.0, 23.0])
+        assert np.allclose(copy.pos[0], [21.0, 22.0, 23.0])
+
+        with pytest.raises(IndexError) as exception:
+            system[np.array([0, 10])]
+        assert str(
+            exception.value) == 'index 10 is out of bounds for axis 0 with size 10'
@@ -1,7 +1,7 @@
 import numpy as np
 import pytest
 
-from PQAnalysis.core import AtomicSystem, Atom, AtomicSystemPositionsError
+from PQAnalysis.core import AtomicSystem, Atom, Cell, AtomicSystemPositionsError
 
 
 class TestPositionsMixin:
@@ -57,3 +57,28 @@ class TestPositionsMixin:
             system.nearest_neighbours(n=1)
         assert str(
             exception.value) == AtomicSystemPositionsError.message
+
+    def test_distance_histogram(self):
+        positions = np.array([[0, 0, 0], [1, 0, 0], [0, 2.5, 0], [9.4, 0, 0]])
+        atoms = [Atom('O'), Atom('H'), Atom('H'), Atom('O')]
+
+        system = AtomicSystem(pos=positions, atoms=atoms, cell=Cell(10, 10, 10))
+
+        # O-O: 0.6 (through the boundary)
+        histogram = system.distance_histogram(3.0, 6, atoms1=['O'])
+        assert np.allclose(histogram, [0, 1, 0, 0, 0, 0])
+
+        # O-H: 1.0, 2.5, 1.6, sqrt(0.36 + 6.25)
+        histogram = system.distance_histogram(3.0, 6, atoms1=['O'], atoms2=['H'])
+        assert np.allclose(histogram, [0, 0, 1, 1, 0, 2])
+
+        # self pairs of atoms in both selections are not counted
+        histogram = system.distance_histogram(3.0, 6, atoms1=['O'], atoms2=np.array([0, 1]))
+        assert np.allclose(histogram, [0, 1, 1, 1, 0, 0])
+
+        histogram = system.distance_histogram(3.0, 6, atoms1=['O'], cell=Cell())
+        assert np.allclose(histogram, [0, 0, 0, 0, 0, 0])
+
+        system = AtomicSystem(atoms=atoms)
+        with pytest.raises(AtomicSystemPositionsError):
+            system.distance_histogram(3.0, 6)
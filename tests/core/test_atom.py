@@ -3,7 +3,7 @@ import numpy as np
 
 from multimethod import DispatchError
 
-from PQAnalysis.core.atom import Atom, guess_element
+from PQAnalysis.core.atom import Atom, guess_element, resolve_elements, element_symbols, element_numbers, element_masses, element_covalent_radii
 from PQAnalysis.core.exceptions import ElementNotFoundError
 
 
@@ -85,3 +85,28 @@ class TestAtom:
     def test__repr__(self):
         element = Atom('C')
         assert repr(element) == str(element)
+
+
+def test_resolve_elements():
+    codes = resolve_elements(['C', 'h', 'H', 'O', 'C'])
+    assert np.all(element_numbers[codes] == [6, 1, 1, 8, 6])
+    assert np.all(element_symbols[codes] == ['c', 'h', 'h', 'o', 'c'])
+    assert np.allclose(element_masses[codes], [
+                       12.0107, 1.00794, 1.00794, 15.9994, 12.0107])
+    assert np.allclose(element_covalent_radii[codes], [
+                       0.76, 0.31, 0.31, 0.66, 0.76])
+
+    assert resolve_elements([]).shape == (0,)
+
+    with pytest.raises(ElementNotFoundError) as exception:
+        resolve_elements(['C', 'C1'])
+    assert str(exception.value) == "Id C1 is not a valid element identifier."
+
+    codes = resolve_elements(np.array(['C1', 'D']), strict=False)
+    assert codes[0] == -1
+    assert element_numbers[codes[1]] == 1
+    assert element_symbols[codes[1]] == 'd'
+
+    # the first symbol of an atomic number is used for int identifiers
+    assert guess_element(1)[0] == 'h'
+    assert guess_element(103)[0] == 'lr'
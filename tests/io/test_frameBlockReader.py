@@ -0,0 +1,72 @@
+import pytest
+
+from PQAnalysis.io import FrameBlockReader
+from PQAnalysis.io.exceptions import TrajectoryReaderError
+
+
+class TestFrameBlockReader:
+    @pytest.mark.usefixtures("tmpdir")
+    def test__iter__(self):
+        frames = [
+            "2 1.0 1.0 1.0\n\nh 0.0 0.0 0.0\no 0.0 1.0 0.0\n",
+            "2\n1 comment starting with a digit\nh 1.0 0.0 0.0\no 0.0 1.0 1.0\n",
+            "1\n\nh 1.0 0.0 0.0\n",
+        ]
+
+        with open("tmp", "w") as file:
+            file.write(frames[0] + "\n" + frames[1] + frames[2])
+
+        for block_size in [1, 7, 64, 1 << 24]:
+            reader = FrameBlockReader("tmp", block_size=block_size)
+            assert [frame.decode() for frame in reader] == frames
+
+        # the last line break and incomplete frames are passed on to the parser
+        with open("tmp", "w") as file:
+            file.write(frames[0] + frames[2][:-1])
+        assert [frame.decode() for frame in FrameBlockReader("tmp")] == [
+            frames[0], frames[2]]
+
+        with open("tmp", "w") as file:
+            file.write(frames[0] + "3\n\nh 1.0 0.0 0.0\n")
+        assert [frame.decode() for frame in FrameBlockReader("tmp", block_size=5)] == [
+            frames[0], "3\n\nh 1.0 0.0 0.0\n"]
+
+        with open("tmp", "w") as file:
+            file.write(frames[0] + "h 1.0 0.0 0.0\n")
+        with pytest.raises(TrajectoryReaderError) as exception:
+            list(FrameBlockReader("tmp"))
+        assert str(exception.value) == "Invalid header line of frame: 'h 1.0 0.0 0.0'."
+
+        # stopping early does not block the read-ahead thread
+        reader = iter(FrameBlockReader("tmp", block_size=1, prefetch=1))
+        assert next(reader).decode() == frames[0]
+        reader.close()
+
+        with pytest.raises(FileNotFoundError):
+            list(FrameBlockReader("missing"))
+
+        with pytest.raises(ValueError) as exception:
+            FrameBlockReader("tmp", block_size=0)
+        assert str(exception.value) == "block_size and prefetch have to be at least 1."
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test__iter__large_frames(self, monkeypatch):
+        frame = "1000\n\n" + "h 1.0 0.0 0.0\n" * 1000
+
+        with open("tmp", "w") as file:
+            file.write(frame * 3)
+
+        calls = []
+        split_frames = FrameBlockReader._split_frames
+
+        def counting_split_frames(buffer):
+            calls.append(len(buffer))
+            return split_frames(buffer)
+
+        monkeypatch.setattr(FrameBlockReader, "_split_frames", staticmethod(counting_split_frames))
+
+        assert [block.decode() for block in FrameBlockReader("tmp", block_size=64)] == [frame] * 3
+
+        # the blocks of a frame larger than a block are joined only once the frame is complete
+        assert len(calls) <= 6
+        assert sum(calls) < 2 * len(frame) * 3
@@ -0,0 +1,35 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.io.frameBufferRing import FrameBufferRing
+
+
+class TestFrameBufferRing:
+    def test__init__(self):
+        ring = FrameBufferRing(2, dtype=np.float32)
+        assert ring.n_buffers == 2
+        assert ring.dtype == np.float32
+
+        with pytest.raises(ValueError) as exception:
+            FrameBufferRing(0)
+        assert str(exception.value) == "n_buffers has to be at least 1."
+
+    def test_next(self):
+        ring = FrameBufferRing(2)
+
+        buffer1 = ring.next((4, 3))
+        buffer2 = ring.next((4, 3))
+        buffer3 = ring.next((2, 3))
+
+        assert buffer1.shape == (4, 3)
+        assert buffer3.shape == (2, 3)
+        assert buffer1.dtype == np.float64
+        assert not np.shares_memory(buffer1, buffer2)
+        assert np.shares_memory(buffer1, buffer3)
+
+        # a larger request reallocates the buffer
+        buffer4 = ring.next(20)
+        assert buffer4.shape == (20,)
+        assert not np.shares_memory(buffer2, buffer4)
+        assert not np.shares_memory(buffer4, ring.next(10))
+        assert np.shares_memory(buffer4, ring.next(5))
@@ -48,6 +48,57 @@ class TestFrameReader:
             ["", "", "h 1.0 2.0 3.0", "o 2.0 2.0 2.0"], n_atoms=2)
         assert np.allclose(xyz, [[1.0, 2.0, 3.0], [2.0, 2.0, 2.0]])
         assert atoms == ["h", "o"]
+        assert xyz.dtype == np.float64
+
+        reader = FrameReader(dtype=np.float32)
+        xyz, atoms = reader._read_xyz(
+            ["", "", "h 1.0 2.0 3.0", "o 2.0 2.0 2.0"], n_atoms=2)
+        assert np.allclose(xyz, [[1.0, 2.0, 3.0], [2.0, 2.0, 2.0]])
+        assert xyz.dtype == np.float32
+
+        scalar, atoms = reader._read_scalar(["", "", "h 1.0"], n_atoms=1)
+        assert scalar.dtype == np.float32
+
+        xyz, atoms = reader._read_xyz(["", ""], n_atoms=0)
+        assert xyz.shape == (0, 3)
+        assert atoms == []
+
+    def test_read_dtype(self):
+        # all arrays of a velocity-only frame have the type of the reader
+        reader = FrameReader(dtype=np.float32)
+        frame = reader.read("2 10 10 10\n\nh 1.0 2.0 3.0\no 2.0 2.0 2.0", format=TrajectoryFormat.VEL)
+
+        assert np.allclose(frame.vel, [[1.0, 2.0, 3.0], [2.0, 2.0, 2.0]])
+        assert frame.dtype == np.float32
+        for array in (frame.pos, frame.vel, frame.forces, frame.charges):
+            assert array.dtype == np.float32
+
+        frame = FrameReader().read("1\n\nh 1.0", format=TrajectoryFormat.CHARGE)
+        assert frame.dtype == np.float64 and frame.charges.dtype == np.float64
+
+    def test_buffers(self):
+        reader = FrameReader()
+        assert reader.buffers is None
+
+        frame1 = reader.read("2\n\nh 1.0 2.0 3.0\no 2.0 2.0 2.0")
+        frame2 = reader.read("2\n\nh 1.0 2.0 3.0\no 2.0 2.0 2.0")
+        assert not np.shares_memory(frame1.pos, frame2.pos)
+        assert frame1.atoms is not frame2.atoms
+
+        reader = FrameReader(n_buffers=1)
+        assert reader.buffers.n_buffers == 1
+
+        frame1 = reader.read("2\n\nh 1.0 2.0 3.0\no 2.0 2.0 2.0")
+        assert np.allclose(frame1.pos, [[1.0, 2.0, 3.0], [2.0, 2.0, 2.0]])
+
+        frame2 = reader.read("2\n\nh 3.0 2.0 1.0\no 2.0 2.0 2.0")
+        assert np.shares_memory(frame1.pos, frame2.pos)
+        assert np.allclose(frame1.pos, [[3.0, 2.0, 1.0], [2.0, 2.0, 2.0]])
+        assert frame1.atoms is frame2.atoms
+
+        frame3 = reader.read("1\n\nC 1.0", format="charge")
+        assert np.allclose(frame3.charges, [1.0])
+        assert frame3.atoms == [Atom("C")]
 
     def test__read_scalar(self):
         reader = FrameReader()
@@ -0,0 +1,118 @@
+import pytest
+import os
+import numpy as np
+
+from PQAnalysis.io import TrajectoryIndex, TrajectoryIndexError
+from PQAnalysis.core import Cell
+
+
+def write_test_trajectory(filename="tmp"):
+    file = open(filename, "w")
+    print("2 1.0 2.0 3.0", file=file)
+    print("", file=file)
+    print("h 0.0 0.0 0.0", file=file)
+    print("o 0.0 1.0 0.0", file=file)
+    print("", file=file)
+    print("2", file=file)
+    print("comment", file=file)
+    print("h 1.0 0.0 0.0", file=file)
+    print("o 0.0 1.0 1.0", file=file)
+    print("1 2.0 2.0 2.0 90.0 90.0 120.0", file=file)
+    print("", file=file)
+    print("h 1.0 1.0 0.0", file=file)
+    file.close()
+
+
+class TestTrajectoryIndex:
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_build(self):
+        write_test_trajectory()
+
+        index = TrajectoryIndex.build("tmp")
+
+        assert index.n_frames == 3
+        assert len(index) == 3
+        assert np.allclose(index.n_atoms, [2, 2, 1])
+        assert index.offsets[-1] == os.path.getsize("tmp")
+        assert np.allclose(index.cells[0], [1.0, 2.0, 3.0, 90.0, 90.0, 90.0])
+        assert np.all(np.isnan(index.cells[1]))
+        assert np.allclose(index.cells[2], [2.0, 2.0, 2.0, 90.0, 90.0, 120.0])
+
+        assert index.read_bytes(1) == b"2\ncomment\nh 1.0 0.0 0.0\no 0.0 1.0 1.0\n"
+        assert index.read_bytes(-1) == b"1 2.0 2.0 2.0 90.0 90.0 120.0\n\nh 1.0 1.0 0.0\n"
+
+        cells = index.effective_cells()
+        assert cells[0] == Cell(1.0, 2.0, 3.0)
+        assert cells[1] == Cell(1.0, 2.0, 3.0)
+        assert cells[2] == Cell(2.0, 2.0, 2.0, 90.0, 90.0, 120.0)
+
+        assert index.effective_cells(np.array([2, 1])) == [cells[2], cells[1]]
+        assert np.allclose(index.effective_cell_parameters()[1], [1.0, 2.0, 3.0, 90.0, 90.0, 90.0])
+
+        with open("tmp", "rb") as file:
+            assert index.read_bytes(1, file) == index.read_bytes(1)
+            assert index.read_bytes(0, file) == b"2 1.0 2.0 3.0\n\nh 0.0 0.0 0.0\no 0.0 1.0 0.0\n\n"
+
+        file = open("tmp", "a")
+        print("2", file=file)
+        print("", file=file)
+        print("h 1.0 1.0 0.0", file=file)
+        file.close()
+
+        with pytest.raises(TrajectoryIndexError) as exception:
+            TrajectoryIndex.build("tmp")
+        assert str(
+            exception.value) == "The last frame of trajectory file tmp is incomplete."
+
+        file = open("tmp", "w")
+        print("2 1.0 2.0", file=file)
+        file.close()
+
+        with pytest.raises(TrajectoryIndexError) as exception:
+            TrajectoryIndex.build("tmp")
+        assert str(
+            exception.value) == "Invalid header line of frame: '2 1.0 2.0'."
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_from_file(self):
+        write_test_trajectory()
+
+        index = TrajectoryIndex.from_file("tmp", persistent=False)
+        assert not os.path.isfile("tmp.pqidx")
+
+        index = TrajectoryIndex.from_file("tmp")
+        assert os.path.isfile("tmp.pqidx")
+
+        loaded = TrajectoryIndex.load("tmp")
+        assert np.all(loaded.offsets == index.offsets)
+        assert np.all(loaded.n_atoms == index.n_atoms)
+        assert np.allclose(loaded.cells, index.cells, equal_nan=True)
+
+        # a modified trajectory file invalidates the stored index
+        file = open("tmp", "a")
+        print("1", file=file)
+        print("", file=file)
+        print("h 1.0 1.0 0.0", file=file)
+        file.close()
+
+        assert TrajectoryIndex.load("tmp") is None
+        assert TrajectoryIndex.from_file("tmp").n_frames == 4
+        assert TrajectoryIndex.load("tmp").n_frames == 4
+
+        assert TrajectoryIndex.load("tmp", "not_existing.pqidx") is None
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_frame_indices(self):
+        write_test_trajectory()
+
+        index = TrajectoryIndex.build("tmp")
+
+        assert np.all(index.frame_indices(slice(None, None, 2)) == [0, 2])
+        assert np.all(index.frame_indices([2, -3]) == [2, 0])
+        assert np.all(index.frame_indices(1) == [1])
+
+        with pytest.raises(IndexError) as exception:
+            index.frame_indices([3])
+        assert str(
+            exception.value) == "Frame index out of range for trajectory with 3 frames."
@@ -1,6 +1,8 @@
 import pytest
 import numpy as np
 
+from unittest import mock
+
 from PQAnalysis.io import TrajectoryReader
 from PQAnalysis.io.exceptions import TrajectoryReaderError
 from PQAnalysis.traj import Frame
@@ -46,10 +48,16 @@ class TestTrajectoryReader:
             atoms=atoms, pos=np.array([[1.0, 0.0, 0.0], [0.0, 1.0, 1.0]]), cell=cell))
 
         assert traj[0] == frame1
+        assert traj[0].dtype == np.float64
         # NOTE: here cell is not none because of the consecutive reading of frames
         # Cell will be taken from the previous frame
         assert traj[1] == frame2
 
+        traj32 = TrajectoryReader("tmp", dtype=np.float32).read()
+        assert traj32 == traj
+        assert traj32[0].dtype == np.float32
+        assert traj32[1].dtype == np.float32
+
         reader = TrajectoryReader("tmp")
 
         with pytest.raises(TrajectoryReaderError) as exception:
@@ -89,3 +97,99 @@ class TestTrajectoryReader:
         traj = reader.read(md_format="qmcfc")
 
         assert traj == ref_traj
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_read_frames(self):
+
+        file = open("tmp", "w")
+        print("2 1.0 1.0 1.0", file=file)
+        print("", file=file)
+        print("X 0.0 0.0 0.0", file=file)
+        print("o 0.0 1.0 0.0", file=file)
+        print("2", file=file)
+        print("", file=file)
+        print("X 1.0 0.0 0.0", file=file)
+        print("o 0.0 1.0 1.0", file=file)
+        print("2 2.0 2.0 2.0", file=file)
+        print("", file=file)
+        print("X 1.0 0.0 0.0", file=file)
+        print("o 0.0 0.0 1.0", file=file)
+        file.close()
+
+        reader = TrajectoryReader("tmp")
+        ref_traj = reader.read()
+
+        assert reader.read_frames(slice(None)) == ref_traj
+        assert reader.read_frames([2, 0]) == ref_traj[2:0:-2] + ref_traj[0:1]
+
+        # the cell of the second frame is inherited from the first frame
+        # even if the first frame is not read
+        traj = reader.read_frames(1)
+        assert len(traj) == 1
+        assert traj[0] == ref_traj[1]
+        assert traj[0].cell == Cell(1.0, 1.0, 1.0)
+
+        traj = reader.read_frames([1], md_format="qmcfc")
+        assert traj[0] == ref_traj[1][1]
+
+        reader = TrajectoryReader(["tmp", "tmp"])
+        traj = reader.read_frames(np.array([0, 3, 5]))
+        assert traj == ref_traj[0:1] + ref_traj[0:1] + ref_traj[2:3]
+
+        # the trajectory file is opened once for all frames (the stored index is loaded)
+        with mock.patch("builtins.open", wraps=open) as opened:
+            traj = reader.read_frames(np.array([5, 0, 4, 1]))
+        assert traj == ref_traj[2:3] + ref_traj[0:2] + ref_traj[1:2]
+        assert [call.args[0] for call in opened.call_args_list].count("tmp") == 1
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_iter_frames(self):
+
+        file = open("tmp", "w")
+        print("2 1.0 1.0 1.0", file=file)
+        print("", file=file)
+        print("X 0.0 0.0 0.0", file=file)
+        print("o 0.0 1.0 0.0", file=file)
+        print("2", file=file)
+        print("", file=file)
+        print("X 1.0 0.0 0.0", file=file)
+        print("o 0.0 1.0 1.0", file=file)
+        print("2 2.0 2.0 2.0", file=file)
+        print("", file=file)
+        print("X 1.0 0.0 0.0", file=file)
+        print("o 0.0 0.0 1.0", file=file)
+        file.close()
+
+        reader = TrajectoryReader("tmp")
+        ref_traj = reader.read()
+
+        assert list(reader.iter_frames()) == ref_traj.frames
+        assert list(reader.iter_frames(md_format="qmcfc")) == [
+            frame[1:] for frame in ref_traj]
+
+        # every frame is valid until n_buffers further frames are read
+        frames = reader.iter_frames(n_buffers=2)
+        frame1 = next(frames)
+        frame2 = next(frames)
+        assert frame1 == ref_traj[0]
+        assert frame2 == ref_traj[1]
+        assert frame2.cell == Cell(1.0, 1.0, 1.0)
+        assert frame1.atoms is frame2.atoms
+
+        frame3 = next(frames)
+        assert frame3 == ref_traj[2]
+        assert np.shares_memory(frame1.pos, frame3.pos)
+
+        assert list(reader.iter_frames(frames=slice(1, 3))) == ref_traj.frames[1:3]
+        assert list(reader.iter_frames(frames=[2, 0], n_buffers=2)) == [
+            ref_traj[2], ref_traj[0]]
+
+        reader = TrajectoryReader("tmp", read_ahead=True)
+        assert reader.read() == ref_traj
+        assert list(reader.iter_frames(md_format="qmcfc", n_buffers=1))[-1] == ref_traj[2][1:]
+
+        reader = TrajectoryReader(["tmp", "tmp"], dtype=np.float32)
+        frames = [frame.pos.copy() for frame in reader.iter_frames(n_buffers=1)]
+        assert len(frames) == 6
+        assert frames[0].dtype == np.float32
+        assert np.allclose(frames[4], ref_traj[1].pos)
@@ -163,3 +163,49 @@ or their case insensitive string representation: {MDEngineFormat.value_repr()}""
 
         captured = capsys.readouterr()
         assert captured.out == "2 10 10 10 90 90 90\n\nh 1\no 2\n2 11 10 10 90 90 90\n\nh 3\no 4\n"
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_write_parallel(self):
+
+        rng = np.random.default_rng(42)
+        atoms = [Atom(atom) for atom in ['h', 'o', 'c']]
+
+        frames = []
+        for i in range(7):
+            cell = Cell(10, 10, 10) if i % 2 == 0 else Cell()
+            frames.append(Frame(AtomicSystem(atoms=atoms,
+                                             pos=rng.random((3, 3)),
+                                             vel=rng.random((3, 3)).astype(np.float32),
+                                             forces=rng.random((3, 3)),
+                                             charges=rng.random(3),
+                                             cell=cell)))
+        traj = Trajectory(frames)
+
+        # one pool of the writer formats all types, also across several writes
+        with TrajectoryWriter("parallel", format=MDEngineFormat.QMCFC, n_workers=2, chunk_size=3) as writer:
+            executors = set()
+            for type in TrajectoryFormat:
+                writer.write(traj, type=type)
+                executors.add(id(writer._executor))
+
+            assert len(executors) == 1 and writer._executor is not None
+
+        assert writer._executor is None
+
+        sequential = TrajectoryWriter("sequential", format=MDEngineFormat.QMCFC)
+        for type in TrajectoryFormat:
+            sequential.write(traj, type=type)
+
+        with open("sequential") as sequential, open("parallel") as parallel:
+            assert parallel.read() == sequential.read()
+
+        # the default chunks split the frames evenly
+        TrajectoryWriter("sequential-xyz").write(traj)
+        with TrajectoryWriter("parallel-xyz", n_workers=2) as writer:
+            writer.write(traj)
+
+        with open("sequential-xyz") as sequential, open("parallel-xyz") as parallel:
+            assert parallel.read() == sequential.read()
+
+        writer = TrajectoryWriter(n_workers=None)
+        assert writer.n_workers >= 1
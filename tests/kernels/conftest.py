@@ -0,0 +1,11 @@
+import pytest
+
+from PQAnalysis.kernels import available_backends, get_backend, set_backend
+
+
+@pytest.fixture(params=available_backends())
+def backend(request):
+    previous = get_backend()
+    set_backend(request.param)
+    yield request.param
+    set_backend(previous)
@@ -0,0 +1,200 @@
+import os
+import subprocess
+import sys
+
+import pytest
+import numpy as np
+
+from PQAnalysis.core import Cell
+from PQAnalysis.kernels import (
+    KernelBackendError,
+    CellList,
+    available_backends,
+    get_backend,
+    set_backend,
+    minimum_image,
+    paired_distances,
+    distances,
+    distance_histogram,
+    cutoff_pairs,
+)
+
+
+def reference_distances(pos1, pos2, cell):
+    dpos = pos1[:, None, :] - pos2[None, :, :]
+    inv_box = np.linalg.inv(cell.box_matrix)
+    fractional_pos = np.einsum('ij,abj->abi', inv_box, dpos)
+    fractional_pos -= np.round(fractional_pos)
+    dpos = np.einsum('ij,abj->abi', cell.box_matrix, fractional_pos)
+    return np.linalg.norm(dpos, axis=2)
+
+
+@pytest.fixture
+def system():
+    rng = np.random.default_rng(42)
+    cell = Cell(10, 11, 12, 80, 95, 110)
+    pos1 = rng.uniform(-5, 15, (50, 3))
+    pos2 = rng.uniform(-5, 15, (40, 3))
+    return cell, pos1, pos2
+
+
+def test_backends():
+    assert "numpy" in available_backends()
+
+    with pytest.raises(KernelBackendError) as exception:
+        set_backend("fortran")
+    assert str(exception.value).startswith(
+        "Unknown kernel backend 'fortran'.")
+
+
+def test_backends_lazy_import():
+    # the numba backend is only imported when it is selected or the backends are listed
+    script = ("import sys; from PQAnalysis.kernels import get_backend; get_backend(); "
+              "print('PQAnalysis.kernels._numba' in sys.modules, 'numba' in sys.modules)")
+
+    environment = dict(os.environ, PQANALYSIS_KERNEL_BACKEND="numpy")
+    output = subprocess.run([sys.executable, "-c", script], capture_output=True, text=True,
+                            env=environment, timeout=120, check=True)
+
+    assert output.stdout.split() == ["False", "False"]
+
+
+def test_minimum_image(backend, system):
+    cell, pos1, pos2 = system
+
+    dpos = pos1[:40] - pos2
+    imaged = minimum_image(dpos, cell.box_matrix)
+
+    assert imaged.shape == (40, 3)
+    assert np.allclose(np.linalg.norm(imaged, axis=1), np.diag(
+        reference_distances(pos1[:40], pos2, cell)))
+    assert np.allclose(cell.image(dpos), imaged)
+
+
+def test_paired_distances(backend, system):
+    cell, pos1, pos2 = system
+
+    assert np.allclose(paired_distances(pos1[:40], pos2, cell.box_matrix),
+                       np.diag(reference_distances(pos1[:40], pos2, cell)))
+    assert np.allclose(paired_distances(pos1[:40], pos2),
+                       np.linalg.norm(pos1[:40] - pos2, axis=1))
+
+    with pytest.raises(ValueError):
+        paired_distances(pos1, pos2)
+
+
+def test_distances(backend, system):
+    cell, pos1, pos2 = system
+
+    assert np.allclose(distances(pos1, pos2, cell.box_matrix),
+                       reference_distances(pos1, pos2, cell))
+    assert np.allclose(distances(pos1, pos2),
+                       np.linalg.norm(pos1[:, None] - pos2[None], axis=2))
+
+
+def test_distance_histogram(backend, system):
+    cell, pos1, pos2 = system
+
+    r = reference_distances(pos1, pos2, cell)
+    hist = distance_histogram(pos1, pos2, 6.0, 12, cell.box_matrix)
+    assert hist.dtype == np.float64
+    assert np.allclose(hist, np.histogram(r, bins=12, range=(0, 6))[0])
+
+    r = reference_distances(pos1, pos1, cell)[np.triu_indices(len(pos1), 1)]
+    hist = distance_histogram(pos1, None, 6.0, 10, cell.box_matrix, r_min=1.0)
+    assert np.allclose(hist, np.histogram(r, bins=10, range=(1, 6))[0])
+
+    with pytest.raises(ValueError):
+        distance_histogram(pos1, pos2, 1.0, 0)
+
+
+def test_cutoff_pairs(backend, system):
+    cell, pos1, pos2 = system
+
+    r = reference_distances(pos1, pos2, cell)
+    pairs, pair_distances = cutoff_pairs(pos1, pos2, 4.0, cell.box_matrix)
+    assert np.all(pairs == np.argwhere(r < 4.0))
+    assert np.allclose(pair_distances, r[r < 4.0])
+
+    r = reference_distances(pos1, pos1, cell)
+    pairs, pair_distances = cutoff_pairs(pos1, None, 4.0, cell.box_matrix)
+    assert np.all(pairs == np.argwhere(np.triu(r < 4.0, 1)))
+    assert np.allclose(pair_distances, r[np.triu(r < 4.0, 1)])
+
+    pairs, pair_distances = cutoff_pairs(pos1, pos2, 0.0, cell.box_matrix)
+    assert pairs.shape == (0, 2)
+    assert pair_distances.shape == (0,)
+
+
+def test_cutoff_pairs_cell_list(backend):
+    rng = np.random.default_rng(7)
+    cell = Cell(16, 17, 18, 85, 95, 100)
+    pos1 = rng.uniform(-2, 20, (300, 3))
+    pos2 = rng.uniform(-2, 20, (200, 3))
+
+    assert CellList.is_usable(cell.box_matrix, 4.0)
+
+    r = reference_distances(pos1, pos2, cell)
+    pairs, pair_distances = cutoff_pairs(pos1, pos2, 4.0, cell.box_matrix)
+    assert np.all(pairs == np.argwhere(r < 4.0))
+    assert np.allclose(pair_distances, r[r < 4.0])
+
+    r = reference_distances(pos1, pos1, cell)
+    pairs, pair_distances = cutoff_pairs(pos1, None, 4.0, cell.box_matrix)
+    assert np.all(pairs == np.argwhere(np.triu(r < 4.0, 1)))
+    assert np.allclose(pair_distances, r[np.triu(r < 4.0, 1)])
+
+
+def test_cell_list():
+    box_matrix = Cell(10, 11, 12, 80, 95, 110).box_matrix
+
+    assert np.all(CellList.grid_shape(box_matrix, 3.2) == [2, 3, 3])
+    assert not CellList.is_usable(box_matrix, 3.2)
+    assert CellList.is_usable(box_matrix, 3.0)
+    assert np.all(CellList.grid_shape(Cell().box_matrix, 3.0) == [1, 1, 1])
+
+    # small cutoffs in large cells are limited to max_cells coarser cells
+    shape = CellList.grid_shape(np.eye(3) * 100.0, 0.05)
+    assert np.prod(shape) <= CellList.max_cells
+    assert np.all(shape == shape[0]) and shape[0] >= 3
+
+    rng = np.random.default_rng(0)
+    pos = rng.uniform(-5, 15, (100, 3))
+    cells = CellList(pos, box_matrix, 2.5)
+
+    assert cells.n_atoms == 100
+    assert cells.offsets[-1] == 100
+    assert np.all(np.diff(cells.offsets) >= 0)
+    assert np.allclose(cells.sorted_pos, pos[cells.order].T)
+
+
+def test_cell_list_histogram(backend):
+    rng = np.random.default_rng(7)
+    cell = Cell(20, 21, 22, 85, 95, 100)
+    pos1 = rng.uniform(0, 20, (400, 3))
+    pos2 = rng.uniform(0, 20, (300, 3))
+
+    # a cell list is used if the backend supports it, the result is the same
+    r = reference_distances(pos1, pos2, cell)
+    hist = distance_histogram(pos1, pos2, 5.0, 50, cell.box_matrix)
+    assert np.all(hist == np.histogram(r, bins=50, range=(0, 5))[0])
+
+    r = reference_distances(pos1, pos1, cell)[np.triu_indices(len(pos1), 1)]
+    hist = distance_histogram(pos1, None, 5.0, 50, cell.box_matrix, r_min=0.5)
+    assert np.all(hist == np.histogram(r, bins=50, range=(0.5, 5))[0])
+
+
+def test_small_cutoff_large_cell(backend):
+    rng = np.random.default_rng(3)
+    cell = Cell(100, 100, 100)
+    pos = rng.uniform(0, 100, (200, 3))
+    pos[1] = pos[0] + 0.01
+
+    r = reference_distances(pos, pos, cell)
+
+    pairs, pair_distances = cutoff_pairs(pos, None, 0.05, cell.box_matrix)
+    assert np.all(pairs == np.argwhere(np.triu(r < 0.05, 1)))
+    assert np.allclose(pair_distances, r[np.triu(r < 0.05, 1)])
+
+    hist = distance_histogram(pos, None, 0.05, 5, cell.box_matrix)
+    assert np.all(hist == np.histogram(r[np.triu_indices(200, 1)], bins=5, range=(0, 0.05))[0])
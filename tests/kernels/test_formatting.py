@@ -0,0 +1,34 @@
+import numpy as np
+
+from PQAnalysis.kernels import format_restart_lines, format_atom_lines
+
+
+def test_format_restart_lines(backend):
+    pos = np.array([[0.1, 1.0, 2.0], [3.5, -4.0, 1e-05]])
+    vel = np.zeros((2, 3))
+    forces = np.array([[1, 2, 3], [4, 5, 6]])
+
+    lines = format_restart_lines(['O', 'H'], np.array([1, 2]), pos, vel, forces)
+    assert lines == ["O    0    1    0.1 1.0 2.0 0.0 0.0 0.0 1 2 3 ",
+                     "H    1    2    3.5 -4.0 1e-05 0.0 0.0 0.0 4 5 6 "]
+
+    lines = format_restart_lines(['O'], np.array([0]), pos[:1], vel[:1], forces[:1], extended=True)
+    assert lines == [
+        "O    0    0    0.1 1.0 2.0 0.0 0.0 0.0 1 2 3 0.1 1.0 2.0 0.0 0.0 0.0 1 2 3"]
+
+    # float32 values keep their shortest representation
+    lines = format_restart_lines(['O'], np.array([0]), pos[:1].astype(np.float32), vel[:1], forces[:1])
+    assert lines == ["O    0    0    0.1 1.0 2.0 0.0 0.0 0.0 1 2 3 "]
+
+    assert format_restart_lines([], np.array([], dtype=int), np.zeros((0, 3)),
+                                np.zeros((0, 3)), np.zeros((0, 3))) == []
+
+
+def test_format_atom_lines(backend):
+    pos = np.array([[0.1, 1.0, 2.0], [3.5, -4.0, 1e-05]])
+
+    assert format_atom_lines(['O', 'H'], pos) == ["O 0.1 1.0 2.0", "H 3.5 -4.0 1e-05"]
+    assert format_atom_lines(['O', 'H'], np.array([1, 2])) == ["O 1", "H 2"]
+    assert format_atom_lines(['O'], pos[:1].astype(np.float32)) == [
+        f"O {np.float32(0.1)} 1.0 2.0"]
+    assert format_atom_lines([], np.zeros((0, 3))) == []
@@ -0,0 +1,27 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.kernels import connected_components
+
+
+def test_connected_components(backend):
+    edges = np.array([[5, 3], [1, 0], [3, 7], [8, 9], [7, 2]])
+
+    labels = connected_components(10, edges)
+
+    assert np.all(labels == [0, 0, 2, 2, 4, 2, 6, 2, 8, 8])
+    assert np.all(connected_components(3, np.zeros((0, 2), dtype=np.int64)) == [0, 1, 2])
+
+    # the labels do not depend on the order of the edges
+    rng = np.random.default_rng(3)
+    edges = rng.integers(0, 500, (400, 2))
+    labels = connected_components(500, edges)
+
+    assert np.all(connected_components(500, edges[rng.permutation(400)][:, ::-1]) == labels)
+    assert np.all(labels[edges[:, 0]] == labels[edges[:, 1]])
+    assert np.all(labels <= np.arange(500))
+    assert np.all(labels[labels] == labels)
+
+    with pytest.raises(ValueError) as exception:
+        connected_components(3, np.array([[0, 3]]))
+    assert str(exception.value) == "The edges have to connect nodes between 0 and 2."
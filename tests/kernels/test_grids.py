@@ -0,0 +1,94 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.core import Cell
+from PQAnalysis.kernels import fractional_grid, surface_distances, covering_diameters, distances
+
+
+def test_fractional_grid():
+    cell = Cell(10, 12, 7, 80, 95, 120)
+
+    points, shape = fractional_grid(cell.box_matrix, 0.9)
+
+    assert np.all(shape == [12, 14, 8])
+    assert points.shape == (12 * 14 * 8, 3)
+
+    # the points are the centers of the grid cells in fractional coordinates
+    fractional = points @ np.linalg.inv(cell.box_matrix).T
+    assert np.allclose(fractional[0], 0.5 / shape)
+    assert np.allclose(np.mean(fractional, axis=0), 0.5)
+    assert np.all((fractional > 0.0) & (fractional < 1.0))
+
+    with pytest.raises(ValueError) as exception:
+        fractional_grid(cell.box_matrix, 0.0)
+    assert str(exception.value) == "The spacing of a grid has to be positive."
+
+
+@pytest.mark.parametrize("cell", [Cell(15, 16, 17), Cell(15, 16, 17, 75, 100, 110), None])
+def test_surface_distances(cell):
+    rng = np.random.default_rng(11)
+    box_matrix = None if cell is None else cell.box_matrix
+
+    pos = rng.uniform(0, 15, (300, 3))
+    points = rng.uniform(-3, 18, (500, 3))
+    radii = rng.uniform(0.5, 2.0, 300)
+
+    for atom_radii in (None, radii):
+        surface, atoms = surface_distances(points, pos, atom_radii, box_matrix)
+
+        reference = distances(points, pos, box_matrix)
+        if atom_radii is not None:
+            reference -= atom_radii
+
+        assert np.allclose(surface, np.min(reference, axis=1))
+        assert np.all(atoms == np.argmin(reference, axis=1))
+
+    # a point in a large void needs several searches
+    surface, atoms = surface_distances(np.array([[50.0, 50.0, 50.0]]),
+                                       np.array([[0.0, 0.0, 0.0], [1.0, 0.0, 0.0]]), np.array([1.0, 0.5]))
+    assert np.isclose(surface[0], np.sqrt(49.0**2 + 2 * 50.0**2) - 0.5) and atoms[0] == 1
+
+    with pytest.raises(ValueError) as exception:
+        surface_distances(points, np.zeros((0, 3)))
+    assert str(exception.value) == "The surface distances need at least one atom."
+
+    with pytest.raises(ValueError) as exception:
+        surface_distances(points, pos, np.ones(3))
+    assert str(exception.value) == "The surface distances need one radius per atom."
+
+
+def test_covering_diameters():
+    cell = Cell(6, 7, 5, 80, 95, 110)
+    points, shape = fractional_grid(cell.box_matrix, 0.8)
+
+    rng = np.random.default_rng(5)
+    surface = rng.uniform(-0.5, 1.5, len(points))
+    edges = np.linspace(0.0, 2.5, 11)
+
+    diameters = covering_diameters(surface, shape, cell.box_matrix, edges)
+
+    # the largest covering sphere of each point with the radii rounded down to the edges
+    levels = np.searchsorted(edges, 2.0 * surface, side="right") - 1
+    covering = distances(points, points, cell.box_matrix) <= 0.5 * edges[levels] * (1.0 + 1e-10)
+    covering &= (surface > 0.0)
+    reference = np.max(np.where(covering, levels, -1), axis=1)
+
+    centers = np.append(0.5 * (edges[:-1] + edges[1:]), np.inf)
+    assert np.all(diameters == np.where(surface > 0.0, centers[reference], 0.0))
+
+    # all points of a spherical pore are covered by the sphere in its center, a grid point
+    cell = Cell(10, 10, 10)
+    points, shape = fractional_grid(cell.box_matrix, 0.25)
+    surface = 4.0 - np.linalg.norm(points - 5.125, axis=1)
+
+    diameters = covering_diameters(surface, shape, cell.box_matrix, np.linspace(0.0, 10.0, 51))
+    assert np.allclose(diameters[surface > 0.0], 8.1)
+    assert np.all(diameters[surface <= 0.0] == 0.0)
+
+    with pytest.raises(ValueError) as exception:
+        covering_diameters(surface[1:], shape, cell.box_matrix, np.linspace(0.0, 10.0, 51))
+    assert str(exception.value) == "The covering diameters need one distance per grid point."
+
+    with pytest.raises(ValueError) as exception:
+        covering_diameters(surface, shape, cell.box_matrix, np.linspace(1.0, 10.0, 51))
+    assert str(exception.value) == "The edges of the covering diameters have to increase from 0."
@@ -0,0 +1,25 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.core import Cell, Atom, AtomicSystem
+from PQAnalysis.kernels import group_centers_of_mass
+
+
+def test_group_centers_of_mass(backend):
+    rng = np.random.default_rng(3)
+    cell = Cell(8, 9, 10, 80, 95, 105)
+
+    atoms = [Atom('O'), Atom('H'), Atom('H')] * 20
+    pos = rng.uniform(0, 10, (60, 3))
+    masses = np.array([atom.mass for atom in atoms])
+
+    com = group_centers_of_mass(pos, masses, 3, cell.box_matrix)
+
+    reference = [AtomicSystem(atoms=atoms[i:i+3], pos=pos[i:i+3], cell=cell).center_of_mass
+                 for i in range(0, 60, 3)]
+
+    assert com.shape == (20, 3)
+    assert np.allclose(com, reference)
+
+    with pytest.raises(ValueError):
+        group_centers_of_mass(pos, masses, 7, cell.box_matrix)
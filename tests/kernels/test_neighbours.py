@@ -0,0 +1,119 @@
+import itertools
+
+import pytest
+import numpy as np
+
+from PQAnalysis.core import Cell
+from PQAnalysis.kernels import (
+    CellList,
+    k_nearest_neighbours,
+    minimum_distance,
+    self_image_distance,
+    distances,
+)
+
+
+@pytest.mark.parametrize("cell", [Cell(15, 16, 17), Cell(15, 16, 17, 75, 100, 110), None])
+@pytest.mark.parametrize("queries", [False, True])
+def test_k_nearest_neighbours(cell, queries):
+    rng = np.random.default_rng(7)
+    box_matrix = None if cell is None else cell.box_matrix
+
+    pos = rng.uniform(0, 15, (800, 3))
+    query_pos = rng.uniform(-5, 20, (60, 3)) if queries else None
+
+    indices, neighbour_distances = k_nearest_neighbours(pos, 6, box_matrix, query_pos)
+
+    reference = distances(pos if query_pos is None else query_pos, pos, box_matrix)
+    if query_pos is None:
+        np.fill_diagonal(reference, np.inf)
+
+    assert indices.shape == (len(reference), 6)
+    assert np.allclose(neighbour_distances, np.sort(reference, axis=1)[:, :6])
+    assert np.allclose(np.take_along_axis(reference, indices, axis=1), neighbour_distances)
+
+
+def test_k_nearest_neighbours_void():
+    # a dense cluster and a single far atom, whose neighbours need an enlarged radius
+    rng = np.random.default_rng(3)
+    cell = Cell(40, 40, 40)
+
+    pos = np.concatenate([rng.uniform(0, 8, (500, 3)), [[25.0, 25.0, 25.0]]])
+
+    _, neighbour_distances = k_nearest_neighbours(pos, 4, cell.box_matrix)
+
+    reference = distances(pos, pos, cell.box_matrix)
+    np.fill_diagonal(reference, np.inf)
+
+    assert np.allclose(neighbour_distances, np.sort(reference, axis=1)[:, :4])
+
+
+def test_k_nearest_neighbours_errors():
+    with pytest.raises(ValueError) as exception:
+        k_nearest_neighbours(np.zeros((3, 3)), 3)
+    assert str(exception.value) == "3 nearest neighbours were requested, but only 2 positions are available."
+
+
+@pytest.mark.parametrize("cell", [Cell(10, 11, 12), Cell(10, 11, 12, 70, 100, 115), None])
+def test_minimum_distance(cell):
+    rng = np.random.default_rng(5)
+    box_matrix = None if cell is None else cell.box_matrix
+
+    pos1 = rng.uniform(0, 10, (30, 3))
+    pos2 = rng.uniform(0, 10, (400, 3))
+
+    reference = distances(pos1, pos2, box_matrix)
+    pair, distance = minimum_distance(pos1, pos2, box_matrix)
+
+    assert distance == pytest.approx(reference.min())
+    assert reference[pair[0], pair[1]] == pytest.approx(distance)
+
+    reference = distances(pos2, pos2, box_matrix)
+    np.fill_diagonal(reference, np.inf)
+    pair, distance = minimum_distance(pos2, None, box_matrix)
+
+    assert distance == pytest.approx(reference.min())
+    assert pair[0] < pair[1]
+    assert reference[pair[0], pair[1]] == pytest.approx(distance)
+
+    with pytest.raises(ValueError):
+        minimum_distance(np.zeros((0, 3)), pos2)
+
+
+@pytest.mark.parametrize("cell", [Cell(10, 11, 12), Cell(10, 11, 12, 70, 100, 115),
+                                  Cell(20, 20, 20, 60, 60, 60)])
+def test_self_image_distance(cell):
+    rng = np.random.default_rng(9)
+    box_matrix = cell.box_matrix
+
+    for n in [1, 40]:
+        pos = rng.normal(0, 2.5, (n, 3))
+
+        reference = np.inf
+        for image in itertools.product(range(-3, 4), repeat=3):
+            if any(image):
+                reference = min(reference, distances(pos, pos + box_matrix @ image).min())
+
+        pair, image, distance = self_image_distance(pos, box_matrix)
+
+        assert distance == pytest.approx(reference)
+        assert np.any(image != 0)
+        assert np.linalg.norm(pos[pair[1]] + box_matrix @ image - pos[pair[0]]) == pytest.approx(distance)
+
+
+def test_cell_list_tables():
+    rng = np.random.default_rng(1)
+    cell = Cell(12, 12, 12)
+    pos = rng.uniform(0, 12, (100, 3))
+
+    cells = CellList(pos, cell.box_matrix, 3.0)
+    table = cells.cell_table()
+
+    assert np.array_equal(np.sort(table[table >= 0]), np.arange(100))
+    assert np.array_equal(cells.cell_indices(pos[table[:, 0][table[:, 0] >= 0]]),
+                          np.flatnonzero(table[:, 0] >= 0))
+
+    neighbours = cells.neighbour_cells()
+    assert neighbours.shape == (64, 27)
+    assert all(len(np.unique(row)) == 27 for row in neighbours)
+    assert np.all(neighbours[:, 13] == np.arange(64))
@@ -0,0 +1,88 @@
+import pytest
+import warnings
+import numpy as np
+
+from PQAnalysis.kernels import voronoi_cells, available_backends, get_backend, set_backend
+
+
+def _lattice(basis, n):
+    cells = np.stack(np.meshgrid(*[np.arange(n)] * 3, indexing="ij"), axis=-1).reshape(-1, 3)
+    return (cells[:, np.newaxis, :] + np.asarray(basis)).reshape(-1, 3)
+
+
+def test_voronoi_cells_lattices(backend):
+    # simple cubic: unit cubes with 6 faces, also if the box is smaller than the candidate radius
+    for n in (1, 4):
+        pos = _lattice([[0.0, 0.0, 0.0]], n)
+        volumes, faces, areas = voronoi_cells(pos, np.eye(3) * n)
+
+        assert np.allclose(volumes, 1.0)
+        assert np.all(np.bincount(faces[:, 0], minlength=len(pos)) == 6)
+        assert np.allclose(areas, 1.0)
+
+    # fcc: rhombic dodecahedra of a quarter of the cubic cell with 12 faces
+    pos = _lattice([[0.0, 0.0, 0.0], [0.5, 0.5, 0.0], [0.5, 0.0, 0.5], [0.0, 0.5, 0.5]], 3) * 2.0
+    volumes, faces, areas = voronoi_cells(pos + 0.1, np.eye(3) * 6.0)
+
+    assert np.allclose(volumes, 2.0)
+    assert np.all(np.bincount(faces[:, 0]) == 12)
+    assert np.allclose(areas, np.sqrt(2.0) / 2.0)
+
+
+def test_voronoi_cells_random(backend):
+    rng = np.random.default_rng(5)
+    box_matrix = np.array([[7.0, 1.5, -1.0], [0.0, 6.5, 2.0], [0.0, 0.0, 7.5]])
+
+    pos = rng.uniform(-5.0, 15.0, (150, 3))
+    volumes, faces, areas = voronoi_cells(pos, box_matrix)
+
+    assert np.isclose(np.sum(volumes), np.linalg.det(box_matrix))
+    assert np.all(volumes > 0.0)
+    assert np.all(np.diff(faces[:, 0]) >= 0)
+
+    # each face belongs to both cells with the same area
+    order = np.lexsort((faces[:, 0], faces[:, 1]))
+    assert np.all(faces[order][:, ::-1] == faces)
+    assert np.allclose(areas[order], areas)
+
+    # the radical tessellation shifts volume to the larger atoms
+    radii = np.where(np.arange(150) < 50, 1.5, 1.0)
+    radical_volumes, _, _ = voronoi_cells(pos, box_matrix, radii)
+
+    assert np.isclose(np.sum(radical_volumes), np.linalg.det(box_matrix))
+    assert np.mean(radical_volumes[:50]) > np.mean(volumes[:50])
+
+    # equal radii give the Voronoi tessellation
+    assert np.allclose(voronoi_cells(pos, box_matrix, np.full(150, 1.2))[0], volumes)
+
+
+def test_voronoi_cells_numpy_warning():
+    pos = _lattice([[0.0, 0.0, 0.0]], 2)
+    previous = get_backend()
+
+    try:
+        set_backend("numpy")
+        with pytest.warns(RuntimeWarning, match="clipped in pure Python by the numpy backend"):
+            voronoi_cells(pos, np.eye(3) * 2.0)
+
+        for name in available_backends()[:-1]:
+            set_backend(name)
+            with warnings.catch_warnings():
+                warnings.simplefilter("error")
+                voronoi_cells(pos, np.eye(3) * 2.0)
+    finally:
+        set_backend(previous)
+
+
+def test_voronoi_cells_errors():
+    with pytest.raises(ValueError) as exception:
+        voronoi_cells(np.zeros((0, 3)), np.eye(3))
+    assert str(exception.value) == "The Voronoi tessellation needs at least one position."
+
+    with pytest.raises(ValueError) as exception:
+        voronoi_cells(np.zeros((2, 3)), np.eye(3), np.ones(3))
+    assert str(exception.value) == "The radical Voronoi tessellation needs one radius per position."
+
+    with pytest.raises(ValueError) as exception:
+        voronoi_cells(np.zeros((2, 3)), np.eye(3))
+    assert str(exception.value) == "The Voronoi cells do not fill the box, probably due to coinciding atoms."
@@ -0,0 +1,98 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.physicalData import Energy, EnergyAlignment, EnergyError
+from PQAnalysis.traj import Frame
+from PQAnalysis.core import AtomicSystem
+
+
+def _energy(n_rows, time_step=0.5):
+    data = np.array([np.arange(1, n_rows + 1) * time_step,
+                     np.arange(n_rows) * 10.0])
+    info = {"SIMULATION-TIME": 0, "E(TOT)": 1}
+    units = {"SIMULATION-TIME": "fs", "E(TOT)": "kcal/mol"}
+    return Energy(data, info, units)
+
+
+class TestEnergyAlignment:
+    def test__init__(self):
+        energy = _energy(12)
+
+        alignment = EnergyAlignment(energy, 4)
+        assert alignment.stride == 3
+        assert alignment.offset == 2
+        assert len(alignment) == 4
+        assert np.all(alignment.rows == [2, 5, 8, 11])
+
+        alignment = EnergyAlignment(energy, 4, frame_interval=1.0)
+        assert alignment.stride == 2
+        assert alignment.offset == 1
+
+        alignment = EnergyAlignment(energy, 3, stride=5, offset=0)
+        assert np.all(alignment.rows == [0, 5, 10])
+
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(energy, 5)
+        assert str(exception.value) == (
+            "The stride cannot be inferred from 12 energy rows and 5 frames. Please give the stride explicitly.")
+
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(energy, 4, frame_interval=0.75)
+        assert str(exception.value) == (
+            "The frame interval 0.75 is not a multiple of the energy row interval 0.5.")
+
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(energy, 4, stride=4)
+        assert str(exception.value) == (
+            "4 frames with stride 4 and offset 3 exceed the 12 energy rows.")
+
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(energy, 4, stride=0)
+        assert str(exception.value) == "The stride has to be at least 1."
+
+        energy.data[0, 5] = 100.0
+        energy.simulation_time = energy.data[0]
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(energy, 4)
+        assert str(exception.value) == (
+            "The SIMULATION-TIME of the energy rows is not evenly spaced. Please give the stride explicitly.")
+
+        with pytest.raises(EnergyError) as exception:
+            EnergyAlignment(Energy(np.arange(12.0)), 4, frame_interval=1.0)
+        assert str(exception.value) == (
+            "The stride can only be inferred from the frame interval with at least two SIMULATION-TIME rows.")
+
+    def test_views(self):
+        energy = _energy(12)
+        alignment = EnergyAlignment(energy, 4)
+
+        assert alignment.data.shape == (2, 4)
+        assert np.shares_memory(alignment.data, energy.data)
+        assert np.allclose(alignment.frame_times, [1.5, 3.0, 4.5, 6.0])
+        assert np.allclose(alignment.column("E(TOT)"), [20.0, 50.0, 80.0, 110.0])
+        assert np.allclose(alignment[1], [3.0, 50.0])
+        assert np.allclose(alignment[-1], [6.0, 110.0])
+        assert np.shares_memory(alignment[1], energy.data)
+
+        with pytest.raises(EnergyError) as exception:
+            alignment.column("E(QM)")
+        assert str(exception.value) == "The energy has no column E(QM)."
+
+        alignment = EnergyAlignment(Energy(np.arange(12.0)), 4)
+        assert np.allclose(alignment.column(0), [2.0, 5.0, 8.0, 11.0])
+
+        with pytest.raises(EnergyError) as exception:
+            alignment.frame_times
+        assert str(exception.value) == "The energy has no SIMULATION-TIME column."
+
+    def test_iter_frames(self):
+        alignment = EnergyAlignment(_energy(6), 3)
+        frames = [Frame(AtomicSystem(pos=np.full((1, 3), i))) for i in range(3)]
+
+        pairs = list(alignment.iter_frames(iter(frames)))
+        assert [frame for frame, _ in pairs] == frames
+        assert np.allclose([row for _, row in pairs], [[1.0, 10.0], [2.0, 30.0], [3.0, 50.0]])
+
+        with pytest.raises(EnergyError) as exception:
+            list(alignment.iter_frames(frames + frames[:1]))
+        assert str(exception.value) == "The trajectory has more frames than the 3 aligned frames."
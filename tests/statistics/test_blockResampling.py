@@ -0,0 +1,124 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.statistics import BlockResampling, ResamplingResult, StatisticsError
+
+
+def _mean(partial):
+    return partial[0] / partial[1]
+
+
+class _MeanAccumulator:
+    def __init__(self):
+        self.total = 0.0
+        self.count = 0
+
+    def merge(self, other):
+        self.total += other.total
+        self.count += other.count
+        return self
+
+
+def _accumulator_mean(accumulator):
+    return accumulator.total / accumulator.count
+
+
+class TestBlockResampling:
+    def test__init__(self):
+        with pytest.raises(StatisticsError) as exception:
+            BlockResampling([np.zeros(2)])
+        assert str(exception.value) == "At least two blocks are needed for resampling."
+
+        resampling = BlockResampling([1.0, 2.0], n_workers=None)
+        assert resampling.n_blocks == 2
+        assert resampling.n_workers >= 1
+        assert resampling.estimate() == 3.0
+
+    def test_from_frames(self):
+        values = np.arange(10.0)
+
+        resampling = BlockResampling.from_frames(
+            values, 3, lambda: np.zeros(2), lambda partial, value: partial + [value, 1.0], _mean)
+
+        # frames 0-3, 4-6 and 7-9
+        assert np.allclose(resampling.partials, [[6.0, 4.0], [15.0, 3.0], [24.0, 3.0]])
+        assert resampling.estimate() == pytest.approx(4.5)
+
+        def update(accumulator, value):
+            accumulator.total += value
+            accumulator.count += 1
+
+        resampling = BlockResampling.from_frames(
+            iter(values), 5, _MeanAccumulator, update, _accumulator_mean, n_frames=10)
+        assert [partial.count for partial in resampling.partials] == [2] * 5
+        assert resampling.estimate() == pytest.approx(4.5)
+
+        with pytest.raises(StatisticsError) as exception:
+            BlockResampling.from_frames(values, 11, _MeanAccumulator, update)
+        assert str(exception.value) == "The 10 frames cannot be split into 11 blocks."
+
+        # the given number of frames has to match the consumed frames
+        with pytest.raises(StatisticsError) as exception:
+            BlockResampling.from_frames(iter(values), 5, _MeanAccumulator, update, n_frames=9)
+        assert str(exception.value) == "The frames yield more than the given 9 frames."
+
+        with pytest.raises(StatisticsError) as exception:
+            BlockResampling.from_frames(iter(values), 5, _MeanAccumulator, update, n_frames=12)
+        assert str(exception.value) == "The frames yield 10 instead of the given 12 frames."
+
+    def test_jackknife(self):
+        block_means = np.array([1.0, 2.0, 4.0, 3.0, 5.0])
+        partials = [np.array([mean * 10, 10.0]) for mean in block_means]
+
+        result = BlockResampling(partials, _mean).jackknife()
+        assert isinstance(result, ResamplingResult)
+        assert result.method == "jackknife"
+        assert result.estimate == pytest.approx(3.0)
+        assert result.error == pytest.approx(np.std(block_means, ddof=1) / np.sqrt(5))
+        assert result.replicas.shape == (5,)
+
+        with pytest.raises(StatisticsError) as exception:
+            result.confidence_interval()
+        assert str(exception.value) == "Percentile confidence intervals are only available for bootstrap results."
+
+    def test_bootstrap(self):
+        rng = np.random.default_rng(0)
+        block_means = rng.normal(size=20)
+        partials = [np.array([mean, 1.0]) for mean in block_means]
+
+        result = BlockResampling(partials, _mean).bootstrap(n_replicas=4000, seed=1)
+        assert result.method == "bootstrap"
+        assert result.replicas.shape == (4000,)
+        assert result.error == pytest.approx(np.std(block_means) / np.sqrt(20), rel=0.1)
+
+        lower, upper = result.confidence_interval(0.9)
+        assert lower < result.estimate < upper
+
+        # mergeable accumulators and array partials give the same replicas
+        accumulators = []
+        for mean in block_means:
+            accumulator = _MeanAccumulator()
+            accumulator.total, accumulator.count = mean, 1
+            accumulators.append(accumulator)
+
+        accumulator_result = BlockResampling(accumulators, _accumulator_mean).bootstrap(n_replicas=50, seed=1)
+        array_result = BlockResampling(partials, _mean).bootstrap(n_replicas=50, seed=1)
+        assert np.allclose(accumulator_result.replicas, array_result.replicas)
+        assert accumulators[0].count == 1
+
+        # vector valued estimators
+        partials = [np.array([[mean, 2 * mean], [1.0, 1.0]]) for mean in block_means]
+        result = BlockResampling(partials, _mean).bootstrap(n_replicas=10, seed=1)
+        assert result.replicas.shape == (10, 2)
+        assert np.allclose(result.error[1], 2 * result.error[0])
+
+    def test_parallel(self):
+        block_means = np.arange(8.0)
+        partials = [np.array([mean, 1.0]) for mean in block_means]
+
+        serial = BlockResampling(partials, _mean).bootstrap(n_replicas=40, seed=3)
+        parallel = BlockResampling(partials, _mean, n_workers=2).bootstrap(n_replicas=40, seed=3)
+        assert np.allclose(serial.replicas, parallel.replicas)
+
+        parallel = BlockResampling(partials, _mean, n_workers=3).jackknife()
+        assert np.allclose(parallel.replicas, BlockResampling(partials, _mean).jackknife().replicas)
@@ -0,0 +1,96 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.statistics import correlation, MultiTauCorrelator, StatisticsError
+
+
+def _direct(a, b):
+    n = len(a)
+    return np.array([np.mean(np.sum(np.reshape(a[:n - t] * b[t:], (n - t, a.shape[1], -1)), axis=-1), axis=0)
+                     for t in range(n)])
+
+
+def test_correlation():
+    rng = np.random.default_rng(0)
+
+    a = rng.normal(size=(50, 7, 3))
+    b = rng.normal(size=(50, 7, 3))
+
+    reference = _direct(a, a)
+    assert np.allclose(correlation(a, average=False), reference)
+    assert np.allclose(correlation(a), np.mean(reference, axis=1))
+    assert np.allclose(correlation(a, n_lags=10), np.mean(reference, axis=1)[:10])
+
+    # the series are processed in batches, optionally by several threads
+    assert np.allclose(correlation(a, batch_size=2, average=False), reference)
+    assert np.allclose(correlation(a, batch_size=3, n_workers=3, average=False), reference)
+
+    # cross-correlation <a(s) b(s+t)>
+    assert np.allclose(correlation(a, b, average=False), _direct(a, b))
+    assert np.allclose(correlation(a[:, :, 0], b[:, :, 0], average=False),
+                       _direct(a[:, :, :1], b[:, :, :1]))
+
+    scalar = correlation(a[:, 0, 0], average=False)
+    assert scalar.shape == (50,)
+    assert np.allclose(scalar, _direct(a[:, :1, :1], a[:, :1, :1])[:, 0])
+
+    with pytest.raises(StatisticsError) as exception:
+        correlation(a, b[:10])
+    assert str(exception.value) == "The time series have different shapes (50, 7, 3) and (10, 7, 3)."
+
+    with pytest.raises(StatisticsError) as exception:
+        correlation(a, n_lags=51)
+    assert str(exception.value) == "The number of lags has to be between 1 and the number of time steps 50."
+
+    with pytest.raises(StatisticsError):
+        correlation(np.zeros((2, 2, 2, 2)))
+
+
+class TestMultiTauCorrelator:
+    def test__init__(self):
+        with pytest.raises(StatisticsError) as exception:
+            MultiTauCorrelator(n_points=15, factor=2)
+        assert str(exception.value) == "The multi-tau correlator needs n_levels >= 1, factor >= 2 and n_points being a multiple of factor."
+
+        correlator = MultiTauCorrelator()
+        assert len(correlator.lags) == 0
+
+        with pytest.raises(StatisticsError) as exception:
+            correlator.correlation()
+        assert str(exception.value) == "No values were added to the correlator."
+
+    def test_add(self):
+        rng = np.random.default_rng(1)
+        a = rng.normal(size=(200, 5, 3))
+        b = rng.normal(size=(200, 5, 3))
+
+        correlator = MultiTauCorrelator(n_levels=4, n_points=8, factor=2)
+        cross = MultiTauCorrelator(n_levels=4, n_points=8, factor=2)
+        for step in range(len(a)):
+            correlator.add(a[step])
+            cross.add(a[step], b[step])
+
+        assert correlator.n_steps == 200
+        assert np.array_equal(correlator.lags, [0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14,
+                                                16, 20, 24, 28, 32, 40, 48, 56])
+
+        # the first level is exact
+        assert np.allclose(correlator.correlation(average=False)[:8], _direct(a, a)[:8])
+        assert np.allclose(correlator.correlation()[:8], np.mean(_direct(a, a)[:8], axis=1))
+        assert np.allclose(cross.correlation()[:8], np.mean(_direct(a, b)[:8], axis=1))
+
+        with pytest.raises(StatisticsError) as exception:
+            correlator.add(a[0, :2])
+        assert str(exception.value) == "The values have the shape (2, 3), but the correlator was started with (5, 3)."
+
+    def test_slow_decay(self):
+        # the coarse levels approximate slowly decaying correlations
+        times = np.arange(4096)
+        series = np.cos(2.0 * np.pi * times / 2048.0)
+
+        correlator = MultiTauCorrelator(n_levels=8, n_points=16, factor=2)
+        for value in series:
+            correlator.add(value)
+
+        reference = correlation(series)[correlator.lags]
+        assert np.allclose(correlator.correlation(), reference, atol=2e-2)
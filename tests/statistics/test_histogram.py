@@ -0,0 +1,116 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.statistics import Histogram, StatisticsError
+
+
+class TestHistogram:
+    def test__init__(self):
+        histogram = Histogram((0.0, 2.0), 4)
+        assert histogram.dim == 1
+        assert np.array_equal(histogram.n_bins, [4])
+        assert histogram.counts.shape == (4,)
+        assert histogram.counts.dtype == np.float64
+        assert np.allclose(histogram.edges[0], [0.0, 0.5, 1.0, 1.5, 2.0])
+        assert np.allclose(histogram.centers[0], [0.25, 0.75, 1.25, 1.75])
+
+        histogram = Histogram([(0.0, 1.0), (-1.0, 1.0), (0.0, 3.0)], [2, 4, 3])
+        assert histogram.dim == 3
+        assert histogram.counts.shape == (2, 4, 3)
+        assert np.allclose(histogram.widths, [0.5, 0.5, 1.0])
+
+        with pytest.raises(StatisticsError) as exception:
+            Histogram([(0.0, 1.0)] * 4, 2)
+        assert str(exception.value) == "Only 1D, 2D and 3D histograms with one number of bins per dimension are supported."
+
+        with pytest.raises(StatisticsError):
+            Histogram([(0.0, 1.0)] * 2, [2, 2, 2])
+
+        with pytest.raises(StatisticsError) as exception:
+            Histogram((1.0, 1.0), 2)
+        assert str(exception.value) == "Each dimension of a histogram needs a positive number of bins and an upper limit larger than the lower limit."
+
+    def test_add(self):
+        rng = np.random.default_rng(0)
+
+        values = rng.uniform(-0.5, 2.5, size=1000)
+        weights = rng.uniform(size=1000)
+
+        histogram = Histogram((0.0, 2.0), 8)
+        histogram.add(values, weights)
+
+        reference, _ = np.histogram(values, bins=8, range=(0.0, 2.0), weights=weights)
+        assert np.allclose(histogram.counts, reference)
+
+        inside = (values >= 0.0) & (values <= 2.0)
+        assert np.isclose(histogram.outside, np.sum(weights[~inside]))
+        assert np.isclose(histogram.total, np.sum(weights))
+
+        # the upper limit belongs to the last bin and NaN values are outside
+        histogram = Histogram((0.0, 2.0), 8)
+        histogram.add(np.array([2.0, 0.0, np.nan]), 2.0)
+        assert histogram.counts[-1] == 2.0
+        assert histogram.counts[0] == 2.0
+        assert histogram.outside == 2.0
+
+        values = rng.uniform(size=(500, 3))
+        histogram = Histogram([(0.0, 1.0), (0.0, 0.5), (0.0, 1.0)], [2, 3, 4])
+        histogram.add(values)
+
+        reference, _ = np.histogramdd(values, bins=[2, 3, 4], range=[(0.0, 1.0), (0.0, 0.5), (0.0, 1.0)])
+        assert np.allclose(histogram.counts, reference)
+        assert np.isclose(np.sum(histogram.density() * np.prod(histogram.widths)), 1.0)
+
+        with pytest.raises(StatisticsError) as exception:
+            histogram.add(values[:, :2])
+        assert str(exception.value) == "The values of a 3D histogram need the shape (n, 3), got (500, 2)."
+
+        with pytest.raises(StatisticsError) as exception:
+            Histogram((0.0, 1.0), 2).density()
+        assert str(exception.value) == "The histogram is empty."
+
+    def test_merge(self):
+        rng = np.random.default_rng(1)
+        values = rng.normal(size=(300, 2))
+
+        full = Histogram([(-2.0, 2.0), (-2.0, 2.0)], 10)
+        full.add(values)
+
+        first = Histogram([(-2.0, 2.0), (-2.0, 2.0)], 10)
+        second = Histogram([(-2.0, 2.0), (-2.0, 2.0)], 10)
+        first.add(values[:100])
+        second.add(values[100:])
+
+        assert first.merge(second) is first
+        assert np.allclose(first.counts, full.counts)
+        assert first.outside == full.outside
+
+        first.add_counts(np.ones((10, 10)), 2.0)
+        assert np.allclose(first.counts, full.counts + 1.0)
+
+        with pytest.raises(StatisticsError) as exception:
+            first.add_counts(np.ones(10))
+        assert str(exception.value) == "The counts have the shape (10,), but the histogram has the shape (10, 10)."
+
+        with pytest.raises(StatisticsError) as exception:
+            first.merge(Histogram([(-2.0, 2.0), (-2.0, 3.0)], 10))
+        assert str(exception.value) == "Only histograms with identical bins can be merged."
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_save(self):
+        histogram = Histogram([(0.0, 1.0), (0.0, 2.0)], [3, 4])
+        histogram.add(np.array([[0.5, 0.5], [0.1, 1.9], [3.0, 0.0]]), np.array([1.0, 2.0, 3.0]))
+
+        histogram.save("histogram.npz")
+        loaded = Histogram.load("histogram.npz")
+
+        assert np.array_equal(loaded.ranges, histogram.ranges)
+        assert np.array_equal(loaded.n_bins, histogram.n_bins)
+        assert np.array_equal(loaded.counts, histogram.counts)
+        assert loaded.outside == 3.0
+
+        state = histogram.to_dict()
+        state["version"] = np.array(0)
+        with pytest.raises(StatisticsError) as exception:
+            Histogram.from_dict(state)
+        assert str(exception.value) == "The histogram was stored with version 0, but version 1 is expected."
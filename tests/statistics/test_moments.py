@@ -0,0 +1,86 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.statistics import MomentAccumulator, StatisticsError
+
+
+class TestMomentAccumulator:
+    def test_add(self):
+        rng = np.random.default_rng(0)
+        values = 1e6 + rng.normal(size=(1000, 3))
+        weights = rng.uniform(size=1000)
+
+        accumulator = MomentAccumulator()
+        assert accumulator.shape is None
+
+        for batch in np.array_split(np.arange(1000), 7):
+            accumulator.add(values[batch], weights[batch])
+
+        assert accumulator.shape == (3,)
+        assert np.allclose(accumulator.weight, np.sum(weights))
+
+        mean = np.average(values, axis=0, weights=weights)
+        variance = np.average((values - mean)**2, axis=0, weights=weights)
+        assert np.allclose(accumulator.mean, mean)
+        assert np.allclose(accumulator.variance(), variance)
+        assert np.allclose(accumulator.std(), np.sqrt(variance))
+
+        accumulator = MomentAccumulator(shape=(3,))
+        accumulator.add(values)
+        assert np.allclose(accumulator.variance(ddof=1), np.var(values, axis=0, ddof=1))
+
+        # element-wise weights
+        accumulator = MomentAccumulator()
+        accumulator.add(np.array([[1.0, 1.0], [3.0, 5.0]]), np.array([[1.0, 0.0], [1.0, 1.0]]))
+        assert np.allclose(accumulator.mean, [2.0, 5.0])
+        assert np.allclose(accumulator.weight, [2.0, 1.0])
+
+        scalar = MomentAccumulator()
+        for value in [1.0, 2.0, 3.0, 4.0]:
+            scalar.add(value)
+        assert np.isclose(scalar.mean, 2.5)
+        assert np.isclose(scalar.variance(ddof=1), np.var([1.0, 2.0, 3.0, 4.0], ddof=1))
+        assert np.isnan(MomentAccumulator(shape=()).variance(ddof=1))
+
+        with pytest.raises(StatisticsError) as exception:
+            accumulator.add(np.zeros((2, 3)))
+        assert str(exception.value) == "The samples have the shape (3,), but the accumulator has the shape (2,)."
+
+    def test_merge(self):
+        rng = np.random.default_rng(1)
+        values = rng.normal(size=(500, 2))
+
+        full = MomentAccumulator()
+        full.add(values)
+
+        parts = [MomentAccumulator() for _ in range(3)]
+        for part, batch in zip(parts, np.array_split(values, 3)):
+            part.add(batch)
+
+        merged = MomentAccumulator()
+        assert merged.merge(parts[0]) is merged
+        merged.merge(parts[1]).merge(parts[2]).merge(MomentAccumulator())
+
+        assert np.allclose(merged.weight, full.weight)
+        assert np.allclose(merged.mean, full.mean)
+        assert np.allclose(merged.m2, full.m2)
+
+        with pytest.raises(StatisticsError) as exception:
+            merged.merge(MomentAccumulator(shape=(3,)))
+        assert str(exception.value) == "An accumulator of shape (3,) cannot be merged into an accumulator of shape (2,)."
+
+    @pytest.mark.usefixtures("tmpdir")
+    def test_save(self):
+        accumulator = MomentAccumulator()
+        accumulator.add(np.arange(12.0).reshape(4, 3))
+
+        accumulator.save("moments.npz")
+        loaded = MomentAccumulator.load("moments.npz")
+
+        assert loaded.shape == (3,)
+        assert np.array_equal(loaded.mean, accumulator.mean)
+        assert np.array_equal(loaded.m2, accumulator.m2)
+        assert np.array_equal(loaded.weight, accumulator.weight)
+
+        MomentAccumulator().save("empty.npz")
+        assert MomentAccumulator.load("empty.npz").shape is None
@@ -0,0 +1,79 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.statistics import autocorrelation, statistical_inefficiency, decorrelated_indices, read_decorrelated_frames, StatisticsError
+from PQAnalysis.io import TrajectoryReader
+
+
+def _ar1(n, phi, seed=0):
+    rng = np.random.default_rng(seed)
+    noise = rng.normal(size=n)
+    series = np.empty(n)
+    series[0] = noise[0]
+    for i in range(1, n):
+        series[i] = phi * series[i - 1] + noise[i]
+    return series
+
+
+def test_autocorrelation():
+    series = np.array([1.0, -1.0, 1.0, -1.0])
+    assert np.allclose(autocorrelation(series), [1.0, -1.0, 1.0, -1.0])
+
+    assert np.allclose(autocorrelation(np.ones(5)), [1.0, 0.0, 0.0, 0.0, 0.0])
+
+
+def test_statistical_inefficiency():
+    # g = (1 + phi) / (1 - phi) for an AR(1) process
+    assert statistical_inefficiency(_ar1(200000, 0.8)) == pytest.approx(9.0, rel=0.1)
+
+    uncorrelated = np.random.default_rng(1).normal(size=10000)
+    assert statistical_inefficiency(uncorrelated) == pytest.approx(1.0, abs=0.2)
+
+    assert statistical_inefficiency(np.ones(10)) == 1.0
+
+    # the largest inefficiency of all columns is returned
+    observable = np.column_stack([uncorrelated, _ar1(10000, 0.8)])
+    assert statistical_inefficiency(observable) == pytest.approx(
+        statistical_inefficiency(observable[:, 1]))
+
+    with pytest.raises(StatisticsError) as exception:
+        statistical_inefficiency(np.ones(1))
+    assert str(exception.value) == "The statistical inefficiency needs at least two samples."
+
+
+def test_decorrelated_indices():
+    observable = np.zeros(10)
+
+    assert np.all(decorrelated_indices(observable, inefficiency=2.5) == [0, 2, 5, 8])
+    assert np.all(decorrelated_indices(observable, inefficiency=2.5, conservative=True) == [0, 3, 6, 9])
+    assert np.all(decorrelated_indices(observable) == np.arange(10))
+
+
+@pytest.mark.usefixtures("tmpdir")
+def test_read_decorrelated_frames():
+    values = _ar1(40, 0.9)
+
+    with open("traj.xyz", "w") as file:
+        for value in values:
+            print(f"1 10.0 10.0 10.0\n\nh {value} 0.0 0.0", file=file)
+
+    reader = TrajectoryReader("traj.xyz")
+    expected = decorrelated_indices(values)
+    assert len(expected) < 40
+
+    traj, frames = read_decorrelated_frames(reader, values)
+    assert np.all(frames == expected)
+    assert np.allclose([frame.pos[0, 0] for frame in traj], values[frames])
+
+    traj, frames = read_decorrelated_frames(reader, lambda frame: frame.pos[0, 0])
+    assert np.all(frames == expected)
+    assert len(traj) == len(expected)
+
+    # observables returning views on the reused frame buffer
+    traj, frames = read_decorrelated_frames(reader, lambda frame: frame.pos[0])
+    assert np.all(frames == expected)
+    assert np.allclose([frame.pos[0, 0] for frame in traj], values[frames])
+
+    with pytest.raises(StatisticsError) as exception:
+        read_decorrelated_frames(reader, values[:10])
+    assert str(exception.value) == "The observable has 10 values, but the trajectory has 40 frames."
@@ -0,0 +1,77 @@
+import pytest
+import numpy as np
+
+from PQAnalysis.topology import MoleculeTopology, TopologyError
+from PQAnalysis.io import MoldescriptorReader
+from PQAnalysis.core import Atom, Cell
+
+
+class TestMoleculeTopology:
+    def test__init__(self):
+        topology = MoleculeTopology(np.array([0, 3, 4]))
+
+        assert topology.n_molecules == 2
+        assert topology.n_atoms == 4
+        assert np.array_equal(topology.sizes, [3, 1])
+        assert np.array_equal(topology.first_atoms, [0, 3])
+        assert np.array_equal(topology.molecule(0), [0, 1, 2])
+        assert np.array_equal(topology.atom_molecules(), [0, 0, 0, 1])
+        assert np.array_equal(topology.mol_type_ids, [0, 0])
+
+        with pytest.raises(TopologyError) as exception:
+            MoleculeTopology(np.array([0, 3, 3]))
+        assert str(exception.value) == "The offsets of a molecule topology have to increase from 0 to the number of atoms."
+
+        with pytest.raises(TopologyError) as exception:
+            MoleculeTopology(np.array([0, 3]), mol_type_ids=np.array([1, 2]))
+        assert str(exception.value) == "The number of mol type ids has to match the number of molecules."
+
+    def test_from_groups(self):
+        topology = MoleculeTopology.from_groups(6, 3)
+        assert np.array_equal(topology.offsets, [0, 3, 6])
+
+        with pytest.raises(TopologyError):
+            MoleculeTopology.from_groups(7, 3)
+
+    @pytest.mark.parametrize("example_dir", ["readMoldescriptor"], indirect=False)
+    def test_from_mol_types(self, test_with_data_dir):
+        mol_types = MoldescriptorReader("moldescriptor.dat").read()
+
+        topology = MoleculeTopology.from_mol_types(
+            np.array([0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2]), mol_types)
+
+        assert np.array_equal(topology.offsets, [0, 1, 4, 7, 11])
+        assert np.array_equal(topology.mol_type_ids, [0, 1, 1, 2])
+
+        charges = topology.partial_charges(mol_types)
+        assert np.allclose(charges[:4], [0.0, -0.65966, 0.32983, 0.32983])
+        assert np.allclose(charges[7:], [-0.8022, 0.2674, 0.2674, 0.2674])
+
+        water = topology.select(1)
+        assert np.array_equal(water.indices, np.arange(1, 7))
+        assert np.array_equal(water.offsets, [0, 3, 6])
+
+        with pytest.raises(TopologyError) as exception:
+            MoleculeTopology.from_mol_types(np.array([1, 1]), mol_types)
+        assert str(exception.value) == "The 2 consecutive atoms of mol type 1 are not a multiple of its 3 atoms."
+
+        with pytest.raises(TopologyError) as exception:
+            MoleculeTopology.from_mol_types(np.array([3]), mol_types)
+        assert str(exception.value) == "The mol type 3 is not defined."
+
+        with pytest.raises(TopologyError):
+            topology.select(5)
+
+    def test_from_bonds(self):
+        pos = np.array([[0.0, 0.0, 0.0], [5.0, 5.0, 5.0], [0.96, 0.0, 0.0],
+                        [9.8, 5.0, 5.0], [-0.24, 0.93, 0.0], [0.5, 5.6, 5.0], [9.1, 5.6, 5.0]])
+        atoms = [Atom(name) for name in ["O", "Na", "H", "O", "H", "H", "H"]]
+
+        topology = MoleculeTopology.from_bonds(pos, atoms, Cell(10, 10, 10).box_matrix)
+
+        assert np.array_equal(topology.offsets, [0, 3, 4, 7])
+        assert np.array_equal(topology.indices, [0, 2, 4, 1, 3, 5, 6])
+
+        # without periodic boundary conditions the second water is broken
+        topology = MoleculeTopology.from_bonds(pos, atoms)
+        assert topology.n_molecules == 4
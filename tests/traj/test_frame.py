@@ -2,7 +2,7 @@ import numpy as np
 import pytest
 
 from PQAnalysis.traj import Frame, FrameError
-from PQAnalysis.core import Cell, Atom, AtomicSystem
+from PQAnalysis.core import Cell, Atom, AtomicSystem, AtomicSystemPositionsError, AtomicSystemMassError
 from PQAnalysis.topology import Topology
 
 
@@ -46,6 +46,17 @@ class TestFrame:
         assert com_frame.atoms == [
             Atom(atom, use_guess_element=False) for atom in ['C', 'H', 'H']]
 
+        # atoms without masses are rejected before the centers of mass are computed
+        frame = Frame(AtomicSystem(atoms=[Atom('C'), Atom('X', use_guess_element=False)], pos=np.zeros((2, 3))))
+        with pytest.raises(AtomicSystemMassError) as exception:
+            frame.compute_com_frame()
+        assert str(exception.value) == AtomicSystemMassError.message
+
+        frame = Frame(AtomicSystem(atoms=[Atom('C')], pos=np.zeros((2, 3))))
+        with pytest.raises(AtomicSystemPositionsError) as exception:
+            frame.compute_com_frame()
+        assert str(exception.value) == AtomicSystemPositionsError.message
+
     def test__eq__(self):
         frame1 = Frame(AtomicSystem(pos=np.array([[0, 0, 0]])))
         frame2 = Frame(AtomicSystem(pos=np.array([[0, 0, 0]])))
@@ -110,6 +110,15 @@ class TestTrajectory:
 
         assert Trajectory() != 1
 
+    def test_astype(self):
+        traj = Trajectory(self.frames)
+        traj32 = traj.astype(np.float32)
+
+        assert len(traj32) == len(traj)
+        assert all(frame.dtype == np.float32 for frame in traj32)
+        assert all(frame.dtype != np.float32 for frame in traj)
+        assert traj32 == traj
+
     def test_append(self):
         traj = Trajectory()
         traj.append(self.frame1)